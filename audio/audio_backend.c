@@ -0,0 +1,291 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "audio_backend.h"
+#include "wav_writer.h"
+#include "log.h"
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+//=================================================CLOCK==========================================================
+
+uint64_t audio_clock_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void audio_sleep_until(uint64_t deadline_ns) {
+    uint64_t now = audio_clock_ns();
+    if (now >= deadline_ns) return;
+#ifdef _WIN32
+    //? Sleep() has millisecond granularity at best, round down and let the caller catch up
+    DWORD ms = (DWORD)((deadline_ns - now) / 1000000ull);
+    if (ms > 0) Sleep(ms);
+#else
+    uint64_t wait = deadline_ns - now;
+    struct timespec ts = { (time_t)(wait / 1000000000ull), (long)(wait % 1000000000ull) };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+#endif
+}
+
+//=================================================SINK BACKENDS==========================================================
+//* The null, simulated and file backends share one implementation: a thread that renders block
+//* after block and either drops the audio or appends it to a WAV file. When paced, it models
+//* a device with a ring of `depth` buffers played back to back in real time. The offline
+//* backend reuses the state but has no thread: the caller renders into its buffer.
+
+#define SINK_MAX_DEPTH 64
+
+typedef struct sink_impl_t {
+    pthread_t thread;
+    atomic_bool running;
+    bool started;
+    unsigned depth;             //? buffers queued on the modelled device, 0 renders as fast as possible
+    wav_writer_t* writer;       //? NULL unless this is the file backend
+    int16_t* target;            //? offline backend: the caller's buffer, `capacity` frames
+    size_t capacity;
+    int16_t* block;
+    uint64_t next_block;        //? render calls so far, numbers the block events
+    uint64_t done_at[SINK_MAX_DEPTH];   //? when each queued buffer finishes playing
+} sink_impl_t;
+
+static void sink_event(audio_backend_t* backend, audio_block_event_t event, uint64_t block, uint64_t time_ns) {
+    if (backend->config.on_block) backend->config.on_block(backend->config.user, event, block, time_ns);
+}
+
+static void* sink_thread(void* arg) {
+    audio_backend_t* backend = (audio_backend_t*)arg;
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    const audio_config_t* config = &backend->config;
+    const uint64_t block_ns = (uint64_t)config->block_frames * 1000000000ull / config->sample_rate;
+    uint64_t played_until = audio_clock_ns();   //? when the audio handed over so far runs out
+    unsigned oldest = 0, queued = 0;
+    bool first = true;
+
+    while (atomic_load_explicit(&sink->running, memory_order_acquire)) {
+        if (sink->depth > 0 && queued == sink->depth) {
+            //? Every buffer is queued: wait for the oldest to finish playing, like waiting on WOM_DONE
+            audio_sleep_until(sink->done_at[oldest]);
+            sink_event(backend, AUDIO_BLOCK_DONE, sink->next_block - queued, audio_clock_ns());
+            oldest = (oldest + 1) % sink->depth;
+            --queued;
+            continue;
+        }
+        config->render(config->user, sink->block, config->block_frames);
+        if (sink->writer && !wav_writer_append_frames(sink->writer, sink->block, config->block_frames)) {
+            Log(LOG_ERROR, "File sink: write failed, stopping.\n");
+            break;
+        }
+        atomic_fetch_add_explicit(&backend->frames_rendered, config->block_frames, memory_order_relaxed);
+        uint64_t now = audio_clock_ns();
+        const uint64_t block = sink->next_block++;
+        sink_event(backend, AUDIO_BLOCK_SUBMITTED, block, now);
+        if (sink->depth == 0) {
+            sink_event(backend, AUDIO_BLOCK_DONE, block, now);
+            continue;
+        }
+        //* The device played everything it had before this block arrived
+        if (now > played_until) {
+            if (!first) atomic_fetch_add_explicit(&backend->underruns, 1, memory_order_relaxed);
+            played_until = now;
+        }
+        first = false;
+        played_until += block_ns;
+        sink->done_at[(oldest + queued) % sink->depth] = played_until;
+        ++queued;
+    }
+    return NULL;
+}
+
+static bool sink_start(audio_backend_t* backend) {
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    if (sink->started) return true;
+    atomic_store(&sink->running, true);
+    if (pthread_create(&sink->thread, NULL, sink_thread, backend) != 0) {
+        Log(LOG_ERROR, "%s backend: unable to start the render thread.\n", backend->ops->name);
+        atomic_store(&sink->running, false);
+        return false;
+    }
+    sink->started = true;
+    return true;
+}
+
+static void sink_stop(audio_backend_t* backend) {
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    if (!sink->started) return;
+    atomic_store_explicit(&sink->running, false, memory_order_release);
+    pthread_join(sink->thread, NULL);
+    sink->started = false;
+    if (sink->writer && !wav_writer_flush(sink->writer)) {
+        Log(LOG_ERROR, "File sink: unable to update the WAV header.\n");
+    }
+}
+
+static void sink_destroy(audio_backend_t* backend) {
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    if (sink) {
+        if (sink->writer) wav_writer_close(sink->writer);
+        free(sink->writer);
+        free(sink->block);
+        free(sink);
+    }
+    free(backend);
+}
+
+static const audio_backend_ops_t null_ops = { "null", sink_start, sink_stop, sink_destroy };
+static const audio_backend_ops_t sim_ops = { "sim", sink_start, sink_stop, sink_destroy };
+static const audio_backend_ops_t file_ops = { "file", sink_start, sink_stop, sink_destroy };
+
+//? Offline rendering only happens in audio_offline_render(), there's no thread to start or stop
+static bool offline_start(audio_backend_t* backend) {
+    (void)backend;
+    return true;
+}
+
+static void offline_stop(audio_backend_t* backend) {
+    (void)backend;
+}
+
+static const audio_backend_ops_t offline_ops = { "offline", offline_start, offline_stop, sink_destroy };
+
+static audio_backend_t* sink_init(const audio_config_t* config, const audio_backend_ops_t* ops, unsigned depth) {
+    if (!config || !config->render || config->sample_rate == 0 || config->num_channels == 0 || config->block_frames == 0 || depth > SINK_MAX_DEPTH) {
+        Log(LOG_ERROR, "Invalid audio backend configuration.\n");
+        return NULL;
+    }
+    audio_backend_t* backend = (audio_backend_t*)calloc(1, sizeof(audio_backend_t));
+    sink_impl_t* sink = (sink_impl_t*)calloc(1, sizeof(sink_impl_t));
+    int16_t* block = (int16_t*)malloc(config->block_frames * config->num_channels * sizeof(int16_t));
+    if (!backend || !sink || !block) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the %s backend.\n", ops->name);
+        free(backend);
+        free(sink);
+        free(block);
+        return NULL;
+    }
+    backend->ops = ops;
+    backend->config = *config;
+    atomic_init(&backend->frames_rendered, 0);
+    atomic_init(&backend->underruns, 0);
+    atomic_init(&sink->running, false);
+    sink->depth = depth;
+    sink->block = block;
+    backend->impl = sink;
+    return backend;
+}
+
+//? Realtime pacing is the double-buffered case: the next block is asked for as soon as the previous one starts playing
+audio_backend_t* audio_null_backend_init(const audio_config_t* config, bool realtime) {
+    return sink_init(config, &null_ops, realtime ? 2 : 0);
+}
+
+audio_backend_t* audio_sim_backend_init(const audio_config_t* config, unsigned num_buffers) {
+    if (num_buffers < 2) {
+        Log(LOG_ERROR, "Invalid audio backend configuration.\n");
+        return NULL;
+    }
+    return sink_init(config, &sim_ops, num_buffers);
+}
+
+audio_backend_t* audio_file_backend_init(const audio_config_t* config, const char* path, bool realtime) {
+    audio_backend_t* backend = sink_init(config, &file_ops, realtime ? 2 : 0);
+    if (!backend) return NULL;
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    wav_header_t format;
+    wav_init_header(&format, WAV_FORMAT_PCM, config->num_channels, config->sample_rate, 16);
+    sink->writer = (wav_writer_t*)malloc(sizeof(wav_writer_t));
+    if (!sink->writer || !wav_writer_open(sink->writer, path, &format, NULL)) {
+        free(sink->writer);
+        sink->writer = NULL;
+        sink_destroy(backend);
+        return NULL;
+    }
+    return backend;
+}
+
+audio_backend_t* audio_offline_backend_init(const audio_config_t* config, int16_t* buffer, size_t capacity_frames) {
+    if (!buffer) {
+        Log(LOG_ERROR, "Invalid audio backend configuration.\n");
+        return NULL;
+    }
+    audio_backend_t* backend = sink_init(config, &offline_ops, 0);
+    if (!backend) return NULL;
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    sink->target = buffer;
+    sink->capacity = capacity_frames;
+    return backend;
+}
+
+size_t audio_offline_render(audio_backend_t* backend, size_t frames) {
+    if (!backend || backend->ops != &offline_ops) return 0;
+    sink_impl_t* sink = (sink_impl_t*)backend->impl;
+    const audio_config_t* config = &backend->config;
+    size_t written = (size_t)audio_backend_frames_rendered(backend);
+    if (frames > sink->capacity - written) frames = sink->capacity - written;
+    //* Same blocks and events as a device would see, rendered straight into the buffer
+    for (size_t done = 0; done < frames; ) {
+        size_t n = (frames - done < config->block_frames) ? frames - done : config->block_frames;
+        config->render(config->user, sink->target + (written + done) * config->num_channels, n);
+        atomic_fetch_add_explicit(&backend->frames_rendered, n, memory_order_relaxed);
+        const uint64_t block = sink->next_block++;
+        const uint64_t now = audio_clock_ns();
+        sink_event(backend, AUDIO_BLOCK_SUBMITTED, block, now);
+        sink_event(backend, AUDIO_BLOCK_DONE, block, now);
+        done += n;
+    }
+    return frames;
+}
+
+//=================================================DISPATCH==========================================================
+
+bool audio_backend_start(audio_backend_t* backend) {
+    if (!backend) return false;
+    return backend->ops->start(backend);
+}
+
+void audio_backend_stop(audio_backend_t* backend) {
+    if (!backend) return;
+    backend->ops->stop(backend);
+}
+
+void audio_backend_free(audio_backend_t* backend) {
+    if (!backend) return;
+    backend->ops->stop(backend);
+    backend->ops->destroy(backend);
+}
+
+uint64_t audio_backend_frames_rendered(const audio_backend_t* backend) {
+    return atomic_load_explicit((atomic_uint_fast64_t*)&backend->frames_rendered, memory_order_relaxed);
+}
+
+uint64_t audio_backend_underruns(const audio_backend_t* backend) {
+    return atomic_load_explicit((atomic_uint_fast64_t*)&backend->underruns, memory_order_relaxed);
+}
@@ -0,0 +1,174 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/**
+ * Called by a backend on its own thread whenever the device needs `frames` more
+ * frames of interleaved 16-bit audio. It must not block: no locks, no I/O, no
+ * allocation.
+ */
+typedef void (*audio_render_fn)(void* user, int16_t* out, size_t frames);
+
+typedef enum audio_block_event_t {
+    AUDIO_BLOCK_SUBMITTED,      //? the block was handed to the device
+    AUDIO_BLOCK_DONE,           //? the device finished playing it
+} audio_block_event_t;
+
+/**
+ * Optional timing hook, called on the backend's render thread. `block` numbers render
+ * calls from 0 since the backend was opened; `time_ns` is audio_clock_ns() when the
+ * event happened. Blocks still queued when the backend stops get no DONE.
+ */
+typedef void (*audio_block_fn)(void* user, audio_block_event_t event, uint64_t block, uint64_t time_ns);
+
+/**
+ * What a backend is opened with.
+ */
+typedef struct audio_config_t {
+    uint32_t sample_rate;
+    uint16_t num_channels;
+    size_t block_frames;        //? frames per render call
+    audio_render_fn render;
+    void* user;                 //? passed back to `render` and `on_block`
+    audio_block_fn on_block;    //? NULL when nobody is measuring
+} audio_config_t;
+
+typedef struct audio_backend_t audio_backend_t;
+
+/**
+ * Functions every backend provides; `audio_backend_*` dispatch through these.
+ */
+typedef struct audio_backend_ops_t {
+    const char* name;
+    bool (*start)(audio_backend_t* backend);
+    void (*stop)(audio_backend_t* backend);
+    void (*destroy)(audio_backend_t* backend);
+} audio_backend_ops_t;
+
+/**
+ * An output device. It owns the thread that calls `config.render` (pull model),
+ * so the code producing audio never talks to the device API itself.
+ */
+struct audio_backend_t {
+    const audio_backend_ops_t* ops;
+    audio_config_t config;
+    atomic_uint_fast64_t frames_rendered;   //? frames handed to the device so far
+    atomic_uint_fast64_t underruns;         //? times the device ran out of audio before the next block was ready
+    void* impl;                             //? backend specific state
+};
+
+/**
+ * @brief Opens a backend that throws the audio away.
+ *
+ * With `realtime` set it paces render calls to the sample rate like a double-buffered
+ * device would, and counts an underrun whenever a render call returns after the
+ * previous block has finished "playing". Otherwise it calls `render` back to back
+ * (benchmarks, offline tests).
+ *
+ * @returns `NULL` if the configuration is invalid or an allocation fails.
+ */
+audio_backend_t* audio_null_backend_init(const audio_config_t* config, bool realtime);
+
+/**
+ * @brief Opens a simulated device that behaves like the waveOut backend: a ring of
+ *        `num_buffers` buffers, all queued at start, each rendered again as soon as the
+ *        device "finishes" it.
+ *
+ * Playback time is the wall clock, so block events, latency and underruns come out
+ * the way they would on a real device with that many buffers, on any platform.
+ */
+audio_backend_t* audio_sim_backend_init(const audio_config_t* config, unsigned num_buffers);
+
+/**
+ * @brief Opens a backend that writes everything it renders to a 16-bit PCM WAV file.
+ *
+ * Rendering runs as fast as the disk allows unless `realtime` is set. The header
+ * sizes are patched when the backend is stopped, and past 4 GB the file becomes RF64.
+ */
+audio_backend_t* audio_file_backend_init(const audio_config_t* config, const char* path, bool realtime);
+
+/**
+ * @brief Opens a backend that renders into `buffer`, `capacity_frames` frames of
+ *        interleaved 16-bit audio, on the caller's thread.
+ *
+ * Nothing runs on its own: start and stop do nothing, and each audio_offline_render()
+ * call renders the next frames in blocks of `block_frames`, with the usual block
+ * events. Whatever is queued between two calls (plays, fades, gain changes) lands on
+ * the same frame every run, so renders are repeatable: tests, bounces, golden files.
+ */
+audio_backend_t* audio_offline_backend_init(const audio_config_t* config, int16_t* buffer, size_t capacity_frames);
+
+/**
+ * @brief Renders the next `frames` frames into an offline backend's buffer.
+ *
+ * @returns the frames rendered: fewer than asked once the buffer is full, 0 if
+ *          `backend` isn't an offline backend.
+ */
+size_t audio_offline_render(audio_backend_t* backend, size_t frames);
+
+#ifdef _WIN32
+/**
+ * @brief Opens the default waveOut device.
+ *
+ * The device is fed from a ring of `num_buffers` buffers of `block_frames` each:
+ * whenever the driver hands one back, the backend's thread renders into it and
+ * queues it again. Output latency is about `num_buffers * block_frames` frames;
+ * fewer buffers mean less latency and less slack before an underrun.
+ */
+audio_backend_t* audio_waveout_backend_init(const audio_config_t* config, unsigned num_buffers);
+#endif
+
+/**
+ * @brief Starts calling `render` on the backend's thread.
+ */
+bool audio_backend_start(audio_backend_t* backend);
+
+/**
+ * @brief Stops the device and joins its thread. No render call is running once it returns.
+ */
+void audio_backend_stop(audio_backend_t* backend);
+
+/**
+ * @brief Stops the backend if needed and frees it.
+ */
+void audio_backend_free(audio_backend_t* backend);
+
+/**
+ * @returns the number of frames rendered since the backend was opened.
+ */
+uint64_t audio_backend_frames_rendered(const audio_backend_t* backend);
+
+/**
+ * @returns how many times the device ran dry since the backend was opened.
+ */
+uint64_t audio_backend_underruns(const audio_backend_t* backend);
+
+/**
+ * @returns a monotonic timestamp in nanoseconds.
+ */
+uint64_t audio_clock_ns(void);
+
+/**
+ * @brief Sleeps until audio_clock_ns() reaches `deadline_ns`.
+ */
+void audio_sleep_until(uint64_t deadline_ns);
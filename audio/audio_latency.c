@@ -0,0 +1,101 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "audio_latency.h"
+#include <string.h>
+
+static unsigned histogram_bucket(uint64_t ns) {
+    if (ns < AUDIO_HISTOGRAM_SUB_BUCKETS) return (unsigned)ns;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(ns);
+    //? The top bit picks the octave, the next 3 bits the step inside it
+    unsigned index = (msb - 2) * AUDIO_HISTOGRAM_SUB_BUCKETS + (unsigned)((ns >> (msb - 3)) & (AUDIO_HISTOGRAM_SUB_BUCKETS - 1));
+    return (index < AUDIO_HISTOGRAM_BUCKETS) ? index : AUDIO_HISTOGRAM_BUCKETS - 1;
+}
+
+//? Middle of the bucket's range
+static uint64_t histogram_bucket_value(unsigned index) {
+    if (index < AUDIO_HISTOGRAM_SUB_BUCKETS) return index;
+    unsigned msb = index / AUDIO_HISTOGRAM_SUB_BUCKETS + 2;
+    uint64_t step = 1ull << (msb - 3);
+    uint64_t low = (uint64_t)(AUDIO_HISTOGRAM_SUB_BUCKETS + index % AUDIO_HISTOGRAM_SUB_BUCKETS) << (msb - 3);
+    return low + step / 2;
+}
+
+void audio_latency_reset(audio_latency_t* latency) {
+    for (int s = 0; s < AUDIO_LATENCY_STAGES; ++s) {
+        audio_histogram_t* h = &latency->stages[s];
+        for (int i = 0; i < AUDIO_HISTOGRAM_BUCKETS; ++i) atomic_init(&h->buckets[i], 0);
+        atomic_init(&h->count, 0);
+        atomic_init(&h->sum_ns, 0);
+        atomic_init(&h->max_ns, 0);
+    }
+}
+
+void audio_histogram_record(audio_histogram_t* histogram, uint64_t ns) {
+    atomic_fetch_add_explicit(&histogram->buckets[histogram_bucket(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum_ns, ns, memory_order_relaxed);
+    uint_fast64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    while (ns > max && !atomic_compare_exchange_weak_explicit(&histogram->max_ns, &max, ns, memory_order_relaxed, memory_order_relaxed)) {}
+    //? Count last: a reader that sees it also sees (most of) the bucket it belongs to
+    atomic_fetch_add_explicit(&histogram->count, 1, memory_order_release);
+}
+
+void audio_histogram_summarize(const audio_histogram_t* histogram, audio_latency_summary_t* summary) {
+    audio_histogram_t* h = (audio_histogram_t*)histogram;
+    memset(summary, 0, sizeof(*summary));
+    //* Totals come from the buckets themselves so the percentiles agree with the count even mid-recording
+    uint64_t counts[AUDIO_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+    atomic_load_explicit(&h->count, memory_order_acquire);
+    for (int i = 0; i < AUDIO_HISTOGRAM_BUCKETS; ++i) {
+        counts[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return;
+    summary->count = total;
+    summary->max_ns = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+    summary->mean_ns = atomic_load_explicit(&h->sum_ns, memory_order_relaxed) / total;
+    const uint64_t p50_rank = (total + 1) / 2;
+    const uint64_t p99_rank = total - total / 100;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < AUDIO_HISTOGRAM_BUCKETS; ++i) {
+        if (counts[i] == 0) continue;
+        uint64_t before = seen;
+        seen += counts[i];
+        uint64_t value = histogram_bucket_value(i);
+        if (value > summary->max_ns) value = summary->max_ns;
+        if (before < p50_rank && seen >= p50_rank) summary->p50_ns = value;
+        if (before < p99_rank && seen >= p99_rank) {
+            summary->p99_ns = value;
+            break;
+        }
+    }
+}
+
+const char* audio_latency_stage_name(audio_latency_stage_t stage) {
+    static const char* names[AUDIO_LATENCY_STAGES] = { "mix", "submit", "done" };
+    return ((unsigned)stage < AUDIO_LATENCY_STAGES) ? names[stage] : "unknown";
+}
+
+void audio_latency_print(FILE* out, const char* name, const audio_latency_t* latency) {
+    for (int s = 0; s < AUDIO_LATENCY_STAGES; ++s) {
+        audio_latency_summary_t summary;
+        audio_histogram_summarize(&latency->stages[s], &summary);
+        if (summary.count == 0) continue;
+        fprintf(out, "%s %-6s n=%llu mean=%.3fms p50=%.3fms p99=%.3fms max=%.3fms\n", name, audio_latency_stage_name((audio_latency_stage_t)s),
+            (unsigned long long)summary.count, summary.mean_ns / 1e6, summary.p50_ns / 1e6, summary.p99_ns / 1e6, summary.max_ns / 1e6);
+    }
+}
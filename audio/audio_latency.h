@@ -0,0 +1,91 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+//* Log-linear buckets: 8 per power of two, so any percentile is within 12.5% of the real
+//* value. Values past 2^40 ns (~18 minutes) land in the last bucket, `max_ns` stays exact.
+#define AUDIO_HISTOGRAM_SUB_BUCKETS 8
+#define AUDIO_HISTOGRAM_BUCKETS     320
+
+/**
+ * Lock-free latency histogram. Any thread may record into it or read it at any time;
+ * a read taken while others record is a consistent-enough snapshot, not an atomic one.
+ */
+typedef struct audio_histogram_t {
+    atomic_uint_fast64_t buckets[AUDIO_HISTOGRAM_BUCKETS];
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t sum_ns;
+    atomic_uint_fast64_t max_ns;
+} audio_histogram_t;
+
+/**
+ * Where a triggered sound is on its way to the speaker. Every stage is measured from
+ * the trigger timestamp (mixer_voice_params_t::trigger_ns, play_sound() entry in the player).
+ */
+typedef enum audio_latency_stage_t {
+    AUDIO_LATENCY_MIX,          //? first frame mixed (streams: first decoded frame, not the silence before it)
+    AUDIO_LATENCY_SUBMIT,       //? buffer holding that frame handed to the device (waveOutWrite)
+    AUDIO_LATENCY_DONE,         //? device finished playing that buffer (WOM_DONE): the first frame has been heard
+    AUDIO_LATENCY_STAGES
+} audio_latency_stage_t;
+
+/**
+ * One histogram per stage, usually one per sound. Embed it anywhere and
+ * audio_latency_reset() it before use; it holds no other resources.
+ */
+typedef struct audio_latency_t {
+    audio_histogram_t stages[AUDIO_LATENCY_STAGES];
+} audio_latency_t;
+
+typedef struct audio_latency_summary_t {
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} audio_latency_summary_t;
+
+/**
+ * @brief Clears every stage. Not safe against concurrent recording.
+ */
+void audio_latency_reset(audio_latency_t* latency);
+
+/**
+ * @brief Adds one sample. Lock-free and wait-free apart from the `max` CAS loop.
+ */
+void audio_histogram_record(audio_histogram_t* histogram, uint64_t ns);
+
+/**
+ * @brief Computes count, mean, p50, p99 and max from a histogram.
+ *
+ * Percentiles are the middle of the bucket they fall in (capped at the max seen).
+ */
+void audio_histogram_summarize(const audio_histogram_t* histogram, audio_latency_summary_t* summary);
+
+/**
+ * @returns the stage's name for reports ("mix", "submit", "done").
+ */
+const char* audio_latency_stage_name(audio_latency_stage_t stage);
+
+/**
+ * @brief Prints one line per stage that has samples: `name stage count mean p50 p99 max` in milliseconds.
+ */
+void audio_latency_print(FILE* out, const char* name, const audio_latency_t* latency);
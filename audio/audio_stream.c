@@ -0,0 +1,407 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "audio_stream.h"
+#include "audio_backend.h"
+#include "wav_codec.h"
+#include "log.h"
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+struct audio_stream_t {
+    wav_header_t header;
+    wav_sample_format_t format;
+    uint16_t channels;
+    uint32_t out_rate;
+    size_t frame_bytes;             //? one float frame in the ring
+    //* Source: a file read on demand, or a parsed file in memory
+    bool from_file;
+    wav_stream_t file;
+    const wav_file_t* memory;
+    uint64_t memory_cursor;         //? next frame of `memory`
+    bool adpcm;                     //? `memory` is IMA ADPCM, expanded into `raw` chunk by chunk
+    wav_adpcm_state_t adpcm_state;
+    //* Feeder thread state
+    pthread_t thread;
+    bool started;
+    sem_t wake;                     //? posted by seeks, stop and the reader dropping stale frames; cuts a nap short, posting never blocks
+    //* Looping, changeable while the feeder runs: it picks them up at its next read
+    atomic_bool loop;
+    atomic_uint_fast64_t loop_start;
+    atomic_uint_fast64_t loop_end;      //? exclusive, 0 for the end of the source
+    atomic_bool running;
+    atomic_bool eof;                //? the feeder pushed the last frame
+    bool resample;
+    wav_resampler_t resampler;
+    size_t chunk_frames;            //? frames decoded per source read
+    uint8_t* raw;                   //? file reads (or decoded ADPCM) land here before conversion
+    float* in;                      //? decoded source frames
+    size_t in_pos;
+    size_t in_count;
+    float* out;                     //? resampler output
+    spsc_ring_t ring;
+    //* Seeking: any thread asks, the feeder repositions the source, the audio thread drops what was buffered before
+    atomic_uint_fast64_t seek_request;  //? source frame to jump to, STREAM_NO_SEEK when none
+    atomic_size_t discard_to;           //? ring position where the frames after the last seek start
+    //* Stats, written by the audio thread
+    uint64_t start_ns;
+    atomic_uint_fast64_t frames_read;
+    atomic_uint_fast64_t underruns;
+    atomic_uint_fast64_t first_frame_ns;
+};
+
+#define STREAM_NO_SEEK UINT64_MAX
+
+//=================================================FEEDER==========================================================
+
+static bool stream_rewind(audio_stream_t* stream) {
+    stream->memory_cursor = 0;
+    return !stream->from_file || wav_stream_rewind(&stream->file);
+}
+
+static bool stream_seek_source(audio_stream_t* stream, uint64_t frame) {
+    if (stream->from_file) return wav_stream_seek(&stream->file, frame);
+    stream->memory_cursor = (frame < stream->memory->samples) ? frame : stream->memory->samples;
+    return true;
+}
+
+static uint64_t stream_length(const audio_stream_t* stream) {
+    return stream->from_file ? stream->file.frames_total : stream->memory->samples;
+}
+
+//? Source frame the next fetch starts at
+static uint64_t stream_position(const audio_stream_t* stream) {
+    return stream->from_file ? stream->file.frames_total - stream->file.frames_left : stream->memory_cursor;
+}
+
+//? Decodes the next chunk of the source into `in`, stopping at source frame `end`; returns the frames decoded (0 at the end)
+static size_t stream_fetch(audio_stream_t* stream, uint64_t end) {
+    const uint64_t position = stream_position(stream);
+    const uint64_t left = (end > position) ? end - position : 0;
+    const size_t wanted = (left < stream->chunk_frames) ? (size_t)left : stream->chunk_frames;
+    const uint8_t* src;
+    size_t frames;
+    if (stream->from_file) {
+        frames = wav_stream_read_frames(&stream->file, stream->raw, wanted);
+        src = stream->raw;
+    } else if (stream->adpcm) {
+        frames = wav_adpcm_decode(stream->memory, stream->memory_cursor, wanted, (int16_t*)stream->raw, &stream->adpcm_state);
+        src = stream->raw;
+        stream->memory_cursor += frames;
+    } else {
+        frames = wanted;
+        src = stream->memory->data + (size_t)stream->memory_cursor * stream->header.block_align;
+        stream->memory_cursor += frames;
+    }
+    wav_convert_to_float(stream->in, src, frames * stream->channels, stream->format);
+    return frames;
+}
+
+//? stream_fetch() that wraps to the loop start at the loop end while looping
+static size_t stream_fetch_next(audio_stream_t* stream) {
+    const uint64_t length = stream_length(stream);
+    if (!atomic_load_explicit(&stream->loop, memory_order_relaxed)) return stream_fetch(stream, length);
+    uint64_t loop_start = atomic_load_explicit(&stream->loop_start, memory_order_relaxed);
+    uint64_t loop_end = atomic_load_explicit(&stream->loop_end, memory_order_relaxed);
+    if (loop_end == 0 || loop_end > length) loop_end = length;
+    if (loop_start >= loop_end) loop_start = 0;
+    //* Past the loop end (after a seek) the source plays out before it wraps, like a mixer voice
+    size_t frames = stream_fetch(stream, (stream_position(stream) <= loop_end) ? loop_end : length);
+    if (frames == 0 && stream_seek_source(stream, loop_start)) {
+        //* The resampler keeps its history across the wrap, the loop point stays seamless
+        frames = stream_fetch(stream, loop_end);
+    }
+    return frames;
+}
+
+//? Sleeps up to `nap_ns`, 0 for as long as it takes, or until a seek or stop posts `wake`
+static void stream_nap(audio_stream_t* stream, uint64_t nap_ns) {
+    if (nap_ns == 0) {
+        while (sem_wait(&stream->wake) != 0 && errno == EINTR) {}
+        return;
+    }
+    //? sem_timedwait() only takes a wall clock deadline; a clock step just makes one nap longer or shorter
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    const uint64_t ns = (uint64_t)deadline.tv_nsec + nap_ns;
+    deadline.tv_sec += (time_t)(ns / 1000000000ull);
+    deadline.tv_nsec = (long)(ns % 1000000000ull);
+    while (sem_timedwait(&stream->wake, &deadline) != 0 && errno == EINTR) {}
+}
+
+static void* stream_feeder(void* arg) {
+    audio_stream_t* stream = (audio_stream_t*)arg;
+    //? Wakes up about twice per chunk of output, well inside the ring's worth of slack
+    const uint64_t nap_ns = (uint64_t)stream->chunk_frames * 500000000ull / stream->out_rate;
+    bool draining = false;      //? source exhausted, only the resampler's tail is left
+
+    while (atomic_load_explicit(&stream->running, memory_order_acquire)) {
+        //? Checked before the space test: after a seek the full ring is exactly what gets thrown away
+        uint64_t seek = atomic_exchange_explicit(&stream->seek_request, STREAM_NO_SEEK, memory_order_acquire);
+        if (seek != STREAM_NO_SEEK) {
+            stream_seek_source(stream, seek);
+            //* History from before the jump would smear into the new position
+            if (stream->resample) wav_resampler_reset(&stream->resampler);
+            stream->in_pos = stream->in_count = 0;
+            draining = false;
+            atomic_store_explicit(&stream->eof, false, memory_order_relaxed);
+            atomic_store_explicit(&stream->discard_to, spsc_ring_write_position(&stream->ring), memory_order_release);
+        }
+        size_t space = spsc_ring_writable(&stream->ring) / stream->frame_bytes;
+        if (space < stream->chunk_frames) {
+            stream_nap(stream, nap_ns);
+            continue;
+        }
+        if (draining) {
+            size_t n = stream->resample ? wav_resampler_flush(&stream->resampler, stream->out, stream->chunk_frames) : 0;
+            if (n == 0) {
+                //? Finished: park until a seek brings the stream back or it is stopped
+                atomic_store_explicit(&stream->eof, true, memory_order_release);
+                stream_nap(stream, 0);
+                continue;
+            }
+            spsc_ring_write(&stream->ring, stream->out, n * stream->frame_bytes);
+            continue;
+        }
+        if (stream->in_pos == stream->in_count) {
+            stream->in_pos = 0;
+            stream->in_count = stream_fetch_next(stream);
+            if (stream->in_count == 0) {
+                draining = true;
+                continue;
+            }
+        }
+        const float* in = stream->in + stream->in_pos * stream->channels;
+        size_t avail = stream->in_count - stream->in_pos;
+        if (stream->resample) {
+            size_t used = 0;
+            size_t n = wav_resampler_process(&stream->resampler, in, avail, &used, stream->out, stream->chunk_frames);
+            spsc_ring_write(&stream->ring, stream->out, n * stream->frame_bytes);
+            stream->in_pos += used;
+        } else {
+            size_t n = (avail < space) ? avail : space;
+            spsc_ring_write(&stream->ring, in, n * stream->frame_bytes);
+            stream->in_pos += n;
+        }
+    }
+    return NULL;
+}
+
+//=================================================PUBLIC API==========================================================
+
+static audio_stream_t* stream_create(const wav_header_t* header, uint32_t out_rate, size_t ring_frames) {
+    audio_stream_t* stream = (audio_stream_t*)calloc(1, sizeof(audio_stream_t));
+    if (!stream) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the stream.\n");
+        return NULL;
+    }
+    if (sem_init(&stream->wake, 0, 0) != 0) {
+        Log(LOG_ERROR, "Unable to create the stream's wake-up semaphore.\n");
+        free(stream);
+        return NULL;
+    }
+    //? ADPCM decodes to 16-bit PCM, which is what gets converted to float
+    stream->adpcm = header->encoding == WAV_FORMAT_IMA_ADPCM;
+    if (stream->adpcm) {
+        stream->format = WAV_SAMPLE_S16;
+    } else if (!wav_sample_format_from_header(header, &stream->format)) {
+        Log(LOG_ERROR, "Can't stream format %d with %d bits.\n", header->encoding, header->bits_per_sample);
+        audio_stream_close(stream);
+        return NULL;
+    }
+    if (ring_frames == 0) ring_frames = AUDIO_STREAM_DEFAULT_RING_FRAMES;
+    stream->header = *header;
+    stream->channels = header->num_channels;
+    stream->out_rate = out_rate ? out_rate : header->sample_rate;
+    stream->frame_bytes = stream->channels * sizeof(float);
+    stream->chunk_frames = (ring_frames / 4) ? ring_frames / 4 : 1;
+    atomic_init(&stream->running, false);
+    atomic_init(&stream->loop, false);
+    atomic_init(&stream->loop_start, 0);
+    atomic_init(&stream->loop_end, 0);
+    atomic_init(&stream->eof, false);
+    atomic_init(&stream->frames_read, 0);
+    atomic_init(&stream->underruns, 0);
+    atomic_init(&stream->first_frame_ns, 0);
+    atomic_init(&stream->seek_request, STREAM_NO_SEEK);
+    atomic_init(&stream->discard_to, 0);
+
+    stream->resample = stream->out_rate != header->sample_rate;
+    if (stream->resample && !wav_resampler_init(&stream->resampler, header->sample_rate, stream->out_rate, stream->channels, WAV_RESAMPLE_MEDIUM)) {
+        stream->resample = false;
+        audio_stream_close(stream);
+        return NULL;
+    }
+    stream->in = (float*)malloc(stream->chunk_frames * stream->frame_bytes);
+    stream->out = (float*)malloc(stream->chunk_frames * stream->frame_bytes);
+    if (!stream->in || !stream->out || !spsc_ring_init(&stream->ring, ring_frames * stream->frame_bytes)) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the stream buffers.\n");
+        audio_stream_close(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+audio_stream_t* audio_stream_open_file(const char* path, uint32_t out_rate, size_t ring_frames) {
+    wav_stream_t file;
+    if (!wav_stream_open(path, &file)) return NULL;
+    audio_stream_t* stream = stream_create(&file.header, out_rate, ring_frames);
+    if (!stream) {
+        wav_stream_close(&file);
+        return NULL;
+    }
+    stream->from_file = true;
+    stream->file = file;
+    stream->raw = (uint8_t*)malloc(stream->chunk_frames * file.header.block_align);
+    if (!stream->raw) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the stream buffers.\n");
+        audio_stream_close(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+audio_stream_t* audio_stream_open_memory(const wav_file_t* file, uint32_t out_rate, size_t ring_frames) {
+    if (!file || !file->data) return NULL;
+    if (file->header.encoding == WAV_FORMAT_IMA_ADPCM && file->header.num_channels > WAV_ADPCM_MAX_CHANNELS) {
+        Log(LOG_ERROR, "Can't stream IMA ADPCM with %d channels.\n", file->header.num_channels);
+        return NULL;
+    }
+    audio_stream_t* stream = stream_create(&file->header, out_rate, ring_frames);
+    if (!stream) return NULL;
+    stream->memory = file;
+    if (stream->adpcm) {
+        stream->raw = (uint8_t*)malloc(stream->chunk_frames * stream->channels * sizeof(int16_t));
+        if (!stream->raw) {
+            Log(LOG_ERROR, "Memory allocation failed: unable to allocate the stream buffers.\n");
+            audio_stream_close(stream);
+            return NULL;
+        }
+    }
+    return stream;
+}
+
+bool audio_stream_start(audio_stream_t* stream, bool loop) {
+    return audio_stream_start_at(stream, 0, loop);
+}
+
+bool audio_stream_start_at(audio_stream_t* stream, uint64_t frame, bool loop) {
+    if (!stream || frame == STREAM_NO_SEEK) return false;
+    audio_stream_stop(stream);
+    //? The old feeder is joined, nothing else takes requests now: one left over from the last play is dropped
+    atomic_store(&stream->seek_request, STREAM_NO_SEEK);
+    if (!(frame == 0 ? stream_rewind(stream) : stream_seek_source(stream, frame))) return false;
+    if (stream->resample) wav_resampler_reset(&stream->resampler);
+    stream->in_pos = stream->in_count = 0;
+    atomic_store(&stream->loop, loop);
+    spsc_ring_reset(&stream->ring);
+    atomic_store(&stream->discard_to, 0);
+    atomic_store(&stream->eof, false);
+    atomic_store(&stream->frames_read, 0);
+    atomic_store(&stream->underruns, 0);
+    atomic_store(&stream->first_frame_ns, 0);
+    stream->start_ns = audio_clock_ns();
+    atomic_store(&stream->running, true);
+    if (pthread_create(&stream->thread, NULL, stream_feeder, stream) != 0) {
+        Log(LOG_ERROR, "Unable to start the stream's feeder thread.\n");
+        atomic_store(&stream->running, false);
+        return false;
+    }
+    stream->started = true;
+    return true;
+}
+
+void audio_stream_stop(audio_stream_t* stream) {
+    if (!stream || !stream->started) return;
+    atomic_store_explicit(&stream->running, false, memory_order_release);
+    sem_post(&stream->wake);
+    pthread_join(stream->thread, NULL);
+    stream->started = false;
+}
+
+void audio_stream_close(audio_stream_t* stream) {
+    if (!stream) return;
+    audio_stream_stop(stream);
+    if (stream->from_file) wav_stream_close(&stream->file);
+    if (stream->resample) wav_resampler_free(&stream->resampler);
+    spsc_ring_free(&stream->ring);
+    sem_destroy(&stream->wake);
+    free(stream->raw);
+    free(stream->in);
+    free(stream->out);
+    free(stream);
+}
+
+bool audio_stream_seek(audio_stream_t* stream, uint64_t frame) {
+    if (!stream || frame == STREAM_NO_SEEK) return false;
+    atomic_store_explicit(&stream->seek_request, frame, memory_order_release);
+    sem_post(&stream->wake);
+    return true;
+}
+
+bool audio_stream_set_loop(audio_stream_t* stream, bool loop, uint64_t start, uint64_t end) {
+    if (!stream) return false;
+    atomic_store_explicit(&stream->loop_start, start, memory_order_relaxed);
+    atomic_store_explicit(&stream->loop_end, end, memory_order_relaxed);
+    atomic_store_explicit(&stream->loop, loop, memory_order_relaxed);
+    return true;
+}
+
+size_t audio_stream_read(audio_stream_t* stream, float* out, size_t frames) {
+    //? Frames decoded before the last seek are never played; the room that frees is what the feeder waits for
+    if (spsc_ring_skip_to(&stream->ring, atomic_load_explicit(&stream->discard_to, memory_order_acquire)) > 0) {
+        sem_post(&stream->wake);
+    }
+    size_t got = spsc_ring_read(&stream->ring, out, frames * stream->frame_bytes) / stream->frame_bytes;
+    uint64_t before = atomic_load_explicit(&stream->frames_read, memory_order_relaxed);
+    if (got > 0) {
+        if (before == 0) {
+            atomic_store_explicit(&stream->first_frame_ns, audio_clock_ns() - stream->start_ns, memory_order_relaxed);
+        }
+        atomic_store_explicit(&stream->frames_read, before + got, memory_order_relaxed);
+    }
+    //? Coming up short before the first frame is start-up latency, not an underrun
+    if (got < frames && before + got > 0 && !atomic_load_explicit(&stream->eof, memory_order_acquire)) {
+        atomic_fetch_add_explicit(&stream->underruns, 1, memory_order_relaxed);
+    }
+    return got;
+}
+
+bool audio_stream_finished(const audio_stream_t* stream) {
+    audio_stream_t* s = (audio_stream_t*)stream;
+    return atomic_load_explicit(&s->eof, memory_order_acquire) && spsc_ring_readable(&s->ring) == 0;
+}
+
+uint16_t audio_stream_channels(const audio_stream_t* stream) {
+    return stream->channels;
+}
+
+uint32_t audio_stream_sample_rate(const audio_stream_t* stream) {
+    return stream->out_rate;
+}
+
+const wav_header_t* audio_stream_header(const audio_stream_t* stream) {
+    return &stream->header;
+}
+
+void audio_stream_get_stats(const audio_stream_t* stream, audio_stream_stats_t* stats) {
+    audio_stream_t* s = (audio_stream_t*)stream;
+    stats->frames_read = atomic_load_explicit(&s->frames_read, memory_order_relaxed);
+    stats->underruns = atomic_load_explicit(&s->underruns, memory_order_relaxed);
+    stats->first_frame_ns = atomic_load_explicit(&s->first_frame_ns, memory_order_relaxed);
+}
@@ -0,0 +1,133 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "spsc_ring.h"
+#include "wav_resampler.h"
+
+#define AUDIO_STREAM_DEFAULT_RING_FRAMES 8192   //? ~170 ms at 48 kHz
+
+/**
+ * Counters of one stream, reset by every audio_stream_start().
+ */
+typedef struct audio_stream_stats_t {
+    uint64_t frames_read;       //? frames handed to the audio thread
+    uint64_t underruns;         //? reads that came up short while the feeder was still running
+    uint64_t first_frame_ns;    //? audio_stream_start() to the first frame read, 0 until then
+} audio_stream_stats_t;
+
+/**
+ * A sound played while it is being read.
+ *
+ * A feeder thread pulls frames from disk (or from a parsed file in memory),
+ * converts them to float at the output sample rate and pushes them into a small
+ * lock-free SPSC ring; the audio thread pops them with audio_stream_read(). Only
+ * the ring is resident, so playback starts as soon as the first chunk is decoded
+ * and memory use does not grow with the length of the file.
+ */
+typedef struct audio_stream_t audio_stream_t;
+
+/**
+ * @brief Opens `path` for streaming. Only the header is read here.
+ *
+ * @param out_rate    rate the frames are delivered at, the source is resampled if it differs.
+ * @param ring_frames frames buffered ahead of the audio thread, 0 for AUDIO_STREAM_DEFAULT_RING_FRAMES.
+ * @returns `NULL` (with the reason logged) on failure.
+ */
+audio_stream_t* audio_stream_open_file(const char* path, uint32_t out_rate, size_t ring_frames);
+
+/**
+ * @brief Streams a file that is already parsed. `file` must outlive the stream.
+ *
+ * An IMA ADPCM file stays compressed in memory; the feeder decodes it a chunk at a time.
+ */
+audio_stream_t* audio_stream_open_memory(const wav_file_t* file, uint32_t out_rate, size_t ring_frames);
+
+/**
+ * @brief Rewinds the source and starts the feeder thread.
+ *
+ * Must not be called while the audio thread is reading the stream. With `loop` set
+ * the feeder wraps around at the end of the data, or of the range given to
+ * audio_stream_set_loop(), forever.
+ */
+bool audio_stream_start(audio_stream_t* stream, bool loop);
+
+/**
+ * @brief audio_stream_start() from source frame `frame` instead of the start.
+ *
+ * The source is positioned after the previous feeder is joined, so no seek still
+ * pending from the last play can move it; such a seek is dropped.
+ */
+bool audio_stream_start_at(audio_stream_t* stream, uint64_t frame, bool loop);
+
+/**
+ * @brief Turns looping on or off and sets the range repeated, source frames `start` to `end - 1`.
+ *
+ * Safe from any thread while the stream plays; the feeder applies it at its next
+ * read, so the change is heard after what's already buffered. The loop end is
+ * followed directly by the loop start, with the resampler's history carried over.
+ * Turning `loop` off lets the stream play out to the end of the source.
+ *
+ * @param end 0 for the end of the source; an empty range loops the whole source.
+ */
+bool audio_stream_set_loop(audio_stream_t* stream, bool loop, uint64_t start, uint64_t end);
+
+/**
+ * @brief Moves playback to source frame `frame`, sample-accurately and without stopping anything.
+ *
+ * Safe from any thread while the stream plays: the feeder repositions the source
+ * (one positional read for a file, however long) and the audio thread drops the
+ * frames buffered before the jump, so the new position is heard as soon as the
+ * first chunk from it is decoded. To choose where playback begins use
+ * audio_stream_start_at(). `frame` counts source frames, before any resampling;
+ * seeking past the end finishes the stream.
+ */
+bool audio_stream_seek(audio_stream_t* stream, uint64_t frame);
+
+/**
+ * @brief Stops and joins the feeder thread. Buffered frames stay readable.
+ */
+void audio_stream_stop(audio_stream_t* stream);
+
+/**
+ * @brief Stops the feeder and frees the stream. The audio thread must be done with it.
+ */
+void audio_stream_close(audio_stream_t* stream);
+
+/**
+ * @brief Audio thread side: pops up to `frames` interleaved float frames into `out`.
+ *
+ * Never blocks. A short read means the feeder is behind (an underrun, counted) or
+ * the stream is finished.
+ *
+ * @returns the number of frames written to `out`.
+ */
+size_t audio_stream_read(audio_stream_t* stream, float* out, size_t frames);
+
+/**
+ * @returns `true` once the feeder reached the end of the source and every frame was read.
+ */
+bool audio_stream_finished(const audio_stream_t* stream);
+
+uint16_t audio_stream_channels(const audio_stream_t* stream);
+uint32_t audio_stream_sample_rate(const audio_stream_t* stream);
+
+/**
+ * @returns the source's header.
+ */
+const wav_header_t* audio_stream_header(const audio_stream_t* stream);
+
+void audio_stream_get_stats(const audio_stream_t* stream, audio_stream_stats_t* stats);
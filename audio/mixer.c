@@ -0,0 +1,1167 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "mixer.h"
+#include "wav_isa.h"
+#include "wav_codec.h"
+#include "log.h"
+#include <math.h>
+
+#define MIXER_FREE_END  0xFFFFu     //? end of the free list
+//* Latency marks wait here until the device reports the block they were mixed into as played;
+//* a block with more starts than fit, or one older than the ring, just isn't measured
+#define MIXER_LATENCY_BLOCKS    32
+#define MIXER_LATENCY_MARKS     16
+//* Gain, pan and master changes glide over this long instead of stepping, which would click
+#define MIXER_SMOOTH_MS         5
+#define MIXER_FADE_FLOOR        0.001f  //? -60 dB, where an exponential fade to or from silence starts or snaps
+
+//* Starting a voice doesn't go through the queue (see mixer_push_pending), so a play is never lost to a full queue
+typedef enum mixer_cmd_type_t {
+    MIXER_CMD_STOP,
+    MIXER_CMD_GAIN,
+    MIXER_CMD_MASTER,
+    MIXER_CMD_STOP_ALL,
+    MIXER_CMD_SEEK,
+    MIXER_CMD_FADE,
+    MIXER_CMD_FILTER,
+    MIXER_CMD_LOOP,
+    MIXER_CMD_STOP_COUNTED,
+} mixer_cmd_type_t;
+
+typedef struct mixer_cmd_t {
+    mixer_cmd_type_t type;
+    mixer_voice_t voice;
+    float gain;                     //? target gain, or the cutoff in Hz for MIXER_CMD_FILTER
+    float pan;
+    uint64_t frame;                 //? MIXER_CMD_SEEK target, MIXER_CMD_FADE length, MIXER_CMD_LOOP start
+    mixer_fade_curve_t curve;       //? MIXER_CMD_FADE only
+    bool stop_at_end;               //? MIXER_CMD_FADE only
+    bool loop;                      //? MIXER_CMD_LOOP only
+    uint64_t loop_end;              //? MIXER_CMD_LOOP only
+    const atomic_uint* counter;     //? MIXER_CMD_STOP_COUNTED only
+} mixer_cmd_t;
+
+//? A parameter moving from `from` to `to` over `len` frames; `len` 0 means it sits at `to`
+typedef struct mixer_ramp_t {
+    float from;
+    float to;
+    uint32_t pos;
+    uint32_t len;
+    bool exponential;
+} mixer_ramp_t;
+
+//? One cell of the bounded MPSC queue, `sequence` tells producers and the consumer whose turn it is
+typedef struct mixer_cmd_cell_t {
+    atomic_size_t sequence;
+    mixer_cmd_t cmd;
+} mixer_cmd_cell_t;
+
+typedef struct mixer_voice_slot_t {
+    atomic_uint_fast32_t handle;    //? handle currently owning the slot, MIXER_INVALID_VOICE when free
+    atomic_uint_fast32_t next_free; //? free list link, only meaningful while the slot is free
+    //? Handle of a voice stolen from this slot whose sources the audio thread may still be reading.
+    //? Non-zero also means a steal is in flight: nobody else may steal the slot until it's cleared
+    atomic_uint_fast32_t retiring;
+    atomic_uint_fast32_t live;      //? last handle the audio thread started; only live voices can be stolen
+    uint16_t generation;            //? bumped on every reuse so stale handles don't match
+    //* The voice to start, filled by the thread that claimed the slot before it goes on the pending list
+    uint32_t pending_next;
+    const wav_file_t* pending_sound;
+    audio_stream_t* pending_stream;
+    float pending_gain;
+    float pending_pan;
+    bool pending_loop;
+    uint64_t pending_loop_start;
+    uint64_t pending_loop_end;
+    audio_latency_t* pending_latency;
+    uint64_t pending_trigger_ns;
+    uint64_t pending_start_frame;
+    atomic_uint* pending_counter;
+    //* What stealing looks at; written by the thread that claims the slot, read by everyone
+    atomic_uint_fast64_t start_seq;
+    atomic_uint priority;
+    _Atomic float level;            //? voice gain, the audio thread updates it on mixer_set_gain()
+    //* Everything below is only touched by the audio thread
+    mixer_voice_t playing;          //? handle the audio thread is mixing in this slot
+    audio_stream_t* stream;         //? streaming voice, `data` is unused then
+    const uint8_t* data;
+    uint64_t frames;
+    uint64_t cursor;
+    size_t block_align;
+    wav_sample_format_t format;     //? WAV_SAMPLE_S16 for ADPCM, what it decodes to
+    const wav_file_t* adpcm;        //? IMA ADPCM sound, decoded chunk by chunk as it's mixed; NULL otherwise
+    wav_adpcm_state_t adpcm_state;
+    uint16_t channels;
+    bool loop;
+    uint64_t loop_start;            //? looped range, loop_end exclusive; the whole sound unless set
+    uint64_t loop_end;
+    bool active;
+    uint32_t active_index;          //? position in mixer->active
+    //* The voice's DSP chain, applied to the converted block on its way to the bus: filter, then gain and pan
+    mixer_ramp_t gain;
+    mixer_ramp_t pan;
+    bool stop_after_fade;           //? release the voice once `gain` reaches its target
+    float filter_a;                 //? one-pole lowpass coefficient, 0 when off
+    bool filter_primed;             //? filter_z holds the last output; false starts it from the next input
+    float filter_z[MIXER_MAX_SOURCE_CHANNELS];
+    audio_latency_t* latency;       //? until the first frame is mixed
+    uint64_t trigger_ns;
+    atomic_uint* counter;           //? decremented once the voice's source is let go
+} mixer_voice_slot_t;
+
+typedef struct mixer_latency_mark_t {
+    audio_latency_t* latency;
+    uint64_t trigger_ns;
+} mixer_latency_mark_t;
+
+//? Voices whose first frame went into render call `block`
+typedef struct mixer_latency_block_t {
+    uint64_t block;
+    uint32_t count;
+    mixer_latency_mark_t marks[MIXER_LATENCY_MARKS];
+} mixer_latency_block_t;
+
+struct mixer_t {
+    mixer_config_t config;
+    mixer_voice_slot_t* voices;
+    //? Treiber stack of free slots: low 32 bits are the top slot, high 32 bits a tag against ABA
+    atomic_uint_fast64_t free_head;
+    atomic_uint_fast32_t pending_head;  //? slots waiting to start, the audio thread takes the whole list at once
+    mixer_cmd_cell_t* queue;
+    size_t queue_mask;
+    atomic_size_t queue_tail;       //? producers
+    size_t queue_head;              //? audio thread only
+    uint32_t* active;               //? slots currently mixing, unordered
+    uint32_t active_count;
+    mixer_ramp_t master_gain;
+    uint32_t smooth_frames;         //? MIXER_SMOOTH_MS in frames
+    float* bus;                     //? block_frames * num_channels
+    float* scratch;                 //? one source block converted to float
+    int16_t* decoded;               //? one ADPCM source block expanded to 16-bit, before conversion
+    atomic_uint_fast32_t stat_active;
+    atomic_uint_fast64_t stat_blocks;
+    atomic_uint_fast64_t stat_started;
+    atomic_uint_fast64_t stat_dropped;
+    atomic_uint_fast64_t stat_stolen;
+    atomic_uint_fast64_t next_seq;  //? trigger order, for MIXER_STEAL_OLDEST
+    //* Render thread only
+    uint64_t render_calls;
+    mixer_latency_block_t latency_blocks[MIXER_LATENCY_BLOCKS];
+};
+
+//=================================================MIX KERNELS==========================================================
+//* bus += src * gains, where gains repeats every `channels` samples (gains[k] = gain of channel k % channels)
+
+typedef void (*mix_fn)(float* bus, const float* src, const float* gains, size_t samples);
+typedef void (*upmix_fn)(float* bus, const float* src, float left, float right, size_t frames);
+//* Ramped versions for a block whose gains are moving: sample i gets gains[i & 7] + steps[i & 7] * (i / 8),
+//* and the upmix frame i gets left + dleft * i, right + dright * i
+typedef void (*mix_ramp_fn)(float* bus, const float* src, const float* gains, const float* steps, size_t samples);
+typedef void (*upmix_ramp_fn)(float* bus, const float* src, float left, float right, float dleft, float dright, size_t frames);
+
+static void mix_scalar(float* bus, const float* src, const float* gains, size_t samples) {
+    //? gains holds 8 entries, valid for any channel count that divides 8
+    for (size_t i = 0; i < samples; ++i) {
+        bus[i] += src[i] * gains[i & 7];
+    }
+}
+
+//? Mono source on a stereo bus: every input sample feeds both output channels
+static void upmix_scalar(float* bus, const float* src, float left, float right, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        bus[2 * i]     += src[i] * left;
+        bus[2 * i + 1] += src[i] * right;
+    }
+}
+
+//? The SIMD kernels finish their tail here, from sample (or frame) `from` on
+static void mix_ramp_from(float* bus, const float* src, const float* gains, const float* steps, size_t from, size_t samples) {
+    for (size_t i = from; i < samples; ++i) {
+        bus[i] += src[i] * (gains[i & 7] + steps[i & 7] * (float)(i >> 3));
+    }
+}
+
+static void upmix_ramp_from(float* bus, const float* src, float left, float right, float dleft, float dright, size_t from, size_t frames) {
+    for (size_t i = from; i < frames; ++i) {
+        bus[2 * i]     += src[i] * (left + dleft * (float)i);
+        bus[2 * i + 1] += src[i] * (right + dright * (float)i);
+    }
+}
+
+static void mix_ramp_scalar(float* bus, const float* src, const float* gains, const float* steps, size_t samples) {
+    mix_ramp_from(bus, src, gains, steps, 0, samples);
+}
+
+static void upmix_ramp_scalar(float* bus, const float* src, float left, float right, float dleft, float dright, size_t frames) {
+    upmix_ramp_from(bus, src, left, right, dleft, dright, 0, frames);
+}
+
+#ifdef WAV_ISA_X86
+TARGET_SSE2 static void mix_sse2(float* bus, const float* src, const float* gains, size_t samples) {
+    const __m128 g = _mm_loadu_ps(gains);
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        _mm_storeu_ps(bus + i,     _mm_add_ps(_mm_loadu_ps(bus + i),     _mm_mul_ps(_mm_loadu_ps(src + i),     g)));
+        _mm_storeu_ps(bus + i + 4, _mm_add_ps(_mm_loadu_ps(bus + i + 4), _mm_mul_ps(_mm_loadu_ps(src + i + 4), g)));
+    }
+    mix_scalar(bus + i, src + i, gains, samples - i);
+}
+
+TARGET_SSE2 static void upmix_sse2(float* bus, const float* src, float left, float right, size_t frames) {
+    const __m128 g = _mm_setr_ps(left, right, left, right);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 s = _mm_loadu_ps(src + i);
+        float* b = bus + 2 * i;
+        _mm_storeu_ps(b,     _mm_add_ps(_mm_loadu_ps(b),     _mm_mul_ps(_mm_unpacklo_ps(s, s), g)));
+        _mm_storeu_ps(b + 4, _mm_add_ps(_mm_loadu_ps(b + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), g)));
+    }
+    upmix_scalar(bus + 2 * i, src + i, left, right, frames - i);
+}
+
+TARGET_AVX2 static void mix_avx2(float* bus, const float* src, const float* gains, size_t samples) {
+    const __m256 g = _mm256_loadu_ps(gains);
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        _mm256_storeu_ps(bus + i,     _mm256_add_ps(_mm256_loadu_ps(bus + i),     _mm256_mul_ps(_mm256_loadu_ps(src + i),     g)));
+        _mm256_storeu_ps(bus + i + 8, _mm256_add_ps(_mm256_loadu_ps(bus + i + 8), _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), g)));
+    }
+    //? 16 is a multiple of 8, so the pattern is still lined up for the SSE2 tail
+    _mm256_zeroupper();     //? see wav_convert.c
+    mix_sse2(bus + i, src + i, gains, samples - i);
+}
+
+TARGET_AVX2 static void upmix_avx2(float* bus, const float* src, float left, float right, size_t frames) {
+    const __m256 g = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        //? Lanes are (s0 s1 s4 s5 | s2 s3 s6 s7) after this load, so the per-lane unpacks come out in order
+        __m256 s = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + i)), _mm_loadu_ps(src + i + 4), 1);
+        s = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(s), 0xD8));
+        float* b = bus + 2 * i;
+        _mm256_storeu_ps(b,     _mm256_add_ps(_mm256_loadu_ps(b),     _mm256_mul_ps(_mm256_unpacklo_ps(s, s), g)));
+        _mm256_storeu_ps(b + 8, _mm256_add_ps(_mm256_loadu_ps(b + 8), _mm256_mul_ps(_mm256_unpackhi_ps(s, s), g)));
+    }
+    _mm256_zeroupper();
+    upmix_sse2(bus + 2 * i, src + i, left, right, frames - i);
+}
+
+//? Gains are rebuilt from the group index rather than accumulated, so a long block doesn't drift off its end value
+TARGET_SSE2 static void mix_ramp_sse2(float* bus, const float* src, const float* gains, const float* steps, size_t samples) {
+    const __m128 g0 = _mm_loadu_ps(gains), g1 = _mm_loadu_ps(gains + 4);
+    const __m128 s0 = _mm_loadu_ps(steps), s1 = _mm_loadu_ps(steps + 4);
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m128 t = _mm_set1_ps((float)(i >> 3));
+        _mm_storeu_ps(bus + i,     _mm_add_ps(_mm_loadu_ps(bus + i),     _mm_mul_ps(_mm_loadu_ps(src + i),     _mm_add_ps(g0, _mm_mul_ps(s0, t)))));
+        _mm_storeu_ps(bus + i + 4, _mm_add_ps(_mm_loadu_ps(bus + i + 4), _mm_mul_ps(_mm_loadu_ps(src + i + 4), _mm_add_ps(g1, _mm_mul_ps(s1, t)))));
+    }
+    mix_ramp_from(bus, src, gains, steps, i, samples);
+}
+
+TARGET_SSE2 static void upmix_ramp_sse2(float* bus, const float* src, float left, float right, float dleft, float dright, size_t frames) {
+    const __m128 base = _mm_setr_ps(left, right, left + dleft, right + dright);
+    const __m128 d = _mm_setr_ps(dleft, dright, dleft, dright);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 s = _mm_loadu_ps(src + i);
+        float* b = bus + 2 * i;
+        const __m128 lo = _mm_add_ps(base, _mm_mul_ps(d, _mm_set1_ps((float)i)));
+        const __m128 hi = _mm_add_ps(base, _mm_mul_ps(d, _mm_set1_ps((float)(i + 2))));
+        _mm_storeu_ps(b,     _mm_add_ps(_mm_loadu_ps(b),     _mm_mul_ps(_mm_unpacklo_ps(s, s), lo)));
+        _mm_storeu_ps(b + 4, _mm_add_ps(_mm_loadu_ps(b + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), hi)));
+    }
+    upmix_ramp_from(bus, src, left, right, dleft, dright, i, frames);
+}
+
+TARGET_AVX2 static void mix_ramp_avx2(float* bus, const float* src, const float* gains, const float* steps, size_t samples) {
+    const __m256 g = _mm256_loadu_ps(gains);
+    const __m256 st = _mm256_loadu_ps(steps);
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m256 gain = _mm256_add_ps(g, _mm256_mul_ps(st, _mm256_set1_ps((float)(i >> 3))));
+        _mm256_storeu_ps(bus + i, _mm256_add_ps(_mm256_loadu_ps(bus + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain)));
+    }
+    _mm256_zeroupper();
+    mix_ramp_from(bus, src, gains, steps, i, samples);
+}
+
+TARGET_AVX2 static void upmix_ramp_avx2(float* bus, const float* src, float left, float right, float dleft, float dright, size_t frames) {
+    //? Frames 0-3 of each group of 8 go through the unpacklo half, 4-7 through unpackhi (see upmix_avx2)
+    const __m256 base = _mm256_setr_ps(left, right, left + dleft, right + dright,
+                                       left + 2.0f * dleft, right + 2.0f * dright, left + 3.0f * dleft, right + 3.0f * dright);
+    const __m256 d = _mm256_setr_ps(dleft, dright, dleft, dright, dleft, dright, dleft, dright);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 s = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + i)), _mm_loadu_ps(src + i + 4), 1);
+        s = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(s), 0xD8));
+        float* b = bus + 2 * i;
+        const __m256 lo = _mm256_add_ps(base, _mm256_mul_ps(d, _mm256_set1_ps((float)i)));
+        const __m256 hi = _mm256_add_ps(base, _mm256_mul_ps(d, _mm256_set1_ps((float)(i + 4))));
+        _mm256_storeu_ps(b,     _mm256_add_ps(_mm256_loadu_ps(b),     _mm256_mul_ps(_mm256_unpacklo_ps(s, s), lo)));
+        _mm256_storeu_ps(b + 8, _mm256_add_ps(_mm256_loadu_ps(b + 8), _mm256_mul_ps(_mm256_unpackhi_ps(s, s), hi)));
+    }
+    _mm256_zeroupper();
+    upmix_ramp_from(bus, src, left, right, dleft, dright, i, frames);
+}
+#endif
+
+static const mix_fn mix_kernels[WAV_ISA_COUNT] = {
+    mix_scalar,
+#ifdef WAV_ISA_X86
+    mix_sse2,
+    mix_avx2,
+#endif
+};
+
+static const upmix_fn upmix_kernels[WAV_ISA_COUNT] = {
+    upmix_scalar,
+#ifdef WAV_ISA_X86
+    upmix_sse2,
+    upmix_avx2,
+#endif
+};
+
+static const mix_ramp_fn mix_ramp_kernels[WAV_ISA_COUNT] = {
+    mix_ramp_scalar,
+#ifdef WAV_ISA_X86
+    mix_ramp_sse2,
+    mix_ramp_avx2,
+#endif
+};
+
+static const upmix_ramp_fn upmix_ramp_kernels[WAV_ISA_COUNT] = {
+    upmix_ramp_scalar,
+#ifdef WAV_ISA_X86
+    upmix_ramp_sse2,
+    upmix_ramp_avx2,
+#endif
+};
+
+//=================================================PARAMETER RAMPS==========================================================
+//* Gains only ever change along a ramp, evaluated at the edges of each mixed chunk; the kernels
+//* interpolate linearly in between, so an exponential fade is piecewise linear at block_frames
+
+//? Value `offset` frames after the ramp's current position
+static float ramp_at(const mixer_ramp_t* ramp, size_t offset) {
+    uint64_t pos = (uint64_t)ramp->pos + offset;
+    if (pos >= ramp->len) return ramp->to;
+    float t = (float)pos / (float)ramp->len;
+    if (ramp->exponential) {
+        //? Equal steps in dB; silence is out of reach that way, so it's floored and the end snaps to it
+        float from = fmaxf(ramp->from, MIXER_FADE_FLOOR), to = fmaxf(ramp->to, MIXER_FADE_FLOOR);
+        return from * powf(to / from, t);
+    }
+    return ramp->from + (ramp->to - ramp->from) * t;
+}
+
+//? Heads for `target` from wherever the ramp is now, so retargeting mid-ramp doesn't jump
+static void ramp_start(mixer_ramp_t* ramp, float target, uint32_t frames, bool exponential) {
+    ramp->from = ramp_at(ramp, 0);
+    ramp->to = target;
+    ramp->pos = 0;
+    ramp->len = frames;
+    ramp->exponential = exponential;
+}
+
+static void ramp_set(mixer_ramp_t* ramp, float value) {
+    ramp->from = ramp->to = value;
+    ramp->pos = ramp->len = 0;
+}
+
+//? How many of the `frames` frames from `offset` on are still part of the ramp, all of them if it doesn't end in there
+static size_t ramp_span(const mixer_ramp_t* ramp, size_t offset, size_t frames) {
+    uint64_t pos = (uint64_t)ramp->pos + offset;
+    if (ramp->len == 0 || pos >= ramp->len) return frames;
+    return (ramp->len - pos < frames) ? (size_t)(ramp->len - pos) : frames;
+}
+
+static void ramp_advance(mixer_ramp_t* ramp, size_t frames) {
+    if (ramp->len == 0) return;
+    if ((uint64_t)ramp->pos + frames >= ramp->len) {
+        ramp->pos = ramp->len = 0;
+    } else {
+        ramp->pos += (uint32_t)frames;
+    }
+}
+
+//=================================================COMMAND QUEUE==========================================================
+//* Bounded multi-producer/single-consumer ring (Vyukov): producers claim a cell with one CAS on the
+//* tail, the audio thread is the only consumer so it owns the head outright
+
+static bool mixer_push_cmd(mixer_t* mixer, const mixer_cmd_t* cmd) {
+    size_t pos = atomic_load_explicit(&mixer->queue_tail, memory_order_relaxed);
+    mixer_cmd_cell_t* cell;
+    for (;;) {
+        cell = &mixer->queue[pos & mixer->queue_mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&mixer->queue_tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   //? full, the audio thread is behind
+        } else {
+            pos = atomic_load_explicit(&mixer->queue_tail, memory_order_relaxed);
+        }
+    }
+    cell->cmd = *cmd;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+static bool mixer_pop_cmd(mixer_t* mixer, mixer_cmd_t* cmd) {
+    mixer_cmd_cell_t* cell = &mixer->queue[mixer->queue_head & mixer->queue_mask];
+    size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    if (sequence != mixer->queue_head + 1) return false;
+    *cmd = cell->cmd;
+    atomic_store_explicit(&cell->sequence, mixer->queue_head + mixer->queue_mask + 1, memory_order_release);
+    ++mixer->queue_head;
+    return true;
+}
+
+//=================================================VOICE SLOTS==========================================================
+
+static uint32_t mixer_pop_free(mixer_t* mixer) {
+    uint64_t head = atomic_load_explicit(&mixer->free_head, memory_order_acquire);
+    for (;;) {
+        uint32_t slot = (uint32_t)(head & 0xFFFFFFFFu);
+        if (slot == MIXER_FREE_END) return MIXER_FREE_END;
+        uint32_t next = (uint32_t)atomic_load_explicit(&mixer->voices[slot].next_free, memory_order_relaxed);
+        uint64_t desired = ((head >> 32) + 1) << 32 | next;
+        if (atomic_compare_exchange_weak_explicit(&mixer->free_head, &head, desired, memory_order_acq_rel, memory_order_acquire)) {
+            return slot;
+        }
+    }
+}
+
+static void mixer_push_free(mixer_t* mixer, uint32_t slot) {
+    uint64_t head = atomic_load_explicit(&mixer->free_head, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&mixer->voices[slot].next_free, (uint32_t)(head & 0xFFFFFFFFu), memory_order_relaxed);
+        uint64_t desired = ((head >> 32) + 1) << 32 | slot;
+        if (atomic_compare_exchange_weak_explicit(&mixer->free_head, &head, desired, memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+static uint32_t voice_slot(mixer_voice_t voice) {
+    return voice & 0xFFFFu;
+}
+
+static void mixer_deactivate(mixer_t* mixer, mixer_voice_slot_t* voice) {
+    if (!voice->active) return;
+    uint32_t last = mixer->active[--mixer->active_count];
+    mixer->active[voice->active_index] = last;
+    mixer->voices[last].active_index = voice->active_index;
+    voice->active = false;
+    voice->data = NULL;
+    voice->stream = NULL;
+    if (voice->counter) atomic_fetch_sub_explicit(voice->counter, 1, memory_order_release);
+    voice->counter = NULL;
+}
+
+//? Audio thread: takes a finished or stopped voice out of the mix and hands its slot back
+static void mixer_release_voice(mixer_t* mixer, mixer_voice_slot_t* voice) {
+    uint32_t slot = (uint32_t)(voice - mixer->voices);
+    mixer_voice_t playing = voice->playing;
+    mixer_deactivate(mixer, voice);
+    uint_fast32_t expected = playing;
+    if (atomic_compare_exchange_strong(&voice->handle, &expected, MIXER_INVALID_VOICE)) {
+        mixer_push_free(mixer, slot);
+    } else {
+        //* Stolen meanwhile: the slot already belongs to the pending PLAY, only the old sources are let go
+        expected = playing;
+        atomic_compare_exchange_strong(&voice->retiring, &expected, MIXER_INVALID_VOICE);
+    }
+}
+
+//=================================================PUBLIC API==========================================================
+
+mixer_t* mixer_init(const mixer_config_t* config) {
+    if (!config || config->sample_rate == 0 || config->num_channels == 0 || config->block_frames == 0 ||
+        config->max_voices == 0 || config->max_voices >= MIXER_FREE_END) {
+        Log(LOG_ERROR, "Invalid mixer configuration.\n");
+        return NULL;
+    }
+    mixer_t* mixer = (mixer_t*)calloc(1, sizeof(mixer_t));
+    if (!mixer) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the mixer.\n");
+        return NULL;
+    }
+    mixer->config = *config;
+    size_t capacity = 16;
+    while (capacity < config->queue_capacity) capacity <<= 1;
+    mixer->queue_mask = capacity - 1;
+    mixer->voices = (mixer_voice_slot_t*)calloc(config->max_voices, sizeof(mixer_voice_slot_t));
+    mixer->queue = (mixer_cmd_cell_t*)calloc(capacity, sizeof(mixer_cmd_cell_t));
+    mixer->active = (uint32_t*)calloc(config->max_voices, sizeof(uint32_t));
+    mixer->bus = (float*)malloc(config->block_frames * config->num_channels * sizeof(float));
+    mixer->scratch = (float*)malloc(config->block_frames * MIXER_MAX_SOURCE_CHANNELS * sizeof(float));
+    mixer->decoded = (int16_t*)malloc(config->block_frames * MIXER_MAX_SOURCE_CHANNELS * sizeof(int16_t));
+    if (!mixer->voices || !mixer->queue || !mixer->active || !mixer->bus || !mixer->scratch || !mixer->decoded) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the mixer's voices and buffers.\n");
+        mixer_free(mixer);
+        return NULL;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        atomic_init(&mixer->queue[i].sequence, i);
+    }
+    atomic_init(&mixer->queue_tail, 0);
+    //* Chain every slot into the free list, slot 0 on top
+    for (uint32_t i = 0; i < config->max_voices; ++i) {
+        atomic_init(&mixer->voices[i].handle, MIXER_INVALID_VOICE);
+        atomic_init(&mixer->voices[i].retiring, MIXER_INVALID_VOICE);
+        atomic_init(&mixer->voices[i].live, MIXER_INVALID_VOICE);
+        atomic_init(&mixer->voices[i].start_seq, 0);
+        atomic_init(&mixer->voices[i].priority, 0);
+        atomic_init(&mixer->voices[i].level, 0.0f);
+        atomic_init(&mixer->voices[i].next_free, (i + 1 < config->max_voices) ? i + 1 : MIXER_FREE_END);
+    }
+    atomic_init(&mixer->free_head, 0);
+    atomic_init(&mixer->pending_head, MIXER_FREE_END);
+    mixer->master_gain.to = 1.0f;
+    mixer->smooth_frames = (uint32_t)((uint64_t)config->sample_rate * MIXER_SMOOTH_MS / 1000);
+    atomic_init(&mixer->stat_active, 0);
+    atomic_init(&mixer->stat_blocks, 0);
+    atomic_init(&mixer->stat_started, 0);
+    atomic_init(&mixer->stat_dropped, 0);
+    atomic_init(&mixer->stat_stolen, 0);
+    atomic_init(&mixer->next_seq, 0);
+    return mixer;
+}
+
+void mixer_free(mixer_t* mixer) {
+    if (!mixer) return;
+    free(mixer->voices);
+    free(mixer->queue);
+    free(mixer->active);
+    free(mixer->bus);
+    free(mixer->scratch);
+    free(mixer->decoded);
+    free(mixer);
+}
+
+static mixer_voice_t make_handle(uint16_t* generation, uint32_t slot) {
+    if (++*generation == 0) *generation = 1;
+    return ((mixer_voice_t)*generation << 16) | slot;
+}
+
+//? True when `candidate` (priority, key) is a better victim than the best so far
+static bool steal_better(mixer_steal_policy_t policy, unsigned priority, double key, unsigned best_priority, double best_key) {
+    if (policy == MIXER_STEAL_LOWEST_PRIORITY && priority != best_priority) return priority < best_priority;
+    return key < best_key;
+}
+
+/**
+ * Claims the slot of a playing voice for a new one, per the mixer's steal policy.
+ * Only voices of `priority` or lower are considered. The slot's handle is switched
+ * with a CAS, so the audio thread releasing it at the same moment or another
+ * trigger stealing it can't both win; `retiring` keeps the old handle reported
+ * as playing until the audio thread has dropped its sources.
+ */
+static uint32_t mixer_steal(mixer_t* mixer, unsigned priority, mixer_voice_t* handle_out) {
+    const mixer_steal_policy_t policy = mixer->config.steal_policy;
+    if (policy == MIXER_STEAL_NONE) return MIXER_FREE_END;
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint32_t best = MIXER_FREE_END;
+        mixer_voice_t best_handle = MIXER_INVALID_VOICE;
+        unsigned best_priority = 0;
+        double best_key = 0.0;
+        for (uint32_t i = 0; i < mixer->config.max_voices; ++i) {
+            mixer_voice_slot_t* voice = &mixer->voices[i];
+            mixer_voice_t handle = (mixer_voice_t)atomic_load_explicit(&voice->handle, memory_order_acquire);
+            unsigned p = atomic_load_explicit(&voice->priority, memory_order_relaxed);
+            //? A voice whose start is still pending can't be stolen: each slot holds at most one pending start
+            if (handle == MIXER_INVALID_VOICE || p > priority ||
+                atomic_load_explicit(&voice->live, memory_order_acquire) != handle ||
+                atomic_load_explicit(&voice->retiring, memory_order_relaxed) != MIXER_INVALID_VOICE) {
+                continue;
+            }
+            double key = (policy == MIXER_STEAL_QUIETEST)
+                ? (double)atomic_load_explicit(&voice->level, memory_order_relaxed)
+                : (double)atomic_load_explicit(&voice->start_seq, memory_order_relaxed);
+            if (best == MIXER_FREE_END || steal_better(policy, p, key, best_priority, best_key)) {
+                best = i;
+                best_handle = handle;
+                best_priority = p;
+                best_key = key;
+            }
+        }
+        if (best == MIXER_FREE_END) return MIXER_FREE_END;
+
+        mixer_voice_slot_t* voice = &mixer->voices[best];
+        uint_fast32_t expected = MIXER_INVALID_VOICE;
+        if (!atomic_compare_exchange_strong(&voice->retiring, &expected, best_handle)) continue;
+        uint16_t generation = (uint16_t)(best_handle >> 16);
+        mixer_voice_t handle = make_handle(&generation, best);
+        expected = best_handle;
+        if (atomic_compare_exchange_strong(&voice->handle, &expected, handle)) {
+            voice->generation = generation;
+            atomic_fetch_add_explicit(&mixer->stat_stolen, 1, memory_order_relaxed);
+            *handle_out = handle;
+            return best;
+        }
+        //? Lost the race (the voice ended or was stopped), look again
+        expected = best_handle;
+        atomic_compare_exchange_strong(&voice->retiring, &expected, MIXER_INVALID_VOICE);
+    }
+    return MIXER_FREE_END;
+}
+
+//? Lock-free push onto the pending list; the audio thread only ever takes the whole list, so there's no ABA
+static void mixer_push_pending(mixer_t* mixer, uint32_t slot) {
+    uint_fast32_t head = atomic_load_explicit(&mixer->pending_head, memory_order_relaxed);
+    do {
+        mixer->voices[slot].pending_next = (uint32_t)head;
+    } while (!atomic_compare_exchange_weak_explicit(&mixer->pending_head, &head, slot, memory_order_release, memory_order_relaxed));
+}
+
+//? Claims a free (or stolen) slot, gives it a fresh handle and hands the voice to the audio thread
+static mixer_voice_t mixer_start_voice(mixer_t* mixer, const wav_file_t* sound, audio_stream_t* stream, const mixer_voice_params_t* params) {
+    mixer_voice_t handle = MIXER_INVALID_VOICE;
+    uint32_t slot = mixer_pop_free(mixer);
+    if (slot != MIXER_FREE_END) {
+        //? The slot is ours until the audio thread releases it, nobody else touches the generation
+        handle = make_handle(&mixer->voices[slot].generation, slot);
+    } else {
+        slot = mixer_steal(mixer, params->priority, &handle);
+        if (slot == MIXER_FREE_END) {
+            atomic_fetch_add_explicit(&mixer->stat_dropped, 1, memory_order_relaxed);
+            return MIXER_INVALID_VOICE;
+        }
+    }
+    mixer_voice_slot_t* voice = &mixer->voices[slot];
+    voice->pending_sound = sound;
+    voice->pending_stream = stream;
+    voice->pending_gain = params->gain;
+    voice->pending_pan = params->pan;
+    voice->pending_loop = params->loop;
+    voice->pending_loop_start = params->loop_start;
+    voice->pending_loop_end = params->loop_end;
+    voice->pending_latency = params->latency;
+    voice->pending_trigger_ns = (params->latency && params->trigger_ns == 0) ? audio_clock_ns() : params->trigger_ns;
+    voice->pending_start_frame = params->start_frame;
+    voice->pending_counter = params->counter;
+    //? Counted before the audio thread can see the voice, so the count never dips below the voices in flight
+    if (params->counter) atomic_fetch_add_explicit(params->counter, 1, memory_order_relaxed);
+    atomic_store_explicit(&voice->start_seq, atomic_fetch_add_explicit(&mixer->next_seq, 1, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&voice->priority, params->priority, memory_order_relaxed);
+    atomic_store_explicit(&voice->level, params->gain, memory_order_relaxed);
+    atomic_store_explicit(&voice->handle, handle, memory_order_release);
+    mixer_push_pending(mixer, slot);
+    return handle;
+}
+
+mixer_voice_t mixer_play_ex(mixer_t* mixer, const wav_file_t* sound, const mixer_voice_params_t* params) {
+    if (!mixer || !sound || !params || !sound->data || sound->samples == 0) return MIXER_INVALID_VOICE;
+    wav_sample_format_t format;
+    const bool adpcm = sound->header.encoding == WAV_FORMAT_IMA_ADPCM;
+    if ((!adpcm && !wav_sample_format_from_header(&sound->header, &format)) || sound->header.num_channels > MIXER_MAX_SOURCE_CHANNELS) {
+        Log(LOG_ERROR, "The mixer can't play format %d with %d bits and %d channels.\n", sound->header.encoding, sound->header.bits_per_sample, sound->header.num_channels);
+        return MIXER_INVALID_VOICE;
+    }
+    if (sound->header.sample_rate != mixer->config.sample_rate) {
+        Log(LOG_ERROR, "The sound is %u Hz but the mixer runs at %u Hz, resample it first.\n", sound->header.sample_rate, mixer->config.sample_rate);
+        return MIXER_INVALID_VOICE;
+    }
+    return mixer_start_voice(mixer, sound, NULL, params);
+}
+
+mixer_voice_t mixer_play(mixer_t* mixer, const wav_file_t* sound, float gain, float pan, bool loop) {
+    mixer_voice_params_t params = { gain, pan, loop, MIXER_PRIORITY_NORMAL, NULL, 0, 0, 0, 0, NULL };
+    return mixer_play_ex(mixer, sound, &params);
+}
+
+mixer_voice_t mixer_play_stream_ex(mixer_t* mixer, audio_stream_t* stream, const mixer_voice_params_t* params) {
+    if (!mixer || !stream || !params) return MIXER_INVALID_VOICE;
+    if (audio_stream_channels(stream) > MIXER_MAX_SOURCE_CHANNELS || audio_stream_sample_rate(stream) != mixer->config.sample_rate) {
+        Log(LOG_ERROR, "The mixer can't play a %d channel stream at %u Hz.\n", audio_stream_channels(stream), audio_stream_sample_rate(stream));
+        return MIXER_INVALID_VOICE;
+    }
+    return mixer_start_voice(mixer, NULL, stream, params);
+}
+
+mixer_voice_t mixer_play_stream(mixer_t* mixer, audio_stream_t* stream, float gain, float pan) {
+    mixer_voice_params_t params = { gain, pan, false, MIXER_PRIORITY_NORMAL, NULL, 0, 0, 0, 0, NULL };
+    return mixer_play_stream_ex(mixer, stream, &params);
+}
+
+bool mixer_stop(mixer_t* mixer, mixer_voice_t voice) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_STOP, voice, 0.0f, 0.0f, 0, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_stop_counted(mixer_t* mixer, const atomic_uint* counter) {
+    if (!mixer || !counter) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_STOP_COUNTED, MIXER_INVALID_VOICE, 0.0f, 0.0f, 0, MIXER_FADE_LINEAR, false, false, 0, counter };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_set_gain(mixer_t* mixer, mixer_voice_t voice, float gain, float pan) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_GAIN, voice, gain, pan, 0, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_fade(mixer_t* mixer, mixer_voice_t voice, float gain, uint32_t frames, mixer_fade_curve_t curve, bool stop_at_end) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_FADE, voice, gain, 0.0f, frames, curve, stop_at_end, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_set_filter(mixer_t* mixer, mixer_voice_t voice, float cutoff_hz) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_FILTER, voice, cutoff_hz, 0.0f, 0, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_seek(mixer_t* mixer, mixer_voice_t voice, uint64_t frame) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_SEEK, voice, 0.0f, 0.0f, frame, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_set_loop(mixer_t* mixer, mixer_voice_t voice, bool loop, uint64_t start, uint64_t end) {
+    if (!mixer || voice == MIXER_INVALID_VOICE) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_LOOP, voice, 0.0f, 0.0f, start, MIXER_FADE_LINEAR, false, loop, end, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_set_master_gain(mixer_t* mixer, float gain) {
+    if (!mixer) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_MASTER, MIXER_INVALID_VOICE, gain, 0.0f, 0, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_stop_all(mixer_t* mixer) {
+    if (!mixer) return false;
+    mixer_cmd_t cmd = { MIXER_CMD_STOP_ALL, MIXER_INVALID_VOICE, 0.0f, 0.0f, 0, MIXER_FADE_LINEAR, false, false, 0, NULL };
+    return mixer_push_cmd(mixer, &cmd);
+}
+
+bool mixer_voice_playing(const mixer_t* mixer, mixer_voice_t voice) {
+    if (!mixer || voice == MIXER_INVALID_VOICE || voice_slot(voice) >= mixer->config.max_voices) return false;
+    mixer_voice_slot_t* slot = &((mixer_t*)mixer)->voices[voice_slot(voice)];
+    //? Handle first: a steal sets `retiring` before it switches the handle
+    return atomic_load(&slot->handle) == voice || atomic_load(&slot->retiring) == voice;
+}
+
+void mixer_get_stats(const mixer_t* mixer, mixer_stats_t* stats) {
+    mixer_t* m = (mixer_t*)mixer;
+    stats->active_voices = (uint32_t)atomic_load_explicit(&m->stat_active, memory_order_relaxed);
+    stats->blocks_mixed = atomic_load_explicit(&m->stat_blocks, memory_order_relaxed);
+    stats->voices_started = atomic_load_explicit(&m->stat_started, memory_order_relaxed);
+    stats->plays_dropped = atomic_load_explicit(&m->stat_dropped, memory_order_relaxed);
+    stats->voices_stolen = atomic_load_explicit(&m->stat_stolen, memory_order_relaxed);
+}
+
+//=================================================AUDIO THREAD==========================================================
+
+//? An end of 0 or past the sound means the sound's end; a range that's empty after that loops the whole sound
+static void mixer_set_voice_loop(mixer_voice_slot_t* voice, uint64_t start, uint64_t end) {
+    if (end == 0 || end > voice->frames) end = voice->frames;
+    if (start >= end) start = 0;
+    voice->loop_start = start;
+    voice->loop_end = end;
+}
+
+//? Starts one pending voice, replacing the sources of the voice it was stolen from if any
+static void mixer_start_pending(mixer_t* mixer, uint32_t slot) {
+    mixer_voice_slot_t* voice = &mixer->voices[slot];
+    mixer_voice_t handle = (mixer_voice_t)atomic_load_explicit(&voice->handle, memory_order_acquire);
+    //? Still active means the voice was stolen: its source is dropped here rather than in mixer_deactivate()
+    atomic_uint* released = voice->active ? voice->counter : NULL;
+    voice->counter = voice->pending_counter;
+    voice->stream = voice->pending_stream;
+    if (voice->stream) {
+        voice->data = NULL;
+        voice->channels = audio_stream_channels(voice->stream);
+    } else {
+        const wav_file_t* sound = voice->pending_sound;
+        voice->adpcm = (sound->header.encoding == WAV_FORMAT_IMA_ADPCM) ? sound : NULL;
+        if (voice->adpcm) {
+            //? Nothing carries over from the slot's last ADPCM voice, the first chunk decodes from its block header
+            voice->format = WAV_SAMPLE_S16;
+            memset(&voice->adpcm_state, 0, sizeof(voice->adpcm_state));
+        } else {
+            wav_sample_format_from_header(&sound->header, &voice->format);
+        }
+        voice->data = sound->data;
+        voice->frames = sound->samples;
+        voice->cursor = (voice->pending_start_frame < sound->samples) ? voice->pending_start_frame : sound->samples;
+        voice->block_align = sound->header.block_align;
+        voice->channels = sound->header.num_channels;
+        mixer_set_voice_loop(voice, voice->pending_loop_start, voice->pending_loop_end);
+    }
+    voice->loop = voice->pending_loop;
+    voice->latency = voice->pending_latency;
+    voice->trigger_ns = voice->pending_trigger_ns;
+    //* A new voice starts at its own gain and pan, nothing carries over from the slot's last voice
+    ramp_set(&voice->gain, voice->pending_gain);
+    ramp_set(&voice->pan, voice->pending_pan);
+    voice->stop_after_fade = false;
+    voice->filter_a = 0.0f;
+    if (!voice->active) {
+        voice->active = true;
+        voice->active_index = mixer->active_count;
+        mixer->active[mixer->active_count++] = slot;
+    }
+    voice->playing = handle;
+    //* The stolen voice's sources are no longer referenced: its owner may free them now
+    if (released) atomic_fetch_sub_explicit(released, 1, memory_order_release);
+    atomic_store(&voice->retiring, MIXER_INVALID_VOICE);
+    atomic_store_explicit(&voice->live, handle, memory_order_release);
+    atomic_fetch_add_explicit(&mixer->stat_started, 1, memory_order_relaxed);
+}
+
+static void mixer_drain_pending(mixer_t* mixer) {
+    uint32_t slot = (uint32_t)atomic_exchange_explicit(&mixer->pending_head, MIXER_FREE_END, memory_order_acquire);
+    //? The list comes newest first; reverse it so voices start in trigger order
+    uint32_t ordered = MIXER_FREE_END;
+    while (slot != MIXER_FREE_END) {
+        uint32_t next = mixer->voices[slot].pending_next;
+        mixer->voices[slot].pending_next = ordered;
+        ordered = slot;
+        slot = next;
+    }
+    while (ordered != MIXER_FREE_END) {
+        uint32_t next = mixer->voices[ordered].pending_next;
+        mixer_start_pending(mixer, ordered);
+        ordered = next;
+    }
+}
+
+//? One-pole lowpass, y += a * (x - y) with a = 1 - e^(-2 pi fc / fs); off at 0 Hz or from Nyquist up
+static void mixer_set_voice_filter(mixer_t* mixer, mixer_voice_slot_t* voice, float cutoff_hz) {
+    const float nyquist = 0.5f * (float)mixer->config.sample_rate;
+    if (!(cutoff_hz > 0.0f) || cutoff_hz >= nyquist) {
+        voice->filter_a = 0.0f;
+        return;
+    }
+    //? Switching it on starts from the signal, not from 0, or the first few ms would dip
+    if (voice->filter_a == 0.0f) voice->filter_primed = false;
+    voice->filter_a = 1.0f - expf(-6.28318531f * cutoff_hz / (float)mixer->config.sample_rate);
+}
+
+static void mixer_apply_cmd(mixer_t* mixer, const mixer_cmd_t* cmd) {
+    switch (cmd->type) {
+        case MIXER_CMD_STOP:
+        case MIXER_CMD_GAIN:
+        case MIXER_CMD_SEEK:
+        case MIXER_CMD_FADE:
+        case MIXER_CMD_FILTER:
+        case MIXER_CMD_LOOP: {
+            if (voice_slot(cmd->voice) >= mixer->config.max_voices) break;
+            mixer_voice_slot_t* voice = &mixer->voices[voice_slot(cmd->voice)];
+            //? A voice that already ended may have been handed out again: only act on an exact match
+            if (!voice->active || voice->playing != cmd->voice) break;
+            if (cmd->type == MIXER_CMD_STOP) {
+                mixer_release_voice(mixer, voice);
+            } else if (cmd->type == MIXER_CMD_SEEK) {
+                //? Past the end the block loop wraps a looping voice and ends the others
+                if (voice->stream) {
+                    audio_stream_seek(voice->stream, cmd->frame);
+                } else {
+                    voice->cursor = (cmd->frame < voice->frames) ? cmd->frame : voice->frames;
+                }
+            } else if (cmd->type == MIXER_CMD_LOOP) {
+                //? Streams loop on their own (see audio_stream_set_loop())
+                if (voice->stream) break;
+                voice->loop = cmd->loop;
+                mixer_set_voice_loop(voice, cmd->frame, cmd->loop_end);
+            } else if (cmd->type == MIXER_CMD_FILTER) {
+                mixer_set_voice_filter(mixer, voice, cmd->gain);
+            } else {
+                //? A plain gain change is a short linear fade too, and cancels any fade in progress
+                const bool fade = cmd->type == MIXER_CMD_FADE;
+                const uint32_t frames = fade ? (uint32_t)cmd->frame : mixer->smooth_frames;
+                ramp_start(&voice->gain, cmd->gain, frames, fade && cmd->curve == MIXER_FADE_EXPONENTIAL);
+                if (!fade) ramp_start(&voice->pan, cmd->pan, mixer->smooth_frames, false);
+                voice->stop_after_fade = fade && cmd->stop_at_end;
+                atomic_store_explicit(&voice->level, cmd->gain, memory_order_relaxed);
+            }
+            break;
+        }
+        case MIXER_CMD_MASTER:
+            ramp_start(&mixer->master_gain, cmd->gain, mixer->smooth_frames, false);
+            break;
+        case MIXER_CMD_STOP_ALL:
+            while (mixer->active_count > 0) {
+                mixer_release_voice(mixer, &mixer->voices[mixer->active[0]]);
+            }
+            break;
+        case MIXER_CMD_STOP_COUNTED:
+            //? Releasing swaps the last active voice into slot i, so walk down
+            for (uint32_t i = mixer->active_count; i-- > 0; ) {
+                mixer_voice_slot_t* voice = &mixer->voices[mixer->active[i]];
+                if (voice->counter == cmd->counter) mixer_release_voice(mixer, voice);
+            }
+            break;
+    }
+}
+
+//! Recursive, so it runs per channel in order; it filters the converted copy in place, never the sound
+static void mixer_filter_voice(mixer_voice_slot_t* voice, float* src, size_t frames) {
+    const uint16_t channels = voice->channels;
+    const float a = voice->filter_a, b = 1.0f - a;
+    if (!voice->filter_primed && frames > 0) {
+        for (uint16_t c = 0; c < channels; ++c) voice->filter_z[c] = src[c];
+        voice->filter_primed = true;
+    }
+    if (channels == 2) {
+        //? Written so only one multiply-add waits on the previous output; the two channels run side by side
+        float zl = voice->filter_z[0], zr = voice->filter_z[1];
+        for (size_t i = 0; i < frames; ++i) {
+            zl = a * src[2 * i] + b * zl;
+            zr = a * src[2 * i + 1] + b * zr;
+            src[2 * i] = zl;
+            src[2 * i + 1] = zr;
+        }
+        voice->filter_z[0] = zl;
+        voice->filter_z[1] = zr;
+        return;
+    }
+    for (uint16_t c = 0; c < channels; ++c) {
+        float z = voice->filter_z[c];
+        for (size_t i = 0; i < frames; ++i) {
+            z = a * src[i * channels + c] + b * z;
+            src[i * channels + c] = z;
+        }
+        voice->filter_z[c] = z;
+    }
+}
+
+//? Constant power: pan -1..1 maps to 0..pi/2, with both sides at unity in the centre
+static void mixer_pan_gains(float gain, float pan, float* left, float* right) {
+    float p = pan < -1.0f ? -1.0f : (pan > 1.0f ? 1.0f : pan);
+    float angle = (p + 1.0f) * 0.78539816f;
+    *left = gain * cosf(angle) * 1.41421356f;
+    *right = gain * sinf(angle) * 1.41421356f;
+}
+
+//* Adds a span of the voice to the bus, with gains taken `at` frames into the chunk and `offset` into the block
+static void mixer_mix_span(mixer_t* mixer, const mixer_voice_slot_t* voice, float* bus, const float* src, size_t frames, size_t at, size_t offset) {
+    const wav_isa_t isa = wav_convert_get_isa();
+    const uint16_t out_channels = mixer->config.num_channels;
+    const float gain = ramp_at(&voice->gain, at) * ramp_at(&mixer->master_gain, offset);
+    const float gain_end = ramp_at(&voice->gain, at + frames) * ramp_at(&mixer->master_gain, offset + frames);
+    float left = gain, right = gain, left_end = gain_end, right_end = gain_end;
+    if (out_channels == 2) {
+        mixer_pan_gains(gain, ramp_at(&voice->pan, at), &left, &right);
+        mixer_pan_gains(gain_end, ramp_at(&voice->pan, at + frames), &left_end, &right_end);
+    }
+
+    if (left != left_end || right != right_end) {
+        //* Moving: per frame steps that land exactly on the end gains, which the next chunk starts from
+        const float dleft = (left_end - left) / (float)frames, dright = (right_end - right) / (float)frames;
+        const float dgain = (gain_end - gain) / (float)frames;
+        if (voice->channels == out_channels && 8 % out_channels == 0) {
+            const size_t per_group = 8 / out_channels;      //? frames in each run of 8 samples
+            float gains[8], steps[8];
+            for (int k = 0; k < 8; ++k) {
+                float start = (out_channels == 2) ? ((k & 1) ? right : left) : gain;
+                float step = (out_channels == 2) ? ((k & 1) ? dright : dleft) : dgain;
+                gains[k] = start + step * (float)(k / out_channels);
+                steps[k] = step * (float)per_group;
+            }
+            mix_ramp_kernels[isa](bus, src, gains, steps, frames * out_channels);
+        } else if (voice->channels == 1 && out_channels == 2) {
+            upmix_ramp_kernels[isa](bus, src, left, right, dleft, dright, frames);
+        } else {
+            for (size_t i = 0; i < frames; ++i) {
+                for (uint16_t c = 0; c < out_channels; ++c) {
+                    uint16_t from = (voice->channels == 1) ? 0 : c;
+                    if (from >= voice->channels) continue;
+                    float g = (out_channels == 2) ? (c ? right + dright * (float)i : left + dleft * (float)i) : gain + dgain * (float)i;
+                    bus[i * out_channels + c] += src[i * voice->channels + from] * g;
+                }
+            }
+        }
+        return;
+    }
+
+    if (voice->channels == out_channels && 8 % out_channels == 0) {
+        float gains[8];
+        for (int k = 0; k < 8; ++k) {
+            gains[k] = (out_channels == 2) ? ((k & 1) ? right : left) : gain;
+        }
+        mix_kernels[isa](bus, src, gains, frames * out_channels);
+    } else if (voice->channels == 1 && out_channels == 2) {
+        upmix_kernels[isa](bus, src, left, right, frames);
+    } else {
+        //* Odd layouts: mono goes everywhere, otherwise channels map one to one and extras are dropped
+        for (size_t i = 0; i < frames; ++i) {
+            for (uint16_t c = 0; c < out_channels; ++c) {
+                uint16_t from = (voice->channels == 1) ? 0 : c;
+                if (from >= voice->channels) continue;
+                float g = (out_channels == 2) ? (c ? right : left) : gain;
+                bus[i * out_channels + c] += src[i * voice->channels + from] * g;
+            }
+        }
+    }
+}
+
+/**
+ * Runs the voice's DSP chain on `frames` frames of its source (already converted into
+ * `src`) and adds the result to the bus. `offset` is where the chunk starts in the
+ * current block, for the master gain's ramp. The voice's own ramps are advanced by
+ * the caller.
+ */
+static void mixer_mix_voice(mixer_t* mixer, mixer_voice_slot_t* voice, float* bus, float* src, size_t frames, size_t offset) {
+    if (voice->filter_a != 0.0f) mixer_filter_voice(voice, src, frames);
+    //* A ramp ending inside the chunk splits it there, or the kernels would stretch its end over the whole chunk
+    for (size_t at = 0; at < frames; ) {
+        size_t n = ramp_span(&voice->gain, at, frames - at);
+        n = ramp_span(&voice->pan, at, n);
+        n = ramp_span(&mixer->master_gain, offset + at, n);
+        mixer_mix_span(mixer, voice, bus + at * mixer->config.num_channels, src + at * voice->channels, n, at, offset + at);
+        at += n;
+    }
+}
+
+//? The voice's first frame is in this render call: time the mix now, submit and done once the backend reports them
+static void mixer_mark_started(mixer_t* mixer, mixer_voice_slot_t* voice) {
+    const uint64_t now = audio_clock_ns();
+    audio_histogram_record(&voice->latency->stages[AUDIO_LATENCY_MIX], now > voice->trigger_ns ? now - voice->trigger_ns : 0);
+    mixer_latency_block_t* block = &mixer->latency_blocks[mixer->render_calls % MIXER_LATENCY_BLOCKS];
+    if (block->count < MIXER_LATENCY_MARKS) {
+        block->marks[block->count].latency = voice->latency;
+        block->marks[block->count].trigger_ns = voice->trigger_ns;
+        ++block->count;
+    }
+    voice->latency = NULL;
+}
+
+//* Mixes one chunk of at most block_frames into mixer->bus
+static void mixer_mix_block(mixer_t* mixer, size_t frames) {
+    mixer_cmd_t cmd;
+    mixer_drain_pending(mixer);
+    while (mixer_pop_cmd(mixer, &cmd)) {
+        mixer_apply_cmd(mixer, &cmd);
+    }
+
+    const uint16_t out_channels = mixer->config.num_channels;
+    memset(mixer->bus, 0, frames * out_channels * sizeof(float));
+    for (uint32_t i = 0; i < mixer->active_count; ) {
+        mixer_voice_slot_t* voice = &mixer->voices[mixer->active[i]];
+        if (voice->stream) {
+            //* Whatever the feeder hasn't delivered yet is left silent
+            size_t got = audio_stream_read(voice->stream, mixer->scratch, frames);
+            mixer_mix_voice(mixer, voice, mixer->bus, mixer->scratch, got, 0);
+            //? Ramps run on the clock, a stream that's behind doesn't hold a fade up
+            ramp_advance(&voice->gain, frames);
+            ramp_advance(&voice->pan, frames);
+            if (voice->latency && got > 0) mixer_mark_started(mixer, voice);
+            if ((got < frames && audio_stream_finished(voice->stream)) || (voice->stop_after_fade && voice->gain.len == 0)) {
+                mixer_release_voice(mixer, voice);
+                continue;
+            }
+            ++i;
+            continue;
+        }
+        size_t done = 0;
+        bool finished = false;
+        while (done < frames) {
+            //* The wrap happens inside the block, so the loop start follows the loop end on the very next frame.
+            //* A cursor already past the loop end (a seek, a loop set late) plays out the sound before wrapping
+            uint64_t end = (voice->loop && voice->cursor <= voice->loop_end) ? voice->loop_end : voice->frames;
+            uint64_t left = end - voice->cursor;
+            if (left == 0) {
+                if (!voice->loop) {
+                    finished = true;
+                    break;
+                }
+                voice->cursor = voice->loop_start;
+                continue;
+            }
+            size_t n = (left < frames - done) ? (size_t)left : frames - done;
+            const void* src;
+            if (voice->adpcm) {
+                //* Only this chunk is expanded; playing on from here continues the decode where it stopped
+                wav_adpcm_decode(voice->adpcm, voice->cursor, n, mixer->decoded, &voice->adpcm_state);
+                src = mixer->decoded;
+            } else {
+                src = voice->data + (size_t)voice->cursor * voice->block_align;
+            }
+            wav_convert_to_float(mixer->scratch, src, n * voice->channels, voice->format);
+            mixer_mix_voice(mixer, voice, mixer->bus + done * out_channels, mixer->scratch, n, done);
+            ramp_advance(&voice->gain, n);
+            ramp_advance(&voice->pan, n);
+            voice->cursor += n;
+            done += n;
+        }
+        if (voice->latency && done > 0) mixer_mark_started(mixer, voice);
+        if (finished || (!voice->loop && voice->cursor == voice->frames) || (voice->stop_after_fade && voice->gain.len == 0)) {
+            mixer_release_voice(mixer, voice);     //? swaps the last active voice into slot i
+            continue;
+        }
+        ++i;
+    }
+    ramp_advance(&mixer->master_gain, frames);
+    atomic_store_explicit(&mixer->stat_active, mixer->active_count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&mixer->stat_blocks, 1, memory_order_relaxed);
+}
+
+//? Every render call is one block to the backend, whatever it's split into here
+static void mixer_begin_render(mixer_t* mixer) {
+    mixer_latency_block_t* block = &mixer->latency_blocks[mixer->render_calls % MIXER_LATENCY_BLOCKS];
+    block->block = mixer->render_calls;
+    block->count = 0;
+}
+
+void mixer_render_float(mixer_t* mixer, float* out, size_t frames) {
+    const uint16_t channels = mixer->config.num_channels;
+    mixer_begin_render(mixer);
+    for (size_t done = 0; done < frames; ) {
+        size_t n = (frames - done < mixer->config.block_frames) ? frames - done : mixer->config.block_frames;
+        mixer_mix_block(mixer, n);
+        memcpy(out + done * channels, mixer->bus, n * channels * sizeof(float));
+        done += n;
+    }
+    ++mixer->render_calls;
+}
+
+void mixer_render(void* user, int16_t* out, size_t frames) {
+    mixer_t* mixer = (mixer_t*)user;
+    const uint16_t channels = mixer->config.num_channels;
+    mixer_begin_render(mixer);
+    for (size_t done = 0; done < frames; ) {
+        size_t n = (frames - done < mixer->config.block_frames) ? frames - done : mixer->config.block_frames;
+        mixer_mix_block(mixer, n);
+        //* Rounds and saturates, a loud mix clips instead of wrapping around
+        wav_convert_from_float(out + done * channels, mixer->bus, n * channels, WAV_SAMPLE_S16);
+        done += n;
+    }
+    ++mixer->render_calls;
+}
+
+void mixer_block_event(void* user, audio_block_event_t event, uint64_t block, uint64_t time_ns) {
+    mixer_t* mixer = (mixer_t*)user;
+    mixer_latency_block_t* entry = &mixer->latency_blocks[block % MIXER_LATENCY_BLOCKS];
+    //? Too old: the ring already moved on and the entry belongs to a later block
+    if (entry->block != block) return;
+    const audio_latency_stage_t stage = (event == AUDIO_BLOCK_SUBMITTED) ? AUDIO_LATENCY_SUBMIT : AUDIO_LATENCY_DONE;
+    for (uint32_t i = 0; i < entry->count; ++i) {
+        const mixer_latency_mark_t* mark = &entry->marks[i];
+        audio_histogram_record(&mark->latency->stages[stage], time_ns > mark->trigger_ns ? time_ns - mark->trigger_ns : 0);
+    }
+    if (event == AUDIO_BLOCK_DONE) entry->count = 0;
+}
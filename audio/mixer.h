@@ -0,0 +1,245 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "audio_backend.h"
+#include "audio_stream.h"
+#include "audio_latency.h"
+
+#define MIXER_INVALID_VOICE         0u
+#define MIXER_MAX_SOURCE_CHANNELS   8
+#define MIXER_PRIORITY_NORMAL       128
+
+/**
+ * Handle to one playing instance of a sound. Stays unique while the voice plays;
+ * once it ends the handle just stops matching anything.
+ */
+typedef uint32_t mixer_voice_t;
+
+/**
+ * What happens when a sound is triggered and every voice is busy.
+ */
+typedef enum mixer_steal_policy_t {
+    MIXER_STEAL_NONE,               //? the new sound is dropped
+    MIXER_STEAL_OLDEST,             //? the voice triggered longest ago is cut
+    MIXER_STEAL_QUIETEST,           //? the voice with the lowest gain is cut
+    MIXER_STEAL_LOWEST_PRIORITY,    //? the lowest priority voice is cut, the oldest among equals
+} mixer_steal_policy_t;
+
+/**
+ * Shape of a mixer_fade().
+ */
+typedef enum mixer_fade_curve_t {
+    MIXER_FADE_LINEAR,          //? straight line in amplitude
+    MIXER_FADE_EXPONENTIAL,     //? straight line in dB, sounds even; ends at -60 dB before snapping to silence
+} mixer_fade_curve_t;
+
+/**
+ * Mixer setup. The output format is fixed for the mixer's lifetime and should
+ * match the backend it renders into.
+ */
+typedef struct mixer_config_t {
+    uint32_t sample_rate;
+    uint16_t num_channels;
+    size_t block_frames;        //? largest chunk mixed in one go, render calls can be any size
+    uint32_t max_voices;        //? preallocated voice slots (at most 65535)
+    uint32_t queue_capacity;    //? pending stop/gain commands, rounded up to a power of 2
+    mixer_steal_policy_t steal_policy;
+} mixer_config_t;
+
+/**
+ * How a voice plays. Stealing never cuts a voice of higher priority than the new one.
+ */
+typedef struct mixer_voice_params_t {
+    float gain;                 //? linear, 1 = unity
+    float pan;                  //? -1 (left) to 1 (right), constant power; ignored past 2 output channels
+    bool loop;
+    uint8_t priority;           //? MIXER_PRIORITY_NORMAL for mixer_play()
+    audio_latency_t* latency;   //? optional, receives this voice's trigger-to-device timings (see mixer_block_event())
+    uint64_t trigger_ns;        //? audio_clock_ns() of the trigger, 0 for "now"
+    uint64_t start_frame;       //? first frame played, 0 for the start; streams ignore it (see audio_stream_seek())
+    uint64_t loop_start;        //? with `loop`, the range repeated: frames loop_start to loop_end - 1
+    uint64_t loop_end;          //? 0 for the end of the sound; streams ignore both (see audio_stream_set_loop())
+    atomic_uint* counter;       //? optional, counts the voice from its play call until the audio thread lets go of its source
+} mixer_voice_params_t;
+
+typedef struct mixer_stats_t {
+    uint32_t active_voices;
+    uint64_t blocks_mixed;
+    uint64_t voices_started;
+    uint64_t plays_dropped;     //? no free voice and nothing the steal policy could cut
+    uint64_t voices_stolen;
+} mixer_stats_t;
+
+typedef struct mixer_t mixer_t;
+
+/**
+ * @brief Creates a mixer: one float bus that every active voice is summed into,
+ *        converted to saturated 16-bit at the end of each block.
+ *
+ * Voices, command queue and scratch buffers are all allocated here; rendering
+ * never allocates or takes a lock.
+ */
+mixer_t* mixer_init(const mixer_config_t* config);
+
+/**
+ * @brief Frees the mixer. The backend rendering it must be stopped first.
+ */
+void mixer_free(mixer_t* mixer);
+
+/**
+ * @brief Starts playing `sound` on a free voice.
+ *
+ * Lock-free, allocation-free and safe from any number of threads: the voice slot
+ * comes off a lock-free free list (or is stolen per the steal policy when all are
+ * busy) and is handed to the audio thread through a lock-free list, so it never
+ * waits on the audio thread. `sound` must stay loaded until mixer_voice_playing()
+ * turns `false`, and its sample rate must match the mixer's (see wav_resample_file()).
+ * IMA ADPCM sounds stay compressed: each chunk is decoded as it's mixed.
+ *
+ * @param gain linear gain, 1 = unity.
+ * @param pan  -1 (left) to 1 (right), constant power; ignored past 2 output channels.
+ * @returns the voice handle, or MIXER_INVALID_VOICE if the sound can't be played
+ *          or no voice/queue slot is free.
+ */
+mixer_voice_t mixer_play(mixer_t* mixer, const wav_file_t* sound, float gain, float pan, bool loop);
+
+/**
+ * @brief mixer_play() with a priority for the steal policy.
+ */
+mixer_voice_t mixer_play_ex(mixer_t* mixer, const wav_file_t* sound, const mixer_voice_params_t* params);
+
+/**
+ * @brief Starts playing a stream on a free voice.
+ *
+ * The voice pulls its frames from `stream` on the audio thread and ends once the
+ * stream is finished (never, for a looping stream). Start the stream first; until
+ * its first chunk is decoded the voice plays silence. The stream's rate must be
+ * the mixer's and it must stay open until mixer_voice_playing() turns `false`.
+ *
+ * @returns the voice handle, or MIXER_INVALID_VOICE.
+ */
+mixer_voice_t mixer_play_stream(mixer_t* mixer, audio_stream_t* stream, float gain, float pan);
+
+/**
+ * @brief mixer_play_stream() with a priority for the steal policy (`loop` is the stream's business and ignored).
+ */
+mixer_voice_t mixer_play_stream_ex(mixer_t* mixer, audio_stream_t* stream, const mixer_voice_params_t* params);
+
+/**
+ * @brief Stops a voice at the next block boundary. Stale handles are ignored.
+ */
+bool mixer_stop(mixer_t* mixer, mixer_voice_t voice);
+
+/**
+ * @brief Stops every voice started with `counter` (see mixer_voice_params_t) at the next block boundary.
+ *
+ * Lets an owner that never kept the handles stop its voices; once `*counter` reads 0
+ * none of them references its source any more. Voices started after the command ran
+ * keep playing, so call it again until the count drops.
+ */
+bool mixer_stop_counted(mixer_t* mixer, const atomic_uint* counter);
+
+/**
+ * @brief Moves a voice to frame `frame` of its sound at the next block boundary.
+ *
+ * The frame after the jump follows the one before it directly, nothing is stopped
+ * or restarted. Stream voices forward the jump to audio_stream_seek(). Past the
+ * end, a looping voice wraps to its loop start and any other voice ends.
+ */
+bool mixer_seek(mixer_t* mixer, mixer_voice_t voice, uint64_t frame);
+
+/**
+ * @brief Changes a playing voice's looping at the next block boundary.
+ *
+ * A looping voice goes from frame `end - 1` straight to frame `start`, inside the
+ * block, with no silence or repeated frame in between. If it is already past `end`
+ * it plays to the end of the sound first. Turning `loop` off lets the voice play out
+ * to the end of the sound and stop (a sampler's release).
+ *
+ * @param end 0 for the end of the sound; an empty range loops the whole sound.
+ */
+bool mixer_set_loop(mixer_t* mixer, mixer_voice_t voice, bool loop, uint64_t start, uint64_t end);
+
+/**
+ * @brief Changes a voice's gain and pan from the next block on.
+ *
+ * The change glides over a few milliseconds instead of stepping, so it doesn't
+ * click, and it cancels any fade in progress.
+ */
+bool mixer_set_gain(mixer_t* mixer, mixer_voice_t voice, float gain, float pan);
+
+/**
+ * @brief Moves a voice's gain to `gain` over the next `frames` frames.
+ *
+ * Like every per-voice setting this only changes how the voice is mixed: the sound's
+ * samples are never touched, so any number of voices can play one sound with their
+ * own fades. A new fade or gain change starts from wherever the current one got to.
+ *
+ * @param stop_at_end stop the voice once the fade is over (a fade out).
+ */
+bool mixer_fade(mixer_t* mixer, mixer_voice_t voice, float gain, uint32_t frames, mixer_fade_curve_t curve, bool stop_at_end);
+
+/**
+ * @brief Runs a voice through a one-pole lowpass (6 dB per octave) from the next block on.
+ *
+ * @param cutoff_hz -3 dB point; 0, or anything from half the sample rate up, turns the filter off.
+ */
+bool mixer_set_filter(mixer_t* mixer, mixer_voice_t voice, float cutoff_hz);
+
+/**
+ * @brief Scales the whole mix, smoothed like mixer_set_gain().
+ */
+bool mixer_set_master_gain(mixer_t* mixer, float gain);
+
+/**
+ * @brief Stops every voice.
+ */
+bool mixer_stop_all(mixer_t* mixer);
+
+/**
+ * @returns `true` while `voice` is queued or playing. A stolen voice reads as playing
+ *          until the audio thread has let go of its sound or stream, so once this
+ *          returns `false` the source can be freed.
+ */
+bool mixer_voice_playing(const mixer_t* mixer, mixer_voice_t voice);
+
+/**
+ * @brief Mixes `frames` frames of interleaved 16-bit audio into `out`.
+ *
+ * Matches audio_render_fn, with the mixer as `user`: hand it to a backend and the
+ * backend's thread becomes the mixer's audio thread.
+ */
+void mixer_render(void* mixer, int16_t* out, size_t frames);
+
+/**
+ * @brief Feeds the backend's block timings into the voices' latency histograms.
+ *
+ * Matches audio_block_fn, with the mixer as `user`. Must be called on the render
+ * thread (every backend does), so each `latency` a voice was started with must
+ * stay valid until the backend is stopped, not just until the voice ends.
+ */
+void mixer_block_event(void* mixer, audio_block_event_t event, uint64_t block, uint64_t time_ns);
+
+/**
+ * @brief Same as mixer_render() but leaves the mix as float (no master clipping).
+ */
+void mixer_render_float(mixer_t* mixer, float* out, size_t frames);
+
+/**
+ * @brief Reads the mixer's counters. Values are updated by the audio thread and may lag slightly.
+ */
+void mixer_get_stats(const mixer_t* mixer, mixer_stats_t* stats);
@@ -0,0 +1,96 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "spsc_ring.h"
+#include "log.h"
+
+bool spsc_ring_init(spsc_ring_t* ring, size_t capacity) {
+    size_t size = 64;
+    while (size < capacity) size <<= 1;
+    ring->buffer = (uint8_t*)malloc(size);
+    if (!ring->buffer) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate a %zu byte ring.\n", size);
+        return false;
+    }
+    ring->capacity = size;
+    ring->mask = size - 1;
+    atomic_init(&ring->write_pos, 0);
+    atomic_init(&ring->read_pos, 0);
+    return true;
+}
+
+void spsc_ring_free(spsc_ring_t* ring) {
+    free(ring->buffer);
+    ring->buffer = NULL;
+    ring->capacity = 0;
+}
+
+void spsc_ring_reset(spsc_ring_t* ring) {
+    atomic_store(&ring->write_pos, 0);
+    atomic_store(&ring->read_pos, 0);
+}
+
+size_t spsc_ring_readable(const spsc_ring_t* ring) {
+    spsc_ring_t* r = (spsc_ring_t*)ring;
+    return atomic_load_explicit(&r->write_pos, memory_order_acquire) - atomic_load_explicit(&r->read_pos, memory_order_relaxed);
+}
+
+size_t spsc_ring_writable(const spsc_ring_t* ring) {
+    spsc_ring_t* r = (spsc_ring_t*)ring;
+    return ring->capacity - (atomic_load_explicit(&r->write_pos, memory_order_relaxed) - atomic_load_explicit(&r->read_pos, memory_order_acquire));
+}
+
+//* Both sides copy in at most two pieces: up to the end of the buffer, then from its start
+
+size_t spsc_ring_write(spsc_ring_t* ring, const void* src, size_t bytes) {
+    size_t write = atomic_load_explicit(&ring->write_pos, memory_order_relaxed);
+    size_t read = atomic_load_explicit(&ring->read_pos, memory_order_acquire);
+    size_t space = ring->capacity - (write - read);
+    if (bytes > space) bytes = space;
+    size_t offset = write & ring->mask;
+    size_t first = (bytes < ring->capacity - offset) ? bytes : ring->capacity - offset;
+    memcpy(ring->buffer + offset, src, first);
+    memcpy(ring->buffer, (const uint8_t*)src + first, bytes - first);
+    //? Release: the consumer must see the bytes before it sees the new position
+    atomic_store_explicit(&ring->write_pos, write + bytes, memory_order_release);
+    return bytes;
+}
+
+size_t spsc_ring_read(spsc_ring_t* ring, void* dst, size_t bytes) {
+    size_t read = atomic_load_explicit(&ring->read_pos, memory_order_relaxed);
+    size_t write = atomic_load_explicit(&ring->write_pos, memory_order_acquire);
+    if (bytes > write - read) bytes = write - read;
+    size_t offset = read & ring->mask;
+    size_t first = (bytes < ring->capacity - offset) ? bytes : ring->capacity - offset;
+    memcpy(dst, ring->buffer + offset, first);
+    memcpy((uint8_t*)dst + first, ring->buffer, bytes - first);
+    //? Release: the producer must not overwrite the bytes before they've been copied out
+    atomic_store_explicit(&ring->read_pos, read + bytes, memory_order_release);
+    return bytes;
+}
+
+size_t spsc_ring_write_position(const spsc_ring_t* ring) {
+    return atomic_load_explicit(&((spsc_ring_t*)ring)->write_pos, memory_order_relaxed);
+}
+
+size_t spsc_ring_skip_to(spsc_ring_t* ring, size_t position) {
+    size_t read = atomic_load_explicit(&ring->read_pos, memory_order_relaxed);
+    size_t write = atomic_load_explicit(&ring->write_pos, memory_order_acquire);
+    //? Positions wrap, compare distances: `position` must lie between the read and the write position
+    if (position - read > write - read) return 0;
+    atomic_store_explicit(&ring->read_pos, position, memory_order_release);
+    return position - read;
+}
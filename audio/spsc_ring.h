@@ -0,0 +1,82 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/**
+ * Lock-free single-producer/single-consumer byte ring.
+ *
+ * Exactly one thread writes and exactly one thread reads; neither ever waits on
+ * the other, so the reader can be a realtime audio thread. Positions only ever
+ * grow and are masked on access, which is why the capacity is a power of 2.
+ */
+typedef struct spsc_ring_t {
+    uint8_t* buffer;
+    size_t capacity;
+    size_t mask;
+    _Alignas(64) atomic_size_t write_pos;   //? producer owned, own cache line so the two sides don't false share
+    _Alignas(64) atomic_size_t read_pos;    //? consumer owned
+} spsc_ring_t;
+
+/**
+ * @brief Allocates a ring holding at least `capacity` bytes (rounded up to a power of 2).
+ */
+bool spsc_ring_init(spsc_ring_t* ring, size_t capacity);
+
+void spsc_ring_free(spsc_ring_t* ring);
+
+/**
+ * @brief Empties the ring. Neither side may be using it at the time.
+ */
+void spsc_ring_reset(spsc_ring_t* ring);
+
+/**
+ * @returns the bytes the consumer can read right now.
+ */
+size_t spsc_ring_readable(const spsc_ring_t* ring);
+
+/**
+ * @returns the bytes the producer can write right now.
+ */
+size_t spsc_ring_writable(const spsc_ring_t* ring);
+
+/**
+ * @brief Producer side: copies up to `bytes` bytes in.
+ * @returns the number of bytes actually written.
+ */
+size_t spsc_ring_write(spsc_ring_t* ring, const void* src, size_t bytes);
+
+/**
+ * @brief Consumer side: copies up to `bytes` bytes out.
+ * @returns the number of bytes actually read.
+ */
+size_t spsc_ring_read(spsc_ring_t* ring, void* dst, size_t bytes);
+
+/**
+ * @brief Producer side: total bytes written since the last reset, a position the consumer can skip to.
+ */
+size_t spsc_ring_write_position(const spsc_ring_t* ring);
+
+/**
+ * @brief Consumer side: drops everything before `position` (from spsc_ring_write_position()).
+ * @returns the number of bytes dropped, 0 if the consumer is already past it.
+ */
+size_t spsc_ring_skip_to(spsc_ring_t* ring, size_t position);
@@ -0,0 +1,131 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+#include "bench_util.h"
+#include "wav_endian.h"
+#include <math.h>
+#include <stdarg.h>
+
+#define BENCH_WRITE_FRAMES 4096     //? frames generated per append
+
+static int failures;
+
+//=================================================FIXTURES==========================================================
+
+bool bench_make_sound(wav_file_t* sound, uint16_t channels, uint32_t rate, uint64_t frames, bench_fill_fn fill, void* user) {
+    wav_init_file(sound);
+    wav_init_header(&sound->header, WAV_FORMAT_PCM, channels, rate, 16);
+    sound->samples = frames;
+    sound->data_length = frames * sound->header.block_align;
+    sound->header.data_size = sound->data_length;
+    sound->data = (uint8_t*)malloc((size_t)sound->data_length);
+    if (!sound->data) return false;
+    int16_t* samples = (int16_t*)sound->data;
+    for (uint64_t i = 0; i < frames; ++i) fill(user, i, samples + i * channels, channels);
+    return true;
+}
+
+typedef struct tone_t {
+    double step;                //? radians per frame, 0 for a constant
+    double amplitude;
+} tone_t;
+
+static void fill_tone(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    const tone_t* tone = (const tone_t*)user;
+    const double v = (tone->step > 0.0) ? sin(tone->step * (double)frame) : 1.0;
+    for (uint16_t c = 0; c < channels; ++c) samples[c] = (int16_t)(tone->amplitude * v);
+}
+
+bool bench_make_tone(wav_file_t* sound, uint16_t channels, uint32_t rate, uint64_t frames, double frequency, double level) {
+    tone_t tone = { 2.0 * 3.14159265358979 * frequency / rate, 32767.0 * level };
+    return bench_make_sound(sound, channels, rate, frames, fill_tone, &tone);
+}
+
+//=================================================TEST FILES==========================================================
+
+bool bench_write_wav(const char* path, uint16_t channels, uint32_t rate, uint64_t frames, bench_fill_fn fill, void* user) {
+    wav_header_t format;
+    wav_init_header(&format, WAV_FORMAT_PCM, channels, rate, 16);
+    int16_t* block = (int16_t*)malloc(BENCH_WRITE_FRAMES * format.block_align);
+    wav_writer_t writer;
+    wav_writer_options_t options = { frames, WAV_RF64_NEVER, 0 };
+    if (!block || !wav_writer_open(&writer, path, &format, &options)) {
+        free(block);
+        return false;
+    }
+    bool ok = true;
+    for (uint64_t done = 0; ok && done < frames; ) {
+        size_t n = (frames - done < BENCH_WRITE_FRAMES) ? (size_t)(frames - done) : BENCH_WRITE_FRAMES;
+        for (size_t i = 0; i < n; ++i) fill(user, done + i, block + i * channels, channels);
+        ok = wav_writer_append_frames(&writer, block, n);
+        done += n;
+    }
+    free(block);
+    return wav_writer_close(&writer) && ok;
+}
+
+void bench_canonical_header(uint8_t out[BENCH_CANONICAL_HEADER], const wav_header_t* format, uint32_t data_bytes) {
+    memcpy(out, "RIFF", 4);
+    encode_u32(out + 4, 36 + data_bytes);
+    memcpy(out + 8, "WAVEfmt ", 8);
+    encode_u32(out + 16, 16);
+    encode_u16(out + 20, WAV_FORMAT_PCM);
+    encode_u16(out + 22, format->num_channels);
+    encode_u32(out + 24, format->sample_rate);
+    encode_u32(out + 28, format->byte_rate);
+    encode_u16(out + 32, format->block_align);
+    encode_u16(out + 34, format->bits_per_sample);
+    memcpy(out + 36, "data", 4);
+    encode_u32(out + 40, data_bytes);
+}
+
+void bench_put_u16(FILE* f, uint16_t v) {
+    uint8_t bytes[2];
+    encode_u16(bytes, v);
+    fwrite(bytes, 1, 2, f);
+}
+
+void bench_put_u32(FILE* f, uint32_t v) {
+    uint8_t bytes[4];
+    encode_u32(bytes, v);
+    fwrite(bytes, 1, 4, f);
+}
+
+//=================================================SELF-CHECKS==========================================================
+
+void bench_check_begin(const char* columns) {
+    printf("check,result,%s\n", columns);
+}
+
+bool bench_check(const char* name, bool ok, const char* detail, ...) {
+    printf("%s,%s,", name, ok ? "ok" : "FAIL");
+    va_list args;
+    va_start(args, detail);
+    vprintf(detail, args);
+    va_end(args);
+    putchar('\n');
+    if (!ok) ++failures;
+    return ok;
+}
+
+bool bench_check_mismatches(const char* name, size_t mismatches, size_t first) {
+    return bench_check(name, mismatches == 0, "%zu,%zu", mismatches, first);
+}
+
+int bench_status(void) {
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
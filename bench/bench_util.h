@@ -0,0 +1,88 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+#pragma once
+#include "wav_writer.h"
+
+#define BENCH_CANONICAL_HEADER 44   //? bytes in the plain RIFF/fmt/data header older writers emit
+
+/**
+ * Produces test audio a frame at a time: writes the `channels` samples of frame
+ * `frame` into `samples`.
+ */
+typedef void (*bench_fill_fn)(void* user, uint64_t frame, int16_t* samples, uint16_t channels);
+
+//=================================================FIXTURES==========================================================
+
+/**
+ * @brief Builds an in-memory 16-bit PCM sound of `frames` frames from `fill`.
+ *
+ * The header comes from wav_init_header(); release the sound with wav_free_file().
+ */
+bool bench_make_sound(wav_file_t* sound, uint16_t channels, uint32_t rate, uint64_t frames, bench_fill_fn fill, void* user);
+
+/**
+ * @brief bench_make_sound() of a sine at `frequency` Hz, `level` of full scale, the
+ *        same on every channel. Frequency 0 is a constant `level` (handy for reading gains back).
+ */
+bool bench_make_tone(wav_file_t* sound, uint16_t channels, uint32_t rate, uint64_t frames, double frequency, double level);
+
+/**
+ * @brief Writes a 16-bit PCM test file of `frames` frames from `fill` through the streaming writer.
+ *
+ * Only one block of frames is in memory at a time, so the file can be any length a
+ * plain RIFF file holds. The header comes from wav_init_header().
+ */
+bool bench_write_wav(const char* path, uint16_t channels, uint32_t rate, uint64_t frames, bench_fill_fn fill, void* user);
+
+/**
+ * @brief Fills `out` with the canonical 44-byte header of a plain PCM file holding
+ *        `data_bytes` bytes of `format`'s samples, what hand-rolled writers emit.
+ */
+void bench_canonical_header(uint8_t out[BENCH_CANONICAL_HEADER], const wav_header_t* format, uint32_t data_bytes);
+
+/**
+ * @brief Little-endian writes, for benches that lay out unusual chunk orders themselves.
+ */
+void bench_put_u16(FILE* f, uint16_t v);
+void bench_put_u32(FILE* f, uint32_t v);
+
+//=================================================SELF-CHECKS==========================================================
+//* Benches check what they measure before timing it: one CSV row per check, and the
+//* process exit status says whether all of them passed.
+
+/**
+ * @brief Prints the header row of the check table: "check,result," then `columns`.
+ */
+void bench_check_begin(const char* columns);
+
+/**
+ * @brief Prints one row: `name`, ok or FAIL, then `detail` formatted like printf().
+ * @returns `ok`.
+ */
+bool bench_check(const char* name, bool ok, const char* detail, ...);
+
+/**
+ * @brief bench_check() of a comparison: passes when nothing mismatched, and reports
+ *        the number of mismatches and where the first one was.
+ */
+bool bench_check_mismatches(const char* name, size_t mismatches, size_t first);
+
+/**
+ * @returns EXIT_FAILURE if any check failed so far, EXIT_SUCCESS otherwise.
+ */
+int bench_status(void);
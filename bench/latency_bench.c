@@ -0,0 +1,108 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Trigger-to-speaker latency on a simulated waveOut device.
+ *
+ *   latency_bench [seconds_per_run]
+ *
+ * Runs the mixer on the simulated backend (a ring of N buffers played back in real
+ * time) for a few device layouts and fires a short sound every 5-20 ms from a game
+ * thread, the way play_sound() does: a cached 48 kHz sound mixed directly, and a
+ * 44.1 kHz one played through a resampling stream. Every stage is measured from the
+ * trigger: first frame mixed, its buffer submitted, and that buffer played (WOM_DONE).
+ * done_p99 is what a player would hear; it grows with buffers * block.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/latency_bench.c bench/bench_util.c audio/audio_latency.c audio/mixer.c \
+ *       audio/audio_stream.c audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o latency_bench
+ */
+
+#include "mixer.h"
+#include "bench_util.h"
+
+#define BENCH_RATE 48000
+
+typedef struct layout_t {
+    unsigned buffers;
+    size_t block_frames;
+} layout_t;
+
+static void print_row(const layout_t* layout, const char* source, const audio_latency_t* latency, uint64_t underruns) {
+    printf("%u,%zu,%s", layout->buffers, layout->block_frames, source);
+    for (int s = 0; s < AUDIO_LATENCY_STAGES; ++s) {
+        audio_latency_summary_t summary;
+        audio_histogram_summarize(&latency->stages[s], &summary);
+        if (s == 0) printf(",%llu", (unsigned long long)summary.count);
+        printf(",%.2f,%.2f,%.2f", summary.p50_ns / 1e6, summary.p99_ns / 1e6, summary.max_ns / 1e6);
+    }
+    printf(",%llu\n", (unsigned long long)underruns);
+}
+
+int main(int argc, char const *argv[])
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 3.0;
+    if (seconds <= 0.0) seconds = 3.0;
+
+    static const layout_t layouts[] = { { 2, 240 }, { 4, 480 }, { 8, 480 }, { 3, 1024 } };
+    wav_file_t direct, resampled;
+    //? 50 ms blips, one at the device rate and one the stream has to resample
+    if (!bench_make_tone(&direct, 1, BENCH_RATE, BENCH_RATE / 20, 660.0, 0.2)
+        || !bench_make_tone(&resampled, 1, 44100, 44100 / 20, 660.0, 0.2)) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    printf("buffers,block,source,plays,mix_p50_ms,mix_p99_ms,mix_max_ms,submit_p50_ms,submit_p99_ms,submit_max_ms,done_p50_ms,done_p99_ms,done_max_ms,underruns\n");
+    for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); ++l) {
+        const layout_t* layout = &layouts[l];
+        mixer_config_t mixer_config = { BENCH_RATE, 2, layout->block_frames, 16, 256, MIXER_STEAL_OLDEST };
+        mixer_t* mixer = mixer_init(&mixer_config);
+        audio_stream_t* stream = audio_stream_open_memory(&resampled, BENCH_RATE, 0);
+        static audio_latency_t latency[2];
+        audio_latency_reset(&latency[0]);
+        audio_latency_reset(&latency[1]);
+        audio_config_t config = { BENCH_RATE, 2, layout->block_frames, mixer_render, mixer, mixer_block_event };
+        audio_backend_t* backend = (mixer && stream) ? audio_sim_backend_init(&config, layout->buffers) : NULL;
+        if (!backend || !audio_backend_start(backend)) return EXIT_FAILURE;
+
+        uint32_t seed = 12345;
+        mixer_voice_t stream_voice = MIXER_INVALID_VOICE;
+        const uint64_t end = audio_clock_ns() + (uint64_t)(seconds * 1e9);
+        for (unsigned i = 0; audio_clock_ns() < end; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            audio_sleep_until(audio_clock_ns() + 5000000ull + (seed >> 8) % 15000000ull);
+            const uint64_t trigger = audio_clock_ns();
+            if (i & 1) {
+                mixer_voice_params_t params = { 0.5f, 0.0f, false, MIXER_PRIORITY_NORMAL, &latency[0], trigger, 0, 0, 0, NULL };
+                mixer_play_ex(mixer, &direct, &params);
+            } else if (!mixer_voice_playing(mixer, stream_voice)) {
+                //? Like play_sound(): the feeder restarts on the trigger and the voice plays silence until it catches up
+                mixer_voice_params_t params = { 0.5f, 0.0f, false, MIXER_PRIORITY_NORMAL, &latency[1], trigger, 0, 0, 0, NULL };
+                if (audio_stream_start(stream, false)) stream_voice = mixer_play_stream_ex(mixer, stream, &params);
+            }
+        }
+        audio_backend_stop(backend);
+        print_row(layout, "cached", &latency[0], audio_backend_underruns(backend));
+        print_row(layout, "stream", &latency[1], audio_backend_underruns(backend));
+        audio_backend_free(backend);
+        audio_stream_close(stream);
+        mixer_free(mixer);
+    }
+    wav_free_file(&direct);
+    wav_free_file(&resampled);
+    return 0;
+}
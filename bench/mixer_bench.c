@@ -0,0 +1,132 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Mixer cost per block as the number of concurrent voices grows.
+ *
+ *   mixer_bench [seconds_of_audio]
+ *
+ * Starts N looping voices (half mono, half stereo 16-bit, 48 kHz) and drives the
+ * mixer through the null backend with realtime pacing off, so the render thread
+ * mixes as fast as it can. us_per_block is the CPU time of one 256 frame block;
+ * realtime_x is how many times faster than playback that is. A separate thread
+ * keeps retuning gains through the command queue while it runs.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/mixer_bench.c bench/bench_util.c audio/mixer.c audio/audio_latency.c \
+ *       audio/audio_stream.c audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o mixer_bench
+ */
+
+#include "mixer.h"
+#include "bench_util.h"
+#include <pthread.h>
+
+#define BENCH_RATE 48000
+#define BENCH_BLOCK 256
+#define BENCH_SOUND_FRAMES (BENCH_RATE / 2)
+
+typedef struct control_t {
+    mixer_t* mixer;
+    mixer_voice_t* voices;
+    size_t count;
+    atomic_bool running;
+    uint64_t commands;
+} control_t;
+
+static void* control_thread(void* arg) {
+    control_t* control = (control_t*)arg;
+    size_t i = 0;
+    while (atomic_load(&control->running)) {
+        float t = (float)(i % 100) / 100.0f;
+        if (mixer_set_gain(control->mixer, control->voices[i % control->count], 0.5f + t * 0.5f, t * 2.0f - 1.0f)) {
+            ++control->commands;
+        }
+        ++i;
+        audio_sleep_until(audio_clock_ns() + 50000ull);     //? a game thread doesn't spin either
+    }
+    return NULL;
+}
+
+int main(int argc, char const *argv[])
+{
+    double audio_seconds = (argc > 1) ? atof(argv[1]) : 5.0;
+    if (audio_seconds <= 0.0) audio_seconds = 5.0;
+
+    static const size_t voice_counts[] = { 1, 16, 64, 256, 512, 1024 };
+    wav_file_t sounds[2];
+    //? A detuned tone per layout so nothing cancels out
+    if (!bench_make_tone(&sounds[0], 1, BENCH_RATE, BENCH_SOUND_FRAMES, 220.0, 0.25)
+        || !bench_make_tone(&sounds[1], 2, BENCH_RATE, BENCH_SOUND_FRAMES, 330.0, 0.25)) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("voices,isa,blocks,us_per_block,realtime_x,commands\n");
+    for (size_t v = 0; v < sizeof(voice_counts) / sizeof(voice_counts[0]); ++v) {
+        const size_t count = voice_counts[v];
+        for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+            wav_convert_set_isa((wav_isa_t)isa);
+            mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, (uint32_t)count, 4096, MIXER_STEAL_NONE };
+            mixer_t* mixer = mixer_init(&config);
+            mixer_voice_t* voices = (mixer_voice_t*)malloc(count * sizeof(mixer_voice_t));
+            if (!mixer || !voices) {
+                fprintf(stderr, "out of memory\n");
+                return EXIT_FAILURE;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                voices[i] = mixer_play(mixer, &sounds[i & 1], 1.0f / (float)count, 0.0f, true);
+            }
+            //* Mixing in float means the master gain can go back up without clipping the sum early
+            mixer_set_master_gain(mixer, 0.9f);
+
+            audio_config_t backend_config = { BENCH_RATE, 2, BENCH_BLOCK, mixer_render, mixer, NULL };
+            audio_backend_t* backend = audio_null_backend_init(&backend_config, false);
+            if (!backend) return EXIT_FAILURE;
+            control_t control = { mixer, voices, count, false, 0 };
+            atomic_init(&control.running, true);
+            pthread_t thread;
+            pthread_create(&thread, NULL, control_thread, &control);
+
+            const uint64_t target = (uint64_t)(audio_seconds * BENCH_RATE);
+            uint64_t start = audio_clock_ns();
+            audio_backend_start(backend);
+            while (audio_backend_frames_rendered(backend) < target) {
+                audio_sleep_until(audio_clock_ns() + 1000000ull);
+            }
+            audio_backend_stop(backend);
+            double seconds = (double)(audio_clock_ns() - start) / 1e9;
+            atomic_store(&control.running, false);
+            pthread_join(thread, NULL);
+
+            mixer_stats_t stats;
+            mixer_get_stats(mixer, &stats);
+            double rendered = (double)audio_backend_frames_rendered(backend) / BENCH_RATE;
+            printf("%zu,%s,%llu,%.3f,%.1f,%llu\n", count, wav_isa_name((wav_isa_t)isa), (unsigned long long)stats.blocks_mixed,
+                seconds * 1e6 / (double)stats.blocks_mixed, rendered / seconds, (unsigned long long)control.commands);
+            if (stats.active_voices != count) {
+                fprintf(stderr, "expected %zu active voices, got %u\n", count, stats.active_voices);
+            }
+            audio_backend_free(backend);
+            mixer_free(mixer);
+            free(voices);
+        }
+        wav_convert_set_isa(best);
+    }
+    wav_free_file(&sounds[0]);
+    wav_free_file(&sounds[1]);
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Streaming playback: time to first sample, underruns and resident memory.
+ *
+ *   stream_bench [seconds_per_run] [scratch.wav]
+ *
+ * Writes a 60 s stereo 16-bit 44.1 kHz file, then plays 1 and 16 concurrent
+ * streams of it through the mixer on the null backend in realtime mode (it paces
+ * itself like a double-buffered 48 kHz device with 10 ms blocks), so the feeder
+ * threads read from disk and resample while the audio thread is on a deadline.
+ *
+ * first_sample_ms is audio_stream_start() to the first frame reaching the mixer,
+ * load_ms the time wav_parse_file() needs before the whole-file path can start.
+ * ring_kb is what one playing stream keeps resident, file_kb what the whole-file
+ * path pinned.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/stream_bench.c bench/bench_util.c audio/audio_stream.c audio/spsc_ring.c \
+ *       audio/mixer.c audio/audio_latency.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o stream_bench
+ */
+
+#include "mixer.h"
+#include "bench_util.h"
+#include <math.h>
+
+#define BENCH_FILE_RATE 44100
+#define BENCH_FILE_SECONDS 60
+#define BENCH_DEVICE_RATE 48000
+#define BENCH_BLOCK 480
+#define BENCH_MAX_STREAMS 16
+
+//? 440 Hz, right channel inverted
+static void fill_tone(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    (void)user; (void)channels;
+    int16_t v = (int16_t)(12000.0 * sin(2.0 * 3.14159265358979 * 440.0 * (double)frame / BENCH_FILE_RATE));
+    samples[0] = v;
+    samples[1] = (int16_t)(-v);
+}
+
+int main(int argc, char const *argv[])
+{
+    double run_seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    const char* path = (argc > 2) ? argv[2] : "stream_bench.wav";
+    if (run_seconds <= 0.0) run_seconds = 1.0;
+    if (!bench_write_wav(path, 2, BENCH_FILE_RATE, (uint64_t)BENCH_FILE_RATE * BENCH_FILE_SECONDS, fill_tone, NULL)) {
+        fprintf(stderr, "unable to write %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    wav_file_t whole;
+    wav_init_file(&whole);
+    uint64_t load_start = audio_clock_ns();
+    if (!wav_parse_file(path, &whole)) return EXIT_FAILURE;
+    double load_ms = (double)(audio_clock_ns() - load_start) / 1e6;
+    const size_t file_kb = (size_t)(whole.data_length / 1024);
+    wav_free_file(&whole);
+
+    static const size_t ring_sizes[] = { 1024, 2048, 8192 };
+    static const size_t stream_counts[] = { 1, BENCH_MAX_STREAMS };
+    printf("streams,ring_frames,ring_kb,file_kb,load_ms,first_sample_ms,stream_underruns,device_underruns\n");
+    for (size_t r = 0; r < sizeof(ring_sizes) / sizeof(ring_sizes[0]); ++r) {
+        for (size_t c = 0; c < sizeof(stream_counts) / sizeof(stream_counts[0]); ++c) {
+            const size_t count = stream_counts[c];
+            mixer_config_t mixer_config = { BENCH_DEVICE_RATE, 2, BENCH_BLOCK, BENCH_MAX_STREAMS, 256, MIXER_STEAL_NONE };
+            mixer_t* mixer = mixer_init(&mixer_config);
+            audio_config_t config = { BENCH_DEVICE_RATE, 2, BENCH_BLOCK, mixer_render, mixer, NULL };
+            audio_backend_t* backend = mixer ? audio_null_backend_init(&config, true) : NULL;
+            if (!backend) return EXIT_FAILURE;
+            audio_backend_start(backend);
+
+            audio_stream_t* streams[BENCH_MAX_STREAMS];
+            for (size_t i = 0; i < count; ++i) {
+                streams[i] = audio_stream_open_file(path, BENCH_DEVICE_RATE, ring_sizes[r]);
+                if (!streams[i] || !audio_stream_start(streams[i], true)) return EXIT_FAILURE;
+                mixer_play_stream(mixer, streams[i], 1.0f / (float)count, 0.0f);
+            }
+            audio_sleep_until(audio_clock_ns() + (uint64_t)(run_seconds * 1e9));
+            audio_backend_stop(backend);
+
+            double first_ms = 0.0;
+            uint64_t underruns = 0;
+            for (size_t i = 0; i < count; ++i) {
+                audio_stream_stats_t stats;
+                audio_stream_get_stats(streams[i], &stats);
+                first_ms += (double)stats.first_frame_ns / 1e6 / (double)count;
+                underruns += stats.underruns;
+                audio_stream_close(streams[i]);
+            }
+            printf("%zu,%zu,%zu,%zu,%.3f,%.3f,%llu,%llu\n", count, ring_sizes[r], ring_sizes[r] * 2 * sizeof(float) / 1024, file_kb,
+                load_ms, first_ms, (unsigned long long)underruns, (unsigned long long)audio_backend_underruns(backend));
+            audio_backend_free(backend);
+            mixer_free(mixer);
+        }
+    }
+    remove(path);
+    return 0;
+}
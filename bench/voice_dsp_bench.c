@@ -0,0 +1,188 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+/**
+ * Per-voice DSP chain: checks through the offline backend, then its cost.
+ *
+ *   voice_dsp_bench [voices]
+ *
+ * The checks render known signals into memory and compare against what the chain
+ * should do: fade end points and shape, constant-power pan, the smoothing of a gain
+ * change and the lowpass response. Every render is synchronous, so each run lands
+ * on the same frames. Then N looping voices (mono and stereo, 48 kHz) are mixed
+ * steady, fading the whole time, and fading through the filter, per ISA;
+ * us_per_block is the CPU time of one 256 frame block.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/voice_dsp_bench.c bench/bench_util.c audio/mixer.c audio/audio_latency.c \
+ *       audio/audio_stream.c audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o voice_dsp_bench
+ */
+
+#include "mixer.h"
+#include "bench_util.h"
+#include <math.h>
+
+#define BENCH_RATE 48000
+#define BENCH_BLOCK 256
+#define BENCH_SOUND_FRAMES BENCH_RATE
+
+typedef struct offline_t {
+    mixer_t* mixer;
+    audio_backend_t* backend;
+    int16_t* out;
+} offline_t;
+
+static bool offline_open(offline_t* offline, size_t frames) {
+    mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, 64, 256, MIXER_STEAL_NONE };
+    offline->mixer = mixer_init(&config);
+    offline->out = (int16_t*)calloc(frames * 2, sizeof(int16_t));
+    if (!offline->mixer || !offline->out) return false;
+    audio_config_t backend_config = { BENCH_RATE, 2, BENCH_BLOCK, mixer_render, offline->mixer, NULL };
+    offline->backend = audio_offline_backend_init(&backend_config, offline->out, frames);
+    return offline->backend != NULL;
+}
+
+static void offline_close(offline_t* offline) {
+    audio_backend_free(offline->backend);
+    mixer_free(offline->mixer);
+    free(offline->out);
+}
+
+static double sample(const offline_t* offline, size_t frame, int channel) {
+    return offline->out[frame * 2 + channel] / 32767.0;
+}
+
+static double rms(const offline_t* offline, size_t from, size_t to, int channel) {
+    double sum = 0.0;
+    for (size_t i = from; i < to; ++i) sum += sample(offline, i, channel) * sample(offline, i, channel);
+    return sqrt(sum / (double)(to - from));
+}
+
+static void run_checks(void) {
+    wav_file_t dc, tone_low, tone_high;
+    offline_t o;
+    if (!bench_make_tone(&dc, 1, BENCH_RATE, BENCH_SOUND_FRAMES, 0.0, 0.5) || !bench_make_tone(&tone_low, 1, BENCH_RATE, BENCH_SOUND_FRAMES, 100.0, 0.5)
+        || !bench_make_tone(&tone_high, 1, BENCH_RATE, BENCH_SOUND_FRAMES, 10000.0, 0.5)) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    bench_check_begin("value");
+
+    //* Linear fade out over 4800 frames that stops the voice
+    if (!offline_open(&o, 9600)) exit(EXIT_FAILURE);
+    mixer_voice_t v = mixer_play(o.mixer, &dc, 1.0f, 0.0f, true);
+    audio_offline_render(o.backend, 1024);
+    mixer_fade(o.mixer, v, 0.0f, 4800, MIXER_FADE_LINEAR, true);
+    audio_offline_render(o.backend, 8576);
+    bench_check("linear_fade_start", fabs(sample(&o, 1023, 0) - 0.5) < 1e-3, "%.4f", sample(&o, 1023, 0));
+    bench_check("linear_fade_half", fabs(sample(&o, 1024 + 2400, 0) - 0.25) < 2e-3, "%.4f", sample(&o, 1024 + 2400, 0));
+    bench_check("linear_fade_end", sample(&o, 1024 + 4800, 0) == 0.0 && sample(&o, 9599, 1) == 0.0, "%.4f", sample(&o, 1024 + 4800, 0));
+    bench_check("fade_stops_voice", !mixer_voice_playing(o.mixer, v), "%.4f", 0.0);
+    offline_close(&o);
+
+    //* Exponential fade from 1 to 0.01: halfway is 0.1, the geometric mean
+    if (!offline_open(&o, 9600)) exit(EXIT_FAILURE);
+    v = mixer_play(o.mixer, &dc, 1.0f, 0.0f, true);
+    mixer_fade(o.mixer, v, 0.01f, 4800, MIXER_FADE_EXPONENTIAL, false);
+    audio_offline_render(o.backend, 9600);
+    bench_check("exp_fade_half", fabs(sample(&o, 2400, 0) / 0.5 - 0.1) < 0.01, "%.4f", sample(&o, 2400, 0) / 0.5);
+    bench_check("exp_fade_end", fabs(sample(&o, 9000, 0) / 0.5 - 0.01) < 1e-3, "%.4f", sample(&o, 9000, 0) / 0.5);
+    offline_close(&o);
+
+    //* Constant power pan: hard left is silent on the right, centre is unity on both sides
+    if (!offline_open(&o, 4800)) exit(EXIT_FAILURE);
+    v = mixer_play(o.mixer, &dc, 1.0f, -1.0f, true);
+    audio_offline_render(o.backend, 1024);
+    mixer_set_gain(o.mixer, v, 1.0f, 0.0f);
+    audio_offline_render(o.backend, 3776);
+    bench_check("pan_left_right_silent", sample(&o, 512, 1) == 0.0, "%.4f", sample(&o, 512, 1));
+    bench_check("pan_left_power", fabs(sample(&o, 512, 0) - 0.5 * sqrt(2.0)) < 2e-3, "%.4f", sample(&o, 512, 0));
+    bench_check("pan_centre", fabs(sample(&o, 4000, 0) - 0.5) < 1e-3 && fabs(sample(&o, 4000, 1) - 0.5) < 1e-3, "%.4f", sample(&o, 4000, 1));
+    //? The move from left to centre is spread over ~5 ms: no frame jumps by more than a small step
+    double largest = 0.0;
+    for (size_t i = 1; i < 4800; ++i) largest = fmax(largest, fabs(sample(&o, i, 1) - sample(&o, i - 1, 1)));
+    bench_check("gain_change_smoothed", largest < 0.01, "%.4f", largest);
+    offline_close(&o);
+
+    //* Lowpass at 500 Hz: 100 Hz goes through, 10 kHz is down by well over 20 dB
+    if (!offline_open(&o, 19200)) exit(EXIT_FAILURE);
+    mixer_voice_t low = mixer_play(o.mixer, &tone_low, 1.0f, -1.0f, true);
+    mixer_voice_t high = mixer_play(o.mixer, &tone_high, 1.0f, 1.0f, true);
+    audio_offline_render(o.backend, 9600);
+    mixer_set_filter(o.mixer, low, 500.0f);
+    mixer_set_filter(o.mixer, high, 500.0f);
+    audio_offline_render(o.backend, 9600);
+    double pass = rms(&o, 9600 + 4800, 19200, 0) / rms(&o, 4800, 9600, 0);
+    double stop = rms(&o, 9600 + 4800, 19200, 1) / rms(&o, 4800, 9600, 1);
+    bench_check("filter_passband_db", 20.0 * log10(pass) > -1.0, "%.4f", 20.0 * log10(pass));
+    bench_check("filter_stopband_db", 20.0 * log10(stop) < -20.0, "%.4f", 20.0 * log10(stop));
+    offline_close(&o);
+
+    //* The sounds' samples are still what they were: everything happened on the way to the bus
+    bench_check("source_untouched", ((int16_t*)dc.data)[100] == 16383, "%.4f", (double)((int16_t*)dc.data)[100]);
+    wav_free_file(&dc);
+    wav_free_file(&tone_low);
+    wav_free_file(&tone_high);
+}
+
+static void run_bench(size_t count) {
+    static const char* modes[] = { "steady", "fading", "fading+filter" };
+    wav_file_t sounds[2];
+    if (!bench_make_tone(&sounds[0], 1, BENCH_RATE, BENCH_SOUND_FRAMES, 220.0, 0.25)
+        || !bench_make_tone(&sounds[1], 2, BENCH_RATE, BENCH_SOUND_FRAMES, 330.0, 0.25)) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    const size_t blocks = 2000;
+    int16_t* out = (int16_t*)malloc(BENCH_BLOCK * 2 * sizeof(int16_t));
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("\nvoices,isa,mode,us_per_block\n");
+    for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+        wav_convert_set_isa((wav_isa_t)isa);
+        for (int mode = 0; mode < 3; ++mode) {
+            mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, (uint32_t)count, 4096, MIXER_STEAL_NONE };
+            mixer_t* mixer = mixer_init(&config);
+            if (!mixer || !out) exit(EXIT_FAILURE);
+            for (size_t i = 0; i < count; ++i) {
+                mixer_voice_t v = mixer_play(mixer, &sounds[i & 1], 1.0f / (float)count, (float)(i % 7) / 3.0f - 1.0f, true);
+                //? Longer than the run, so every block is a ramp
+                if (mode >= 1) mixer_fade(mixer, v, 0.0f, (uint32_t)(blocks * 2 * BENCH_BLOCK), (mixer_fade_curve_t)(i & 1), false);
+                if (mode == 2) mixer_set_filter(mixer, v, 2000.0f);
+            }
+            mixer_render(mixer, out, BENCH_BLOCK);
+            uint64_t start = audio_clock_ns();
+            for (size_t b = 0; b < blocks; ++b) mixer_render(mixer, out, BENCH_BLOCK);
+            double us = (double)(audio_clock_ns() - start) / 1e3 / (double)blocks;
+            printf("%zu,%s,%s,%.3f\n", count, wav_isa_name((wav_isa_t)isa), modes[mode], us);
+            mixer_free(mixer);
+        }
+    }
+    wav_convert_set_isa(best);
+    free(out);
+    wav_free_file(&sounds[0]);
+    wav_free_file(&sounds[1]);
+}
+
+int main(int argc, char const *argv[])
+{
+    long voices = (argc > 1) ? atol(argv[1]) : 64;
+    if (voices <= 0) voices = 64;
+    run_checks();
+    run_bench((size_t)voices);
+    return bench_status();
+}
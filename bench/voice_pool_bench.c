@@ -0,0 +1,211 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Trigger latency and voice stealing with an exhausted voice pool.
+ *
+ *   voice_pool_bench [seconds_per_policy] [trigger_threads]
+ *
+ * A 64 voice mixer renders through the null backend in realtime mode (a 48 kHz
+ * device with 5 ms blocks) while trigger threads fire short one-shots with random
+ * priorities and gains as fast as they can, so the pool is full nearly all the
+ * time and every policy has to pick a victim or drop the sound.
+ *
+ * trigger_ns is the time one mixer_play_ex() call takes: claiming a free slot or
+ * stealing one, never waiting on the audio thread. start_ms is how long a trigger
+ * waits before the audio thread actually starts the voice (at most one block).
+ * Every voice is counted through mixer_voice_params_t::counter: once the triggers
+ * stop the count has to match the active voices, and mixer_stop_counted() has to
+ * bring it to 0 (counted_ok), stolen voices included.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/voice_pool_bench.c audio/mixer.c audio/audio_latency.c audio/audio_stream.c \
+ *       audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o voice_pool_bench
+ */
+
+#include "mixer.h"
+#include <math.h>
+#include <pthread.h>
+
+#define BENCH_RATE 48000
+#define BENCH_BLOCK 240
+#define BENCH_VOICES 64
+#define BENCH_SOUND_FRAMES (BENCH_RATE / 4)
+#define BENCH_MAX_THREADS 16
+#define BENCH_SAMPLES 4096      //? trigger timings kept per thread for the percentiles
+
+typedef struct trigger_t {
+    mixer_t* mixer;
+    const wav_file_t* sound;
+    atomic_bool* running;
+    atomic_uint* counter;
+    uint32_t seed;
+    uint64_t triggers;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t samples[BENCH_SAMPLES];
+    size_t sample_count;
+} trigger_t;
+
+static uint32_t next_random(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void* trigger_thread(void* arg) {
+    trigger_t* t = (trigger_t*)arg;
+    while (atomic_load_explicit(t->running, memory_order_relaxed)) {
+        uint32_t r = next_random(&t->seed);
+        mixer_voice_params_t params = { 0.05f + (float)(r & 0xFF) / 512.0f, 0.0f, false, (uint8_t)((r >> 8) & 0xFF), NULL, 0, 0, 0, 0, t->counter };
+        uint64_t start = audio_clock_ns();
+        mixer_play_ex(t->mixer, t->sound, &params);
+        uint64_t elapsed = audio_clock_ns() - start;
+        t->total_ns += elapsed;
+        if (elapsed > t->max_ns) t->max_ns = elapsed;
+        t->samples[t->triggers % BENCH_SAMPLES] = elapsed;
+        if (t->sample_count < BENCH_SAMPLES) ++t->sample_count;
+        ++t->triggers;
+        //? a burst of triggers every 100 us, like a busy game frame
+        if ((t->triggers & 7) == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+    }
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+//? Time from a trigger on an otherwise idle mixer to the audio thread picking the voice up
+static double measure_start_ms(mixer_t* mixer, const wav_file_t* sound) {
+    mixer_stats_t stats;
+    mixer_get_stats(mixer, &stats);
+    const uint64_t before = stats.voices_started;
+    uint64_t start = audio_clock_ns();
+    if (mixer_play(mixer, sound, 0.1f, 0.0f, false) == MIXER_INVALID_VOICE) return -1.0;
+    do {
+        audio_sleep_until(audio_clock_ns() + 50000ull);
+        mixer_get_stats(mixer, &stats);
+    } while (stats.voices_started == before);
+    return (double)(audio_clock_ns() - start) / 1e6;
+}
+
+int main(int argc, char const *argv[])
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+    int threads = (argc > 2) ? atoi(argv[2]) : 4;
+    if (seconds <= 0.0) seconds = 2.0;
+    if (threads < 1 || threads > BENCH_MAX_THREADS) threads = 4;
+
+    wav_file_t sound;
+    memset(&sound, 0, sizeof(sound));
+    sound.header.format_type = 1;
+    sound.header.encoding = 1;
+    sound.header.num_channels = 1;
+    sound.header.sample_rate = BENCH_RATE;
+    sound.header.bits_per_sample = 16;
+    sound.header.block_align = 2;
+    sound.header.byte_rate = BENCH_RATE * 2;
+    sound.samples = BENCH_SOUND_FRAMES;
+    sound.data_length = BENCH_SOUND_FRAMES * 2;
+    sound.data = (uint8_t*)malloc((size_t)sound.data_length);
+    trigger_t* triggers = (trigger_t*)calloc((size_t)threads, sizeof(trigger_t));
+    if (!sound.data || !triggers) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < BENCH_SOUND_FRAMES; ++i) {
+        ((int16_t*)sound.data)[i] = (int16_t)(8000.0 * sin(2.0 * 3.14159265358979 * 880.0 * i / BENCH_RATE));
+    }
+
+    static const mixer_steal_policy_t policies[] = { MIXER_STEAL_NONE, MIXER_STEAL_OLDEST, MIXER_STEAL_QUIETEST, MIXER_STEAL_LOWEST_PRIORITY };
+    static const char* policy_names[] = { "none", "oldest", "quietest", "lowest_priority" };
+    printf("policy,threads,triggers,started,stolen,dropped,trigger_avg_ns,trigger_p99_ns,trigger_max_ns,start_ms,underruns,counted_ok\n");
+    int status = EXIT_SUCCESS;
+    for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); ++p) {
+        mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, BENCH_VOICES, 1024, policies[p] };
+        mixer_t* mixer = mixer_init(&config);
+        audio_config_t backend_config = { BENCH_RATE, 2, BENCH_BLOCK, mixer_render, mixer, NULL };
+        audio_backend_t* backend = mixer ? audio_null_backend_init(&backend_config, true) : NULL;
+        if (!backend || !audio_backend_start(backend)) return EXIT_FAILURE;
+        double start_ms = measure_start_ms(mixer, &sound);
+
+        atomic_bool running;
+        atomic_init(&running, true);
+        atomic_uint counter;
+        atomic_init(&counter, 0);
+        pthread_t ids[BENCH_MAX_THREADS];
+        for (int i = 0; i < threads; ++i) {
+            memset(&triggers[i], 0, sizeof(trigger_t));
+            triggers[i].mixer = mixer;
+            triggers[i].sound = &sound;
+            triggers[i].running = &running;
+            triggers[i].counter = &counter;
+            triggers[i].seed = 0x9E3779B9u * (uint32_t)(i + 1);
+            pthread_create(&ids[i], NULL, trigger_thread, &triggers[i]);
+        }
+        audio_sleep_until(audio_clock_ns() + (uint64_t)(seconds * 1e9));
+        atomic_store(&running, false);
+        uint64_t count = 0, total_ns = 0, max_ns = 0;
+        size_t sample_count = 0;
+        uint64_t* samples = (uint64_t*)malloc((size_t)threads * BENCH_SAMPLES * sizeof(uint64_t));
+        for (int i = 0; i < threads; ++i) {
+            pthread_join(ids[i], NULL);
+            count += triggers[i].triggers;
+            total_ns += triggers[i].total_ns;
+            if (triggers[i].max_ns > max_ns) max_ns = triggers[i].max_ns;
+            if (samples) {
+                memcpy(samples + sample_count, triggers[i].samples, triggers[i].sample_count * sizeof(uint64_t));
+                sample_count += triggers[i].sample_count;
+            }
+        }
+        uint64_t p99 = 0;
+        if (samples && sample_count > 0) {
+            qsort(samples, sample_count, sizeof(uint64_t), compare_u64);
+            p99 = samples[(sample_count * 99) / 100];
+        }
+        free(samples);
+        audio_backend_stop(backend);
+
+        //* The backend is stopped, so this thread is the audio thread now: one block starts whatever is pending
+        int16_t* block = (int16_t*)malloc(BENCH_BLOCK * 2 * sizeof(int16_t));
+        mixer_stats_t stats;
+        bool counted_ok = block != NULL;
+        if (block) {
+            mixer_render(mixer, block, BENCH_BLOCK);
+            mixer_get_stats(mixer, &stats);
+            counted_ok = atomic_load(&counter) == stats.active_voices;
+            mixer_stop_counted(mixer, &counter);
+            mixer_render(mixer, block, BENCH_BLOCK);
+            counted_ok = counted_ok && atomic_load(&counter) == 0;
+        }
+        free(block);
+        if (!counted_ok) status = EXIT_FAILURE;
+        mixer_get_stats(mixer, &stats);
+        printf("%s,%d,%llu,%llu,%llu,%llu,%.0f,%llu,%llu,%.2f,%llu,%s\n", policy_names[p], threads, (unsigned long long)count,
+            (unsigned long long)stats.voices_started, (unsigned long long)stats.voices_stolen, (unsigned long long)stats.plays_dropped,
+            count ? (double)total_ns / (double)count : 0.0, (unsigned long long)p99, (unsigned long long)max_ns, start_ms,
+            (unsigned long long)audio_backend_underruns(backend), counted_ok ? "ok" : "FAIL");
+        audio_backend_free(backend);
+        mixer_free(mixer);
+    }
+    free(triggers);
+    free(sound.data);
+    return status;
+}
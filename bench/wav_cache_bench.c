@@ -0,0 +1,143 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Cost of loading a sound per trigger, with and without the asset cache.
+ *
+ *   wav_cache_bench [threads] [scratch_dir]
+ *
+ * Writes 64 short effects (0.25 s, stereo 16-bit) into `scratch_dir`, then every
+ * thread triggers random effects: `parse` calls wav_parse_file()/wav_free_file()
+ * per trigger like sound_init did, `cache` does a wav_cache_acquire()/release()
+ * pair. A second cache run uses a budget of a quarter of the effects to show the
+ * LRU at work. Parser log lines are discarded.
+ *
+ * Build:
+ *   gcc -O2 -Iwav_parser -Iutils bench/wav_cache_bench.c bench/bench_util.c wav_parser/wav_cache.c wav_parser/wav_parser.c \
+ *       wav_parser/wav_writer.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_cache_bench
+ */
+
+#include "wav_cache.h"
+#include "bench_util.h"
+#include "log.h"
+#include <pthread.h>
+#include <time.h>
+
+#define BENCH_FILES 64
+#define BENCH_FRAMES 11025
+#define BENCH_TRIGGERS 4000
+#define BENCH_MAX_THREADS 64
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+typedef struct worker_t {
+    wav_cache_t* cache;         //? NULL: parse every time
+    char (*paths)[512];
+    unsigned seed;
+    size_t failures;
+    pthread_t thread;
+} worker_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//? A counter per effect, stepping by the effect's index + 1 from sample to sample
+static void fill_effect(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    const unsigned step = *(const unsigned*)user + 1;
+    for (uint16_t c = 0; c < channels; ++c) samples[c] = (int16_t)(uint16_t)((frame * channels + c) * step);
+}
+
+static void* worker_run(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    for (size_t i = 0; i < BENCH_TRIGGERS; ++i) {
+        worker->seed = worker->seed * 1103515245u + 12345u;
+        const char* path = worker->paths[(worker->seed >> 16) % BENCH_FILES];
+        if (worker->cache) {
+            wav_asset_t* asset = wav_cache_acquire(worker->cache, path);
+            if (!asset) ++worker->failures;
+            wav_asset_release(asset);
+        } else {
+            wav_file_t file;
+            wav_init_file(&file);
+            if (!wav_parse_file(path, &file)) ++worker->failures;
+            wav_free_file(&file);
+        }
+    }
+    return NULL;
+}
+
+static double run(wav_cache_t* cache, char (*paths)[512], unsigned threads) {
+    worker_t workers[BENCH_MAX_THREADS];
+    double start = now_seconds();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers[t] = (worker_t){ cache, paths, 1234u + t, 0, 0 };
+        pthread_create(&workers[t].thread, NULL, worker_run, &workers[t]);
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        pthread_join(workers[t].thread, NULL);
+        if (workers[t].failures) fprintf(stderr, "%zu failed loads\n", workers[t].failures);
+    }
+    return now_seconds() - start;
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned threads = (argc > 1) ? (unsigned)atoi(argv[1]) : 4;
+    const char* dir = (argc > 2) ? argv[2] : ".";
+    if (threads == 0 || threads > BENCH_MAX_THREADS) threads = 4;
+
+    static char paths[BENCH_FILES][512];
+    for (unsigned i = 0; i < BENCH_FILES; ++i) {
+        snprintf(paths[i], sizeof(paths[i]), "%s/wav_cache_bench_%02u.wav", dir, i);
+        if (!bench_write_wav(paths[i], 2, 44100, BENCH_FRAMES, fill_effect, &i)) {
+            fprintf(stderr, "unable to write %s\n", paths[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    FILE* sink = fopen(NULL_DEVICE, "w");
+    LogSetOutput(sink);
+
+    const double triggers = (double)BENCH_TRIGGERS * threads;
+    printf("mode,threads,triggers,ns_per_trigger,hits,misses,evictions,resident_kb\n");
+
+    double seconds = run(NULL, paths, threads);
+    printf("parse,%u,%.0f,%.0f,0,%.0f,0,0\n", threads, triggers, seconds * 1e9 / triggers, triggers);
+
+    static const uint64_t budgets[] = { BENCH_FILES * BENCH_FRAMES * 4, BENCH_FILES / 4 * BENCH_FRAMES * 4 };
+    for (size_t b = 0; b < 2; ++b) {
+        wav_cache_t* cache = wav_cache_init(budgets[b]);
+        if (!cache) return EXIT_FAILURE;
+        seconds = run(cache, paths, threads);
+        wav_cache_stats_t stats;
+        wav_cache_get_stats(cache, &stats);
+        printf("cache_%llukb,%u,%.0f,%.0f,%llu,%llu,%llu,%llu\n", (unsigned long long)(budgets[b] / 1024), threads, triggers,
+            seconds * 1e9 / triggers, (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+            (unsigned long long)stats.evictions, (unsigned long long)(stats.bytes / 1024));
+        wav_cache_free(cache);
+    }
+
+    LogSetOutput(NULL);
+    if (sink) fclose(sink);
+    for (unsigned i = 0; i < BENCH_FILES; ++i) remove(paths[i]);
+    return 0;
+}
@@ -0,0 +1,462 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+/**
+ * Compressed playback: checks of the IMA ADPCM and G.711 decoders, then their throughput
+ * against the 16-bit PCM path.
+ *
+ *   wav_codec_bench [seconds_of_audio]
+ *
+ * A stereo test signal is encoded to IMA ADPCM by a reference encoder in this file,
+ * wrapped in a RIFF image (last block cut short, as files often end) and loaded with
+ * wav_parse_memory(). The checks compare the library's decode with a plain reference
+ * decoder, random-access and chunked decodes with the whole-file one, mixer and stream
+ * playback of the compressed sound with playback of its PCM expansion (they must be
+ * identical, loops and seeks included), and the SIMD G.711 kernels with the tables for
+ * all 256 codes.
+ *
+ * The benchmark decodes the same audio from each format to float in 256 frame chunks,
+ * the way the mixer pulls it, per ISA. src_mb_per_s is compressed bytes consumed,
+ * bytes_per_s_audio what one second of the sound occupies in memory.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/wav_codec_bench.c bench/bench_util.c audio/mixer.c audio/audio_latency.c \
+ *       audio/audio_stream.c audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_codec_bench
+ */
+
+#include "mixer.h"
+#include "wav_codec.h"
+#include "wav_writer.h"
+#include "bench_util.h"
+#include <math.h>
+
+#define BENCH_RATE 48000
+#define BENCH_CHANNELS 2
+#define BENCH_BLOCK 256
+#define BENCH_BLOCK_ALIGN 1024      //? 1017 frames per block in stereo
+#define BENCH_CHECK_FRAMES 49994     //? 49 full blocks and a short one of 161 frames
+#define BENCH_MIN_SECONDS 0.25
+
+static const int32_t ima_steps[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+    5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767
+};
+static const int32_t ima_moves[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static double now_seconds(void) {
+    return (double)audio_clock_ns() / 1e9;
+}
+
+static size_t compare_s16(const int16_t* a, const int16_t* b, size_t n, size_t* first) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i] && mismatches++ == 0) *first = i;
+    }
+    return mismatches;
+}
+
+//=================================================REFERENCE CODEC==========================================================
+
+static int32_t clamp_s16(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+static int32_t clamp_index(int32_t v) {
+    return v > 88 ? 88 : (v < 0 ? 0 : v);
+}
+
+//? The reference shift-and-add step, the decoder in the library has to agree with it bit for bit
+static void ima_step(uint8_t nibble, int32_t* predictor, int32_t* index) {
+    const int32_t step = ima_steps[*index];
+    int32_t delta = step >> 3;
+    if (nibble & 4) delta += step;
+    if (nibble & 2) delta += step >> 1;
+    if (nibble & 1) delta += step >> 2;
+    *predictor = clamp_s16(*predictor + ((nibble & 8) ? -delta : delta));
+    *index = clamp_index(*index + ima_moves[nibble & 7]);
+}
+
+static uint8_t ima_encode(int32_t sample, int32_t* predictor, int32_t* index) {
+    int32_t step = ima_steps[*index];
+    int32_t diff = sample - *predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    for (uint8_t bit = 4; bit > 0; bit >>= 1, step >>= 1) {
+        if (diff >= step) {
+            nibble |= bit;
+            diff -= step;
+        }
+    }
+    ima_step(nibble, predictor, index);
+    return nibble;
+}
+
+/**
+ * Encodes `frames` interleaved frames into a RIFF/WAVE image of IMA ADPCM blocks. `frames`
+ * must end on whole 8-sample groups, the last block may be short.
+ */
+static uint8_t* encode_image(const int16_t* pcm, size_t frames, size_t* image_size) {
+    const uint16_t channels = BENCH_CHANNELS;
+    const uint32_t per_block = (BENCH_BLOCK_ALIGN - 4 * channels) * 2 / channels + 1;
+    const size_t full = frames / per_block;
+    const size_t rest = frames % per_block;
+    const size_t data_size = full * BENCH_BLOCK_ALIGN + (rest ? 4 * channels + (rest - 1) / 8 * 4 * channels : 0);
+    *image_size = 12 + 8 + 20 + 8 + data_size + (data_size & 1);
+    uint8_t* image = (uint8_t*)calloc(1, *image_size);
+    if (!image) return NULL;
+    uint8_t* p = image;
+    uint32_t fields[] = { (uint32_t)(*image_size - 8), 20, (uint32_t)data_size };
+    memcpy(p, "RIFF", 4); memcpy(p + 4, &fields[0], 4); memcpy(p + 8, "WAVEfmt ", 8); memcpy(p + 16, &fields[1], 4);
+    const uint16_t fmt16[] = { WAV_FORMAT_IMA_ADPCM, channels };
+    const uint32_t rates[] = { BENCH_RATE, BENCH_RATE * BENCH_BLOCK_ALIGN / per_block };
+    const uint16_t fmt_tail[] = { BENCH_BLOCK_ALIGN, 4, 2, (uint16_t)per_block };
+    memcpy(p + 20, fmt16, 4); memcpy(p + 24, rates, 8); memcpy(p + 32, fmt_tail, 8);
+    memcpy(p + 40, "data", 4); memcpy(p + 44, &fields[2], 4);
+
+    uint8_t* data = p + 48;
+    int32_t predictor[BENCH_CHANNELS], index[BENCH_CHANNELS] = { 0 };
+    for (size_t start = 0; start < frames; start += per_block, data += BENCH_BLOCK_ALIGN) {
+        const size_t n = (frames - start < per_block) ? frames - start : per_block;
+        for (uint16_t c = 0; c < channels; ++c) {
+            predictor[c] = pcm[start * channels + c];
+            data[4 * c] = (uint8_t)(predictor[c] & 0xFF);
+            data[4 * c + 1] = (uint8_t)((predictor[c] >> 8) & 0xFF);
+            data[4 * c + 2] = (uint8_t)index[c];
+        }
+        for (size_t k = 0; k + 1 < n; ++k) {
+            for (uint16_t c = 0; c < channels; ++c) {
+                uint8_t nibble = ima_encode(pcm[(start + 1 + k) * channels + c], &predictor[c], &index[c]);
+                data[4 * channels + (k / 8) * 4 * channels + 4 * c + (k % 8) / 2] |= (uint8_t)((k & 1) ? nibble << 4 : nibble);
+            }
+        }
+    }
+    return image;
+}
+
+//? Plain block-by-block decode of a parsed ADPCM file, straight from the format description
+static void reference_decode(const wav_file_t* file, int16_t* out) {
+    const uint16_t channels = file->header.num_channels;
+    const uint32_t per_block = file->header.samples_per_block;
+    for (uint64_t start = 0; start < file->samples; start += per_block) {
+        const uint8_t* block = file->data + start / per_block * file->header.block_align;
+        const uint64_t n = (file->samples - start < per_block) ? file->samples - start : per_block;
+        for (uint16_t c = 0; c < channels; ++c) {
+            int32_t predictor = (int16_t)(block[4 * c] | (block[4 * c + 1] << 8));
+            int32_t index = clamp_index(block[4 * c + 2]);
+            out[start * channels + c] = (int16_t)predictor;
+            for (uint64_t k = 0; k + 1 < n; ++k) {
+                uint8_t byte = block[4 * channels + (k / 8) * 4 * channels + 4 * c + (k % 8) / 2];
+                ima_step((k & 1) ? byte >> 4 : byte & 0x0F, &predictor, &index);
+                out[(start + 1 + k) * channels + c] = (int16_t)predictor;
+            }
+        }
+    }
+}
+
+//? Two detuned tones with an envelope, so the step index moves over its whole range
+static void make_signal(int16_t* pcm, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        double t = (double)i / BENCH_RATE;
+        double envelope = 0.5 + 0.5 * sin(2.0 * 3.14159265358979 * 3.0 * t);
+        pcm[2 * i] = (int16_t)(20000.0 * envelope * sin(2.0 * 3.14159265358979 * 440.0 * t));
+        pcm[2 * i + 1] = (int16_t)(12000.0 * sin(2.0 * 3.14159265358979 * 1234.5 * t) + 3000.0 * sin(2.0 * 3.14159265358979 * 97.0 * t));
+    }
+}
+
+//=================================================CHECKS==========================================================
+
+//? Renders the same play/loop/seek sequence for `sound` through the offline backend
+static void render_sequence(const wav_file_t* sound, int16_t* out, size_t frames) {
+    mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, 8, 64, MIXER_STEAL_NONE };
+    mixer_t* mixer = mixer_init(&config);
+    audio_config_t backend_config = { BENCH_RATE, 2, BENCH_BLOCK, mixer_render, mixer, NULL };
+    audio_backend_t* backend = audio_offline_backend_init(&backend_config, out, frames);
+    if (!mixer || !backend) exit(EXIT_FAILURE);
+    //* A loop whose ends sit mid-block, a seek into another block, then a second voice from the middle
+    mixer_voice_params_t params = { 0.7f, -0.2f, true, MIXER_PRIORITY_NORMAL, NULL, 0, 0, 1500, 4321, NULL };
+    mixer_voice_t voice = mixer_play_ex(mixer, sound, &params);
+    audio_offline_render(backend, frames / 4);
+    mixer_seek(mixer, voice, 3000);
+    mixer_voice_params_t second = { 0.5f, 0.4f, false, MIXER_PRIORITY_NORMAL, NULL, 0, 20011, 0, 0, NULL };
+    mixer_play_ex(mixer, sound, &second);
+    audio_offline_render(backend, frames / 4);
+    mixer_set_loop(mixer, voice, false, 0, 0);
+    audio_offline_render(backend, frames - frames / 2);
+    audio_backend_free(backend);
+    mixer_free(mixer);
+}
+
+//? Pulls a whole stream through its feeder thread
+static size_t read_stream(const wav_file_t* file, float* out, size_t frames) {
+    audio_stream_t* stream = audio_stream_open_memory(file, BENCH_RATE, 0);
+    if (!stream || !audio_stream_start(stream, false)) exit(EXIT_FAILURE);
+    size_t got = 0;
+    while (got < frames && !audio_stream_finished(stream)) {
+        size_t n = audio_stream_read(stream, out + got * BENCH_CHANNELS, (frames - got < BENCH_BLOCK) ? frames - got : BENCH_BLOCK);
+        if (n == 0) audio_sleep_until(audio_clock_ns() + 200000ull);
+        got += n;
+    }
+    audio_stream_close(stream);
+    return got;
+}
+
+static void run_checks(const wav_file_t* adpcm, const int16_t* pcm) {
+    const size_t frames = (size_t)adpcm->samples;
+    const size_t samples = frames * BENCH_CHANNELS;
+    int16_t* expected = (int16_t*)malloc(samples * sizeof(int16_t));
+    int16_t* decoded = (int16_t*)malloc(samples * sizeof(int16_t));
+    if (!expected || !decoded) exit(EXIT_FAILURE);
+    size_t first = 0, mismatches;
+    //? Comparisons report their mismatches and first bad sample, the other checks the value they tested
+    bench_check_begin("mismatches_or_value,first_bad_sample");
+
+    bench_check("adpcm_parsed_frames", frames == BENCH_CHECK_FRAMES, "%zu,", frames);
+    reference_decode(adpcm, expected);
+    wav_adpcm_state_t state;
+    memset(&state, 0, sizeof(state));
+    size_t got = wav_adpcm_decode(adpcm, 0, frames, decoded, &state);
+    bench_check_mismatches("adpcm_whole_vs_reference", compare_s16(expected, decoded, samples, &first) + (got != frames), first);
+
+    //* The encoder and decoder track each other, so the error stays a fraction of the signal
+    double signal = 0.0, noise = 0.0;
+    for (size_t i = 0; i < samples; ++i) {
+        signal += (double)pcm[i] * pcm[i];
+        noise += (double)(pcm[i] - decoded[i]) * (pcm[i] - decoded[i]);
+    }
+    double snr = 10.0 * log10(signal / (noise + 1.0));
+    bench_check("adpcm_snr_above_25db", snr > 25.0, "%.1f,", snr);
+
+    //* Mixer-sized chunks carry the state across calls; odd ranges with a fresh state restart from a block header
+    memset(&state, 0, sizeof(state));
+    memset(decoded, 0, samples * sizeof(int16_t));
+    for (size_t at = 0; at < frames; at += BENCH_BLOCK) {
+        wav_adpcm_decode(adpcm, at, BENCH_BLOCK, decoded + at * BENCH_CHANNELS, &state);
+    }
+    bench_check_mismatches("adpcm_chunked", compare_s16(expected, decoded, samples, &first), first);
+    mismatches = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+        uint64_t at = (i * 2654435761u) % frames;
+        size_t n = 1 + (i * 40503u) % 3000;
+        int16_t range[3000 * BENCH_CHANNELS];
+        memset(&state, 0, sizeof(state));
+        got = wav_adpcm_decode(adpcm, at, n, range, &state);
+        if (got != ((frames - at < n) ? frames - at : n)) ++mismatches;
+        mismatches += compare_s16(expected + at * BENCH_CHANNELS, range, got * BENCH_CHANNELS, &first);
+    }
+    bench_check_mismatches("adpcm_random_access", mismatches, first);
+
+    //* Playing the compressed sound has to sound exactly like playing its expansion
+    wav_file_t expanded;
+    if (!wav_decode_file(adpcm, &expanded)) exit(EXIT_FAILURE);
+    bench_check_mismatches("adpcm_decode_file", compare_s16(expected, (const int16_t*)expanded.data, samples, &first) + (expanded.samples != frames), first);
+    int16_t* out_adpcm = (int16_t*)calloc(samples, sizeof(int16_t));
+    int16_t* out_pcm = (int16_t*)calloc(samples, sizeof(int16_t));
+    if (!out_adpcm || !out_pcm) exit(EXIT_FAILURE);
+    render_sequence(adpcm, out_adpcm, frames);
+    render_sequence(&expanded, out_pcm, frames);
+    bench_check_mismatches("mixer_adpcm_vs_pcm", compare_s16(out_pcm, out_adpcm, samples, &first), first);
+
+    float* stream_adpcm = (float*)calloc(samples, sizeof(float));
+    float* stream_pcm = (float*)calloc(samples, sizeof(float));
+    if (!stream_adpcm || !stream_pcm) exit(EXIT_FAILURE);
+    size_t frames_adpcm = read_stream(adpcm, stream_adpcm, frames);
+    size_t frames_pcm = read_stream(&expanded, stream_pcm, frames);
+    mismatches = (frames_adpcm != frames || frames_pcm != frames) ? 1 : 0;
+    for (size_t i = 0; i < samples; ++i) {
+        if (stream_adpcm[i] != stream_pcm[i] && mismatches++ == 0) first = i;
+    }
+    bench_check_mismatches("stream_adpcm_vs_pcm", mismatches, first);
+
+    //* G.711: every code, every ISA, against the scalar tables and a few levels from the spec
+    const wav_isa_t best = wav_convert_get_isa();
+    uint8_t codes[256 + 45];
+    for (size_t i = 0; i < sizeof(codes); ++i) codes[i] = (uint8_t)(i * 7 + 3);     //? all 256 codes, in vector-sized runs and a tail
+    mismatches = 0;
+    for (int format = WAV_SAMPLE_ULAW; format <= WAV_SAMPLE_ALAW; ++format) {
+        float table[sizeof(codes)], simd[sizeof(codes)];
+        wav_convert_set_isa(WAV_ISA_SCALAR);
+        wav_convert_to_float(table, codes, sizeof(codes), (wav_sample_format_t)format);
+        for (int isa = WAV_ISA_SSE2; isa <= (int)best; ++isa) {
+            wav_convert_set_isa((wav_isa_t)isa);
+            wav_convert_to_float(simd, codes, sizeof(codes), (wav_sample_format_t)format);
+            for (size_t i = 0; i < sizeof(codes); ++i) {
+                if (memcmp(&table[i], &simd[i], sizeof(float)) != 0 && mismatches++ == 0) first = i;
+            }
+        }
+    }
+    wav_convert_set_isa(best);
+    bench_check_mismatches("g711_simd_vs_table", mismatches, first);
+    static const uint8_t spec_codes[] = { 0x00, 0x80, 0xFF, 0x7F, 0x55, 0xD5, 0x2A, 0xAA };
+    static const int spec_levels[] = { -32124, 32124, 0, 0, -8, 8, -32256, 32256 };
+    mismatches = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        float level;
+        wav_convert_to_float(&level, &spec_codes[i], 1, (i < 4) ? WAV_SAMPLE_ULAW : WAV_SAMPLE_ALAW);
+        if (level * 32768.0f != (float)spec_levels[i] && mismatches++ == 0) first = i;
+    }
+    bench_check_mismatches("g711_spec_levels", mismatches, first);
+    //? Encoding a decoded level gives back a code for the same level
+    mismatches = 0;
+    for (int format = WAV_SAMPLE_ULAW; format <= WAV_SAMPLE_ALAW; ++format) {
+        float levels[256], again[256];
+        uint8_t all[256], encoded[256];
+        for (int i = 0; i < 256; ++i) all[i] = (uint8_t)i;
+        wav_convert_to_float(levels, all, 256, (wav_sample_format_t)format);
+        wav_convert_from_float(encoded, levels, 256, (wav_sample_format_t)format);
+        wav_convert_to_float(again, encoded, 256, (wav_sample_format_t)format);
+        for (int i = 0; i < 256; ++i) {
+            if (levels[i] != again[i] && mismatches++ == 0) first = (size_t)i;
+        }
+    }
+    bench_check_mismatches("g711_round_trip", mismatches, first);
+
+    free(stream_adpcm);
+    free(stream_pcm);
+    free(out_adpcm);
+    free(out_pcm);
+    wav_free_file(&expanded);
+    free(expected);
+    free(decoded);
+}
+
+//=================================================THROUGHPUT==========================================================
+
+typedef enum codec_t { CODEC_PCM16, CODEC_ULAW, CODEC_ALAW, CODEC_ADPCM } codec_t;
+
+//? One pass over the sound, decoded to float a mixer chunk at a time; returns the seconds it took
+static double decode_pass(codec_t codec, const wav_file_t* file, int16_t* decoded, float* chunk) {
+    const size_t channels = file->header.num_channels;
+    wav_adpcm_state_t state;
+    memset(&state, 0, sizeof(state));
+    double start = now_seconds();
+    for (uint64_t at = 0; at < file->samples; at += BENCH_BLOCK) {
+        size_t n = (file->samples - at < BENCH_BLOCK) ? (size_t)(file->samples - at) : BENCH_BLOCK;
+        switch (codec) {
+            case CODEC_PCM16:   wav_convert_to_float(chunk, file->data + at * file->header.block_align, n * channels, WAV_SAMPLE_S16); break;
+            case CODEC_ULAW:    wav_convert_to_float(chunk, file->data + at * file->header.block_align, n * channels, WAV_SAMPLE_ULAW); break;
+            case CODEC_ALAW:    wav_convert_to_float(chunk, file->data + at * file->header.block_align, n * channels, WAV_SAMPLE_ALAW); break;
+            case CODEC_ADPCM:
+                wav_adpcm_decode(file, at, n, decoded, &state);
+                wav_convert_to_float(chunk, decoded, n * channels, WAV_SAMPLE_S16);
+                break;
+        }
+    }
+    return now_seconds() - start;
+}
+
+static void run_bench(const wav_file_t* files[4], double audio_seconds) {
+    static const char* names[] = { "pcm16", "ulaw", "alaw", "ima_adpcm" };
+    int16_t decoded[BENCH_BLOCK * BENCH_CHANNELS];
+    float chunk[BENCH_BLOCK * BENCH_CHANNELS];
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("codec,isa,seconds_of_audio,msamples_per_s,src_mb_per_s,realtime_x,bytes_per_s_audio\n");
+    for (int codec = CODEC_PCM16; codec <= CODEC_ADPCM; ++codec) {
+        const wav_file_t* file = files[codec];
+        for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+            wav_convert_set_isa((wav_isa_t)isa);
+            double seconds = 0.0;
+            size_t passes = 0;
+            do {
+                seconds += decode_pass((codec_t)codec, file, decoded, chunk);
+                ++passes;
+            } while (seconds < BENCH_MIN_SECONDS);
+            seconds /= (double)passes;
+            const double samples = (double)file->samples * file->header.num_channels;
+            printf("%s,%s,%.1f,%.1f,%.1f,%.0f,%.0f\n", names[codec], wav_isa_name((wav_isa_t)isa), audio_seconds,
+                samples / seconds / 1e6, (double)file->data_length / seconds / 1e6, audio_seconds / seconds,
+                (double)file->data_length / audio_seconds);
+        }
+    }
+    wav_convert_set_isa(best);
+
+    //* Expanding whole files at load time instead
+    printf("codec,whole_file_decode_ms,decoded_mb_per_s\n");
+    for (int codec = CODEC_ULAW; codec <= CODEC_ADPCM; ++codec) {
+        wav_file_t out;
+        double start = now_seconds();
+        if (!wav_decode_file(files[codec], &out)) exit(EXIT_FAILURE);
+        double seconds = now_seconds() - start;
+        printf("%s,%.2f,%.1f\n", names[codec], seconds * 1e3, (double)out.data_length / seconds / 1e6);
+        wav_free_file(&out);
+    }
+}
+
+//? A PCM header for `frames` frames of `data` in `encoding`
+static void wrap_samples(wav_file_t* file, uint16_t encoding, uint16_t bits, uint8_t* data, uint64_t frames) {
+    wav_init_file(file);
+    wav_init_header(&file->header, encoding, BENCH_CHANNELS, BENCH_RATE, bits);
+    file->data = data;
+    file->samples = frames;
+    file->data_length = frames * file->header.block_align;
+    file->header.data_size = file->data_length;
+    file->owner = WAV_DATA_BORROWED;
+}
+
+int main(int argc, char const *argv[])
+{
+    double audio_seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+    if (audio_seconds <= 0.0) audio_seconds = 10.0;
+
+    int16_t* check_pcm = (int16_t*)malloc(BENCH_CHECK_FRAMES * BENCH_CHANNELS * sizeof(int16_t));
+    if (!check_pcm) return EXIT_FAILURE;
+    make_signal(check_pcm, BENCH_CHECK_FRAMES);
+    size_t image_size;
+    uint8_t* image = encode_image(check_pcm, BENCH_CHECK_FRAMES, &image_size);
+    wav_file_t adpcm;
+    wav_init_file(&adpcm);
+    if (!image || !wav_parse_memory(image, image_size, &adpcm, false)) return EXIT_FAILURE;
+    run_checks(&adpcm, check_pcm);
+    free(image);
+    free(check_pcm);
+
+    //* The same audio in every format, rounded to whole ADPCM blocks
+    const size_t per_block = (BENCH_BLOCK_ALIGN - 4 * BENCH_CHANNELS) * 2 / BENCH_CHANNELS + 1;
+    size_t blocks = (size_t)(audio_seconds * BENCH_RATE) / per_block;
+    size_t frames = (blocks ? blocks : 1) * per_block;
+    int16_t* pcm = (int16_t*)malloc(frames * BENCH_CHANNELS * sizeof(int16_t));
+    float* levels = (float*)malloc(frames * BENCH_CHANNELS * sizeof(float));
+    uint8_t* ulaw = (uint8_t*)malloc(frames * BENCH_CHANNELS);
+    uint8_t* alaw = (uint8_t*)malloc(frames * BENCH_CHANNELS);
+    if (!pcm || !levels || !ulaw || !alaw) return EXIT_FAILURE;
+    make_signal(pcm, frames);
+    wav_convert_to_float(levels, pcm, frames * BENCH_CHANNELS, WAV_SAMPLE_S16);
+    wav_convert_from_float(ulaw, levels, frames * BENCH_CHANNELS, WAV_SAMPLE_ULAW);
+    wav_convert_from_float(alaw, levels, frames * BENCH_CHANNELS, WAV_SAMPLE_ALAW);
+    image = encode_image(pcm, frames, &image_size);
+    wav_file_t files[4];
+    wrap_samples(&files[CODEC_PCM16], WAV_FORMAT_PCM, 16, (uint8_t*)pcm, frames);
+    wrap_samples(&files[CODEC_ULAW], WAV_FORMAT_MULAW, 8, ulaw, frames);
+    wrap_samples(&files[CODEC_ALAW], WAV_FORMAT_ALAW, 8, alaw, frames);
+    wav_init_file(&files[CODEC_ADPCM]);
+    if (!image || !wav_parse_memory(image, image_size, &files[CODEC_ADPCM], false)) return EXIT_FAILURE;
+    const wav_file_t* all[4] = { &files[0], &files[1], &files[2], &files[3] };
+    run_bench(all, (double)frames / BENCH_RATE);
+
+    free(image);
+    free(pcm);
+    free(levels);
+    free(ulaw);
+    free(alaw);
+    return bench_status();
+}
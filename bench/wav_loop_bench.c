@@ -0,0 +1,181 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+/**
+ * Gapless looping and instant restart: checks through the offline backend, then the cost of looping.
+ *
+ *   wav_loop_bench [voices]
+ *
+ * The test sound's samples count up, so every output sample says which source frame
+ * it is. The checks render voices looping over a range, a loop released mid-play,
+ * a restart and a looping stream, and compare the output frame by frame with the
+ * sequence a seamless loop produces: any gap, repeated or dropped frame is a mismatch.
+ * The renders are synchronous, so the commands land on known blocks. Then N voices
+ * are mixed with no loop and with a 64 frame loop (four wraps per 256 frame block),
+ * per ISA; us_per_block is the CPU time of one block.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/wav_loop_bench.c bench/bench_util.c audio/mixer.c audio/audio_latency.c \
+ *       audio/audio_stream.c audio/spsc_ring.c audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_loop_bench
+ */
+
+#include "mixer.h"
+#include "bench_util.h"
+#include <math.h>
+
+#define BENCH_RATE 48000
+#define BENCH_BLOCK 256
+#define BENCH_SOUND_FRAMES 30000
+#define BENCH_RENDER_FRAMES 20000
+#define BENCH_OFFSET 15000          //? sample value of frame i is i - BENCH_OFFSET
+
+//? Mono ramp: frame i holds i - BENCH_OFFSET, so the output can be read back as source frames
+static void fill_ramp(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    (void)user; (void)channels;
+    samples[0] = (int16_t)((int64_t)frame - BENCH_OFFSET);
+}
+
+//? Source frame a seamless loop over [start, end) plays after `frame`
+static int64_t next_frame(int64_t frame, int64_t start, int64_t end) {
+    return (frame + 1 == end) ? start : frame + 1;
+}
+
+//? Compares rendered frames [from, to) with the loop sequence that starts at source frame `expect`
+static size_t compare(const int16_t* out, size_t from, size_t to, int64_t expect, int64_t start, int64_t end, size_t* first) {
+    size_t mismatches = 0;
+    for (size_t i = from; i < to; ++i, expect = next_frame(expect, start, end)) {
+        if (out[i] != (int16_t)(expect - BENCH_OFFSET) && mismatches++ == 0) *first = i;
+    }
+    return mismatches;
+}
+
+static void run_checks(const wav_file_t* sound) {
+    int16_t* out = (int16_t*)calloc(BENCH_RENDER_FRAMES, sizeof(int16_t));
+    mixer_config_t config = { BENCH_RATE, 1, BENCH_BLOCK, 16, 256, MIXER_STEAL_NONE };
+    audio_config_t backend_config = { BENCH_RATE, 1, BENCH_BLOCK, mixer_render, NULL, NULL };
+    size_t first = 0, mismatches;
+    bench_check_begin("mismatches,first_bad_frame");
+
+    //* Loop over [1000, 3000) from the start: 0..2999, then 1000..2999 over and over
+    mixer_t* mixer = mixer_init(&config);
+    backend_config.user = mixer;
+    audio_backend_t* backend = audio_offline_backend_init(&backend_config, out, BENCH_RENDER_FRAMES);
+    if (!mixer || !out || !backend) exit(EXIT_FAILURE);
+    mixer_voice_params_t params = { 1.0f, 0.0f, true, MIXER_PRIORITY_NORMAL, NULL, 0, 0, 1000, 3000, NULL };
+    mixer_voice_t voice = mixer_play_ex(mixer, sound, &params);
+    audio_offline_render(backend, BENCH_RENDER_FRAMES);
+    bench_check_mismatches("voice_loop_range", compare(out, 0, BENCH_RENDER_FRAMES, 0, 1000, 3000, &first), first);
+    audio_backend_free(backend);
+    mixer_free(mixer);
+
+    //* Released mid-loop: the voice runs on past the loop end to the end of the sound and stops
+    int16_t* tail = (int16_t*)calloc(BENCH_SOUND_FRAMES + 4096, sizeof(int16_t));
+    mixer = mixer_init(&config);
+    backend_config.user = mixer;
+    backend = audio_offline_backend_init(&backend_config, tail, BENCH_SOUND_FRAMES + 4096);
+    if (!mixer || !tail || !backend) exit(EXIT_FAILURE);
+    voice = mixer_play_ex(mixer, sound, &params);
+    audio_offline_render(backend, 4096);          //? 0..2999, then 1000..2095
+    mixer_set_loop(mixer, voice, false, 0, 0);
+    audio_offline_render(backend, BENCH_SOUND_FRAMES);
+    mismatches = compare(tail, 0, 4096, 0, 1000, 3000, &first);
+    mismatches += compare(tail, 4096, 4096 + BENCH_SOUND_FRAMES - 2096, 2096, 0, BENCH_SOUND_FRAMES + 1, &first);
+    bench_check_mismatches("loop_release_plays_out", mismatches, first);
+    bench_check_mismatches("loop_release_ends", mixer_voice_playing(mixer, voice) ? 1 : 0, 0);
+    audio_backend_free(backend);
+    mixer_free(mixer);
+    free(tail);
+
+    //* Restart at a block boundary: frame 0 comes right after the last frame before it, no silence in between
+    memset(out, 0, BENCH_RENDER_FRAMES * sizeof(int16_t));
+    mixer = mixer_init(&config);
+    backend_config.user = mixer;
+    backend = audio_offline_backend_init(&backend_config, out, BENCH_RENDER_FRAMES);
+    if (!mixer || !backend) exit(EXIT_FAILURE);
+    voice = mixer_play(mixer, sound, 1.0f, 0.0f, false);
+    audio_offline_render(backend, 5120);
+    mixer_seek(mixer, voice, 0);
+    audio_offline_render(backend, BENCH_RENDER_FRAMES - 5120);
+    mismatches = compare(out, 0, 5120, 0, 0, BENCH_SOUND_FRAMES + 1, &first);
+    mismatches += compare(out, 5120, BENCH_RENDER_FRAMES, 0, 0, BENCH_SOUND_FRAMES + 1, &first);
+    bench_check_mismatches("restart_no_gap", mismatches, first);
+    audio_backend_free(backend);
+    mixer_free(mixer);
+
+    //* Stream looping over the same range, pulled straight from the ring
+    float* pulled = (float*)malloc(BENCH_RENDER_FRAMES * sizeof(float));
+    audio_stream_t* stream = audio_stream_open_memory(sound, BENCH_RATE, 4096);
+    if (!pulled || !stream) exit(EXIT_FAILURE);
+    audio_stream_set_loop(stream, true, 1000, 3000);
+    audio_stream_start(stream, true);
+    for (size_t got = 0; got < BENCH_RENDER_FRAMES; ) {
+        size_t n = audio_stream_read(stream, pulled + got, BENCH_RENDER_FRAMES - got);
+        if (n == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+        got += n;
+    }
+    audio_stream_close(stream);
+    for (size_t i = 0; i < BENCH_RENDER_FRAMES; ++i) out[i] = (int16_t)lrintf(pulled[i] * 32768.0f);
+    bench_check_mismatches("stream_loop_range", compare(out, 0, BENCH_RENDER_FRAMES, 0, 1000, 3000, &first), first);
+    free(pulled);
+    free(out);
+}
+
+static void run_bench(const wav_file_t* sound, size_t count) {
+    const size_t blocks = 2000;
+    int16_t* out = (int16_t*)malloc(BENCH_BLOCK * 2 * sizeof(int16_t));
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("\nvoices,isa,loop_frames,us_per_block\n");
+    for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+        wav_convert_set_isa((wav_isa_t)isa);
+        for (int looped = 0; looped < 2; ++looped) {
+            mixer_config_t config = { BENCH_RATE, 2, BENCH_BLOCK, (uint32_t)count, 256, MIXER_STEAL_NONE };
+            mixer_t* mixer = mixer_init(&config);
+            if (!mixer || !out) exit(EXIT_FAILURE);
+            for (size_t i = 0; i < count; ++i) {
+                //? Staggered so the wraps don't all fall on the same frame
+                uint64_t start = 1000 + i * 7;
+                mixer_voice_params_t params = { 1.0f / (float)count, 0.0f, true, MIXER_PRIORITY_NORMAL, NULL, 0, start,
+                                                looped ? start : 0, looped ? start + 64 : 0, NULL };
+                mixer_play_ex(mixer, sound, &params);
+            }
+            mixer_render(mixer, out, BENCH_BLOCK);
+            uint64_t begin = audio_clock_ns();
+            for (size_t b = 0; b < blocks; ++b) mixer_render(mixer, out, BENCH_BLOCK);
+            double us = (double)(audio_clock_ns() - begin) / 1e3 / (double)blocks;
+            printf("%zu,%s,%d,%.3f\n", count, wav_isa_name((wav_isa_t)isa), looped ? 64 : BENCH_SOUND_FRAMES, us);
+            mixer_free(mixer);
+        }
+    }
+    wav_convert_set_isa(best);
+    free(out);
+}
+
+int main(int argc, char const *argv[])
+{
+    long voices = (argc > 1) ? atol(argv[1]) : 64;
+    if (voices <= 0) voices = 64;
+    wav_file_t sound;
+    if (!bench_make_sound(&sound, 1, BENCH_RATE, BENCH_SOUND_FRAMES, fill_ramp, NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    run_checks(&sound);
+    run_bench(&sound, (size_t)voices);
+    wav_free_file(&sound);
+    return bench_status();
+}
@@ -0,0 +1,187 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Waveform overview build throughput, query cost per zoom level and sidecar size.
+ *
+ *   wav_overview_bench [frames]
+ *
+ * Builds the overview of an in-memory 16-bit file (1, 2 and 6 channels) with each
+ * kernel set and reports the source bytes reduced per second next to a plain
+ * memcpy of the same bytes, which is about as fast as one pass can go. Every
+ * build is checked against a brute-force scan. Queries draw a 1920 pixel wide
+ * view from the whole file down to 1920 frames; the sidecar rows save and load
+ * the overview in the current directory.
+ *
+ * Build:
+ *   gcc -O2 -Idsp -Iwav_parser -Iutils bench/wav_overview_bench.c bench/bench_util.c dsp/wav_overview.c wav_parser/wav_planar.c \
+ *       wav_parser/wav_convert.c wav_parser/wav_parser.c wav_parser/wav_writer.c utils/log.c utils/path_utils.c utils/file_io.c \
+ *       -pthread -lm -o wav_overview_bench
+ */
+
+#include "wav_overview.h"
+#include "bench_util.h"
+#include <math.h>
+#include <time.h>
+
+#define BENCH_MIN_SECONDS 0.25
+#define BENCH_RATE 48000
+#define BENCH_PIXELS 1920
+#define BENCH_SIDECAR "wav_overview_bench.wovr"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//? Noise under a slow envelope, so buckets differ from each other; `user` is the noise state
+static void fill_noise(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    uint32_t* seed = (uint32_t*)user;
+    const double envelope = 0.5 + 0.5 * sin(2.0 * 3.14159265358979 * (double)frame / (BENCH_RATE * 3.0));
+    for (uint16_t c = 0; c < channels; ++c) {
+        *seed ^= *seed << 13; *seed ^= *seed >> 17; *seed ^= *seed << 5;
+        samples[c] = (int16_t)((double)((int32_t)(*seed & 0xFFFF) - 32768) * envelope / (c + 1));
+    }
+}
+
+//* Level 0 recomputed one sample at a time, plus every level's min/max against the one below
+static bool verify(const wav_overview_t* overview, const wav_file_t* sound) {
+    const int16_t* samples = (const int16_t*)sound->data;
+    const uint16_t channels = overview->num_channels;
+    const wav_overview_level_t* level = &overview->levels[0];
+    for (uint64_t i = 0; i < level->buckets; ++i) {
+        for (uint16_t c = 0; c < channels; ++c) {
+            float mn = INFINITY, mx = -INFINITY;
+            double sum = 0.0;
+            uint64_t n = 0;
+            for (uint64_t f = i * level->block_frames; f < (i + 1) * level->block_frames && f < overview->frames; ++f, ++n) {
+                float v = (float)samples[f * channels + c] / 32768.0f;
+                if (v < mn) mn = v;
+                if (v > mx) mx = v;
+                sum += (double)v * v;
+            }
+            const size_t k = c * level->buckets + i;
+            if (level->min[k] != mn || level->max[k] != mx || fabs(level->power[k] - sum / (double)n) > 1e-5 * (sum / (double)n) + 1e-9) {
+                fprintf(stderr, "bucket %llu channel %u: got %f/%f/%g, expected %f/%f/%g\n", (unsigned long long)i, c,
+                    level->min[k], level->max[k], level->power[k], mn, mx, sum / (double)n);
+                return false;
+            }
+        }
+    }
+    const wav_overview_level_t* top = &overview->levels[overview->num_levels - 1];
+    if (top->buckets != 1) return false;
+    for (uint16_t c = 0; c < channels; ++c) {
+        float mn = INFINITY, mx = -INFINITY;
+        for (uint64_t i = 0; i < level->buckets; ++i) {
+            if (level->min[c * level->buckets + i] < mn) mn = level->min[c * level->buckets + i];
+            if (level->max[c * level->buckets + i] > mx) mx = level->max[c * level->buckets + i];
+        }
+        if (top->min[c] != mn || top->max[c] != mx) return false;
+    }
+    return true;
+}
+
+int main(int argc, char const *argv[])
+{
+    size_t frames = (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : (size_t)BENCH_RATE * 300;
+    if (frames == 0) frames = (size_t)BENCH_RATE * 300;
+
+    static const uint16_t layouts[] = { 1, 2, 6 };
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("test,isa,channels,frames,seconds,gb_per_s,detail\n");
+    for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); ++l) {
+        wav_file_t sound;
+        uint32_t seed = 2463534242u;
+        if (!bench_make_sound(&sound, layouts[l], BENCH_RATE, frames, fill_noise, &seed)) {
+            fprintf(stderr, "out of memory\n");
+            return EXIT_FAILURE;
+        }
+        const double bytes = (double)sound.data_length;
+        uint8_t* copy = (uint8_t*)malloc((size_t)sound.data_length);
+        if (!copy) return EXIT_FAILURE;
+        size_t passes = 0;
+        double start = now_seconds(), elapsed;
+        do {
+            memcpy(copy, sound.data, (size_t)sound.data_length);
+            ++passes;
+            elapsed = now_seconds() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+        printf("memcpy,-,%u,%zu,%.6f,%.3f,\n", layouts[l], frames, elapsed / passes, bytes * passes / elapsed / 1e9);
+        free(copy);
+
+        wav_overview_t overview;
+        wav_overview_init(&overview);
+        for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+            wav_convert_set_isa((wav_isa_t)isa);
+            passes = 0;
+            start = now_seconds();
+            do {
+                wav_overview_free(&overview);
+                if (!wav_overview_build(&overview, &sound, WAV_OVERVIEW_DEFAULT_BLOCK_LOG2)) return EXIT_FAILURE;
+                ++passes;
+                elapsed = now_seconds() - start;
+            } while (elapsed < BENCH_MIN_SECONDS);
+            const bool ok = verify(&overview, &sound);
+            printf("build,%s,%u,%zu,%.6f,%.3f,%s\n", wav_isa_name((wav_isa_t)isa), layouts[l], frames, elapsed / passes,
+                bytes * passes / elapsed / 1e9, ok ? "ok" : "MISMATCH");
+            if (!ok) return EXIT_FAILURE;
+        }
+        wav_convert_set_isa(best);
+
+        //* Zooming in 8x at a time, centered, from the whole file to one frame per pixel
+        wav_overview_point_t points[BENCH_PIXELS];
+        for (uint64_t span = frames; ; span /= 8) {
+            if (span < BENCH_PIXELS) span = BENCH_PIXELS;
+            const uint64_t first = (frames - span) / 2;
+            passes = 0;
+            start = now_seconds();
+            do {
+                if (wav_overview_query(&overview, 0, first, span, BENCH_PIXELS, points) != BENCH_PIXELS) return EXIT_FAILURE;
+                ++passes;
+                elapsed = now_seconds() - start;
+            } while (elapsed < BENCH_MIN_SECONDS / 4);
+            printf("query,-,%u,%llu,%.9f,,%.1f frames per pixel\n", layouts[l], (unsigned long long)span, elapsed / passes,
+                (double)span / BENCH_PIXELS);
+            if (span == BENCH_PIXELS) break;
+        }
+
+        start = now_seconds();
+        if (!wav_overview_save(&overview, BENCH_SIDECAR)) return EXIT_FAILURE;
+        const double save_seconds = now_seconds() - start;
+        FILE* file = fopen(BENCH_SIDECAR, "rb");
+        long size = -1;
+        if (file && fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+        if (file) fclose(file);
+        wav_overview_t loaded;
+        start = now_seconds();
+        if (!wav_overview_load(&loaded, BENCH_SIDECAR)) return EXIT_FAILURE;
+        const double load_seconds = now_seconds() - start;
+        remove(BENCH_SIDECAR);
+        //? Rounded outwards, so a loaded peak is never inside the real one
+        bool ok = loaded.num_levels == overview.num_levels;
+        for (uint64_t i = 0; ok && i < overview.levels[0].buckets * layouts[l]; ++i) {
+            ok = loaded.levels[0].min[i] <= overview.levels[0].min[i] && loaded.levels[0].max[i] >= overview.levels[0].max[i];
+        }
+        printf("save,-,%u,%zu,%.6f,,%ld bytes (%.2f%% of the samples)\n", layouts[l], frames, save_seconds, size, 100.0 * (double)size / bytes);
+        printf("load,-,%u,%zu,%.6f,,%s\n", layouts[l], frames, load_seconds, ok ? "ok" : "MISMATCH");
+        wav_overview_free(&loaded);
+        wav_overview_free(&overview);
+        wav_free_file(&sound);
+        if (!ok) return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,464 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Parser throughput over a synthetic corpus, for catching load-path regressions.
+ *
+ *   wav_parser_bench [-d corpus_dir] [-f csv|json] [-m warm|cold|both] [-t seconds_per_case] [-k]
+ *
+ * Writes a corpus of WAVs covering sizes from 4 KB to 32 MB, 1 to 6 channels,
+ * 8/16/24-bit PCM and extensible float, and awkward layouts: big LIST/smpl/JUNK
+ * chunks in front of `data`, odd-sized chunks with their pad byte, fmt after
+ * metadata. Then every load path runs over every file:
+ *
+ *   parse   wav_parse_file()            mapped  wav_parse_file_mapped() + touching every page
+ *   probe   wav_probe()                 memory  wav_parse_memory() over a preloaded image (no I/O)
+ *   stream  wav_stream_open() + wav_stream_read_frames() to the end in 64 KB reads
+ *
+ * warm runs with the file in the page cache; cold drops it (posix_fadvise
+ * DONTNEED, Linux) before every iteration, outside the timed part. mb_per_s counts
+ * the whole file. allocs_per_file counts malloc/calloc/realloc made while loading
+ * (glibc only, libc internals included); read_syscalls_per_file and faults come
+ * from /proc/self/io and getrusage (Linux only). Unavailable counters are -1.
+ * The corpus is removed afterwards unless -k is given.
+ *
+ * Build:
+ *   gcc -O2 -Iwav_parser -Iutils bench/wav_parser_bench.c bench/bench_util.c wav_parser/wav_parser.c wav_parser/wav_writer.c \
+ *       utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_parser_bench
+ */
+
+#include "bench_util.h"
+#include "log.h"
+#include <time.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+#define BENCH_STREAM_CHUNK (64 * 1024)
+#define BENCH_MIN_ITERATIONS 3
+
+typedef enum corpus_layout_t {
+    LAYOUT_PLAIN,               //? fmt, data
+    LAYOUT_METADATA,            //? 64 KB LIST, smpl, 4 KB JUNK, fmt, then data
+    LAYOUT_ODD,                 //? odd-sized chunks (and an odd-sized data chunk), each followed by its pad byte
+    LAYOUT_EXTENSIBLE,          //? WAVE_FORMAT_EXTENSIBLE fmt, fact chunk
+} corpus_layout_t;
+
+typedef struct corpus_file_t {
+    const char* name;
+    corpus_layout_t layout;
+    uint16_t channels;
+    uint16_t bits;
+    uint16_t format;            //? WAV_FORMAT_PCM or WAV_FORMAT_IEEE_FLOAT
+    uint64_t data_bytes;        //? rounded down to whole frames
+} corpus_file_t;
+
+static const corpus_file_t corpus[] = {
+    { "plain_4k_s16_2ch",       LAYOUT_PLAIN,      2, 16, WAV_FORMAT_PCM,        4ull << 10 },
+    { "plain_256k_s16_2ch",     LAYOUT_PLAIN,      2, 16, WAV_FORMAT_PCM,        256ull << 10 },
+    { "plain_4m_s16_2ch",       LAYOUT_PLAIN,      2, 16, WAV_FORMAT_PCM,        4ull << 20 },
+    { "plain_32m_s16_2ch",      LAYOUT_PLAIN,      2, 16, WAV_FORMAT_PCM,        32ull << 20 },
+    { "plain_4k_u8_1ch",        LAYOUT_PLAIN,      1, 8,  WAV_FORMAT_PCM,        4ull << 10 },
+    { "meta_4k_s16_1ch",        LAYOUT_METADATA,   1, 16, WAV_FORMAT_PCM,        4ull << 10 },
+    { "meta_256k_s16_1ch",      LAYOUT_METADATA,   1, 16, WAV_FORMAT_PCM,        256ull << 10 },
+    { "meta_4m_s16_2ch",        LAYOUT_METADATA,   2, 16, WAV_FORMAT_PCM,        4ull << 20 },
+    { "odd_256k_s24_1ch",       LAYOUT_ODD,        1, 24, WAV_FORMAT_PCM,        (256ull << 10) + 3 },
+    { "odd_4m_s24_1ch",         LAYOUT_ODD,        1, 24, WAV_FORMAT_PCM,        (4ull << 20) + 3 },
+    { "ext_256k_f32_6ch",       LAYOUT_EXTENSIBLE, 6, 32, WAV_FORMAT_IEEE_FLOAT, 256ull << 10 },
+    { "ext_4m_f32_6ch",         LAYOUT_EXTENSIBLE, 6, 32, WAV_FORMAT_IEEE_FLOAT, 4ull << 20 },
+};
+#define CORPUS_FILES (sizeof(corpus) / sizeof(corpus[0]))
+
+typedef enum load_path_t {
+    PATH_PARSE,
+    PATH_MAPPED,
+    PATH_PROBE,
+    PATH_MEMORY,
+    PATH_STREAM,
+    PATH_COUNT
+} load_path_t;
+
+static const char* path_names[PATH_COUNT] = { "parse", "mapped", "probe", "memory", "stream" };
+static const char* layout_names[] = { "plain", "metadata", "odd", "extensible" };
+
+//=================================================COUNTERS==========================================================
+
+#ifdef __GLIBC__
+//* Interposes the allocator for the whole process; the bench itself never allocates while timing
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+static uint64_t alloc_count;
+
+void* malloc(size_t size) {
+    ++alloc_count;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    ++alloc_count;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    ++alloc_count;
+    return __libc_realloc(ptr, size);
+}
+#define ALLOCS_AVAILABLE 1
+#else
+static uint64_t alloc_count;
+#define ALLOCS_AVAILABLE 0
+#endif
+
+typedef struct counters_t {
+    uint64_t allocs;
+    int64_t read_syscalls;
+    int64_t minor_faults;
+    int64_t major_faults;
+} counters_t;
+
+#ifdef __linux__
+static int proc_io = -1;
+
+static int64_t read_syscalls(void) {
+    char text[512];
+    if (proc_io < 0) return -1;
+    ssize_t n = pread(proc_io, text, sizeof(text) - 1, 0);
+    if (n <= 0) return -1;
+    text[n] = '\0';
+    const char* field = strstr(text, "syscr:");
+    return field ? strtoll(field + 6, NULL, 10) : -1;
+}
+#endif
+
+static void counters_sample(counters_t* c) {
+    c->allocs = alloc_count;
+#ifdef __linux__
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    c->read_syscalls = read_syscalls();
+    c->minor_faults = usage.ru_minflt;
+    c->major_faults = usage.ru_majflt;
+#else
+    c->read_syscalls = c->minor_faults = c->major_faults = -1;
+#endif
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//? Evicts the file from the page cache; it was fsync'd after writing so every page is clean
+static void drop_cache(const char* path) {
+#ifdef __linux__
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+//=================================================CORPUS==========================================================
+
+static void put_chunk(FILE* f, const char* id, uint32_t size, uint8_t fill) {
+    fwrite(id, 1, 4, f);
+    bench_put_u32(f, size);
+    for (uint32_t i = 0; i < size; ++i) fputc(fill, f);
+    if (size & 1) fputc(0, f);
+}
+
+static void put_fmt(FILE* f, const corpus_file_t* spec) {
+    const uint16_t block_align = (uint16_t)(spec->channels * spec->bits / 8);
+    const bool extensible = spec->layout == LAYOUT_EXTENSIBLE;
+    fwrite("fmt ", 1, 4, f);
+    bench_put_u32(f, extensible ? 40 : 16);
+    bench_put_u16(f, extensible ? WAV_FORMAT_EXTENSIBLE : spec->format);
+    bench_put_u16(f, spec->channels);
+    bench_put_u32(f, 48000);
+    bench_put_u32(f, 48000u * block_align);
+    bench_put_u16(f, block_align);
+    bench_put_u16(f, spec->bits);
+    if (extensible) {
+        static const uint8_t guid_tail[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+        bench_put_u16(f, 22);
+        bench_put_u16(f, spec->bits);
+        bench_put_u32(f, 0x3F);           //? 5.1
+        bench_put_u16(f, spec->format);
+        fwrite(guid_tail, 1, sizeof(guid_tail), f);
+    }
+}
+
+static bool write_corpus_file(const char* path, const corpus_file_t* spec) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    const uint16_t block_align = (uint16_t)(spec->channels * spec->bits / 8);
+    uint64_t data_bytes = spec->data_bytes - spec->data_bytes % block_align;
+    fwrite("RIFF", 1, 4, f);
+    bench_put_u32(f, 0);                  //? patched below
+    fwrite("WAVE", 1, 4, f);
+    switch (spec->layout) {
+        case LAYOUT_PLAIN:
+            put_fmt(f, spec);
+            break;
+        case LAYOUT_METADATA:
+            put_chunk(f, "LIST", 64 * 1024, 'i');
+            put_chunk(f, "smpl", 60, 0);
+            put_chunk(f, "JUNK", 4096, 0);
+            put_fmt(f, spec);
+            break;
+        case LAYOUT_ODD:
+            put_chunk(f, "bext", 601, 'b');
+            put_fmt(f, spec);
+            put_chunk(f, "LIST", 4095, 'i');
+            put_chunk(f, "id3 ", 1, 0);
+            break;
+        case LAYOUT_EXTENSIBLE:
+            put_fmt(f, spec);
+            put_chunk(f, "fact", 4, 0);
+            break;
+    }
+    fwrite("data", 1, 4, f);
+    bench_put_u32(f, (uint32_t)data_bytes);
+    uint8_t block[4096];
+    for (size_t i = 0; i < sizeof(block); ++i) block[i] = (uint8_t)(i * 31 + 7);
+    for (uint64_t left = data_bytes; left > 0; ) {
+        size_t n = left < sizeof(block) ? (size_t)left : sizeof(block);
+        fwrite(block, 1, n, f);
+        left -= n;
+    }
+    if (data_bytes & 1) fputc(0, f);
+    bool ok = !ferror(f);
+    long size = ftell(f);
+    ok = ok && size > 8 && fseek(f, 4, SEEK_SET) == 0;
+    if (ok) bench_put_u32(f, (uint32_t)(size - 8));
+    fflush(f);
+#ifdef __linux__
+    fsync(fileno(f));
+#endif
+    return fclose(f) == 0 && ok;
+}
+
+//=================================================LOAD PATHS==========================================================
+
+typedef struct bench_file_t {
+    char path[512];
+    uint64_t size;
+    uint8_t* image;             //? whole file, for the memory path
+    uint8_t* chunk;             //? stream read buffer
+} bench_file_t;
+
+//? One load of the file through `path`, fully released again. Returns false on failure
+static bool load_once(load_path_t path, bench_file_t* file, volatile uint64_t* sink) {
+    wav_file_t wav;
+    wav_init_file(&wav);
+    switch (path) {
+        case PATH_PARSE:
+            if (!wav_parse_file(file->path, &wav)) return false;
+            *sink += wav.data[wav.data_length - 1];
+            wav_free_file(&wav);
+            return true;
+        case PATH_MAPPED: {
+            if (!wav_parse_file_mapped(file->path, &wav)) return false;
+            //* A mapping is only loaded once touched: read one byte per page so the comparison is fair
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < wav.data_length; i += 4096) sum += wav.data[i];
+            *sink += sum;
+            wav_free_file(&wav);
+            return true;
+        }
+        case PATH_PROBE: {
+            wav_probe_t probe;
+            if (!wav_probe(file->path, &probe)) return false;
+            *sink += probe.data_offset;
+            return true;
+        }
+        case PATH_MEMORY:
+            if (!wav_parse_memory(file->image, (size_t)file->size, &wav, false)) return false;
+            *sink += wav.samples;
+            wav_free_file(&wav);
+            return true;
+        case PATH_STREAM: {
+            wav_stream_t stream;
+            if (!wav_stream_open(file->path, &stream)) {
+                wav_stream_close(&stream);
+                return false;
+            }
+            const size_t frames = BENCH_STREAM_CHUNK / stream.header.block_align;
+            size_t got;
+            while ((got = wav_stream_read_frames(&stream, file->chunk, frames)) > 0) *sink += got;
+            wav_stream_close(&stream);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static bool read_image(bench_file_t* file) {
+    FILE* f = fopen(file->path, "rb");
+    if (!f) return false;
+    file->image = (uint8_t*)malloc((size_t)file->size);
+    bool ok = file->image && fread(file->image, 1, (size_t)file->size, f) == file->size;
+    fclose(f);
+    return ok;
+}
+
+//=================================================MAIN==========================================================
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-d corpus_dir] [-f csv|json] [-m warm|cold|both] [-t seconds_per_case] [-k]\n", argv0);
+}
+
+int main(int argc, char const *argv[])
+{
+    const char* dir = ".";
+    bool json = false, keep = false, warm = true, cold = true;
+    double min_seconds = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            const char* fmt = argv[++i];
+            if (strcmp(fmt, "json") == 0) json = true;
+            else if (strcmp(fmt, "csv") != 0) { usage(argv[0]); return EXIT_FAILURE; }
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            warm = strcmp(mode, "cold") != 0;
+            cold = strcmp(mode, "warm") != 0;
+            if (!warm && !cold) { usage(argv[0]); return EXIT_FAILURE; }
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            min_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0) {
+            keep = true;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    static bench_file_t files[CORPUS_FILES];
+    for (size_t i = 0; i < CORPUS_FILES; ++i) {
+        snprintf(files[i].path, sizeof(files[i].path), "%s/wav_parser_bench_%s.wav", dir, corpus[i].name);
+        if (!write_corpus_file(files[i].path, &corpus[i])) {
+            fprintf(stderr, "unable to write %s\n", files[i].path);
+            return EXIT_FAILURE;
+        }
+        FILE* f = fopen(files[i].path, "rb");
+        if (f && fseek(f, 0, SEEK_END) == 0) files[i].size = (uint64_t)ftell(f);
+        if (f) fclose(f);
+        files[i].chunk = (uint8_t*)malloc(BENCH_STREAM_CHUNK);
+        if (!files[i].chunk || !read_image(&files[i])) {
+            fprintf(stderr, "unable to load %s\n", files[i].path);
+            return EXIT_FAILURE;
+        }
+    }
+#ifdef __linux__
+    proc_io = open("/proc/self/io", O_RDONLY);
+#endif
+    //? Success messages are LOG_DEBUG and filtered out; whatever still gets logged stays out of the table
+    FILE* log_sink = fopen(NULL_DEVICE, "w");
+    LogSetOutput(log_sink);
+    //* What reading the counters costs by itself, taken off every measurement
+    counters_t base0, base1;
+    counters_sample(&base0);
+    counters_sample(&base1);
+    const int64_t counter_reads = (base1.read_syscalls >= 0) ? base1.read_syscalls - base0.read_syscalls : 0;
+
+    if (!json) printf("mode,path,file,layout,channels,bits,file_bytes,iterations,files_per_s,mb_per_s,allocs_per_file,read_syscalls_per_file,minor_faults_per_file,major_faults_per_file\n");
+    volatile uint64_t sink = 0;
+    int failures = 0;
+    for (int m = 0; m < 2; ++m) {
+        const bool is_cold = (m == 1);
+        if ((is_cold && !cold) || (!is_cold && !warm)) continue;
+        for (int p = 0; p < PATH_COUNT; ++p) {
+            //? No I/O on the memory path, dropping the cache changes nothing
+            if (is_cold && p == PATH_MEMORY) continue;
+            for (size_t i = 0; i < CORPUS_FILES; ++i) {
+                bench_file_t* file = &files[i];
+                if (!is_cold && !load_once((load_path_t)p, file, &sink)) {
+                    ++failures;
+                    continue;
+                }
+                uint64_t iterations = 0;
+                double elapsed = 0.0;
+                counters_t total = { 0, 0, 0, 0 };
+                while (iterations < BENCH_MIN_ITERATIONS || elapsed < min_seconds) {
+                    if (is_cold) drop_cache(file->path);
+                    counters_t before, after;
+                    counters_sample(&before);
+                    double start = now_seconds();
+                    bool ok = load_once((load_path_t)p, file, &sink);
+                    elapsed += now_seconds() - start;
+                    counters_sample(&after);
+                    if (!ok) {
+                        ++failures;
+                        break;
+                    }
+                    total.allocs += after.allocs - before.allocs;
+                    total.read_syscalls += after.read_syscalls - before.read_syscalls - counter_reads;
+                    total.minor_faults += after.minor_faults - before.minor_faults;
+                    total.major_faults += after.major_faults - before.major_faults;
+                    ++iterations;
+                }
+                if (iterations == 0) continue;
+                const double n = (double)iterations;
+                const double allocs = ALLOCS_AVAILABLE ? total.allocs / n : -1.0;
+                const double reads = (base0.read_syscalls >= 0) ? total.read_syscalls / n : -1.0;
+                const double minor = (base0.minor_faults >= 0) ? total.minor_faults / n : -1.0;
+                const double major = (base0.major_faults >= 0) ? total.major_faults / n : -1.0;
+                const char* mode = is_cold ? "cold" : "warm";
+                if (json) {
+                    printf("{\"mode\":\"%s\",\"path\":\"%s\",\"file\":\"%s\",\"layout\":\"%s\",\"channels\":%u,\"bits\":%u,\"file_bytes\":%llu,\"iterations\":%llu,\"files_per_s\":%.1f,"
+                        "\"mb_per_s\":%.1f,\"allocs_per_file\":%.2f,\"read_syscalls_per_file\":%.2f,\"minor_faults_per_file\":%.1f,\"major_faults_per_file\":%.1f}\n",
+                        mode, path_names[p], corpus[i].name, layout_names[corpus[i].layout], corpus[i].channels, corpus[i].bits, (unsigned long long)file->size, (unsigned long long)iterations, n / elapsed,
+                        n * (double)file->size / elapsed / 1e6, allocs, reads, minor, major);
+                } else {
+                    printf("%s,%s,%s,%s,%u,%u,%llu,%llu,%.1f,%.1f,%.2f,%.2f,%.1f,%.1f\n", mode, path_names[p], corpus[i].name, layout_names[corpus[i].layout],
+                        corpus[i].channels, corpus[i].bits, (unsigned long long)file->size, (unsigned long long)iterations, n / elapsed,
+                        n * (double)file->size / elapsed / 1e6, allocs, reads, minor, major);
+                }
+                fflush(stdout);
+            }
+        }
+    }
+
+    LogSetOutput(NULL);
+    if (log_sink) fclose(log_sink);
+#ifdef __linux__
+    if (proc_io >= 0) close(proc_io);
+#endif
+    for (size_t i = 0; i < CORPUS_FILES; ++i) {
+        if (!keep) remove(files[i].path);
+        free(files[i].image);
+        free(files[i].chunk);
+    }
+    if (failures) fprintf(stderr, "%d loads failed\n", failures);
+    return failures ? EXIT_FAILURE : 0;
+}
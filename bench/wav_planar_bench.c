@@ -0,0 +1,195 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Deinterleave/interleave kernel throughput, and what a planar layout buys a
+ * per-channel analysis pass on wide (6 and 8 channel) content.
+ *
+ *   wav_planar_bench [frames]
+ *
+ * The "dsp" rows run the same per-channel RMS pass two ways: striding through the
+ * interleaved buffer by channel count, and over contiguous planes (once with the
+ * deinterleave counted, once without, since a planar view is usually built once
+ * and then analysed several times).
+ *
+ * Build:
+ *   gcc -O3 -Iwav_parser -Iutils bench/wav_planar_bench.c wav_parser/wav_planar.c wav_parser/wav_convert.c utils/log.c -pthread -lm -o wav_planar_bench
+ */
+
+#include "wav_planar.h"
+#include <math.h>
+#include <time.h>
+
+#define BENCH_MIN_SECONDS 0.25
+#define BENCH_MAX_CHANNELS 8
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct bench_ctx_t {
+    unsigned channels;
+    size_t frames;
+    float* interleaved;
+    int16_t* interleaved16;
+    float* planes[BENCH_MAX_CHANNELS];
+    int16_t* planes16[BENCH_MAX_CHANNELS];
+    float rms[BENCH_MAX_CHANNELS];
+} bench_ctx_t;
+
+typedef void (*bench_fn)(bench_ctx_t* ctx);
+
+static void run_deinterleave_f32(bench_ctx_t* ctx) {
+    wav_deinterleave_f32(ctx->planes, ctx->interleaved, ctx->frames, ctx->channels);
+}
+
+static void run_interleave_f32(bench_ctx_t* ctx) {
+    wav_interleave_f32(ctx->interleaved, (const float* const*)ctx->planes, ctx->frames, ctx->channels);
+}
+
+static void run_deinterleave_s16(bench_ctx_t* ctx) {
+    wav_deinterleave_s16(ctx->planes16, ctx->interleaved16, ctx->frames, ctx->channels);
+}
+
+static void run_interleave_s16(bench_ctx_t* ctx) {
+    wav_interleave_s16(ctx->interleaved16, (const int16_t* const*)ctx->planes16, ctx->frames, ctx->channels);
+}
+
+//? 8 partial sums so the contiguous version vectorizes without -ffast-math
+static float rms_strided(const float* x, size_t frames, size_t step) {
+    float acc[8] = {0};
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        for (int k = 0; k < 8; ++k) {
+            float v = x[(i + k) * step];
+            acc[k] += v * v;
+        }
+    }
+    for (; i < frames; ++i) acc[0] += x[i * step] * x[i * step];
+    float sum = 0.0f;
+    for (int k = 0; k < 8; ++k) sum += acc[k];
+    return sqrtf(sum / (float)frames);
+}
+
+static float rms_contiguous(const float* x, size_t frames) {
+    float acc[8] = {0};
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        for (int k = 0; k < 8; ++k) {
+            acc[k] += x[i + k] * x[i + k];
+        }
+    }
+    for (; i < frames; ++i) acc[0] += x[i] * x[i];
+    float sum = 0.0f;
+    for (int k = 0; k < 8; ++k) sum += acc[k];
+    return sqrtf(sum / (float)frames);
+}
+
+static void run_dsp_interleaved(bench_ctx_t* ctx) {
+    for (unsigned c = 0; c < ctx->channels; ++c) {
+        ctx->rms[c] = rms_strided(ctx->interleaved + c, ctx->frames, ctx->channels);
+    }
+}
+
+static void run_dsp_planar(bench_ctx_t* ctx) {
+    for (unsigned c = 0; c < ctx->channels; ++c) {
+        ctx->rms[c] = rms_contiguous(ctx->planes[c], ctx->frames);
+    }
+}
+
+static void run_dsp_planar_with_deinterleave(bench_ctx_t* ctx) {
+    run_deinterleave_f32(ctx);
+    run_dsp_planar(ctx);
+}
+
+//? Repeats `fn` until BENCH_MIN_SECONDS have passed, returns seconds per pass
+static double time_fn(bench_fn fn, bench_ctx_t* ctx) {
+    size_t passes = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        fn(ctx);
+        ++passes;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+    return elapsed / (double)passes;
+}
+
+static void print_row(const char* kernel, const char* isa, const bench_ctx_t* ctx, double seconds, double bytes) {
+    printf("%s,%s,%u,%zu,%.6f,%.3f,%.3f\n", kernel, isa, ctx->channels, ctx->frames, seconds,
+        (double)ctx->frames * ctx->channels / seconds / 1e9, bytes / seconds / 1e9);
+}
+
+int main(int argc, char const *argv[])
+{
+    size_t frames = (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : (1u << 20);
+    if (frames == 0) frames = 1u << 20;
+
+    bench_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.frames = frames;
+    ctx.interleaved = (float*)malloc(frames * BENCH_MAX_CHANNELS * sizeof(float));
+    ctx.interleaved16 = (int16_t*)malloc(frames * BENCH_MAX_CHANNELS * sizeof(int16_t));
+    if (!ctx.interleaved || !ctx.interleaved16) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (unsigned c = 0; c < BENCH_MAX_CHANNELS; ++c) {
+        ctx.planes[c] = (float*)malloc(frames * sizeof(float));
+        ctx.planes16[c] = (int16_t*)malloc(frames * sizeof(int16_t));
+        if (!ctx.planes[c] || !ctx.planes16[c]) {
+            fprintf(stderr, "out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (size_t i = 0; i < frames * BENCH_MAX_CHANNELS; ++i) {
+        int v = (int)(i * 2654435761u % 65536) - 32768;
+        ctx.interleaved[i] = (float)v / 32768.0f;
+        ctx.interleaved16[i] = (int16_t)v;
+    }
+
+    static const unsigned layouts[] = { 1, 2, 6, 8 };
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("kernel,isa,channels,frames,seconds,gsamples_per_s,gb_per_s\n");
+    for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); ++l) {
+        ctx.channels = layouts[l];
+        double samples = (double)frames * ctx.channels;
+        for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+            wav_convert_set_isa((wav_isa_t)isa);
+            const char* name = wav_isa_name((wav_isa_t)isa);
+            //* Bytes moved count the read and the write side
+            print_row("deinterleave_f32", name, &ctx, time_fn(run_deinterleave_f32, &ctx), samples * 8);
+            print_row("interleave_f32",   name, &ctx, time_fn(run_interleave_f32, &ctx),   samples * 8);
+            print_row("deinterleave_s16", name, &ctx, time_fn(run_deinterleave_s16, &ctx), samples * 4);
+            print_row("interleave_s16",   name, &ctx, time_fn(run_interleave_s16, &ctx),   samples * 4);
+        }
+        wav_convert_set_isa(best);
+        if (ctx.channels < 6) continue;
+        run_deinterleave_f32(&ctx);
+        print_row("dsp_rms_interleaved", "-", &ctx, time_fn(run_dsp_interleaved, &ctx), samples * 4);
+        print_row("dsp_rms_planar", wav_isa_name(best), &ctx, time_fn(run_dsp_planar, &ctx), samples * 4);
+        print_row("dsp_rms_planar+deinterleave", wav_isa_name(best), &ctx, time_fn(run_dsp_planar_with_deinterleave, &ctx), samples * 12);
+    }
+
+    free(ctx.interleaved);
+    free(ctx.interleaved16);
+    for (unsigned c = 0; c < BENCH_MAX_CHANNELS; ++c) {
+        free(ctx.planes[c]);
+        free(ctx.planes16[c]);
+    }
+    return 0;
+}
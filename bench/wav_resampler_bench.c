@@ -0,0 +1,123 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Resampler throughput for the rate pairs our assets mix, per quality preset and
+ * instruction set.
+ *
+ *   wav_resampler_bench [seconds_of_audio]
+ *
+ * Streams stereo input through wav_resampler_process() in 1024 frame blocks, the
+ * way a loader or a playback feeder would. msamples_per_s_per_ch counts output
+ * samples per second for a single channel; realtime_x is how many stereo streams
+ * of that rate one core keeps up with.
+ *
+ * Build:
+ *   gcc -O2 -Iwav_parser -Iutils -Idsp bench/wav_resampler_bench.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c \
+ *       wav_parser/wav_parser.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_resampler_bench
+ */
+
+#include "wav_resampler.h"
+#include <math.h>
+#include <time.h>
+
+#define BENCH_MIN_SECONDS 0.25
+#define BENCH_CHANNELS 2
+#define BENCH_BLOCK 1024
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const char* quality_name(wav_resample_quality_t quality) {
+    switch (quality) {
+        case WAV_RESAMPLE_FAST:     return "fast";
+        case WAV_RESAMPLE_MEDIUM:   return "medium";
+        case WAV_RESAMPLE_BEST:     return "best";
+    }
+    return "?";
+}
+
+//? Pushes all of `in` through, returns the number of output frames
+static uint64_t run_pass(wav_resampler_t* resampler, const float* in, size_t frames, float* out) {
+    uint64_t produced = 0;
+    wav_resampler_reset(resampler);
+    for (size_t done = 0; done < frames; ) {
+        size_t n = (frames - done < BENCH_BLOCK) ? frames - done : BENCH_BLOCK;
+        size_t used = 0;
+        produced += wav_resampler_process(resampler, in + done * BENCH_CHANNELS, n, &used, out, BENCH_BLOCK * 8);
+        done += used;
+    }
+    size_t got;
+    while ((got = wav_resampler_flush(resampler, out, BENCH_BLOCK * 8)) > 0) {
+        produced += got;
+    }
+    return produced;
+}
+
+int main(int argc, char const *argv[])
+{
+    double audio_seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+    if (audio_seconds <= 0.0) audio_seconds = 2.0;
+
+    static const uint32_t pairs[][2] = {
+        { 44100, 48000 }, { 48000, 44100 }, { 96000, 48000 }, { 22050, 48000 }, { 44100, 44056 },
+    };
+    float* out = (float*)malloc(BENCH_BLOCK * 8 * BENCH_CHANNELS * sizeof(float));
+    const wav_isa_t best = wav_convert_get_isa();
+    printf("in_rate,out_rate,quality,isa,taps,seconds,msamples_per_s_per_ch,realtime_x\n");
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p) {
+        size_t frames = (size_t)(pairs[p][0] * audio_seconds);
+        float* in = (float*)malloc(frames * BENCH_CHANNELS * sizeof(float));
+        if (!in || !out) {
+            fprintf(stderr, "out of memory\n");
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < frames; ++i) {
+            float v = (float)sin(2.0 * 3.14159265358979 * 997.0 * i / pairs[p][0]);
+            in[i * BENCH_CHANNELS] = v;
+            in[i * BENCH_CHANNELS + 1] = -v;
+        }
+        for (int q = WAV_RESAMPLE_FAST; q <= WAV_RESAMPLE_BEST; ++q) {
+            wav_resampler_t resampler;
+            if (!wav_resampler_init(&resampler, pairs[p][0], pairs[p][1], BENCH_CHANNELS, (wav_resample_quality_t)q)) {
+                continue;
+            }
+            for (int isa = WAV_ISA_SCALAR; isa <= (int)best; ++isa) {
+                wav_convert_set_isa((wav_isa_t)isa);
+                size_t passes = 0;
+                uint64_t produced = 0;
+                double start = now_seconds(), seconds;
+                do {
+                    produced += run_pass(&resampler, in, frames, out);
+                    ++passes;
+                    seconds = now_seconds() - start;
+                } while (seconds < BENCH_MIN_SECONDS);
+                double per_channel = (double)produced / seconds;
+                printf("%u,%u,%s,%s,%u,%.6f,%.3f,%.1f\n", pairs[p][0], pairs[p][1], quality_name((wav_resample_quality_t)q),
+                    wav_isa_name((wav_isa_t)isa), resampler.taps, seconds / passes,
+                    per_channel / 1e6, per_channel / pairs[p][1]);
+            }
+            wav_convert_set_isa(best);
+            wav_resampler_free(&resampler);
+        }
+        free(in);
+    }
+    free(out);
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * Random access into a long file: clip reads and streaming seeks against a full load.
+ *
+ *   wav_seek_bench [minutes] [scratch.wav]
+ *
+ * Writes a stereo 16-bit 48 kHz file (60 minutes by default) whose samples encode
+ * their own frame index, then:
+ *   - load:     wav_parse_file() of the whole thing, what scrubbing used to cost
+ *   - read_at:  wav_stream_open() plus wav_read_frames_at() of a 100 ms clip at a
+ *               random position, every clip checked against its frame indices
+ *   - seek:     audio_stream_seek() on a running stream to the first frame from the
+ *               new position coming out of audio_stream_read(), checked to be
+ *               followed by the frames after it with nothing stale in between
+ *   - restart:  audio_stream_start_at() on a stream that played to its end, with a
+ *               stray seek posted just before; the first frame out must be the start frame
+ * The file is left in the page cache by writing it, so the numbers are warm-cache.
+ *
+ * Build:
+ *   gcc -O2 -Iaudio -Idsp -Iwav_parser -Iutils bench/wav_seek_bench.c bench/bench_util.c audio/audio_stream.c audio/spsc_ring.c \
+ *       audio/audio_backend.c dsp/wav_resampler.c wav_parser/wav_planar.c wav_parser/wav_convert.c wav_parser/wav_parser.c \
+ *       wav_parser/wav_writer.c wav_parser/wav_codec.c utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_seek_bench
+ */
+
+#include "audio_stream.h"
+#include "audio_backend.h"
+#include "bench_util.h"
+
+#define BENCH_RATE 48000
+#define BENCH_CLIP (BENCH_RATE / 10)
+#define BENCH_READS 200
+#define BENCH_SEEKS 50
+#define BENCH_POLL 64               //? frames per simulated audio callback
+
+//* Left holds the frame index modulo 32768, right the index divided by 32768: any frame names itself
+static int16_t frame_left(uint64_t frame) { return (int16_t)(frame & 0x7FFF); }
+static int16_t frame_right(uint64_t frame) { return (int16_t)((frame >> 15) & 0x7FFF); }
+
+static void fill_indices(void* user, uint64_t frame, int16_t* samples, uint16_t channels) {
+    (void)user; (void)channels;
+    samples[0] = frame_left(frame);
+    samples[1] = frame_right(frame);
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13; *state ^= *state >> 7; *state ^= *state << 17;
+    return *state;
+}
+
+//? Float frames come back as v / 32768, exact for 16-bit values
+static uint64_t float_frame_index(const float* frame) {
+    return (uint64_t)(frame[0] * 32768.0f) | ((uint64_t)(frame[1] * 32768.0f) << 15);
+}
+
+int main(int argc, char const *argv[])
+{
+    double minutes = (argc > 1) ? atof(argv[1]) : 60.0;
+    if (minutes <= 0.0) minutes = 60.0;
+    const char* path = (argc > 2) ? argv[2] : "wav_seek_bench.wav";
+    const uint64_t frames = (uint64_t)(minutes * 60.0 * BENCH_RATE);
+    if (frames * 4 > 0xFFFFFFFFull - 36 || frames < BENCH_RATE) {
+        fprintf(stderr, "pick between 1 second and about 370 minutes\n");
+        return EXIT_FAILURE;
+    }
+    if (!bench_write_wav(path, 2, BENCH_RATE, frames, fill_indices, NULL)) {
+        fprintf(stderr, "unable to write %s\n", path);
+        return EXIT_FAILURE;
+    }
+    printf("test,ops,mean_ms,max_ms,errors\n");
+    int status = EXIT_SUCCESS;
+    uint64_t seed = 88172645463325252ull;
+
+    wav_file_t file;
+    wav_init_file(&file);
+    uint64_t start = audio_clock_ns();
+    bool loaded = wav_parse_file(path, &file);
+    double load_ms = (audio_clock_ns() - start) / 1e6;
+    printf("load,1,%.3f,%.3f,%d\n", load_ms, load_ms, loaded ? 0 : 1);
+    wav_free_file(&file);
+
+    //* Open + one clip each time, the way a preview of an arbitrary position would run from scratch
+    int16_t* clip = (int16_t*)malloc(BENCH_CLIP * 4);
+    double total = 0.0, worst = 0.0;
+    unsigned errors = 0;
+    for (int i = 0; i < BENCH_READS && clip; ++i) {
+        const uint64_t at = next_random(&seed) % (frames - BENCH_CLIP);
+        start = audio_clock_ns();
+        wav_stream_t stream;
+        size_t got = 0;
+        if (wav_stream_open(path, &stream)) {
+            got = wav_read_frames_at(&stream, at, BENCH_CLIP, clip);
+            wav_stream_close(&stream);
+        }
+        const double ms = (audio_clock_ns() - start) / 1e6;
+        total += ms;
+        if (ms > worst) worst = ms;
+        bool ok = got == BENCH_CLIP;
+        for (size_t k = 0; ok && k < got; ++k) {
+            ok = clip[2 * k] == frame_left(at + k) && clip[2 * k + 1] == frame_right(at + k);
+        }
+        if (!ok) ++errors;
+    }
+    printf("read_at,%d,%.3f,%.3f,%u\n", BENCH_READS, total / BENCH_READS, worst, errors);
+    free(clip);
+    if (errors) status = EXIT_FAILURE;
+
+    //* The stream keeps running between seeks; this thread plays the audio thread's part
+    audio_stream_t* stream = audio_stream_open_file(path, BENCH_RATE, 0);
+    if (!stream || !audio_stream_start(stream, false)) {
+        fprintf(stderr, "unable to stream %s\n", path);
+        remove(path);
+        return EXIT_FAILURE;
+    }
+    float out[BENCH_POLL * 2];
+    total = 0.0, worst = 0.0, errors = 0;
+    for (int i = 0; i < BENCH_SEEKS; ++i) {
+        const uint64_t target = next_random(&seed) % (frames - BENCH_RATE);
+        start = audio_clock_ns();
+        audio_stream_seek(stream, target);
+        bool found = false;
+        uint64_t expect = target;
+        //? Frames from before the jump may still come out until the feeder gets to it, never after
+        while (!found && audio_clock_ns() - start < 1000000000ull) {
+            size_t got = audio_stream_read(stream, out, BENCH_POLL);
+            for (size_t k = 0; k < got; ++k) {
+                const uint64_t index = float_frame_index(out + 2 * k);
+                if (found) {
+                    if (index != expect++) ++errors;
+                } else if (index == target) {
+                    found = true;
+                    ++expect;
+                    const double ms = (audio_clock_ns() - start) / 1e6;
+                    total += ms;
+                    if (ms > worst) worst = ms;
+                }
+            }
+            if (!found && got == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+        }
+        if (!found) {
+            ++errors;
+            continue;
+        }
+        //* And the frames after it follow on
+        while (expect < target + 4 * BENCH_POLL) {
+            size_t got = audio_stream_read(stream, out, BENCH_POLL);
+            for (size_t k = 0; k < got; ++k) {
+                if (float_frame_index(out + 2 * k) != expect++) ++errors;
+            }
+            if (got == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+        }
+    }
+    printf("seek,%d,%.3f,%.3f,%u\n", BENCH_SEEKS, total / BENCH_SEEKS, worst, errors);
+    if (errors) status = EXIT_FAILURE;
+
+    //* The old feeder sits finished at the end; a seek it picks up on the way out must not move the restart
+    total = 0.0, worst = 0.0, errors = 0;
+    for (int i = 0; i < BENCH_SEEKS; ++i) {
+        audio_stream_seek(stream, frames);
+        while (!audio_stream_finished(stream)) {
+            if (audio_stream_read(stream, out, BENCH_POLL) == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+        }
+        const uint64_t target = next_random(&seed) % (frames - BENCH_RATE);
+        audio_stream_seek(stream, next_random(&seed) % frames);
+        start = audio_clock_ns();
+        if (!audio_stream_start_at(stream, target, false)) {
+            ++errors;
+            continue;
+        }
+        size_t got = 0;
+        while (got == 0 && audio_clock_ns() - start < 1000000000ull) {
+            got = audio_stream_read(stream, out, BENCH_POLL);
+            if (got == 0) audio_sleep_until(audio_clock_ns() + 100000ull);
+        }
+        const double ms = (audio_clock_ns() - start) / 1e6;
+        total += ms;
+        if (ms > worst) worst = ms;
+        for (size_t k = 0; k < got; ++k) {
+            if (float_frame_index(out + 2 * k) != target + k) ++errors;
+        }
+        if (got == 0) ++errors;
+    }
+    printf("restart,%d,%.3f,%.3f,%u\n", BENCH_SEEKS, total / BENCH_SEEKS, worst, errors);
+    audio_stream_close(stream);
+    if (errors) status = EXIT_FAILURE;
+    remove(path);
+    return status;
+}
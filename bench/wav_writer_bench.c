@@ -0,0 +1,137 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+/**
+ * Output throughput of the WAV writer against the small writes it replaces.
+ *
+ *   wav_writer_bench [megabytes] [scratch.wav]
+ *
+ * Every case writes the same stereo 16-bit 48 kHz signal (256 MB by default) in
+ * 256 frame blocks, the size a render or conversion loop hands over:
+ *   - pwrite:    one write() per block, what an unbuffered writer does
+ *   - stdio:     fwrite() per block through the default FILE buffer
+ *   - writer:    wav_writer_append_frames() per block
+ *   - prealloc:  the same with expected_frames set, so the space is reserved up front
+ *   - one_shot:  wav_write_file() of the whole signal from memory
+ * Times include closing the file but not syncing it, so they measure the cost of
+ * getting the data into the page cache; every output is probed to check its sizes.
+ *
+ * Build:
+ *   gcc -O2 -Iwav_parser -Iutils bench/wav_writer_bench.c bench/bench_util.c wav_parser/wav_writer.c wav_parser/wav_parser.c \
+ *       utils/log.c utils/path_utils.c utils/file_io.c -pthread -lm -o wav_writer_bench
+ */
+
+#include "bench_util.h"
+#include <time.h>
+
+#define BENCH_RATE 48000
+#define BENCH_BLOCK 256
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool write_pwrite(const char* path, const wav_file_t* sound) {
+    io_file_t file;
+    uint8_t header[BENCH_CANONICAL_HEADER];
+    bench_canonical_header(header, &sound->header, (uint32_t)sound->data_length);
+    if (!io_create_file(path, &file)) return false;
+    bool ok = io_pwrite(&file, header, sizeof(header), 0) == (int64_t)sizeof(header);
+    uint64_t offset = sizeof(header);
+    const size_t block_bytes = BENCH_BLOCK * sound->header.block_align;
+    for (uint64_t done = 0; ok && done < sound->data_length; done += block_bytes) {
+        size_t n = (sound->data_length - done < block_bytes) ? (size_t)(sound->data_length - done) : block_bytes;
+        ok = io_pwrite(&file, sound->data + done, n, offset) == (int64_t)n;
+        offset += n;
+    }
+    io_close_file(&file);
+    return ok;
+}
+
+static bool write_stdio(const char* path, const wav_file_t* sound) {
+    uint8_t header[BENCH_CANONICAL_HEADER];
+    bench_canonical_header(header, &sound->header, (uint32_t)sound->data_length);
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+    const size_t block_bytes = BENCH_BLOCK * sound->header.block_align;
+    for (uint64_t done = 0; ok && done < sound->data_length; done += block_bytes) {
+        size_t n = (sound->data_length - done < block_bytes) ? (size_t)(sound->data_length - done) : block_bytes;
+        ok = fwrite(sound->data + done, 1, n, f) == n;
+    }
+    return fclose(f) == 0 && ok;
+}
+
+static bool write_streaming(const char* path, const wav_file_t* sound, bool preallocate) {
+    wav_writer_t writer;
+    wav_writer_options_t options = { preallocate ? sound->samples : 0, WAV_RF64_AUTO, 0 };
+    if (!wav_writer_open(&writer, path, &sound->header, &options)) return false;
+    bool ok = true;
+    for (uint64_t frame = 0; ok && frame < sound->samples; frame += BENCH_BLOCK) {
+        size_t n = (sound->samples - frame < BENCH_BLOCK) ? (size_t)(sound->samples - frame) : BENCH_BLOCK;
+        ok = wav_writer_append_frames(&writer, sound->data + frame * sound->header.block_align, n);
+    }
+    return wav_writer_close(&writer) && ok;
+}
+
+int main(int argc, char const *argv[])
+{
+    double megabytes = (argc > 1) ? atof(argv[1]) : 256.0;
+    if (megabytes <= 0.0) megabytes = 256.0;
+    const char* path = (argc > 2) ? argv[2] : "wav_writer_bench.wav";
+
+    wav_file_t sound;
+    wav_init_file(&sound);
+    wav_init_header(&sound.header, WAV_FORMAT_PCM, 2, BENCH_RATE, 16);
+    sound.samples = (uint64_t)(megabytes * 1048576.0) / sound.header.block_align;
+    sound.data_length = sound.samples * sound.header.block_align;
+    sound.data = (uint8_t*)malloc((size_t)sound.data_length);
+    if (!sound.data) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    int16_t* samples = (int16_t*)sound.data;
+    for (uint64_t i = 0; i < sound.samples * 2; ++i) samples[i] = (int16_t)(i * 2654435761u >> 16);
+
+    static const char* const names[] = { "pwrite", "stdio", "writer", "prealloc", "one_shot" };
+    printf("case,megabytes,ms,mb_per_s\n");
+    for (int c = 0; c < 5; ++c) {
+        remove(path);
+        uint64_t start = now_ns();
+        bool ok = false;
+        switch (c) {
+            case 0: ok = write_pwrite(path, &sound); break;
+            case 1: ok = write_stdio(path, &sound); break;
+            case 2: ok = write_streaming(path, &sound, false); break;
+            case 3: ok = write_streaming(path, &sound, true); break;
+            case 4: ok = wav_write_file(path, &sound); break;
+        }
+        double ms = (double)(now_ns() - start) / 1e6;
+        wav_probe_t probe;
+        if (!ok || !wav_probe(path, &probe) || probe.samples != sound.samples) {
+            fprintf(stderr, "%s: the output is wrong\n", names[c]);
+            return EXIT_FAILURE;
+        }
+        double mb = (double)sound.data_length / 1048576.0;
+        printf("%s,%.0f,%.1f,%.0f\n", names[c], mb, ms, mb / (ms / 1000.0));
+    }
+    remove(path);
+    free(sound.data);
+    return 0;
+}
@@ -37,6 +37,7 @@ static void clear_screen() {
 }
 
 void playsound_ui_demo(sound* snd) {
+    if (!snd) return;
     setup_console();
 
     const char* states[] = { "", ".", "..", "...", "...." };
@@ -1,10 +1,15 @@
 #include "wav_parser.h"
+#include "log.h"
 
 int main(int argc, char const *argv[])
 {
+    //? Any WAV given on the command line, otherwise the one shipped with the repo
+    const char* path = (argc > 1) ? argv[1] : "resources/sound/bass-wiggle.wav";
+    //? The parser's success messages are debug output, the demo is there to show them
+    LogSetLevel(LOG_DEBUG);
     wav_file_t file;
     wav_init_file(&file);
-    if(wav_parse_file("resources/sound/FlappyBird_Menu.wav", &file)) {
+    if(wav_parse_file(path, &file)) {
         wav_print_header(&file.header);
     }
     wav_free_file(&file);
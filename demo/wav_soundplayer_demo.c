@@ -4,6 +4,7 @@
 int main(int argc, char const *argv[])
 {
     sound *snd = sound_init("resources/sound/bass-wiggle.wav");
+    if (!snd) return EXIT_FAILURE;
     play_sound(snd);
     playsound_ui_demo(snd);
     //?for replay demo purposes
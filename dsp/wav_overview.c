@@ -0,0 +1,550 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_overview.h"
+#include "wav_isa.h"
+#include "wav_endian.h"
+#include "log.h"
+#include <errno.h>
+#include <math.h>
+
+#define OVERVIEW_CHUNK_FRAMES   4096    //? frames converted per pass, rounded up to whole buckets
+#define OVERVIEW_MAGIC          "WOVR"
+#define OVERVIEW_VERSION        1
+
+//* Running min/max/sum of squares for 8 lanes: lane k sees samples k, k + 8, k + 16...
+typedef struct lane_stats_t {
+    float min[8];
+    float max[8];
+    float sum[8];
+} lane_stats_t;
+
+typedef void (*stats_fn)(lane_stats_t* stats, const float* src, size_t samples);
+
+//=================================================STATS KERNELS==========================================================
+
+static void stats_scalar(lane_stats_t* stats, const float* src, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        const unsigned k = (unsigned)(i & 7);
+        const float v = src[i];
+        if (v < stats->min[k]) stats->min[k] = v;
+        if (v > stats->max[k]) stats->max[k] = v;
+        stats->sum[k] += v * v;
+    }
+}
+
+#ifdef WAV_ISA_X86
+TARGET_SSE2 static void stats_sse2(lane_stats_t* stats, const float* src, size_t samples) {
+    __m128 min0 = _mm_loadu_ps(stats->min), min1 = _mm_loadu_ps(stats->min + 4);
+    __m128 max0 = _mm_loadu_ps(stats->max), max1 = _mm_loadu_ps(stats->max + 4);
+    __m128 sum0 = _mm_loadu_ps(stats->sum), sum1 = _mm_loadu_ps(stats->sum + 4);
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4);
+        min0 = _mm_min_ps(min0, a);
+        min1 = _mm_min_ps(min1, b);
+        max0 = _mm_max_ps(max0, a);
+        max1 = _mm_max_ps(max1, b);
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+    }
+    _mm_storeu_ps(stats->min, min0); _mm_storeu_ps(stats->min + 4, min1);
+    _mm_storeu_ps(stats->max, max0); _mm_storeu_ps(stats->max + 4, max1);
+    _mm_storeu_ps(stats->sum, sum0); _mm_storeu_ps(stats->sum + 4, sum1);
+    if (i < samples) stats_scalar(stats, src + i, samples - i);    //? i is a multiple of 8, lanes stay aligned
+}
+
+TARGET_AVX2 static void stats_avx2(lane_stats_t* stats, const float* src, size_t samples) {
+    __m256 mn = _mm256_loadu_ps(stats->min), mx = _mm256_loadu_ps(stats->max), sm = _mm256_loadu_ps(stats->sum);
+    //? A second set of accumulators so the adds don't wait on each other
+    __m256 mn2 = mn, mx2 = mx, sm2 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m256 a = _mm256_loadu_ps(src + i);
+        __m256 b = _mm256_loadu_ps(src + i + 8);
+        mn = _mm256_min_ps(mn, a);
+        mn2 = _mm256_min_ps(mn2, b);
+        mx = _mm256_max_ps(mx, a);
+        mx2 = _mm256_max_ps(mx2, b);
+        sm = _mm256_add_ps(sm, _mm256_mul_ps(a, a));
+        sm2 = _mm256_add_ps(sm2, _mm256_mul_ps(b, b));
+    }
+    if (i + 8 <= samples) {
+        __m256 a = _mm256_loadu_ps(src + i);
+        mn = _mm256_min_ps(mn, a);
+        mx = _mm256_max_ps(mx, a);
+        sm = _mm256_add_ps(sm, _mm256_mul_ps(a, a));
+        i += 8;
+    }
+    _mm256_storeu_ps(stats->min, _mm256_min_ps(mn, mn2));
+    _mm256_storeu_ps(stats->max, _mm256_max_ps(mx, mx2));
+    _mm256_storeu_ps(stats->sum, _mm256_add_ps(sm, sm2));
+    _mm256_zeroupper();
+    if (i < samples) stats_scalar(stats, src + i, samples - i);
+}
+#endif
+
+static const stats_fn stats_kernels[WAV_ISA_COUNT] = {
+    stats_scalar,
+#ifdef WAV_ISA_X86
+    stats_sse2,
+    stats_avx2,
+#endif
+};
+
+static void lane_stats_reset(lane_stats_t* stats) {
+    for (int k = 0; k < 8; ++k) {
+        stats->min[k] = INFINITY;
+        stats->max[k] = -INFINITY;
+        stats->sum[k] = 0.0f;
+    }
+}
+
+//=================================================BUILDING==========================================================
+
+typedef struct overview_builder_t {
+    wav_overview_t* overview;
+    stats_fn stats;
+    uint64_t bucket;            //? next level 0 bucket to fill
+    float* planes_data;         //? deinterleaved chunk, only for channel counts that don't divide 8
+    float** planes;
+} overview_builder_t;
+
+void wav_overview_init(wav_overview_t* overview) {
+    memset(overview, 0, sizeof(*overview));
+}
+
+void wav_overview_free(wav_overview_t* overview) {
+    if (!overview) return;
+    free(overview->storage);
+    free(overview->levels);
+    wav_overview_init(overview);
+}
+
+static bool overview_alloc(wav_overview_t* overview, uint16_t channels, uint32_t sample_rate, uint64_t frames, uint32_t block_log2) {
+    wav_overview_init(overview);
+    if (channels == 0 || block_log2 < WAV_OVERVIEW_MIN_BLOCK_LOG2 || block_log2 > WAV_OVERVIEW_MAX_BLOCK_LOG2) {
+        Log(LOG_ERROR, "Invalid overview layout: %u channels, %u frames per bucket.\n", channels, 1u << (block_log2 & 31));
+        return false;
+    }
+    overview->num_channels = channels;
+    overview->sample_rate = sample_rate;
+    overview->frames = frames;
+    overview->block_log2 = block_log2;
+    //? Levels go up to one bucket for the whole file (an empty file still gets one empty bucket)
+    uint64_t buckets = (frames >> block_log2) + ((frames & ((1ull << block_log2) - 1)) != 0);
+    if (buckets == 0) buckets = 1;
+    uint64_t total = 0;
+    uint32_t levels = 0;
+    for (uint64_t b = buckets; ; b = (b + 1) / 2) {
+        total += b;
+        ++levels;
+        if (b == 1) break;
+    }
+    if (total > SIZE_MAX / sizeof(float) / 3 / channels) {
+        Log(LOG_ERROR, "The overview of %llu frames doesn't fit in memory.\n", (unsigned long long)frames);
+        return false;
+    }
+    overview->levels = (wav_overview_level_t*)calloc(levels, sizeof(wav_overview_level_t));
+    overview->storage = (float*)malloc((size_t)(total * channels * 3) * sizeof(float));
+    if (!overview->levels || !overview->storage) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the overview of %llu frames.\n", (unsigned long long)frames);
+        wav_overview_free(overview);
+        return false;
+    }
+    overview->num_levels = levels;
+    float* p = overview->storage;
+    for (uint32_t l = 0; l < levels; ++l) {
+        wav_overview_level_t* level = &overview->levels[l];
+        level->block_frames = 1ull << (block_log2 + l);
+        level->buckets = buckets;
+        level->min = p;
+        level->max = p + buckets * channels;
+        level->power = p + 2 * buckets * channels;
+        p += 3 * buckets * channels;
+        buckets = (buckets + 1) / 2;
+    }
+    return true;
+}
+
+//? Frames covered by bucket `i` of a level, only the last one can be short
+static uint64_t bucket_frames(const wav_overview_t* overview, uint32_t level, uint64_t i) {
+    const uint64_t block = 1ull << (overview->block_log2 + level);
+    const uint64_t start = i * block;
+    if (start >= overview->frames) return 0;
+    return (overview->frames - start < block) ? overview->frames - start : block;
+}
+
+//* Reduces whole buckets of interleaved float frames into level 0 (`frames` is a multiple of the bucket size except at the end)
+static void overview_scan(overview_builder_t* builder, const float* src, size_t frames) {
+    wav_overview_t* overview = builder->overview;
+    wav_overview_level_t* level = &overview->levels[0];
+    const uint16_t channels = overview->num_channels;
+    const size_t block = (size_t)1 << overview->block_log2;
+    const bool lanes_match = (8 % channels) == 0;
+    if (!lanes_match) wav_deinterleave_f32(builder->planes, src, frames, channels);
+
+    for (size_t done = 0; done < frames; done += block) {
+        const size_t n = (frames - done < block) ? frames - done : block;
+        const uint64_t i = builder->bucket++;
+        lane_stats_t stats;
+        if (lanes_match) {
+            //? With 1, 2, 4 or 8 channels lane k always holds channel k % channels
+            lane_stats_reset(&stats);
+            builder->stats(&stats, src + done * channels, n * channels);
+            for (uint16_t c = 0; c < channels; ++c) {
+                float mn = INFINITY, mx = -INFINITY;
+                double sum = 0.0;
+                for (unsigned k = c; k < 8; k += channels) {
+                    if (stats.min[k] < mn) mn = stats.min[k];
+                    if (stats.max[k] > mx) mx = stats.max[k];
+                    sum += stats.sum[k];
+                }
+                level->min[c * level->buckets + i] = mn;
+                level->max[c * level->buckets + i] = mx;
+                level->power[c * level->buckets + i] = (float)(sum / (double)n);
+            }
+        } else {
+            for (uint16_t c = 0; c < channels; ++c) {
+                lane_stats_reset(&stats);
+                builder->stats(&stats, builder->planes[c] + done, n);
+                float mn = stats.min[0], mx = stats.max[0];
+                double sum = 0.0;
+                for (int k = 0; k < 8; ++k) {
+                    if (stats.min[k] < mn) mn = stats.min[k];
+                    if (stats.max[k] > mx) mx = stats.max[k];
+                    sum += stats.sum[k];
+                }
+                level->min[c * level->buckets + i] = mn;
+                level->max[c * level->buckets + i] = mx;
+                level->power[c * level->buckets + i] = (float)(sum / (double)n);
+            }
+        }
+    }
+}
+
+//* Every level above 0 merges pairs of buckets from the one below
+static void overview_build_levels(wav_overview_t* overview) {
+    const uint16_t channels = overview->num_channels;
+    if (overview->frames == 0) {
+        for (uint16_t c = 0; c < channels; ++c) {
+            overview->levels[0].min[c] = overview->levels[0].max[c] = overview->levels[0].power[c] = 0.0f;
+        }
+    }
+    for (uint32_t l = 1; l < overview->num_levels; ++l) {
+        const wav_overview_level_t* below = &overview->levels[l - 1];
+        wav_overview_level_t* level = &overview->levels[l];
+        for (uint64_t i = 0; i < level->buckets; ++i) {
+            const uint64_t a = 2 * i, b = 2 * i + 1;
+            const double na = (double)bucket_frames(overview, l - 1, a);
+            const double nb = (b < below->buckets) ? (double)bucket_frames(overview, l - 1, b) : 0.0;
+            for (uint16_t c = 0; c < channels; ++c) {
+                const size_t ia = c * below->buckets + a, ib = c * below->buckets + b, io = c * level->buckets + i;
+                float mn = below->min[ia], mx = below->max[ia];
+                double power = below->power[ia] * na;
+                if (nb > 0.0) {
+                    if (below->min[ib] < mn) mn = below->min[ib];
+                    if (below->max[ib] > mx) mx = below->max[ib];
+                    power += below->power[ib] * nb;
+                }
+                level->min[io] = mn;
+                level->max[io] = mx;
+                level->power[io] = (na + nb > 0.0) ? (float)(power / (na + nb)) : 0.0f;
+            }
+        }
+    }
+}
+
+static bool builder_init(overview_builder_t* builder, wav_overview_t* overview, size_t chunk_frames) {
+    memset(builder, 0, sizeof(*builder));
+    builder->overview = overview;
+    builder->stats = stats_kernels[wav_convert_get_isa()];
+    if (8 % overview->num_channels != 0) {
+        builder->planes_data = (float*)malloc(chunk_frames * overview->num_channels * sizeof(float));
+        builder->planes = (float**)malloc(overview->num_channels * sizeof(float*));
+        if (!builder->planes_data || !builder->planes) return false;
+        for (uint16_t c = 0; c < overview->num_channels; ++c) builder->planes[c] = builder->planes_data + c * chunk_frames;
+    }
+    return true;
+}
+
+//? Conversion chunk: at least OVERVIEW_CHUNK_FRAMES and always whole buckets, so only the last one is partial
+static size_t chunk_frames_for(uint32_t block_log2) {
+    const size_t block = (size_t)1 << block_log2;
+    return (block >= OVERVIEW_CHUNK_FRAMES) ? block : OVERVIEW_CHUNK_FRAMES;
+}
+
+bool wav_overview_build(wav_overview_t* overview, const wav_file_t* file, uint32_t block_log2) {
+    if (!overview || !file || (!file->data && file->samples > 0)) return false;
+    wav_sample_format_t format;
+    if (!wav_sample_format_from_header(&file->header, &format)) {
+        Log(LOG_ERROR, "Format %d with %d bits per sample has no conversion kernel.\n", file->header.encoding, file->header.bits_per_sample);
+        return false;
+    }
+    if (!overview_alloc(overview, file->header.num_channels, file->header.sample_rate, file->samples, block_log2)) return false;
+
+    const size_t chunk = chunk_frames_for(block_log2);
+    const uint16_t channels = overview->num_channels;
+    overview_builder_t builder = {0};
+    float* scratch = (float*)malloc(chunk * channels * sizeof(float));
+    bool retval = scratch && builder_init(&builder, overview, chunk);
+    if (!retval) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the overview's scratch buffers.\n");
+        free(builder.planes_data);
+        free(builder.planes);
+        free(scratch);
+        wav_overview_free(overview);
+        return false;
+    }
+    for (uint64_t done = 0; done < file->samples; ) {
+        const size_t n = (file->samples - done < chunk) ? (size_t)(file->samples - done) : chunk;
+        wav_convert_to_float(scratch, file->data + done * file->header.block_align, n * channels, format);
+        overview_scan(&builder, scratch, n);
+        done += n;
+    }
+    overview_build_levels(overview);
+    free(builder.planes_data);
+    free(builder.planes);
+    free(scratch);
+    return true;
+}
+
+bool wav_overview_build_stream(wav_overview_t* overview, wav_stream_t* stream, uint32_t block_log2) {
+    if (!overview || !stream) return false;
+    wav_sample_format_t format;
+    if (!wav_sample_format_from_header(&stream->header, &format)) {
+        Log(LOG_ERROR, "Format %d with %d bits per sample has no conversion kernel.\n", stream->header.encoding, stream->header.bits_per_sample);
+        return false;
+    }
+    if (!wav_stream_rewind(stream)) return false;
+    if (!overview_alloc(overview, stream->header.num_channels, stream->header.sample_rate, stream->frames_total, block_log2)) return false;
+
+    const size_t chunk = chunk_frames_for(block_log2);
+    const uint16_t channels = overview->num_channels;
+    overview_builder_t builder = {0};
+    uint8_t* raw = (uint8_t*)malloc(chunk * stream->header.block_align);
+    float* scratch = (float*)malloc(chunk * channels * sizeof(float));
+    bool retval = raw && scratch && builder_init(&builder, overview, chunk);
+    if (!retval) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the overview's scratch buffers.\n");
+        goto cleanup;
+    }
+    uint64_t done = 0;
+    size_t got;
+    while ((got = wav_stream_read_frames(stream, raw, chunk)) > 0) {
+        wav_convert_to_float(scratch, raw, got * channels, format);
+        overview_scan(&builder, scratch, got);
+        done += got;
+        //! a short read in the middle would shift every bucket after it
+        if (got < chunk && stream->frames_left > 0) break;
+    }
+    if (done != overview->frames) {
+        Log(LOG_ERROR, "Read %llu of %llu frames while building the overview.\n", (unsigned long long)done, (unsigned long long)overview->frames);
+        retval = false;
+        goto cleanup;
+    }
+    overview_build_levels(overview);
+
+cleanup:
+    free(builder.planes_data);
+    free(builder.planes);
+    free(scratch);
+    free(raw);
+    if (!retval) wav_overview_free(overview);
+    return retval;
+}
+
+//=================================================QUERIES==========================================================
+
+size_t wav_overview_query(const wav_overview_t* overview, uint16_t channel, uint64_t first_frame, uint64_t frames, size_t pixels, wav_overview_point_t* out) {
+    if (!overview || !overview->levels || channel >= overview->num_channels || pixels == 0 || !out) return 0;
+    if (first_frame >= overview->frames || frames == 0) return 0;
+
+    //? Coarsest level whose buckets are no wider than a pixel, each column then reads 1 to 3 buckets
+    uint32_t l = 0;
+    while (l + 1 < overview->num_levels && overview->levels[l + 1].block_frames * pixels <= frames) ++l;
+    const wav_overview_level_t* level = &overview->levels[l];
+    const uint32_t shift = overview->block_log2 + l;
+    const float* mins = level->min + (size_t)channel * level->buckets;
+    const float* maxs = level->max + (size_t)channel * level->buckets;
+    const float* power = level->power + (size_t)channel * level->buckets;
+
+    size_t written = 0;
+    for (size_t p = 0; p < pixels; ++p) {
+        //? frames * p can overflow on long files, split the range in double instead
+        uint64_t start = first_frame + (uint64_t)((double)frames * (double)p / (double)pixels);
+        uint64_t end = first_frame + (uint64_t)((double)frames * (double)(p + 1) / (double)pixels);
+        if (end <= start) end = start + 1;
+        if (start >= overview->frames) break;
+        if (end > overview->frames) end = overview->frames;
+
+        const uint64_t first = start >> shift, last = (end - 1) >> shift;
+        float mn = mins[first], mx = maxs[first];
+        double sum = 0.0, weight = 0.0;
+        for (uint64_t b = first; b <= last; ++b) {
+            const double n = (double)bucket_frames(overview, l, b);
+            if (mins[b] < mn) mn = mins[b];
+            if (maxs[b] > mx) mx = maxs[b];
+            sum += power[b] * n;
+            weight += n;
+        }
+        out[p].min = mn;
+        out[p].max = mx;
+        out[p].rms = (weight > 0.0) ? (float)sqrt(sum / weight) : 0.0f;
+        ++written;
+    }
+    return written;
+}
+
+//=================================================SIDECAR FILES==========================================================
+//* "WOVR", u32 version, u16 channels, u16 block_log2, u32 sample rate, u64 frames, then level 0 per
+//* channel: `buckets` i16 minimums, `buckets` i16 maximums, `buckets` u16 RMS values.
+
+#define OVERVIEW_HEADER_SIZE 24
+
+static int16_t quantize_peak(float v, bool round_up) {
+    double q = round_up ? ceil((double)v * 32767.0) : floor((double)v * 32767.0);
+    if (q < -32768.0) q = -32768.0;
+    if (q > 32767.0) q = 32767.0;
+    return (int16_t)q;
+}
+
+static uint16_t quantize_rms(float power) {
+    double q = sqrt((double)power) * 65535.0 + 0.5;
+    return (q > 65535.0) ? 65535 : (uint16_t)q;
+}
+
+bool wav_overview_save(const wav_overview_t* overview, const char* path) {
+    if (!overview || !overview->levels || !path) return false;
+    const wav_overview_level_t* level = &overview->levels[0];
+    uint8_t header[OVERVIEW_HEADER_SIZE];
+    memcpy(header, OVERVIEW_MAGIC, 4);
+    encode_u32(header + 4, OVERVIEW_VERSION);
+    encode_u16(header + 8, overview->num_channels);
+    encode_u16(header + 10, (uint16_t)overview->block_log2);
+    encode_u32(header + 12, overview->sample_rate);
+    encode_u64(header + 16, overview->frames);
+
+    bool retval = false;
+    uint8_t* row = NULL;
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        Log(LOG_ERROR, "Unable to create %s. Reason: %s\n", path, strerror(errno));
+        return false;
+    }
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) goto cleanup;
+    if (level->buckets > SIZE_MAX / 2) goto cleanup;
+    row = (uint8_t*)malloc((size_t)level->buckets * 2);
+    if (!row) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to encode %s.\n", path);
+        goto cleanup;
+    }
+    for (uint16_t c = 0; c < overview->num_channels; ++c) {
+        const size_t base = (size_t)c * level->buckets;
+        for (uint64_t i = 0; i < level->buckets; ++i) encode_u16(row + 2 * i, (uint16_t)quantize_peak(level->min[base + i], false));
+        if (fwrite(row, 2, (size_t)level->buckets, file) != level->buckets) goto cleanup;
+        for (uint64_t i = 0; i < level->buckets; ++i) encode_u16(row + 2 * i, (uint16_t)quantize_peak(level->max[base + i], true));
+        if (fwrite(row, 2, (size_t)level->buckets, file) != level->buckets) goto cleanup;
+        for (uint64_t i = 0; i < level->buckets; ++i) encode_u16(row + 2 * i, quantize_rms(level->power[base + i]));
+        if (fwrite(row, 2, (size_t)level->buckets, file) != level->buckets) goto cleanup;
+    }
+    retval = true;
+
+cleanup:
+    if (fclose(file) != 0) retval = false;
+    if (!retval) Log(LOG_ERROR, "Unable to write the overview to %s.\n", path);
+    free(row);
+    return retval;
+}
+
+bool wav_overview_load(wav_overview_t* overview, const char* path) {
+    if (!overview || !path) return false;
+    wav_overview_init(overview);
+    bool retval = false;
+    uint8_t* row = NULL;
+    uint8_t header[OVERVIEW_HEADER_SIZE];
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        Log(LOG_ERROR, "Unable to open %s. Reason: %s\n", path, strerror(errno));
+        return false;
+    }
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, OVERVIEW_MAGIC, 4) != 0) {
+        Log(LOG_ERROR, "%s isn't an overview file.\n", path);
+        goto cleanup;
+    }
+    if (decode_u32(header + 4) != OVERVIEW_VERSION) {
+        Log(LOG_ERROR, "%s: unsupported overview version %u.\n", path, decode_u32(header + 4));
+        goto cleanup;
+    }
+    const uint16_t channels = decode_u16(header + 8);
+    const uint32_t block_log2 = decode_u16(header + 10);
+    const uint64_t frames = decode_u64(header + 16);
+    if (channels == 0 || block_log2 < WAV_OVERVIEW_MIN_BLOCK_LOG2 || block_log2 > WAV_OVERVIEW_MAX_BLOCK_LOG2) {
+        Log(LOG_ERROR, "%s: invalid overview layout.\n", path);
+        goto cleanup;
+    }
+    //! The header is untrusted: the payload that is actually there must hold exactly the buckets `frames` needs
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, OVERVIEW_HEADER_SIZE, SEEK_SET) != 0) {
+        Log(LOG_ERROR, "Unable to read %s. Reason: %s\n", path, strerror(errno));
+        goto cleanup;
+    }
+    const uint64_t payload = (uint64_t)size - OVERVIEW_HEADER_SIZE;
+    const uint64_t row_bytes = 6ull * channels;
+    uint64_t buckets = (frames >> block_log2) + ((frames & ((1ull << block_log2) - 1)) != 0);
+    if (buckets == 0) buckets = 1;
+    if (payload % row_bytes != 0 || payload / row_bytes != buckets) {
+        Log(LOG_ERROR, "%s: %llu frames don't match the file's size.\n", path, (unsigned long long)frames);
+        goto cleanup;
+    }
+    if (!overview_alloc(overview, channels, decode_u32(header + 12), frames, block_log2)) goto cleanup;
+
+    wav_overview_level_t* level = &overview->levels[0];
+    row = (uint8_t*)malloc((size_t)level->buckets * 2);
+    if (!row) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to decode %s.\n", path);
+        goto cleanup;
+    }
+    for (uint16_t c = 0; c < overview->num_channels; ++c) {
+        float* const dst[3] = { level->min, level->max, level->power };
+        const size_t base = (size_t)c * level->buckets;
+        for (int k = 0; k < 3; ++k) {
+            if (fread(row, 2, (size_t)level->buckets, file) != level->buckets) {
+                Log(LOG_ERROR, "%s is truncated.\n", path);
+                goto cleanup;
+            }
+            for (uint64_t i = 0; i < level->buckets; ++i) {
+                const uint16_t v = decode_u16(row + 2 * i);
+                if (k < 2) {
+                    dst[k][base + i] = (float)(int16_t)v / 32767.0f;
+                } else {
+                    const float rms = (float)v / 65535.0f;
+                    dst[k][base + i] = rms * rms;
+                }
+            }
+        }
+    }
+    overview_build_levels(overview);
+    retval = true;
+
+cleanup:
+    fclose(file);
+    free(row);
+    if (!retval) wav_overview_free(overview);
+    return retval;
+}
@@ -0,0 +1,117 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_planar.h"
+
+#define WAV_OVERVIEW_DEFAULT_BLOCK_LOG2 8       //? 256 frames per finest bucket, ~5 ms at 48 kHz
+#define WAV_OVERVIEW_MIN_BLOCK_LOG2     4
+#define WAV_OVERVIEW_MAX_BLOCK_LOG2     16
+
+/**
+ * One resolution of an overview. Bucket `i` of channel `c` covers frames
+ * [i * block_frames, (i + 1) * block_frames); the last one may be shorter.
+ */
+typedef struct wav_overview_level_t {
+    uint64_t block_frames;
+    uint64_t buckets;
+    float* min;                 //? [c * buckets + i], normalized like wav_convert_to_float()
+    float* max;
+    float* power;               //? mean square, so levels can be merged; rms is its square root
+} wav_overview_level_t;
+
+/**
+ * Min/max/RMS pyramid of a file, per channel. Level 0 has buckets of
+ * 2^block_log2 frames and every level above halves the bucket count, up to a
+ * single bucket for the whole file, so any zoom is answered from about one
+ * bucket per pixel. At the default bucket size it takes ~5% of the memory of the
+ * 16-bit samples it describes, ~1.2% once saved.
+ */
+typedef struct wav_overview_t {
+    uint16_t num_channels;
+    uint32_t sample_rate;
+    uint64_t frames;
+    uint32_t block_log2;
+    uint32_t num_levels;
+    wav_overview_level_t* levels;
+    float* storage;             //? the one allocation behind every level's arrays
+} wav_overview_t;
+
+/**
+ * One pixel column of a waveform.
+ */
+typedef struct wav_overview_point_t {
+    float min;
+    float max;
+    float rms;
+} wav_overview_point_t;
+
+/**
+ * @brief Initializes an overview to an empty state, safe to pass to wav_overview_free().
+ */
+void wav_overview_init(wav_overview_t* overview);
+
+/**
+ * @brief Builds the overview of a loaded file in one pass over its samples.
+ *
+ * Samples are converted to float a cache-sized chunk at a time and reduced with
+ * the SSE2/AVX2 kernels (see wav_convert_set_isa()), so the pass runs at about the
+ * speed the samples can be read from memory.
+ *
+ * @param block_log2 finest bucket size, WAV_OVERVIEW_MIN_BLOCK_LOG2 to WAV_OVERVIEW_MAX_BLOCK_LOG2.
+ * @returns `false` on an unsupported format or if an allocation fails.
+ */
+bool wav_overview_build(wav_overview_t* overview, const wav_file_t* file, uint32_t block_log2);
+
+/**
+ * @brief Same as wav_overview_build() but reads the samples from a stream, for files
+ *        too large to load. The stream is rewound first and left at its end.
+ */
+bool wav_overview_build_stream(wav_overview_t* overview, wav_stream_t* stream, uint32_t block_log2);
+
+/**
+ * @brief Reduces `frames` frames of one channel from `first_frame` on to `pixels` columns.
+ *
+ * Reads the coarsest level whose buckets still fit in a pixel, so the cost depends
+ * on `pixels` only. Zoomed in past level 0 each bucket spans several pixels and is
+ * repeated.
+ *
+ * @returns the number of columns written, fewer than `pixels` if the range runs past the end.
+ */
+size_t wav_overview_query(const wav_overview_t* overview, uint16_t channel, uint64_t first_frame, uint64_t frames, size_t pixels, wav_overview_point_t* out);
+
+/**
+ * @brief Writes the overview to a sidecar file.
+ *
+ * Only level 0 is stored, the levels above are rebuilt on load. Min/max are
+ * stored as 16-bit values rounded outwards (so the loaded peaks never hide a
+ * sample), RMS as 16-bit unsigned; values past full scale are clipped. That's
+ * 6 bytes per bucket per channel, little-endian.
+ */
+bool wav_overview_save(const wav_overview_t* overview, const char* path);
+
+/**
+ * @brief Loads a sidecar written by wav_overview_save().
+ *
+ * Check `frames`, `sample_rate` and `num_channels` against the audio file before
+ * trusting it.
+ */
+bool wav_overview_load(wav_overview_t* overview, const char* path);
+
+/**
+ * @brief Frees the levels and resets `overview`.
+ */
+void wav_overview_free(wav_overview_t* overview);
@@ -0,0 +1,400 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_resampler.h"
+#include "wav_isa.h"
+#include "log.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RESAMPLER_MAX_PHASES    1024    //? above this many exact phases, interpolate between stored ones
+#define RESAMPLER_MAX_TAPS      2048    //? caps the filter length for extreme downsampling ratios
+#define RESAMPLER_BLOCK         1024    //? input frames buffered per channel on top of the filter length
+#define RESAMPLE_FILE_BLOCK     4096    //? frames per pass in wav_resample_file()
+
+typedef struct resample_preset_t {
+    uint32_t taps;
+    double attenuation;         //? stopband attenuation in dB, sets the Kaiser window's beta
+} resample_preset_t;
+
+static const resample_preset_t presets[] = {
+    [WAV_RESAMPLE_FAST]   = { 16,  60.0 },
+    [WAV_RESAMPLE_MEDIUM] = { 32,  80.0 },
+    [WAV_RESAMPLE_BEST]   = { 64, 100.0 },
+};
+
+typedef float (*dot_fn)(const float* x, const float* h, uint32_t taps);
+
+//=================================================DOT PRODUCTS==========================================================
+//* `taps` is always a multiple of 8, the filter rows are zero-padded to get there
+
+static float dot_scalar(const float* x, const float* h, uint32_t taps) {
+    float acc[8] = {0};
+    for (uint32_t i = 0; i < taps; i += 8) {
+        for (int k = 0; k < 8; ++k) {
+            acc[k] += x[i + k] * h[i + k];
+        }
+    }
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+}
+
+#ifdef WAV_ISA_X86
+TARGET_SSE2 static float dot_sse2(const float* x, const float* h, uint32_t taps) {
+    __m128 a = _mm_setzero_ps();
+    __m128 b = _mm_setzero_ps();
+    for (uint32_t i = 0; i < taps; i += 8) {
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(x + i),     _mm_loadu_ps(h + i)));
+        b = _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(h + i + 4)));
+    }
+    a = _mm_add_ps(a, b);
+    a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    a = _mm_add_ss(a, _mm_shuffle_ps(a, a, 1));
+    return _mm_cvtss_f32(a);
+}
+
+TARGET_AVX2 static float dot_avx2(const float* x, const float* h, uint32_t taps) {
+    __m256 a = _mm256_setzero_ps();
+    __m256 b = _mm256_setzero_ps();
+    uint32_t i = 0;
+    //? Two accumulators hide the add latency on the long downsampling filters
+    for (; i + 16 <= taps; i += 16) {
+        a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(x + i),     _mm256_loadu_ps(h + i)));
+        b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(h + i + 8)));
+    }
+    if (i < taps) {
+        a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i)));
+    }
+    a = _mm256_add_ps(a, b);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+#endif
+
+static const dot_fn dot_kernels[WAV_ISA_COUNT] = {
+    dot_scalar,
+#ifdef WAV_ISA_X86
+    dot_sse2,
+    dot_avx2,
+#endif
+};
+
+//=================================================FILTER DESIGN==========================================================
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+//? Zeroth order modified Bessel function of the first kind, series expansion
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0, half = x / 2.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (half / k) * (half / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+static double kaiser_beta(double attenuation) {
+    if (attenuation > 50.0) return 0.1102 * (attenuation - 8.7);
+    if (attenuation >= 21.0) return 0.5842 * pow(attenuation - 21.0, 0.4) + 0.07886 * (attenuation - 21.0);
+    return 0.0;
+}
+
+/**
+ * Fills `row` with the phase whose output sits `frac` (0..1) of the way between two
+ * inputs. Tap j weighs history sample j of the window, `taps / 2 - 1 - j + frac` input
+ * samples before the output instant.
+ */
+static void design_phase(float* row, uint32_t taps, double frac, double cutoff, double beta) {
+    const double half = taps / 2.0;
+    const double norm = bessel_i0(beta);
+    double sum = 0.0;
+    double coefs[RESAMPLER_MAX_TAPS];
+    for (uint32_t j = 0; j < taps; ++j) {
+        double d = half - 1.0 - j + frac;
+        double x = cutoff * d;
+        double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        double r = d / half;
+        double window = (fabs(r) >= 1.0) ? 0.0 : bessel_i0(beta * sqrt(1.0 - r * r)) / norm;
+        coefs[j] = cutoff * sinc * window;
+        sum += coefs[j];
+    }
+    //* Unity DC gain on every phase, otherwise the phases ripple against each other
+    for (uint32_t j = 0; j < taps; ++j) {
+        row[j] = (float)(coefs[j] / sum);
+    }
+}
+
+//=================================================RESAMPLER==========================================================
+
+bool wav_resampler_init(wav_resampler_t* resampler, uint32_t in_rate, uint32_t out_rate, uint16_t num_channels, wav_resample_quality_t quality) {
+    if (!resampler) return false;
+    memset(resampler, 0, sizeof(*resampler));
+    if (in_rate == 0 || out_rate == 0 || num_channels == 0 || (unsigned)quality > WAV_RESAMPLE_BEST) {
+        Log(LOG_ERROR, "Invalid resampler setup: %u Hz -> %u Hz, %u channels.\n", in_rate, out_rate, num_channels);
+        return false;
+    }
+    const resample_preset_t* preset = &presets[quality];
+    uint32_t g = gcd_u32(in_rate, out_rate);
+    resampler->in_rate = in_rate;
+    resampler->out_rate = out_rate;
+    resampler->num_channels = num_channels;
+    resampler->up = out_rate / g;
+    resampler->down = in_rate / g;
+
+    //? Kaiser's estimate of the transition band for this length/attenuation; the cutoff is placed
+    //? so the stopband starts right at the output Nyquist frequency
+    double ratio = (out_rate < in_rate) ? (double)out_rate / in_rate : 1.0;
+    double transition = (preset->attenuation - 8.0) / (2.285 * preset->taps * M_PI);
+    double cutoff = (1.0 - transition / 2.0) * ratio;
+    //* Downsampling narrows the passband, the filter stretches by the same factor to keep its shape
+    double taps = ceil(preset->taps / ratio / 8.0) * 8.0;
+    if (taps > RESAMPLER_MAX_TAPS) {
+        Log(LOG_ERROR, "Resampling %u Hz to %u Hz needs a %.0f tap filter, the limit is %d.\n", in_rate, out_rate, taps, RESAMPLER_MAX_TAPS);
+        return false;
+    }
+    resampler->taps = (uint32_t)taps;
+    resampler->interpolate = resampler->up > RESAMPLER_MAX_PHASES;
+    resampler->phases = resampler->interpolate ? RESAMPLER_MAX_PHASES : resampler->up;
+
+    //? One more row when interpolating: phase `phases` (frac = 1) is the right neighbour of the last one
+    uint32_t rows = resampler->phases + (resampler->interpolate ? 1 : 0);
+    resampler->filter = (float*)malloc((size_t)rows * resampler->taps * sizeof(float));
+    resampler->capacity = resampler->taps + RESAMPLER_BLOCK;
+    resampler->history_data = (float*)malloc(resampler->capacity * num_channels * sizeof(float));
+    resampler->history = (float**)malloc(num_channels * sizeof(float*));
+    resampler->planes = (float**)malloc(num_channels * sizeof(float*));
+    if (!resampler->filter || !resampler->history_data || !resampler->history || !resampler->planes) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the resampler tables.\n");
+        wav_resampler_free(resampler);
+        return false;
+    }
+    double beta = kaiser_beta(preset->attenuation);
+    for (uint32_t p = 0; p < rows; ++p) {
+        design_phase(resampler->filter + (size_t)p * resampler->taps, resampler->taps, (double)p / resampler->phases, cutoff, beta);
+    }
+    for (uint16_t c = 0; c < num_channels; ++c) {
+        resampler->history[c] = resampler->history_data + resampler->capacity * c;
+    }
+    wav_resampler_reset(resampler);
+    return true;
+}
+
+void wav_resampler_reset(wav_resampler_t* resampler) {
+    if (!resampler || !resampler->history_data) return;
+    memset(resampler->history_data, 0, resampler->capacity * resampler->num_channels * sizeof(float));
+    //? taps/2 - 1 zeros in front line the first output up with the first input sample
+    resampler->filled = resampler->taps / 2 - 1;
+    resampler->pos = 0;
+    resampler->phase = 0;
+    resampler->frames_in = 0;
+    resampler->frames_out = 0;
+}
+
+void wav_resampler_free(wav_resampler_t* resampler) {
+    if (!resampler) return;
+    free(resampler->filter);
+    free(resampler->history_data);
+    free(resampler->history);
+    free(resampler->planes);
+    memset(resampler, 0, sizeof(*resampler));
+}
+
+uint64_t wav_resampler_output_frames(const wav_resampler_t* resampler, uint64_t in_frames) {
+    //? Every output instant before the end of the input, i.e. ceil(in * up / down)
+    return (in_frames * resampler->up + resampler->down - 1) / resampler->down;
+}
+
+//* Drops the history nothing will read anymore so new input fits behind what's left
+static void resampler_compact(wav_resampler_t* resampler) {
+    size_t drop = (resampler->pos < resampler->filled) ? resampler->pos : resampler->filled;
+    if (drop == 0) return;
+    for (uint16_t c = 0; c < resampler->num_channels; ++c) {
+        memmove(resampler->history[c], resampler->history[c] + drop, (resampler->filled - drop) * sizeof(float));
+    }
+    resampler->filled -= drop;
+    resampler->pos -= drop;
+}
+
+//* Appends up to `frames` frames of `in` (or silence when NULL), returns how many fit
+static size_t resampler_append(wav_resampler_t* resampler, const float* in, size_t frames) {
+    size_t space = resampler->capacity - resampler->filled;
+    if (frames > space) frames = space;
+    if (frames == 0) return 0;
+    if (in == NULL) {
+        for (uint16_t c = 0; c < resampler->num_channels; ++c) {
+            memset(resampler->history[c] + resampler->filled, 0, frames * sizeof(float));
+        }
+    } else {
+        //? Split straight into the per-channel histories, offset to their current ends
+        for (uint16_t c = 0; c < resampler->num_channels; ++c) {
+            resampler->planes[c] = resampler->history[c] + resampler->filled;
+        }
+        wav_deinterleave_f32(resampler->planes, in, frames, resampler->num_channels);
+    }
+    resampler->filled += frames;
+    return frames;
+}
+
+//* Computes outputs while the history covers a whole filter window, up to `limit` frames
+static size_t resampler_run(wav_resampler_t* resampler, float* out, size_t limit) {
+    const dot_fn dot = dot_kernels[wav_convert_get_isa()];
+    const uint16_t channels = resampler->num_channels;
+    const uint32_t taps = resampler->taps;
+    size_t produced = 0;
+    while (produced < limit && resampler->pos + taps <= resampler->filled) {
+        float* frame = out + produced * channels;
+        if (!resampler->interpolate) {
+            const float* row = resampler->filter + (size_t)resampler->phase * taps;
+            for (uint16_t c = 0; c < channels; ++c) {
+                frame[c] = dot(resampler->history[c] + resampler->pos, row, taps);
+            }
+        } else {
+            uint64_t scaled = (uint64_t)resampler->phase * resampler->phases;
+            const float* row = resampler->filter + (size_t)(scaled / resampler->up) * taps;
+            float t = (float)(scaled % resampler->up) / (float)resampler->up;
+            for (uint16_t c = 0; c < channels; ++c) {
+                float a = dot(resampler->history[c] + resampler->pos, row, taps);
+                float b = dot(resampler->history[c] + resampler->pos, row + taps, taps);
+                frame[c] = a + t * (b - a);
+            }
+        }
+        ++produced;
+        //? Step `down` input samples in units of 1/up
+        uint64_t next = (uint64_t)resampler->phase + resampler->down;
+        resampler->pos += (size_t)(next / resampler->up);
+        resampler->phase = (uint32_t)(next % resampler->up);
+    }
+    resampler->frames_out += produced;
+    return produced;
+}
+
+size_t wav_resampler_process(wav_resampler_t* resampler, const float* in, size_t in_frames, size_t* in_used, float* out, size_t out_frames) {
+    size_t used = 0, produced = 0;
+    for (;;) {
+        produced += resampler_run(resampler, out + produced * resampler->num_channels, out_frames - produced);
+        if (produced == out_frames || used == in_frames) break;
+        resampler_compact(resampler);
+        size_t added = resampler_append(resampler, in + used * resampler->num_channels, in_frames - used);
+        if (added == 0) break;
+        used += added;
+        resampler->frames_in += added;
+    }
+    if (in_used) *in_used = used;
+    return produced;
+}
+
+size_t wav_resampler_flush(wav_resampler_t* resampler, float* out, size_t out_frames) {
+    uint64_t expected = wav_resampler_output_frames(resampler, resampler->frames_in);
+    size_t produced = 0;
+    while (produced < out_frames && resampler->frames_out < expected) {
+        uint64_t left = expected - resampler->frames_out;
+        size_t limit = (left < out_frames - produced) ? (size_t)left : out_frames - produced;
+        size_t got = resampler_run(resampler, out + produced * resampler->num_channels, limit);
+        produced += got;
+        if (got == 0) {
+            //* Out of input: pad with silence to push the held-back tail through the filter
+            resampler_compact(resampler);
+            resampler_append(resampler, NULL, resampler->taps);
+        }
+    }
+    return produced;
+}
+
+bool wav_resample_file(const wav_file_t* in, uint32_t out_rate, wav_resample_quality_t quality, wav_file_t* out) {
+    if (!in || !out || in->data == NULL) return false;
+    wav_init_file(out);
+
+    wav_sample_format_t format;
+    if (!wav_sample_format_from_header(&in->header, &format)) {
+        Log(LOG_ERROR, "Format %d with %d bits per sample has no conversion kernel.\n", in->header.encoding, in->header.bits_per_sample);
+        return false;
+    }
+    wav_resampler_t resampler;
+    if (!wav_resampler_init(&resampler, in->header.sample_rate, out_rate, in->header.num_channels, quality)) {
+        return false;
+    }
+    const uint16_t channels = in->header.num_channels;
+    const size_t block_align = in->header.block_align;
+    const uint64_t frames_out = (in->header.sample_rate == out_rate) ? in->samples : wav_resampler_output_frames(&resampler, in->samples);
+    if (frames_out > SIZE_MAX / block_align) {
+        Log(LOG_ERROR, "The resampled data (%llu frames) doesn't fit in memory.\n", (unsigned long long)frames_out);
+        wav_resampler_free(&resampler);
+        return false;
+    }
+
+    bool retval = true;
+    float* in_block = (float*)malloc((size_t)RESAMPLE_FILE_BLOCK * channels * sizeof(float));
+    float* out_block = (float*)malloc((size_t)RESAMPLE_FILE_BLOCK * channels * sizeof(float));
+    out->data = (uint8_t*)malloc(frames_out ? (size_t)frames_out * block_align : 1);
+    if (!in_block || !out_block || !out->data) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for the resampled data.\n", (unsigned long long)(frames_out * block_align));
+        free(out->data);
+        out->data = NULL;
+        retval = false;
+        goto FREE_BLOCKS;
+    }
+    out->owner = WAV_DATA_HEAP;
+    out->header = in->header;
+    out->header.sample_rate = out_rate;
+    out->header.byte_rate = out_rate * in->header.block_align;
+    out->header.data_size = frames_out * block_align;
+    out->data_length = out->header.data_size;
+    out->samples = frames_out;
+
+    if (in->header.sample_rate == out_rate) {
+        //? Nothing to do, and running the filter anyway would needlessly trim the top of the band
+        memcpy(out->data, in->data, (size_t)out->data_length);
+        goto FREE_BLOCKS;
+    }
+
+    uint64_t written = 0;
+    for (uint64_t done = 0; done < in->samples; ) {
+        size_t frames = (in->samples - done < RESAMPLE_FILE_BLOCK) ? (size_t)(in->samples - done) : RESAMPLE_FILE_BLOCK;
+        wav_convert_to_float(in_block, in->data + (size_t)done * block_align, frames * channels, format);
+        size_t offset = 0;
+        while (offset < frames) {
+            size_t used = 0;
+            size_t got = wav_resampler_process(&resampler, in_block + offset * channels, frames - offset, &used, out_block, RESAMPLE_FILE_BLOCK);
+            wav_convert_from_float(out->data + (size_t)written * block_align, out_block, got * channels, format);
+            written += got;
+            offset += used;
+        }
+        done += frames;
+    }
+    size_t got;
+    while ((got = wav_resampler_flush(&resampler, out_block, RESAMPLE_FILE_BLOCK)) > 0) {
+        wav_convert_from_float(out->data + (size_t)written * block_align, out_block, got * channels, format);
+        written += got;
+    }
+
+FREE_BLOCKS:
+    free(in_block);
+    free(out_block);
+    wav_resampler_free(&resampler);
+    return retval;
+}
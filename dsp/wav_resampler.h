@@ -0,0 +1,112 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_planar.h"
+
+/**
+ * Resampler quality presets. Higher presets use longer filters: less aliasing and
+ * a flatter passband, at a proportional cost in CPU time.
+ */
+typedef enum wav_resample_quality_t {
+    WAV_RESAMPLE_FAST,          //? 16 taps, ~60 dB stopband
+    WAV_RESAMPLE_MEDIUM,        //? 32 taps, ~80 dB stopband
+    WAV_RESAMPLE_BEST,          //? 64 taps, ~100 dB stopband
+} wav_resample_quality_t;
+
+/**
+ * Polyphase windowed-sinc sample-rate converter.
+ *
+ * The rate ratio is reduced to `up`/`down` and one Kaiser-windowed sinc filter
+ * phase is precomputed per output position between two input samples. When `up`
+ * is too large for a table (odd rates like 44056 Hz) a fixed number of phases is
+ * stored and neighbouring phases are interpolated.
+ *
+ * Works on interleaved float frames in blocks of any size; every channel keeps
+ * its own contiguous history so the filter loops run on SIMD dot products.
+ * Output is time-aligned with the input (no leading filter delay).
+ */
+typedef struct wav_resampler_t {
+    uint32_t in_rate;
+    uint32_t out_rate;
+    uint16_t num_channels;
+    uint32_t up;                //? out_rate / gcd
+    uint32_t down;              //? in_rate / gcd
+    uint32_t taps;              //? filter length per phase, a multiple of 8
+    uint32_t phases;            //? rows in `filter` (plus one extra row when interpolating)
+    bool interpolate;           //? phases < up: blend the two nearest rows
+    float* filter;
+    float** history;            //? per-channel input history
+    float* history_data;
+    float** planes;             //? scratch pointers into `history` for the deinterleave kernel
+    size_t capacity;            //? history frames per channel
+    size_t filled;              //? history frames in use
+    size_t pos;                 //? history index of the next output's first tap
+    uint32_t phase;             //? position between two inputs, in 1/up steps
+    uint64_t frames_in;
+    uint64_t frames_out;
+} wav_resampler_t;
+
+/**
+ * @brief Builds the filter tables and history for converting `in_rate` to `out_rate`.
+ *
+ * @returns `false` on invalid rates/channel counts or if an allocation fails.
+ */
+bool wav_resampler_init(wav_resampler_t* resampler, uint32_t in_rate, uint32_t out_rate, uint16_t num_channels, wav_resample_quality_t quality);
+
+/**
+ * @brief Clears the history so the next block starts a new, unrelated signal.
+ */
+void wav_resampler_reset(wav_resampler_t* resampler);
+
+/**
+ * @brief Resamples one block of interleaved float frames.
+ *
+ * Consumes as many of the `in_frames` input frames as it can and writes at most
+ * `out_frames` output frames. Call again with the unconsumed input when `*in_used`
+ * comes back smaller than `in_frames` (the output block was full).
+ *
+ * @returns the number of frames written to `out`.
+ */
+size_t wav_resampler_process(wav_resampler_t* resampler, const float* in, size_t in_frames, size_t* in_used, float* out, size_t out_frames);
+
+/**
+ * @brief Drains the frames still held back by the filter at the end of the input.
+ *
+ * Call until it returns 0; the total output then matches wav_resampler_output_frames().
+ *
+ * @returns the number of frames written to `out`.
+ */
+size_t wav_resampler_flush(wav_resampler_t* resampler, float* out, size_t out_frames);
+
+/**
+ * @returns the number of frames `in_frames` input frames resample to.
+ */
+uint64_t wav_resampler_output_frames(const wav_resampler_t* resampler, uint64_t in_frames);
+
+/**
+ * @brief Frees the tables and history.
+ */
+void wav_resampler_free(wav_resampler_t* resampler);
+
+/**
+ * @brief Resamples a whole loaded file to `out_rate`.
+ *
+ * `out` gets a heap copy in the same sample format as `in` with the header's
+ * rate fields updated, so assets can be normalized to the device rate at load
+ * time. Free it with wav_free_file().
+ */
+bool wav_resample_file(const wav_file_t* in, uint32_t out_rate, wav_resample_quality_t quality, wav_file_t* out);
@@ -0,0 +1,533 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+/**
+ * wav_catalog: indexes every .wav file under one or more directory trees.
+ *
+ *   wav_catalog [-j threads] [-f csv|json] [-o output] <dir>...
+ *
+ * Directories and files are both tasks on a work-stealing pool: each worker pops
+ * from the back of its own deque and, once that runs dry, steals from the front of
+ * someone else's. Headers are read with wav_probe() (one positional read for most
+ * files, no sample data loaded), which also lists the file's chunks. One record per file is written as CSV or JSON lines;
+ * throughput stats go to stderr together with the parser's diagnostics.
+ *
+ * Build (gcc / mingw-w64):
+ *   gcc -O2 -Iwav_parser -Iutils tools/wav_catalog.c wav_parser/wav_parser.c \
+ *       utils/log.c utils/path_utils.c utils/file_io.c -pthread -o wav_catalog
+ */
+
+#include "wav_parser.h"
+#include "log.h"
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define CATALOG_OUTPUT_BUFFER   (64 * 1024)
+#define CATALOG_MAX_THREADS     256
+
+typedef enum catalog_format_t {
+    CATALOG_CSV,
+    CATALOG_JSON
+} catalog_format_t;
+
+typedef enum task_kind_t {
+    TASK_DIRECTORY,
+    TASK_FILE
+} task_kind_t;
+
+typedef struct task_t {
+    task_kind_t kind;
+    char* path;
+} task_t;
+
+//? Mutex-guarded ring: cheap enough next to the I/O each task does, and simple to get right
+typedef struct task_deque_t {
+    pthread_mutex_t lock;
+    task_t* tasks;
+    size_t capacity;
+    size_t head;        // steal end
+    size_t count;
+} task_deque_t;
+
+typedef struct worker_t {
+    struct catalog_t* catalog;
+    pthread_t thread;
+    size_t index;
+    task_deque_t deque;
+    char* out;                  // pending output records
+    size_t out_len;
+    uint64_t files_ok;
+    uint64_t files_failed;
+    uint64_t directories;
+    uint64_t steals;
+    uint64_t audio_bytes;       //? sum of data chunk sizes, for the MB/s "indexed" figure
+} worker_t;
+
+typedef struct catalog_t {
+    worker_t* workers;
+    size_t worker_count;
+    catalog_format_t format;
+    FILE* output;
+    pthread_mutex_t output_lock;
+    atomic_size_t pending;      //! tasks queued or running, 0 means the walk is over
+} catalog_t;
+
+//=================================================TASK DEQUE==========================================================
+
+static bool deque_init(task_deque_t* deque) {
+    deque->capacity = 64;
+    deque->head = 0;
+    deque->count = 0;
+    deque->tasks = (task_t*)malloc(deque->capacity * sizeof(task_t));
+    if (!deque->tasks) return false;
+    pthread_mutex_init(&deque->lock, NULL);
+    return true;
+}
+
+static void deque_destroy(task_deque_t* deque) {
+    for (size_t i = 0; i < deque->count; ++i) {
+        free(deque->tasks[(deque->head + i) % deque->capacity].path);
+    }
+    free(deque->tasks);
+    pthread_mutex_destroy(&deque->lock);
+}
+
+static bool deque_push(task_deque_t* deque, task_t task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        size_t capacity = deque->capacity * 2;
+        task_t* tasks = (task_t*)malloc(capacity * sizeof(task_t));
+        if (!tasks) {
+            pthread_mutex_unlock(&deque->lock);
+            return false;
+        }
+        for (size_t i = 0; i < deque->count; ++i) {
+            tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->capacity = capacity;
+        deque->head = 0;
+    }
+    deque->tasks[(deque->head + deque->count) % deque->capacity] = task;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+//* Owner end: newest first keeps the walk depth-first and the deque short
+static bool deque_pop(task_deque_t* deque, task_t* task) {
+    pthread_mutex_lock(&deque->lock);
+    bool found = deque->count > 0;
+    if (found) {
+        deque->count--;
+        *task = deque->tasks[(deque->head + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+//* Thief end: oldest first, those are the big directories near the top of the tree
+static bool deque_steal(task_deque_t* deque, task_t* task) {
+    if (pthread_mutex_trylock(&deque->lock) != 0) return false;
+    bool found = deque->count > 0;
+    if (found) {
+        *task = deque->tasks[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+//=================================================OUTPUT==========================================================
+
+static void worker_flush(worker_t* worker) {
+    if (worker->out_len == 0) return;
+    pthread_mutex_lock(&worker->catalog->output_lock);
+    fwrite(worker->out, 1, worker->out_len, worker->catalog->output);
+    pthread_mutex_unlock(&worker->catalog->output_lock);
+    worker->out_len = 0;
+}
+
+static void worker_emit(worker_t* worker, const char* text, size_t len) {
+    if (worker->out_len + len > CATALOG_OUTPUT_BUFFER) {
+        worker_flush(worker);
+    }
+    if (len > CATALOG_OUTPUT_BUFFER) {
+        pthread_mutex_lock(&worker->catalog->output_lock);
+        fwrite(text, 1, len, worker->catalog->output);
+        pthread_mutex_unlock(&worker->catalog->output_lock);
+        return;
+    }
+    memcpy(worker->out + worker->out_len, text, len);
+    worker->out_len += len;
+}
+
+static void worker_emit_path(worker_t* worker, const char* path) {
+    char buff[8];
+    if (worker->catalog->format == CATALOG_JSON) {
+        worker_emit(worker, "\"", 1);
+        for (const char* c = path; *c; ++c) {
+            unsigned char ch = (unsigned char)*c;
+            if (ch == '"' || ch == '\\') {
+                buff[0] = '\\';
+                buff[1] = (char)ch;
+                worker_emit(worker, buff, 2);
+            } else if (ch < 0x20) {
+                int n = snprintf(buff, sizeof(buff), "\\u%04x", ch);
+                worker_emit(worker, buff, (size_t)n);
+            } else {
+                worker_emit(worker, c, 1);
+            }
+        }
+        worker_emit(worker, "\"", 1);
+    } else {
+        //? RFC 4180: quote the field and double embedded quotes
+        worker_emit(worker, "\"", 1);
+        for (const char* c = path; *c; ++c) {
+            worker_emit(worker, c, 1);
+            if (*c == '"') worker_emit(worker, "\"", 1);
+        }
+        worker_emit(worker, "\"", 1);
+    }
+}
+
+//? Ids are meant to be printable ASCII, anything else would break the CSV or JSON quoting
+static size_t copy_chunk_id(char* out, const char* id) {
+    size_t n = 0;
+    for (; n < 4 && id[n] != ' ' && id[n] != '\0'; ++n) {
+        char c = id[n];
+        out[n] = (c > ' ' && c < 127 && c != '"' && c != '\\' && c != ',') ? c : '?';
+    }
+    return n;
+}
+
+//? "fmt|LIST/INFO|data|smpl": the chunk directory wav_probe() already recorded, no extra read
+static void format_chunk_list(char* out, size_t size, const wav_chunk_dir_t* chunks) {
+    size_t used = 0;
+    for (uint32_t i = 0; i < chunks->count && used + 10 < size; ++i) {
+        const wav_chunk_t* chunk = &chunks->chunks[i];
+        if (i > 0) out[used++] = '|';
+        used += copy_chunk_id(out + used, chunk->id);
+        if (chunk->form[0] != '\0') {
+            out[used++] = '/';
+            used += copy_chunk_id(out + used, chunk->form);
+        }
+    }
+    if (chunks->truncated && used + 4 < size) {
+        memcpy(out + used, "|...", 4);
+        used += 4;
+    }
+    out[used] = '\0';
+}
+
+static void worker_emit_record(worker_t* worker, const char* path, const wav_probe_t* info) {
+    const wav_header_t* header = &info->header;
+    double duration = header->byte_rate ? (double)info->data_length / header->byte_rate : 0.0;
+    char fields[512];
+    char chunks[WAV_MAX_CHUNKS * 10 + 8];
+    int n;
+
+    format_chunk_list(chunks, sizeof(chunks), &info->chunks);
+    if (worker->catalog->format == CATALOG_JSON) {
+        worker_emit(worker, "{\"path\":", 8);
+        worker_emit_path(worker, path);
+        n = snprintf(fields, sizeof(fields),
+            ",\"format\":%u,\"channels\":%u,\"sample_rate\":%u,\"bits_per_sample\":%u,"
+            "\"duration\":%.6f,\"data_offset\":%llu,\"data_length\":%llu,\"chunks\":\"%s\"}\n",
+            header->format_type, header->num_channels, header->sample_rate, header->bits_per_sample,
+            duration, (unsigned long long)info->data_offset, (unsigned long long)info->data_length, chunks);
+    } else {
+        worker_emit_path(worker, path);
+        n = snprintf(fields, sizeof(fields), ",%u,%u,%u,%u,%.6f,%llu,%llu,%s\n",
+            header->format_type, header->num_channels, header->sample_rate, header->bits_per_sample,
+            duration, (unsigned long long)info->data_offset, (unsigned long long)info->data_length, chunks);
+    }
+    worker_emit(worker, fields, (size_t)n);
+}
+
+//=================================================WALK==========================================================
+
+static bool has_wav_extension(const char* name) {
+    const char* dot = strrchr(name, '.');
+    return dot && dot != name && strcasecmp(dot, ".wav") == 0;
+}
+
+static void worker_schedule(worker_t* worker, task_kind_t kind, char* path) {
+    task_t task = { kind, path };
+    atomic_fetch_add(&worker->catalog->pending, 1);
+    if (!deque_push(&worker->deque, task)) {
+        Log(LOG_ERROR, "Out of memory while queueing %s\n", path);
+        free(path);
+        atomic_fetch_sub(&worker->catalog->pending, 1);
+    }
+}
+
+static void worker_scan_directory(worker_t* worker, const char* path) {
+    DIR* dir = opendir(path);
+    if (!dir) {
+        Log(LOG_WARNING, "Cannot open directory %s: %s\n", path, strerror(errno));
+        return;
+    }
+    worker->directories++;
+
+    size_t path_len = strlen(path);
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char* name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+        size_t len = path_len + 1 + strlen(name);
+        char* child = (char*)malloc(len + 1);
+        if (!child) {
+            Log(LOG_ERROR, "Out of memory while scanning %s\n", path);
+            break;
+        }
+        snprintf(child, len + 1, "%s/%s", path, name);
+
+        bool is_dir = false, is_file = false;
+#ifdef _DIRENT_HAVE_D_TYPE
+        if (entry->d_type == DT_DIR)      is_dir = true;
+        else if (entry->d_type == DT_REG) is_file = true;
+        else if (entry->d_type == DT_UNKNOWN)
+#endif
+        {
+            struct stat st;
+#ifdef _WIN32
+            int res = stat(child, &st);
+#else
+            int res = lstat(child, &st); //! don't follow symlinks, a link loop would never finish
+#endif
+            if (res == 0) {
+                is_dir = S_ISDIR(st.st_mode);
+                is_file = S_ISREG(st.st_mode);
+            }
+        }
+
+        if (is_dir) {
+            worker_schedule(worker, TASK_DIRECTORY, child);
+        } else if (is_file && has_wav_extension(name)) {
+            worker_schedule(worker, TASK_FILE, child);
+        } else {
+            free(child);
+        }
+    }
+    closedir(dir);
+}
+
+static void worker_run_task(worker_t* worker, task_t* task) {
+    if (task->kind == TASK_DIRECTORY) {
+        worker_scan_directory(worker, task->path);
+    } else {
+        wav_probe_t info;
+        if (wav_probe(task->path, &info)) {
+            worker_emit_record(worker, task->path, &info);
+            worker->audio_bytes += info.data_length;
+            worker->files_ok++;
+        } else {
+            worker->files_failed++;
+        }
+    }
+    free(task->path);
+    atomic_fetch_sub(&worker->catalog->pending, 1);
+}
+
+static bool worker_steal(worker_t* worker, task_t* task) {
+    catalog_t* catalog = worker->catalog;
+    for (size_t i = 1; i < catalog->worker_count; ++i) {
+        worker_t* victim = &catalog->workers[(worker->index + i) % catalog->worker_count];
+        if (deque_steal(&victim->deque, task)) {
+            worker->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void idle_pause(void) {
+#ifdef _WIN32
+    Sleep(0);
+#else
+    struct timespec ts = { 0, 50 * 1000 };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void* worker_main(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    task_t task;
+    for (;;) {
+        if (deque_pop(&worker->deque, &task) || worker_steal(worker, &task)) {
+            worker_run_task(worker, &task);
+            continue;
+        }
+        //? Nothing to pop or steal: either someone is still expanding a directory, or we're done
+        if (atomic_load(&worker->catalog->pending) == 0) break;
+        idle_pause();
+    }
+    worker_flush(worker);
+    return NULL;
+}
+
+//=================================================DRIVER==========================================================
+
+static size_t cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+#endif
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-j threads] [-f csv|json] [-o output] <dir>...\n", argv0);
+}
+
+int main(int argc, char const *argv[])
+{
+    catalog_t catalog;
+    memset(&catalog, 0, sizeof(catalog));
+    catalog.format = CATALOG_CSV;
+    catalog.output = stdout;
+    catalog.worker_count = cpu_count();
+    const char* output_path = NULL;
+
+    int argi = 1;
+    for (; argi < argc && argv[argi][0] == '-'; ++argi) {
+        if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc) {
+            long n = strtol(argv[++argi], NULL, 10);
+            catalog.worker_count = (n > 0) ? (size_t)n : 1;
+        } else if (strcmp(argv[argi], "-f") == 0 && argi + 1 < argc) {
+            const char* fmt = argv[++argi];
+            if (strcmp(fmt, "json") == 0)     catalog.format = CATALOG_JSON;
+            else if (strcmp(fmt, "csv") == 0) catalog.format = CATALOG_CSV;
+            else { usage(argv[0]); return EXIT_FAILURE; }
+        } else if (strcmp(argv[argi], "-o") == 0 && argi + 1 < argc) {
+            output_path = argv[++argi];
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argi == argc) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (catalog.worker_count > CATALOG_MAX_THREADS) catalog.worker_count = CATALOG_MAX_THREADS;
+
+    //* Records own stdout (or the output file), diagnostics go to stderr
+    LogSetOutput(stderr);
+    if (output_path) {
+        catalog.output = fopen(output_path, "wb");
+        if (!catalog.output) {
+            Log(LOG_ERROR, "Failed to open %s: %s\n", output_path, strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+    if (catalog.format == CATALOG_CSV) {
+        fputs("path,format,channels,sample_rate,bits_per_sample,duration,data_offset,data_length,chunks\n", catalog.output);
+    }
+
+    catalog.workers = (worker_t*)calloc(catalog.worker_count, sizeof(worker_t));
+    if (!catalog.workers) {
+        Log(LOG_ERROR, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    pthread_mutex_init(&catalog.output_lock, NULL);
+    atomic_init(&catalog.pending, 0);
+    for (size_t i = 0; i < catalog.worker_count; ++i) {
+        worker_t* worker = &catalog.workers[i];
+        worker->catalog = &catalog;
+        worker->index = i;
+        worker->out = (char*)malloc(CATALOG_OUTPUT_BUFFER);
+        if (!worker->out || !deque_init(&worker->deque)) {
+            Log(LOG_ERROR, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    //? Seed the roots round-robin, stealing spreads the rest
+    for (int i = argi; i < argc; ++i) {
+        char* root = (char*)malloc(strlen(argv[i]) + 1);
+        if (!root) continue;
+        strcpy(root, argv[i]);
+        worker_schedule(&catalog.workers[(size_t)(i - argi) % catalog.worker_count], TASK_DIRECTORY, root);
+    }
+
+    double start = now_seconds();
+    size_t started = 0;
+    for (; started < catalog.worker_count; ++started) {
+        if (pthread_create(&catalog.workers[started].thread, NULL, worker_main, &catalog.workers[started]) != 0) {
+            Log(LOG_WARNING, "Could only start %zu worker threads\n", started);
+            break;
+        }
+    }
+    if (started == 0) {
+        worker_main(&catalog.workers[0]);
+    }
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(catalog.workers[i].thread, NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    uint64_t files_ok = 0, files_failed = 0, directories = 0, steals = 0, audio_bytes = 0;
+    for (size_t i = 0; i < catalog.worker_count; ++i) {
+        worker_t* worker = &catalog.workers[i];
+        files_ok += worker->files_ok;
+        files_failed += worker->files_failed;
+        directories += worker->directories;
+        steals += worker->steals;
+        audio_bytes += worker->audio_bytes;
+        deque_destroy(&worker->deque);
+        free(worker->out);
+    }
+    if (output_path) fclose(catalog.output);
+    else fflush(stdout);
+
+    if (elapsed <= 0.0) elapsed = 1e-9;
+    fprintf(stderr,
+        "wav_catalog: %llu files (%llu failed) in %llu directories, %zu threads, %.3f s\n"
+        "wav_catalog: %.0f files/s, %.1f MB/s of audio indexed, %llu steals\n",
+        (unsigned long long)(files_ok + files_failed), (unsigned long long)files_failed,
+        (unsigned long long)directories, started ? started : 1, elapsed,
+        (files_ok + files_failed) / elapsed, audio_bytes / elapsed / (1024.0 * 1024.0),
+        (unsigned long long)steals);
+
+    free(catalog.workers);
+    pthread_mutex_destroy(&catalog.output_lock);
+    return files_failed ? 2 : 0;
+}
@@ -0,0 +1,340 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#define _FILE_OFFSET_BITS 64
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     //? pwritev() and fallocate() on glibc
+#endif
+#include "file_io.h"
+#include <errno.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+//? Only the few codes callers actually report on, everything else is just an I/O error
+static void set_errno_from_win32(void) {
+    switch (GetLastError()) {
+        case ERROR_FILE_NOT_FOUND:
+        case ERROR_PATH_NOT_FOUND:      errno = ENOENT; break;
+        case ERROR_ACCESS_DENIED:       errno = EACCES; break;
+        case ERROR_NOT_ENOUGH_MEMORY:   errno = ENOMEM; break;
+        default:                        errno = EIO;    break;
+    }
+}
+
+bool io_open_file(const char* path, io_file_t* file) {
+    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        file->handle = NULL;
+        file->is_open = false;
+        set_errno_from_win32();
+        return false;
+    }
+    file->handle = hFile;
+    file->is_open = true;
+    return true;
+}
+
+int64_t io_pread(const io_file_t* file, void* buffer, size_t length, uint64_t offset) {
+    uint8_t* dst = (uint8_t*)buffer;
+    int64_t total = 0;
+    while (length > 0) {
+        //? ReadFile takes a DWORD, split huge requests
+        DWORD chunk = (length > 0x40000000u) ? 0x40000000u : (DWORD)length;
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        ov.Offset = (DWORD)(offset & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD got = 0;
+        if (!ReadFile((HANDLE)file->handle, dst, chunk, &got, &ov)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            set_errno_from_win32();
+            return -1;
+        }
+        if (got == 0) break;
+        dst += got;
+        total += got;
+        offset += got;
+        length -= got;
+    }
+    return total;
+}
+
+bool io_create_file(const char* path, io_file_t* file) {
+    HANDLE hFile = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        file->handle = NULL;
+        file->is_open = false;
+        set_errno_from_win32();
+        return false;
+    }
+    file->handle = hFile;
+    file->is_open = true;
+    return true;
+}
+
+int64_t io_pwritev(const io_file_t* file, const io_vec_t* vecs, int count, uint64_t offset) {
+    int64_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint8_t* src = (const uint8_t*)vecs[i].base;
+        size_t length = vecs[i].length;
+        while (length > 0) {
+            //? WriteFile takes a DWORD, split huge requests
+            DWORD chunk = (length > 0x40000000u) ? 0x40000000u : (DWORD)length;
+            OVERLAPPED ov;
+            memset(&ov, 0, sizeof(ov));
+            ov.Offset = (DWORD)(offset & 0xFFFFFFFFu);
+            ov.OffsetHigh = (DWORD)(offset >> 32);
+            DWORD put = 0;
+            if (!WriteFile((HANDLE)file->handle, src, chunk, &put, &ov) || put == 0) {
+                set_errno_from_win32();
+                return -1;
+            }
+            src += put;
+            total += put;
+            offset += put;
+            length -= put;
+        }
+    }
+    return total;
+}
+
+bool io_preallocate(const io_file_t* file, uint64_t size) {
+    //? The allocation past the end of file is given back when the handle closes
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = (LONGLONG)size;
+    if (!SetFileInformationByHandle((HANDLE)file->handle, FileAllocationInfo, &info, sizeof(info))) {
+        set_errno_from_win32();
+        return false;
+    }
+    return true;
+}
+
+void io_close_file(io_file_t* file) {
+    if (file && file->is_open) {
+        CloseHandle((HANDLE)file->handle);
+        file->handle = NULL;
+        file->is_open = false;
+    }
+}
+
+bool io_map_file(const char* path, io_map_t* map) {
+    memset(map, 0, sizeof(*map));
+
+    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        set_errno_from_win32();
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size)) {
+        set_errno_from_win32();
+        CloseHandle(hFile);
+        return false;
+    }
+    if (size.QuadPart == 0 || (unsigned long long)size.QuadPart > (size_t)-1) {
+        errno = (size.QuadPart == 0) ? EINVAL : EFBIG;
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (hMapping == NULL) {
+        set_errno_from_win32();
+        CloseHandle(hFile);
+        return false;
+    }
+
+    void* base = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+    if (base == NULL) {
+        set_errno_from_win32();
+        CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return false;
+    }
+
+    map->base = (uint8_t*)base;
+    map->size = (size_t)size.QuadPart;
+    map->file_handle = hFile;
+    map->mapping_handle = hMapping;
+    return true;
+}
+
+void io_unmap_file(io_map_t* map) {
+    if (!map) return;
+    if (map->base)           UnmapViewOfFile(map->base);
+    if (map->mapping_handle) CloseHandle((HANDLE)map->mapping_handle);
+    if (map->file_handle)    CloseHandle((HANDLE)map->file_handle);
+    memset(map, 0, sizeof(*map));
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define IO_MAX_VECS 16
+
+bool io_open_file(const char* path, io_file_t* file) {
+    file->fd = open(path, O_RDONLY);
+    file->is_open = (file->fd >= 0);
+    return file->is_open;
+}
+
+int64_t io_pread(const io_file_t* file, void* buffer, size_t length, uint64_t offset) {
+    uint8_t* dst = (uint8_t*)buffer;
+    int64_t total = 0;
+    while (length > 0) {
+        ssize_t got = pread(file->fd, dst, length, (off_t)offset);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) break;
+        dst += got;
+        total += got;
+        offset += (uint64_t)got;
+        length -= (size_t)got;
+    }
+    return total;
+}
+
+bool io_create_file(const char* path, io_file_t* file) {
+    file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    file->is_open = (file->fd >= 0);
+    return file->is_open;
+}
+
+int64_t io_pwritev(const io_file_t* file, const io_vec_t* vecs, int count, uint64_t offset) {
+    struct iovec iov[IO_MAX_VECS];
+    if (count > IO_MAX_VECS) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (int i = 0; i < count; ++i) {
+        iov[i].iov_base = (void*)vecs[i].base;
+        iov[i].iov_len = vecs[i].length;
+    }
+    struct iovec* next = iov;
+    int left = count;
+    int64_t total = 0;
+    for (;;) {
+        //? Empty buffers go first, so a write of 0 bytes below always means no progress
+        while (left > 0 && next->iov_len == 0) {
+            ++next;
+            --left;
+        }
+        if (left == 0) break;
+        ssize_t put = pwritev(file->fd, next, left, (off_t)offset);
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (put == 0) {
+            //! Retrying would spin forever, same as a 0-byte WriteFile on Windows
+            errno = EIO;
+            return -1;
+        }
+        total += put;
+        offset += (uint64_t)put;
+        //* Skip what went out, a short write can stop in the middle of a buffer
+        while (left > 0 && (size_t)put >= next->iov_len) {
+            put -= (ssize_t)next->iov_len;
+            ++next;
+            --left;
+        }
+        if (left > 0) {
+            next->iov_base = (uint8_t*)next->iov_base + put;
+            next->iov_len -= (size_t)put;
+        }
+    }
+    return total;
+}
+
+bool io_preallocate(const io_file_t* file, uint64_t size) {
+#ifdef __linux__
+    //? KEEP_SIZE: blocks are reserved but the file still ends where the last write did
+    int rc;
+    do {
+        rc = fallocate(file->fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)size);
+    } while (rc != 0 && errno == EINTR);
+    return rc == 0;
+#else
+    (void)file;
+    (void)size;
+    errno = ENOTSUP;
+    return false;
+#endif
+}
+
+void io_close_file(io_file_t* file) {
+    if (file && file->is_open) {
+        close(file->fd);
+        file->fd = -1;
+        file->is_open = false;
+    }
+}
+
+bool io_map_file(const char* path, io_map_t* map) {
+    memset(map, 0, sizeof(*map));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return false;
+    }
+    if (st.st_size == 0 || (unsigned long long)st.st_size > (size_t)-1) {
+        close(fd);
+        errno = (st.st_size == 0) ? EINVAL : EFBIG;
+        return false;
+    }
+
+    //? MAP_PRIVATE + PROT_WRITE gives copy-on-write pages: callers may scribble on the
+    //? samples (the waveOut API takes a non-const buffer) without touching the file
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd); //* the mapping keeps its own reference to the file
+    if (base == MAP_FAILED) {
+        errno = err;
+        return false;
+    }
+
+    map->base = (uint8_t*)base;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+
+void io_unmap_file(io_map_t* map) {
+    if (!map) return;
+    if (map->base) munmap(map->base, map->size);
+    memset(map, 0, sizeof(*map));
+}
+#endif
+
+int64_t io_pwrite(const io_file_t* file, const void* buffer, size_t length, uint64_t offset) {
+    io_vec_t vec = { buffer, length };
+    return io_pwritev(file, &vec, 1, offset);
+}
@@ -0,0 +1,120 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A file opened for positional reads: every read states its own offset, so there is
+ * no shared file pointer to seek and the same handle can serve several readers.
+ */
+typedef struct io_file_t {
+#ifdef _WIN32
+    void* handle;           //? HANDLE, kept opaque so callers don't need <windows.h>
+#else
+    int fd;
+#endif
+    bool is_open;
+} io_file_t;
+
+/**
+ * One piece of a gathered write, see io_pwritev().
+ */
+typedef struct io_vec_t {
+    const void* base;
+    size_t length;
+} io_vec_t;
+
+/**
+ * A read-only view of a whole file mapped into memory.
+ *
+ * The mapping is copy-on-write: pages are shared with the page cache (and with
+ * every other process mapping the same file) until someone writes to them, at
+ * which point only the touched pages get a private copy. The file on disk is
+ * never modified.
+ */
+typedef struct io_map_t {
+    uint8_t* base;
+    size_t size;
+#ifdef _WIN32
+    void* file_handle;      //? HANDLE, kept opaque so callers don't need <windows.h>
+    void* mapping_handle;   //? HANDLE returned by CreateFileMapping
+#endif
+} io_map_t;
+
+/**
+ * Maps the whole file at `path` into memory.
+ *
+ * @returns `true` on success. On failure `map` is left zeroed and `errno`
+ *          describes the reason (an empty file is reported as EINVAL).
+ */
+bool io_map_file(const char* path, io_map_t* map);
+
+/**
+ * Releases a mapping created by io_map_file(). Safe to call on a zeroed map.
+ */
+void io_unmap_file(io_map_t* map);
+
+/**
+ * Opens `path` for reading. On failure `errno` describes the reason.
+ */
+bool io_open_file(const char* path, io_file_t* file);
+
+/**
+ * Reads up to `length` bytes at absolute `offset` in a single call (pread on POSIX,
+ * ReadFile with an OVERLAPPED offset on Windows), no separate seek needed. Short reads
+ * are retried, so fewer than `length` bytes only come back at end of file.
+ *
+ * @returns the number of bytes read, or -1 on error (`errno` set).
+ */
+int64_t io_pread(const io_file_t* file, void* buffer, size_t length, uint64_t offset);
+
+/**
+ * Closes a file opened by io_open_file(). Safe to call on a zeroed file.
+ */
+void io_close_file(io_file_t* file);
+
+/**
+ * Creates `path` for writing, truncating it if it exists. On failure `errno`
+ * describes the reason. Close it with io_close_file().
+ */
+bool io_create_file(const char* path, io_file_t* file);
+
+/**
+ * Writes `count` buffers back to back at absolute `offset` (pwritev on POSIX, one
+ * WriteFile per buffer on Windows). Short writes are retried, so on success every
+ * byte was written.
+ *
+ * @returns the number of bytes written, or -1 on error (`errno` set).
+ */
+int64_t io_pwritev(const io_file_t* file, const io_vec_t* vecs, int count, uint64_t offset);
+
+/**
+ * Single buffer io_pwritev().
+ */
+int64_t io_pwrite(const io_file_t* file, const void* buffer, size_t length, uint64_t offset);
+
+/**
+ * Reserves disk space for the first `size` bytes of a file being written, so the
+ * filesystem can lay it out in one piece. The file's size doesn't change, writes
+ * still extend it as usual.
+ *
+ * Only a hint: `false` (with `errno` set) when the platform or filesystem can't do
+ * it, which callers can ignore.
+ */
+bool io_preallocate(const io_file_t* file, uint64_t size);
@@ -14,17 +14,419 @@
  * -------------------------------------------------------------
  */
 #include "log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
 
-void Log(LogType type, const char* format, ...) {
-    va_list args;
-    switch(type) {
-        case LOG_INFO:      printf(COLOR_GREEN  "[INFO] - ");    break;
-        case LOG_WARNING:   printf(COLOR_YELLOW "[WARNING] - "); break;
-        case LOG_ERROR:     printf(COLOR_RED    "[ERROR] - ");   break;
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+//? Records are 8-byte aligned; a record with this bit set in `size` is padding up to the end of the ring
+#define LOG_RECORD_PAD      0x80000000u
+#define LOG_IDLE_NS         2000000ull  //? writer nap when every ring is empty
+
+atomic_int log_runtime_level = LOG_INFO;
+
+static FILE* log_stream = NULL; //? NULL means stdout, which isn't a constant initializer
+static atomic_int log_format = LOG_FORMAT_AUTO;
+static atomic_int log_color = -1;       //? LOG_FORMAT_AUTO resolved against the current stream, -1 until checked
+static atomic_uint log_rate_limit = 0;
+static atomic_uint log_next_thread = 1;
+static _Thread_local uint32_t log_thread;
+
+//=================================================FORMATTING==========================================================
+
+static uint64_t log_clock_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t log_thread_id(void) {
+    if (log_thread == 0) log_thread = atomic_fetch_add_explicit(&log_next_thread, 1, memory_order_relaxed);
+    return log_thread;
+}
+
+static FILE* log_out(void) {
+    return log_stream ? log_stream : stdout;
+}
+
+static LogFormat log_resolve_format(FILE* out) {
+    LogFormat format = (LogFormat)atomic_load_explicit(&log_format, memory_order_relaxed);
+    if (format != LOG_FORMAT_AUTO) return format;
+    int color = atomic_load_explicit(&log_color, memory_order_relaxed);
+    if (color < 0) {
+        //? isatty() is a system call, ask once per stream
+        color = isatty(fileno(out)) ? 1 : 0;
+        atomic_store_explicit(&log_color, color, memory_order_relaxed);
+    }
+    return color ? LOG_FORMAT_COLOR : LOG_FORMAT_PLAIN;
+}
+
+static const char* const log_names[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+static const char* const log_colors[] = { COLOR_CYAN, COLOR_GREEN, COLOR_YELLOW, COLOR_RED };
+
+//? Appends at most what fits, `*used` never passes `size - 1`; callers may pass a smaller `size` to keep room
+static void log_append(char* line, size_t size, size_t* used, const char* text, size_t length) {
+    if (*used + 1 >= size) return;
+    if (*used + length >= size) length = size - 1 - *used;
+    memcpy(line + *used, text, length);
+    *used += length;
+}
+
+static void log_append_json_string(char* line, size_t size, size_t* used, const char* text, size_t length) {
+    //? Trailing newlines are the console layout, not part of the message
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) --length;
+    log_append(line, size, used, "\"", 1);
+    //? A truncated message still ends with a whole escape and its closing quote
+    const size_t limit = size - 1;
+    for (size_t i = 0; i < length; ++i) {
+        const unsigned char c = (unsigned char)text[i];
+        char escape[8];
+        size_t n;
+        if (c == '"' || c == '\\') {
+            escape[0] = '\\';
+            escape[1] = (char)c;
+            n = 2;
+        } else if (c == '\n') {
+            memcpy(escape, "\\n", 2);
+            n = 2;
+        } else if (c < 0x20) {
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            n = 6;
+        } else {
+            escape[0] = (char)c;
+            n = 1;
+        }
+        if (*used + n >= limit) break;
+        log_append(line, limit, used, escape, n);
     }
-    
+    log_append(line, size, used, "\"", 1);
+}
+
+//* Turns one message into the line that gets written, returns its length
+static size_t log_format_line(char* line, size_t size, LogFormat format, LogType type, uint64_t time_ns, uint32_t thread,
+                              uint32_t suppressed, const char* text, size_t length) {
+    size_t used = 0;
+    char prefix[160];
+    int n;
+    if (format == LOG_FORMAT_JSON) {
+        n = snprintf(prefix, sizeof(prefix), "{\"time\":%llu.%06u,\"level\":\"%s\",\"thread\":%u,", (unsigned long long)(time_ns / 1000000000ull),
+            (unsigned)(time_ns % 1000000000ull / 1000u), log_names[type], thread);
+        log_append(line, size, &used, prefix, (size_t)n);
+        if (suppressed) {
+            n = snprintf(prefix, sizeof(prefix), "\"suppressed\":%u,", suppressed);
+            log_append(line, size, &used, prefix, (size_t)n);
+        }
+        log_append(line, size, &used, "\"msg\":", 6);
+        //? Keep room for the closing brace and newline whatever the message's length
+        log_append_json_string(line, size - 3, &used, text, length);
+        log_append(line, size, &used, "}\n", 2);
+        line[used] = '\0';
+        return used;
+    }
+    const bool color = format == LOG_FORMAT_COLOR;
+    if (suppressed) {
+        n = snprintf(prefix, sizeof(prefix), "%s[%s] - %u messages from this call site were suppressed%s\n", color ? log_colors[type] : "",
+            log_names[type], suppressed, color ? COLOR_RESET : "");
+        log_append(line, size, &used, prefix, (size_t)n);
+    }
+    n = snprintf(prefix, sizeof(prefix), "%s[%s] - ", color ? log_colors[type] : "", log_names[type]);
+    log_append(line, size, &used, prefix, (size_t)n);
+    log_append(line, size - 8, &used, text, length);
+    if (color) log_append(line, size, &used, COLOR_RESET, sizeof(COLOR_RESET) - 1);
+    log_append(line, size, &used, "\n", 1);
+    line[used] = '\0';
+    return used;
+}
+
+//=================================================ASYNC WRITER==========================================================
+//* One SPSC ring per logging thread: the thread appends records, the writer thread consumes them.
+//* Rings are only freed once their thread has exited and they're drained.
+
+typedef struct log_record_t {
+    uint32_t size;              //? whole record, header included, rounded up to 8
+    uint32_t type;
+    uint32_t thread;
+    uint32_t suppressed;
+    uint64_t time_ns;
+} log_record_t;
+
+typedef struct log_ring_t {
+    struct log_ring_t* next;
+    uint8_t* buffer;
+    size_t capacity;
+    atomic_bool closed;                     //? the owning thread exited
+    _Alignas(64) atomic_size_t head;        //? producer owned
+    _Alignas(64) atomic_size_t tail;        //? writer owned
+} log_ring_t;
+
+static _Atomic(log_ring_t*) log_rings;      //? producers push, only the writer unlinks
+static _Thread_local log_ring_t* log_thread_ring;
+static atomic_bool log_async;
+static atomic_bool log_running;
+static atomic_uint_fast64_t log_dropped;
+static atomic_uint_fast64_t log_flush_requested;
+static atomic_uint_fast64_t log_flush_done;
+static size_t log_ring_bytes = LOG_DEFAULT_RING_BYTES;
+static pthread_t log_writer;
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static pthread_key_t log_ring_key;
+
+static void log_sleep_ns(uint64_t ns) {
+    struct timespec ts = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+static void log_ring_close(void* ring) {
+    atomic_store_explicit(&((log_ring_t*)ring)->closed, true, memory_order_release);
+}
+
+static void log_init_once(void) {
+    pthread_key_create(&log_ring_key, log_ring_close);
+    atexit(LogStopAsync);
+}
+
+static log_ring_t* log_ring_for_thread(void) {
+    if (log_thread_ring) return log_thread_ring;
+    log_ring_t* ring = (log_ring_t*)calloc(1, sizeof(log_ring_t));
+    size_t capacity = 4096;    //? always room for the longest message
+    while (capacity < log_ring_bytes) capacity <<= 1;
+    uint8_t* buffer = ring ? (uint8_t*)malloc(capacity) : NULL;
+    if (!buffer) {
+        free(ring);
+        return NULL;
+    }
+    ring->buffer = buffer;
+    ring->capacity = capacity;
+    atomic_init(&ring->closed, false);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->next = atomic_load_explicit(&log_rings, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&log_rings, &ring->next, ring, memory_order_release, memory_order_relaxed)) {}
+    pthread_setspecific(log_ring_key, ring);
+    log_thread_ring = ring;
+    return ring;
+}
+
+//? Producer side: copies one record in, never waits
+static bool log_ring_push(log_ring_t* ring, const log_record_t* record, const char* text) {
+    const size_t size = (sizeof(log_record_t) + record->size + 7) & ~(size_t)7;
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const size_t offset = head & (ring->capacity - 1);
+    const size_t pad = (offset + size > ring->capacity) ? ring->capacity - offset : 0;
+    if (ring->capacity - (head - tail) < size + pad) return false;
+    if (pad) {
+        uint32_t marker = (uint32_t)pad | LOG_RECORD_PAD;
+        memcpy(ring->buffer + offset, &marker, sizeof(marker));
+    }
+    uint8_t* dst = ring->buffer + ((head + pad) & (ring->capacity - 1));
+    log_record_t header = *record;
+    header.size = (uint32_t)size;
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), text, record->size);
+    atomic_store_explicit(&ring->head, head + pad + size, memory_order_release);
+    return true;
+}
+
+//? Skips padding, returns the ring's next record or NULL if it has none before `limit`
+static const log_record_t* log_ring_peek(log_ring_t* ring, size_t limit) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    while (tail != limit) {
+        const uint8_t* p = ring->buffer + (tail & (ring->capacity - 1));
+        uint32_t size;
+        memcpy(&size, p, sizeof(size));
+        if (!(size & LOG_RECORD_PAD)) return (const log_record_t*)p;
+        tail += size & ~LOG_RECORD_PAD;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return NULL;
+}
+
+//* One pass: everything published before it started is written, oldest first across each batch of 64 threads
+static size_t log_drain(void) {
+    static char line[LOG_MAX_MESSAGE + 256];
+    log_ring_t* rings[64];
+    size_t limits[64];
+    size_t written = 0;
+    FILE* out = log_out();
+    const LogFormat format = log_resolve_format(out);
+    //? Rings pushed after this snapshot only hold records published after the pass started
+    log_ring_t* ring = atomic_load_explicit(&log_rings, memory_order_acquire);
+    while (ring) {
+        size_t count = 0;
+        for (; ring && count < sizeof(rings) / sizeof(rings[0]); ring = ring->next) {
+            rings[count] = ring;
+            limits[count++] = atomic_load_explicit(&ring->head, memory_order_acquire);
+        }
+        for (;;) {
+            size_t best = count;
+            const log_record_t* next = NULL;
+            for (size_t i = 0; i < count; ++i) {
+                const log_record_t* record = log_ring_peek(rings[i], limits[i]);
+                if (record && (!next || record->time_ns < next->time_ns)) {
+                    next = record;
+                    best = i;
+                }
+            }
+            if (!next) break;
+            const char* text = (const char*)(next + 1);
+            size_t length = strnlen(text, next->size - sizeof(log_record_t));
+            size_t n = log_format_line(line, sizeof(line), format, (LogType)next->type, next->time_ns, next->thread, next->suppressed, text, length);
+            fwrite(line, 1, n, out);
+            atomic_fetch_add_explicit(&rings[best]->tail, next->size, memory_order_release);
+            ++written;
+        }
+    }
+    if (written) fflush(out);
+    return written;
+}
+
+//? Unlinks and frees rings whose thread is gone and that hold nothing more
+static void log_reap(void) {
+    log_ring_t* prev = NULL;
+    log_ring_t* ring = atomic_load_explicit(&log_rings, memory_order_acquire);
+    while (ring) {
+        log_ring_t* next = ring->next;
+        bool dead = atomic_load_explicit(&ring->closed, memory_order_acquire) &&
+                    atomic_load_explicit(&ring->head, memory_order_acquire) == atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if (dead) {
+            if (prev) {
+                prev->next = next;
+            } else {
+                log_ring_t* expected = ring;
+                //! a producer may have pushed a new head meanwhile: then the ring is someone's `next`, retry next time
+                if (!atomic_compare_exchange_strong_explicit(&log_rings, &expected, next, memory_order_acq_rel, memory_order_acquire)) {
+                    prev = ring;
+                    ring = next;
+                    continue;
+                }
+            }
+            free(ring->buffer);
+            free(ring);
+            ring = next;
+            continue;
+        }
+        prev = ring;
+        ring = next;
+    }
+}
+
+static void* log_writer_thread(void* arg) {
+    (void)arg;
+    while (atomic_load_explicit(&log_running, memory_order_acquire)) {
+        uint64_t requested = atomic_load_explicit(&log_flush_requested, memory_order_acquire);
+        size_t written = log_drain();
+        atomic_store_explicit(&log_flush_done, requested, memory_order_release);
+        log_reap();
+        if (written == 0) log_sleep_ns(LOG_IDLE_NS);
+    }
+    log_drain();
+    log_reap();
+    return NULL;
+}
+
+bool LogStartAsync(size_t ring_bytes) {
+    pthread_once(&log_once, log_init_once);
+    if (atomic_load(&log_running)) return true;
+    log_ring_bytes = ring_bytes ? ring_bytes : LOG_DEFAULT_RING_BYTES;
+    atomic_store(&log_running, true);
+    if (pthread_create(&log_writer, NULL, log_writer_thread, NULL) != 0) {
+        atomic_store(&log_running, false);
+        Log(LOG_ERROR, "Unable to start the log writer thread, logging stays synchronous.\n");
+        return false;
+    }
+    atomic_store_explicit(&log_async, true, memory_order_release);
+    return true;
+}
+
+void LogStopAsync(void) {
+    if (!atomic_load(&log_running)) return;
+    atomic_store_explicit(&log_async, false, memory_order_release);
+    atomic_store_explicit(&log_running, false, memory_order_release);
+    pthread_join(log_writer, NULL);
+}
+
+void LogFlush(void) {
+    if (!atomic_load_explicit(&log_async, memory_order_acquire)) {
+        fflush(log_out());
+        return;
+    }
+    //? The writer acknowledges a request only after a whole pass that started after it
+    uint64_t ticket = atomic_fetch_add_explicit(&log_flush_requested, 1, memory_order_acq_rel) + 1;
+    while (atomic_load_explicit(&log_flush_done, memory_order_acquire) < ticket && atomic_load(&log_running)) {
+        log_sleep_ns(100000ull);
+    }
+}
+
+uint64_t LogDropped(void) {
+    return atomic_load_explicit(&log_dropped, memory_order_relaxed);
+}
+
+//=================================================PUBLIC API==========================================================
+
+void LogSetOutput(FILE* stream) {
+    log_stream = stream;
+    atomic_store_explicit(&log_color, -1, memory_order_relaxed);
+}
+
+void LogSetLevel(LogType level) {
+    atomic_store_explicit(&log_runtime_level, (int)level, memory_order_relaxed);
+}
+
+void LogSetFormat(LogFormat format) {
+    atomic_store_explicit(&log_format, (int)format, memory_order_relaxed);
+}
+
+void LogSetRateLimit(unsigned per_second) {
+    atomic_store_explicit(&log_rate_limit, per_second, memory_order_relaxed);
+}
+
+void LogWrite(LogSite* site, LogType type, const char* format, ...) {
+    if ((unsigned)type >= (unsigned)LOG_NONE) return;
+    const uint64_t now = log_clock_ns();
+    uint32_t suppressed = 0;
+    const unsigned limit = atomic_load_explicit(&log_rate_limit, memory_order_relaxed);
+    if (limit) {
+        //? Counts are per wall-clock second; whoever moves the window on reports what the last one dropped
+        uint_fast64_t second = now / 1000000000ull;
+        uint_fast64_t window = atomic_load_explicit(&site->window, memory_order_relaxed);
+        if (window != second && atomic_compare_exchange_strong_explicit(&site->window, &window, second, memory_order_relaxed, memory_order_relaxed)) {
+            atomic_store_explicit(&site->count, 0, memory_order_relaxed);
+            suppressed = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+        }
+        if (atomic_fetch_add_explicit(&site->count, 1, memory_order_relaxed) >= limit) {
+            atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    char text[LOG_MAX_MESSAGE];
+    va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    int n = vsnprintf(text, sizeof(text), format, args);
     va_end(args);
-    printf(COLOR_RESET "\n");
+    if (n < 0) return;
+    size_t length = ((size_t)n < sizeof(text)) ? (size_t)n : sizeof(text) - 1;
+
+    if (atomic_load_explicit(&log_async, memory_order_acquire)) {
+        log_ring_t* ring = log_ring_for_thread();
+        log_record_t record = { (uint32_t)length + 1, (uint32_t)type, log_thread_id(), suppressed, now };
+        if (!ring || !log_ring_push(ring, &record, text)) {
+            atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+        }
+        return;
+    }
+    //* Synchronous: the whole line goes out in one write
+    char line[LOG_MAX_MESSAGE + 256];
+    FILE* out = log_out();
+    size_t size = log_format_line(line, sizeof(line), log_resolve_format(out), type, now, log_thread_id(), suppressed, text, length);
+    fwrite(line, 1, size, out);
 }
@@ -17,6 +17,10 @@
 #pragma once
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 #define COLOR_RED       "\033[1;31m"
 #define COLOR_GREEN     "\033[1;32m"
@@ -27,15 +31,44 @@
 #define COLOR_RESET     "\033[0m"
 
 typedef enum LogType {
+    LOG_DEBUG,
     LOG_INFO,
     LOG_WARNING,
-    LOG_ERROR
+    LOG_ERROR,
+    LOG_NONE                    //? only meaningful as a level: lets nothing through
 }LogType;
 
+typedef enum LogFormat {
+    LOG_FORMAT_AUTO,            //? colored on a terminal, plain otherwise (the default)
+    LOG_FORMAT_COLOR,
+    LOG_FORMAT_PLAIN,
+    LOG_FORMAT_JSON,            //? one object per line: time, level, thread, msg (and suppressed)
+}LogFormat;
+
+//* Compile-time floor: calls below it are compiled out entirely. Build with e.g. -DLOG_MIN_LEVEL=LOG_WARNING
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_DEBUG
+#endif
+
+#define LOG_DEFAULT_RING_BYTES  (64u << 10)     //? per logging thread, see LogStartAsync()
+#define LOG_MAX_MESSAGE         1024            //? longer messages are truncated
+
 /**
- * Logs a formatted message to the standard output with a colored log level prefix.
+ * Per call site state for rate limiting, one is declared by every Log() expansion.
+ */
+typedef struct LogSite {
+    atomic_uint_fast64_t window;    //? second the counts belong to
+    atomic_uint count;
+    atomic_uint suppressed;
+}LogSite;
+
+extern atomic_int log_runtime_level;
+
+/**
+ * Logs a formatted message to the standard output (see LogSetOutput) with a level prefix.
  *
  * Supported log levels:
+ *   - LOG_DEBUG   → Cyan      "[DEBUG] - "   (hidden unless LogSetLevel(LOG_DEBUG))
  *   - LOG_INFO    → Green     "[INFO] - "
  *   - LOG_WARNING → Yellow    "[WARNING] - "
  *   - LOG_ERROR   → Red       "[ERROR] - "
@@ -44,13 +77,16 @@ typedef enum LogType {
  *   Log(LOG_INFO, "Loaded file: %s", filename);
  *   Log(LOG_ERROR, "Failed to open device: %d", errorCode);
  *
- * Color codes:
- *   - COLOR_GREEN
- *   - COLOR_YELLOW
- *   - COLOR_RED
+ * A call below LOG_MIN_LEVEL compiles to nothing, one below LogSetLevel() costs an
+ * atomic load and a compare; neither evaluates its arguments. Messages that pass
+ * are written with a single fwrite(), or, once LogStartAsync() ran, formatted into
+ * the calling thread's ring and written by a background thread.
+ *
+ * Color codes (LOG_FORMAT_COLOR, or LOG_FORMAT_AUTO on a terminal):
+ *   - COLOR_CYAN, COLOR_GREEN, COLOR_YELLOW, COLOR_RED
  *   - COLOR_RESET (used at the end of the line)
  *
- * @param type   The log level (LOG_INFO, LOG_WARNING, LOG_ERROR).
+ * @param type   The log level (LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERROR).
  * @param format The printf-style format string.
  * @param ...    Additional arguments for formatting.
  *
@@ -67,4 +103,64 @@ typedef enum LogType {
  *
  *   This prevents the prefix color from being broken mid-line or in multiline logs.
  */
-void Log(LogType type, const char* format, ...);
\ No newline at end of file
+#define Log(type, ...) do { \
+    if ((int)(type) >= (int)LOG_MIN_LEVEL && (int)(type) >= atomic_load_explicit(&log_runtime_level, memory_order_relaxed)) { \
+        static LogSite log_site_; \
+        LogWrite(&log_site_, (type), __VA_ARGS__); \
+    } \
+} while (0)
+
+/**
+ * What Log() calls once a message passed the level checks. Use Log() instead.
+ */
+void LogWrite(LogSite* site, LogType type, const char* format, ...);
+
+/**
+ * Redirects every following Log() call to `stream` (stdout by default, NULL restores it).
+ *
+ * Tools that print machine-readable output on stdout use this to move their
+ * diagnostics to stderr.
+ */
+void LogSetOutput(FILE* stream);
+
+/**
+ * Hides messages below `level` from now on (LOG_INFO by default).
+ */
+void LogSetLevel(LogType level);
+
+void LogSetFormat(LogFormat format);
+
+/**
+ * Lets at most `per_second` messages a second through each Log() call site, 0 (the
+ * default) for no limit. The next message that gets through says how many were dropped.
+ */
+void LogSetRateLimit(unsigned per_second);
+
+/**
+ * Moves writing off the logging threads.
+ *
+ * Every thread that logs gets a lock-free ring of `ring_bytes` (0 for
+ * LOG_DEFAULT_RING_BYTES) that only it writes to; a background thread drains the
+ * rings in timestamp order and does the I/O. A message that doesn't fit in its
+ * thread's ring is dropped and counted (see LogDropped()) rather than waited for.
+ * Pending messages are written at exit.
+ *
+ * @returns `false` if the writer thread can't be started, logging stays synchronous.
+ */
+bool LogStartAsync(size_t ring_bytes);
+
+/**
+ * Writes everything logged so far and goes back to synchronous logging. Other
+ * threads should be done logging: what they log while it stops may be lost.
+ */
+void LogStopAsync(void);
+
+/**
+ * Waits until every message logged before the call has been written.
+ */
+void LogFlush(void);
+
+/**
+ * @returns the number of messages dropped because a thread's ring was full.
+ */
+uint64_t LogDropped(void);
@@ -0,0 +1,306 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_cache.h"
+#include "log.h"
+#include <pthread.h>
+
+#define WAV_CACHE_MIN_BUCKETS 64
+
+typedef enum wav_asset_state_t {
+    WAV_ASSET_LOADING,
+    WAV_ASSET_READY,
+    WAV_ASSET_FAILED,
+} wav_asset_state_t;
+
+struct wav_asset_t {
+    wav_file_t file;
+    wav_cache_t* cache;
+    char* path;
+    uint64_t hash;
+    atomic_uint refs;
+    wav_asset_state_t state;        //? guarded by the cache lock
+    uint64_t bytes;                 //? counted against the budget once READY
+    wav_asset_t* next;              //? hash chain
+    wav_asset_t* lru_prev;          //? LRU list, only while refs == 0
+    wav_asset_t* lru_next;
+    bool in_lru;
+};
+
+struct wav_cache_t {
+    pthread_mutex_t lock;
+    pthread_cond_t loaded;          //? broadcast whenever a load finishes
+    wav_asset_t** buckets;
+    size_t bucket_mask;
+    size_t entries;
+    wav_asset_t* lru_oldest;
+    wav_asset_t* lru_newest;
+    size_t lru_count;
+    uint64_t budget;
+    uint64_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+//=================================================INTERNALS (cache lock held)==========================================================
+
+//? FNV-1a, paths are short and this keeps the lookup cheaper than any syscall
+static uint64_t path_hash(const char* path) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char* p = (const unsigned char*)path; *p; ++p) {
+        hash = (hash ^ *p) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static wav_asset_t* cache_lookup(wav_cache_t* cache, const char* path, uint64_t hash) {
+    for (wav_asset_t* asset = cache->buckets[hash & cache->bucket_mask]; asset; asset = asset->next) {
+        if (asset->hash == hash && strcmp(asset->path, path) == 0) return asset;
+    }
+    return NULL;
+}
+
+static void cache_grow(wav_cache_t* cache) {
+    size_t count = (cache->bucket_mask + 1) * 2;
+    wav_asset_t** buckets = (wav_asset_t**)calloc(count, sizeof(wav_asset_t*));
+    if (!buckets) return;   //? longer chains, still correct
+    for (size_t i = 0; i <= cache->bucket_mask; ++i) {
+        wav_asset_t* asset = cache->buckets[i];
+        while (asset) {
+            wav_asset_t* next = asset->next;
+            asset->next = buckets[asset->hash & (count - 1)];
+            buckets[asset->hash & (count - 1)] = asset;
+            asset = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_mask = count - 1;
+}
+
+static void cache_unlink(wav_cache_t* cache, wav_asset_t* asset) {
+    wav_asset_t** link = &cache->buckets[asset->hash & cache->bucket_mask];
+    while (*link != asset) link = &(*link)->next;
+    *link = asset->next;
+    --cache->entries;
+}
+
+static void lru_remove(wav_cache_t* cache, wav_asset_t* asset) {
+    if (!asset->in_lru) return;
+    if (asset->lru_prev) asset->lru_prev->lru_next = asset->lru_next;
+    else cache->lru_oldest = asset->lru_next;
+    if (asset->lru_next) asset->lru_next->lru_prev = asset->lru_prev;
+    else cache->lru_newest = asset->lru_prev;
+    asset->lru_prev = asset->lru_next = NULL;
+    asset->in_lru = false;
+    --cache->lru_count;
+}
+
+static void lru_push_newest(wav_cache_t* cache, wav_asset_t* asset) {
+    lru_remove(cache, asset);
+    asset->lru_prev = cache->lru_newest;
+    if (cache->lru_newest) cache->lru_newest->lru_next = asset;
+    else cache->lru_oldest = asset;
+    cache->lru_newest = asset;
+    asset->in_lru = true;
+    ++cache->lru_count;
+}
+
+static void asset_destroy(wav_asset_t* asset) {
+    wav_free_file(&asset->file);
+    free(asset->path);
+    free(asset);
+}
+
+static void cache_evict(wav_cache_t* cache) {
+    while (cache->bytes > cache->budget && cache->lru_oldest) {
+        wav_asset_t* asset = cache->lru_oldest;
+        lru_remove(cache, asset);
+        cache_unlink(cache, asset);
+        cache->bytes -= asset->bytes;
+        ++cache->evictions;
+        asset_destroy(asset);
+    }
+}
+
+//=================================================PUBLIC API==========================================================
+
+wav_cache_t* wav_cache_init(uint64_t budget_bytes) {
+    wav_cache_t* cache = (wav_cache_t*)calloc(1, sizeof(wav_cache_t));
+    if (!cache) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the asset cache.\n");
+        return NULL;
+    }
+    cache->buckets = (wav_asset_t**)calloc(WAV_CACHE_MIN_BUCKETS, sizeof(wav_asset_t*));
+    if (!cache->buckets) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the asset cache.\n");
+        free(cache);
+        return NULL;
+    }
+    cache->bucket_mask = WAV_CACHE_MIN_BUCKETS - 1;
+    cache->budget = budget_bytes;
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->loaded, NULL);
+    return cache;
+}
+
+void wav_cache_free(wav_cache_t* cache) {
+    if (!cache) return;
+    if (cache->entries != cache->lru_count) {
+        Log(LOG_WARNING, "Freeing the asset cache while %zu assets are still referenced.\n", cache->entries - cache->lru_count);
+    }
+    for (size_t i = 0; i <= cache->bucket_mask; ++i) {
+        wav_asset_t* asset = cache->buckets[i];
+        while (asset) {
+            wav_asset_t* next = asset->next;
+            asset_destroy(asset);
+            asset = next;
+        }
+    }
+    pthread_mutex_destroy(&cache->lock);
+    pthread_cond_destroy(&cache->loaded);
+    free(cache->buckets);
+    free(cache);
+}
+
+wav_asset_t* wav_cache_acquire(wav_cache_t* cache, const char* path) {
+    const uint64_t hash = path_hash(path);
+    pthread_mutex_lock(&cache->lock);
+    wav_asset_t* asset = cache_lookup(cache, path, hash);
+    if (asset) {
+        //? Taking the first reference back: the asset leaves the LRU list
+        if (atomic_fetch_add(&asset->refs, 1) == 0) lru_remove(cache, asset);
+        while (asset->state == WAV_ASSET_LOADING) {
+            pthread_cond_wait(&cache->loaded, &cache->lock);
+        }
+        bool ready = asset->state == WAV_ASSET_READY;
+        if (ready) ++cache->hits;
+        pthread_mutex_unlock(&cache->lock);
+        if (!ready) {
+            wav_asset_release(asset);
+            return NULL;
+        }
+        return asset;
+    }
+
+    //* Miss: publish a LOADING entry so concurrent acquires of the path wait for this load
+    ++cache->misses;
+    asset = (wav_asset_t*)calloc(1, sizeof(wav_asset_t));
+    char* copy = asset ? (char*)malloc(strlen(path) + 1) : NULL;
+    if (!asset || !copy) {
+        pthread_mutex_unlock(&cache->lock);
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate a cache entry for %s.\n", path);
+        free(asset);
+        return NULL;
+    }
+    strcpy(copy, path);
+    asset->path = copy;
+    asset->hash = hash;
+    asset->cache = cache;
+    asset->state = WAV_ASSET_LOADING;
+    atomic_init(&asset->refs, 1);
+    wav_init_file(&asset->file);
+    if (cache->entries >= cache->bucket_mask + 1) cache_grow(cache);
+    asset->next = cache->buckets[hash & cache->bucket_mask];
+    cache->buckets[hash & cache->bucket_mask] = asset;
+    ++cache->entries;
+    pthread_mutex_unlock(&cache->lock);
+
+    //? Parsed without the lock, hits on other paths don't wait for the disk
+    bool ok = wav_parse_file(path, &asset->file);
+
+    pthread_mutex_lock(&cache->lock);
+    if (ok) {
+        asset->state = WAV_ASSET_READY;
+        asset->bytes = asset->file.data_length;
+        cache->bytes += asset->bytes;
+        cache_evict(cache);
+    } else {
+        //? Out of the table right away, the last waiter frees it
+        asset->state = WAV_ASSET_FAILED;
+        cache_unlink(cache, asset);
+    }
+    pthread_cond_broadcast(&cache->loaded);
+    pthread_mutex_unlock(&cache->lock);
+    if (!ok) {
+        wav_asset_release(asset);
+        return NULL;
+    }
+    return asset;
+}
+
+wav_asset_t* wav_cache_find(wav_cache_t* cache, const char* path) {
+    const uint64_t hash = path_hash(path);
+    pthread_mutex_lock(&cache->lock);
+    wav_asset_t* asset = cache_lookup(cache, path, hash);
+    if (asset && asset->state == WAV_ASSET_READY) {
+        if (atomic_fetch_add(&asset->refs, 1) == 0) lru_remove(cache, asset);
+        ++cache->hits;
+    } else {
+        asset = NULL;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return asset;
+}
+
+void wav_asset_retain(wav_asset_t* asset) {
+    atomic_fetch_add_explicit(&asset->refs, 1, memory_order_relaxed);
+}
+
+void wav_asset_release(wav_asset_t* asset) {
+    if (!asset) return;
+    unsigned refs = atomic_load_explicit(&asset->refs, memory_order_relaxed);
+    while (refs > 1) {
+        if (atomic_compare_exchange_weak_explicit(&asset->refs, &refs, refs - 1, memory_order_acq_rel, memory_order_relaxed)) return;
+    }
+    //* Maybe the last reference: it's dropped under the lock so it can't race an acquire reviving
+    //* the asset (or an eviction freeing it) between the decrement and the LRU update
+    wav_cache_t* cache = asset->cache;
+    pthread_mutex_lock(&cache->lock);
+    if (atomic_fetch_sub_explicit(&asset->refs, 1, memory_order_acq_rel) == 1) {
+        if (asset->state == WAV_ASSET_FAILED) {
+            asset_destroy(asset);
+        } else {
+            lru_push_newest(cache, asset);
+            cache_evict(cache);
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+const wav_file_t* wav_asset_file(const wav_asset_t* asset) {
+    return &asset->file;
+}
+
+void wav_cache_set_budget(wav_cache_t* cache, uint64_t budget_bytes) {
+    pthread_mutex_lock(&cache->lock);
+    cache->budget = budget_bytes;
+    cache_evict(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void wav_cache_get_stats(wav_cache_t* cache, wav_cache_stats_t* stats) {
+    pthread_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+    stats->entries = cache->entries;
+    stats->referenced = cache->entries - cache->lru_count;
+    stats->bytes = cache->bytes;
+    stats->budget = cache->budget;
+    pthread_mutex_unlock(&cache->lock);
+}
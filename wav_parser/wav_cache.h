@@ -0,0 +1,100 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_parser.h"
+#include <stdatomic.h>
+
+/**
+ * Counters of a cache, see wav_cache_get_stats().
+ */
+typedef struct wav_cache_stats_t {
+    uint64_t hits;              //? acquires served from memory
+    uint64_t misses;            //? acquires that parsed the file
+    uint64_t evictions;
+    size_t entries;             //? assets resident, referenced or not
+    size_t referenced;          //? assets with at least one reference
+    uint64_t bytes;             //? sample data resident
+    uint64_t budget;
+} wav_cache_stats_t;
+
+/**
+ * One decoded file shared by every instance playing it. The samples are never
+ * modified after loading, so any number of threads can read them at once.
+ */
+typedef struct wav_asset_t wav_asset_t;
+
+/**
+ * Path-keyed cache of parsed WAV files.
+ *
+ * Every file is parsed once; later acquires of the same path cost a hash lookup
+ * and an atomic increment. Assets nobody references stay resident on an LRU list
+ * and are only evicted, oldest first, when the resident sample data exceeds the
+ * budget. Referenced assets are never evicted, so the budget can be exceeded
+ * while they are all in use.
+ */
+typedef struct wav_cache_t wav_cache_t;
+
+/**
+ * @param budget_bytes sample data kept resident before unreferenced assets are evicted.
+ * @returns `NULL` if an allocation fails.
+ */
+wav_cache_t* wav_cache_init(uint64_t budget_bytes);
+
+/**
+ * @brief Frees the cache and every asset in it. All references must have been released.
+ */
+void wav_cache_free(wav_cache_t* cache);
+
+/**
+ * @brief Returns the asset for `path`, parsing the file on a miss.
+ *
+ * Thread-safe. Concurrent misses on the same path parse the file once, the other
+ * callers wait for that load. The caller owns one reference.
+ *
+ * @returns `NULL` (with the reason logged) if the file can't be parsed.
+ */
+wav_asset_t* wav_cache_acquire(wav_cache_t* cache, const char* path);
+
+/**
+ * @brief Same as wav_cache_acquire() but never touches the disk.
+ * @returns `NULL` if `path` isn't loaded.
+ */
+wav_asset_t* wav_cache_find(wav_cache_t* cache, const char* path);
+
+/**
+ * @brief Takes one more reference on an asset the caller already holds. Lock-free.
+ */
+void wav_asset_retain(wav_asset_t* asset);
+
+/**
+ * @brief Drops a reference. The last one puts the asset on the LRU list; it stays
+ *        loaded until the budget forces it out.
+ */
+void wav_asset_release(wav_asset_t* asset);
+
+/**
+ * @returns the parsed file. Its samples must be treated as read-only.
+ */
+const wav_file_t* wav_asset_file(const wav_asset_t* asset);
+
+/**
+ * @brief Changes the budget, evicting unreferenced assets right away if needed.
+ *        A budget of 0 drops everything that isn't referenced.
+ */
+void wav_cache_set_budget(wav_cache_t* cache, uint64_t budget_bytes);
+
+void wav_cache_get_stats(wav_cache_t* cache, wav_cache_stats_t* stats);
@@ -0,0 +1,174 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+#include "wav_codec.h"
+#include "wav_endian.h"
+#include "wav_convert.h"
+#include "wav_writer.h"
+#include "log.h"
+
+#define DECODE_FILE_BLOCK 1024  //? samples converted per pass when expanding G.711
+
+//=================================================IMA ADPCM==========================================================
+//* Each nibble adds a multiple of the current step to the predictor and moves the step index. Both
+//* only depend on (step index, nibble), so they're expanded at compile time into one table of
+//* 89 x 16 entries: the signed difference times 256 plus the next step index. Decoding a sample is
+//* a lookup, an add and a clamp; the differences come out exactly as the reference shift-and-add
+//* computes them.
+
+#define ADPCM_DIFF(step, n)     (((step) >> 3) + (((n) & 4) ? (step) : 0) + (((n) & 2) ? (step) >> 1 : 0) + (((n) & 1) ? (step) >> 2 : 0))
+#define ADPCM_MOVE(n)           (((n) & 4) ? (((n) & 3) + 1) * 2 : -1)
+#define ADPCM_CLAMP(index)      ((index) < 0 ? 0 : (index) > 88 ? 88 : (index))
+#define ADPCM_ENTRY(index, step, n) \
+    ((((n) & 8) ? -ADPCM_DIFF(step, n) : ADPCM_DIFF(step, n)) * 256 + ADPCM_CLAMP((index) + ADPCM_MOVE(n)))
+#define ADPCM_ROW(index, step) { \
+    ADPCM_ENTRY(index, step, 0),  ADPCM_ENTRY(index, step, 1),  ADPCM_ENTRY(index, step, 2),  ADPCM_ENTRY(index, step, 3),  \
+    ADPCM_ENTRY(index, step, 4),  ADPCM_ENTRY(index, step, 5),  ADPCM_ENTRY(index, step, 6),  ADPCM_ENTRY(index, step, 7),  \
+    ADPCM_ENTRY(index, step, 8),  ADPCM_ENTRY(index, step, 9),  ADPCM_ENTRY(index, step, 10), ADPCM_ENTRY(index, step, 11), \
+    ADPCM_ENTRY(index, step, 12), ADPCM_ENTRY(index, step, 13), ADPCM_ENTRY(index, step, 14), ADPCM_ENTRY(index, step, 15) }
+
+//? Indexed by [step index][nibble], rows are (step index, step size)
+static const int32_t adpcm_table[89][16] = {
+    ADPCM_ROW(0, 7), ADPCM_ROW(1, 8), ADPCM_ROW(2, 9), ADPCM_ROW(3, 10), ADPCM_ROW(4, 11), ADPCM_ROW(5, 12),
+    ADPCM_ROW(6, 13), ADPCM_ROW(7, 14), ADPCM_ROW(8, 16), ADPCM_ROW(9, 17), ADPCM_ROW(10, 19), ADPCM_ROW(11, 21),
+    ADPCM_ROW(12, 23), ADPCM_ROW(13, 25), ADPCM_ROW(14, 28), ADPCM_ROW(15, 31), ADPCM_ROW(16, 34), ADPCM_ROW(17, 37),
+    ADPCM_ROW(18, 41), ADPCM_ROW(19, 45), ADPCM_ROW(20, 50), ADPCM_ROW(21, 55), ADPCM_ROW(22, 60), ADPCM_ROW(23, 66),
+    ADPCM_ROW(24, 73), ADPCM_ROW(25, 80), ADPCM_ROW(26, 88), ADPCM_ROW(27, 97), ADPCM_ROW(28, 107), ADPCM_ROW(29, 118),
+    ADPCM_ROW(30, 130), ADPCM_ROW(31, 143), ADPCM_ROW(32, 157), ADPCM_ROW(33, 173), ADPCM_ROW(34, 190), ADPCM_ROW(35, 209),
+    ADPCM_ROW(36, 230), ADPCM_ROW(37, 253), ADPCM_ROW(38, 279), ADPCM_ROW(39, 307), ADPCM_ROW(40, 337), ADPCM_ROW(41, 371),
+    ADPCM_ROW(42, 408), ADPCM_ROW(43, 449), ADPCM_ROW(44, 494), ADPCM_ROW(45, 544), ADPCM_ROW(46, 598), ADPCM_ROW(47, 658),
+    ADPCM_ROW(48, 724), ADPCM_ROW(49, 796), ADPCM_ROW(50, 876), ADPCM_ROW(51, 963), ADPCM_ROW(52, 1060), ADPCM_ROW(53, 1166),
+    ADPCM_ROW(54, 1282), ADPCM_ROW(55, 1411), ADPCM_ROW(56, 1552), ADPCM_ROW(57, 1707), ADPCM_ROW(58, 1878), ADPCM_ROW(59, 2066),
+    ADPCM_ROW(60, 2272), ADPCM_ROW(61, 2499), ADPCM_ROW(62, 2749), ADPCM_ROW(63, 3024), ADPCM_ROW(64, 3327), ADPCM_ROW(65, 3660),
+    ADPCM_ROW(66, 4026), ADPCM_ROW(67, 4428), ADPCM_ROW(68, 4871), ADPCM_ROW(69, 5358), ADPCM_ROW(70, 5894), ADPCM_ROW(71, 6484),
+    ADPCM_ROW(72, 7132), ADPCM_ROW(73, 7845), ADPCM_ROW(74, 8630), ADPCM_ROW(75, 9493), ADPCM_ROW(76, 10442), ADPCM_ROW(77, 11487),
+    ADPCM_ROW(78, 12635), ADPCM_ROW(79, 13899), ADPCM_ROW(80, 15289), ADPCM_ROW(81, 16818), ADPCM_ROW(82, 18500), ADPCM_ROW(83, 20350),
+    ADPCM_ROW(84, 22385), ADPCM_ROW(85, 24623), ADPCM_ROW(86, 27086), ADPCM_ROW(87, 29794), ADPCM_ROW(88, 32767),
+};
+
+/**
+ * Decodes `count` samples of channel `c` from sample `k` of its block on (0 is the first
+ * nibble after the block header) into every `channels`-th slot of `out`, or just runs the
+ * predictor forward when `out` is NULL.
+ */
+static void adpcm_decode_channel(const uint8_t* block, uint16_t channels, uint16_t c, uint32_t k, size_t count, int32_t* predictor, int32_t* step_index, int16_t* out) {
+    //? After the headers, each channel in turn has 4 bytes holding its next 8 samples, low nibble first
+    const uint8_t* groups = block + 4u * channels + 4u * c;
+    const size_t group_stride = 4u * channels;
+    int32_t sample = *predictor;
+    int32_t index = *step_index;
+    for (size_t i = 0; i < count; ++i, ++k) {
+        const uint8_t byte = groups[(k >> 3) * group_stride + ((k & 7) >> 1)];
+        const int32_t entry = adpcm_table[index][(k & 1) ? byte >> 4 : byte & 0x0F];
+        sample += entry >> 8;
+        if (sample > 32767) sample = 32767;
+        else if (sample < -32768) sample = -32768;
+        index = entry & 0xFF;
+        if (out) out[i * channels] = (int16_t)sample;
+    }
+    *predictor = sample;
+    *step_index = index;
+}
+
+size_t wav_adpcm_decode(const wav_file_t* file, uint64_t frame, size_t count, int16_t* out, wav_adpcm_state_t* state) {
+    if (!file || !file->data || !out || !state) return 0;
+    const wav_header_t* header = &file->header;
+    const uint16_t channels = header->num_channels;
+    if (header->encoding != WAV_FORMAT_IMA_ADPCM || channels > WAV_ADPCM_MAX_CHANNELS || frame >= file->samples) return 0;
+    if (count > file->samples - frame) count = (size_t)(file->samples - frame);
+
+    const uint32_t per_block = header->samples_per_block;
+    for (size_t done = 0; done < count; ) {
+        const uint64_t at = frame + done;
+        const uint8_t* block = file->data + (size_t)(at / per_block) * header->block_align;
+        const uint32_t pos = (uint32_t)(at % per_block);
+        const size_t n = (count - done < per_block - pos) ? count - done : per_block - pos;
+        int16_t* dst = out + done * channels;
+        if (pos == 0 || state->frame != at) {
+            //* Start from the block header, whose predictor is the block's first frame, and run up to `at`
+            for (uint16_t c = 0; c < channels; ++c) {
+                const uint8_t* head = block + 4u * c;
+                state->predictor[c] = (int16_t)decode_u16(head);
+                state->step_index[c] = (head[2] > 88) ? 88 : head[2];
+                if (pos > 1) adpcm_decode_channel(block, channels, c, 0, pos - 1, &state->predictor[c], &state->step_index[c], NULL);
+            }
+        }
+        size_t from_header = 0;
+        if (pos == 0) {
+            for (uint16_t c = 0; c < channels; ++c) dst[c] = (int16_t)state->predictor[c];
+            from_header = 1;
+        }
+        for (uint16_t c = 0; c < channels; ++c) {
+            adpcm_decode_channel(block, channels, c, pos ? pos - 1 : 0, n - from_header, &state->predictor[c], &state->step_index[c],
+                                 dst + from_header * channels + c);
+        }
+        state->frame = at + n;
+        done += n;
+    }
+    return count;
+}
+
+//=================================================WHOLE FILES==========================================================
+
+bool wav_decode_file(const wav_file_t* in, wav_file_t* out) {
+    if (!in || !out || in->data == NULL) return false;
+    wav_init_file(out);
+
+    const wav_header_t* header = &in->header;
+    const bool adpcm = header->encoding == WAV_FORMAT_IMA_ADPCM;
+    wav_sample_format_t format = WAV_SAMPLE_S16;
+    if (!adpcm && (!wav_sample_format_from_header(header, &format) || (format != WAV_SAMPLE_ULAW && format != WAV_SAMPLE_ALAW))) {
+        Log(LOG_ERROR, "Format %d with %d bits per sample isn't a compressed format, there's nothing to decode.\n", header->encoding, header->bits_per_sample);
+        return false;
+    }
+    if (adpcm && header->num_channels > WAV_ADPCM_MAX_CHANNELS) {
+        Log(LOG_ERROR, "IMA ADPCM with %d channels isn't supported (at most %d).\n", header->num_channels, WAV_ADPCM_MAX_CHANNELS);
+        return false;
+    }
+    const size_t frame_bytes = (size_t)header->num_channels * sizeof(int16_t);
+    if (in->samples > SIZE_MAX / frame_bytes) {
+        Log(LOG_ERROR, "The decoded data (%llu frames) doesn't fit in memory.\n", (unsigned long long)in->samples);
+        return false;
+    }
+    out->data = (uint8_t*)malloc(in->samples ? (size_t)in->samples * frame_bytes : 1);
+    if (!out->data) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for the decoded data.\n", (unsigned long long)(in->samples * frame_bytes));
+        return false;
+    }
+    out->owner = WAV_DATA_HEAP;
+    wav_init_header(&out->header, WAV_FORMAT_PCM, header->num_channels, header->sample_rate, 16);
+    out->header.data_size = in->samples * frame_bytes;
+    out->data_length = out->header.data_size;
+    out->samples = in->samples;
+
+    if (adpcm) {
+        wav_adpcm_state_t state;
+        memset(&state, 0, sizeof(state));
+        wav_adpcm_decode(in, 0, (size_t)in->samples, (int16_t*)out->data, &state);
+        return true;
+    }
+    //? G.711 levels are exact 16-bit values, so going through float is lossless and both passes run the SIMD kernels
+    float block[DECODE_FILE_BLOCK];
+    const size_t total = (size_t)in->samples * header->num_channels;
+    for (size_t done = 0; done < total; ) {
+        size_t n = (total - done < DECODE_FILE_BLOCK) ? total - done : DECODE_FILE_BLOCK;
+        wav_convert_to_float(block, in->data + done, n, format);
+        wav_convert_from_float(out->data + done * sizeof(int16_t), block, n, WAV_SAMPLE_S16);
+        done += n;
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_parser.h"
+
+#define WAV_ADPCM_MAX_CHANNELS 8
+
+/**
+ * Where an IMA ADPCM decode left off, so the next call can carry on from there.
+ *
+ * Blocks decode independently, so any frame can be reached by decoding from the
+ * start of its block; when a call starts at the frame the previous one stopped
+ * at, it continues from the saved predictors instead, and sequential playback
+ * decodes every sample exactly once. A zeroed state starts fresh.
+ */
+typedef struct wav_adpcm_state_t {
+    uint64_t frame;                             //? frame the predictors below lead into, 0 when there's nothing to continue
+    int32_t predictor[WAV_ADPCM_MAX_CHANNELS];  //? last sample decoded, per channel
+    int32_t step_index[WAV_ADPCM_MAX_CHANNELS];
+} wav_adpcm_state_t;
+
+/**
+ * @brief Decodes frames `frame` to `frame + count - 1` of an IMA ADPCM file to interleaved 16-bit PCM.
+ *
+ * The data stays compressed (4 bits per sample, about a quarter of 16-bit PCM);
+ * only the range asked for is expanded, so a player can decode each block as it
+ * mixes it. Each sample costs one lookup in a combined step/index table.
+ *
+ * @param out   Caller-owned, at least `count * num_channels` samples.
+ * @param state Carried between calls, see wav_adpcm_state_t.
+ * @returns the frames decoded: fewer than `count` at the end of the data, 0 if
+ *          `file` isn't IMA ADPCM with at most WAV_ADPCM_MAX_CHANNELS channels.
+ */
+size_t wav_adpcm_decode(const wav_file_t* file, uint64_t frame, size_t count, int16_t* out, wav_adpcm_state_t* state);
+
+/**
+ * @brief Expands a whole compressed file (IMA ADPCM, μ-law or A-law) to 16-bit PCM.
+ *
+ * For assets that are played often enough that decoding once at load time beats
+ * keeping them small. `out` gets a heap copy with a plain PCM header; free it with
+ * wav_free_file().
+ *
+ * @returns `false` (with the reason logged) if `in` isn't one of those formats or
+ *          memory runs out.
+ */
+bool wav_decode_file(const wav_file_t* in, wav_file_t* out);
@@ -0,0 +1,672 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_convert.h"
+#include "wav_isa.h"
+#include <math.h>
+
+//! The AVX2 kernels finish with the SSE2/scalar ones, and gcc compiles that as a plain jump with no
+//! vzeroupper: they clear the upper halves themselves, or every legacy SSE instruction the caller runs
+//! afterwards stalls on them
+
+#define U8_SCALE    (1.0f / 128.0f)
+#define S16_SCALE   (1.0f / 32768.0f)
+#define S24_SCALE   (1.0f / 8388608.0f)
+#define S32_SCALE   (1.0f / 2147483648.0f)
+#define S32_MAX_F   2147483520.0f   //! largest float below 2^31, 2147483647 itself isn't representable
+
+typedef void (*to_float_fn)(float* dst, const uint8_t* src, size_t samples);
+typedef void (*from_float_fn)(uint8_t* dst, const float* src, size_t samples);
+
+//=================================================SCALAR KERNELS==========================================================
+
+static int32_t quantize(float x, float scale, float lo, float hi) {
+    float v = x * scale;
+    if (!(v >= lo)) v = lo;     //? also catches NaN, same as the SIMD max/min pair
+    if (v > hi) v = hi;
+    return (int32_t)lrintf(v);
+}
+
+static void u8_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ((float)src[i] - 128.0f) * U8_SCALE;
+    }
+}
+
+static void s16_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int16_t v = (int16_t)(src[2 * i] | (src[2 * i + 1] << 8));
+        dst[i] = (float)v * S16_SCALE;
+    }
+}
+
+static void s24_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* p = src + 3 * i;
+        int32_t v = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+        dst[i] = (float)v * S24_SCALE;
+    }
+}
+
+static void s32_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* p = src + 4 * i;
+        int32_t v = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+        dst[i] = (float)v * S32_SCALE;
+    }
+}
+
+static void s24_unpack_scalar(int32_t* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* p = src + 3 * i;
+        dst[i] = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24));
+    }
+}
+
+static void f32_to_f32(float* dst, const uint8_t* src, size_t n) {
+    memcpy(dst, src, n * sizeof(float));
+}
+
+static void f32_to_u8_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = (uint8_t)(quantize(src[i], 128.0f, -128.0f, 127.0f) + 128);
+    }
+}
+
+static void f32_to_s16_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t v = quantize(src[i], 32768.0f, -32768.0f, 32767.0f);
+        dst[2 * i]     = (uint8_t)(v & 0xFF);
+        dst[2 * i + 1] = (uint8_t)((v >> 8) & 0xFF);
+    }
+}
+
+static void f32_to_s24_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t v = quantize(src[i], 8388608.0f, -8388608.0f, 8388607.0f);
+        dst[3 * i]     = (uint8_t)(v & 0xFF);
+        dst[3 * i + 1] = (uint8_t)((v >> 8) & 0xFF);
+        dst[3 * i + 2] = (uint8_t)((v >> 16) & 0xFF);
+    }
+}
+
+static void f32_to_s32_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t v = (uint32_t)quantize(src[i], 2147483648.0f, -2147483648.0f, S32_MAX_F);
+        dst[4 * i]     = (uint8_t)(v & 0xFF);
+        dst[4 * i + 1] = (uint8_t)((v >> 8) & 0xFF);
+        dst[4 * i + 2] = (uint8_t)((v >> 16) & 0xFF);
+        dst[4 * i + 3] = (uint8_t)(v >> 24);
+    }
+}
+
+static void f32_from_f32(uint8_t* dst, const float* src, size_t n) {
+    memcpy(dst, src, n * sizeof(float));
+}
+
+//* G.711 straight from the spec: a sign, a 3-bit segment (exponent) and a 4-bit step (mantissa).
+//* μ-law bytes are stored inverted, sign set = negative; A-law bytes have every other bit flipped,
+//* sign set = positive. The 256 levels are expanded at compile time, decoding is one lookup
+#define ULAW_MAG(x)         (((((x) & 0x0F) << 3) + 0x84) << (((x) >> 4) & 7))
+#define ULAW_LINEAR(x)      (((x) & 0x80) ? 0x84 - ULAW_MAG(x) : ULAW_MAG(x) - 0x84)
+#define ALAW_MAG(x)         ((((x) >> 4) & 7) == 0 ? (((x) & 0x0F) << 4) + 8 : (((((x) & 0x0F) << 4) + 0x108) << (((x) >> 4) & 7)) >> 1)
+#define ALAW_LINEAR(x)      (((x) & 0x80) ? ALAW_MAG(x) : -ALAW_MAG(x))
+#define ULAW_LEVEL(b)       ((float)ULAW_LINEAR((b) ^ 0xFF) * S16_SCALE)
+#define ALAW_LEVEL(b)       ((float)ALAW_LINEAR((b) ^ 0x55) * S16_SCALE)
+#define G711_ROW4(f, b)     f(b), f((b) + 1), f((b) + 2), f((b) + 3)
+#define G711_ROW16(f, b)    G711_ROW4(f, b), G711_ROW4(f, (b) + 4), G711_ROW4(f, (b) + 8), G711_ROW4(f, (b) + 12)
+#define G711_ROW64(f, b)    G711_ROW16(f, b), G711_ROW16(f, (b) + 16), G711_ROW16(f, (b) + 32), G711_ROW16(f, (b) + 48)
+#define G711_TABLE(f)       G711_ROW64(f, 0), G711_ROW64(f, 64), G711_ROW64(f, 128), G711_ROW64(f, 192)
+
+static const float ulaw_levels[256] = { G711_TABLE(ULAW_LEVEL) };
+static const float alaw_levels[256] = { G711_TABLE(ALAW_LEVEL) };
+
+static void ulaw_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ulaw_levels[src[i]];
+    }
+}
+
+static void alaw_to_f32_scalar(float* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = alaw_levels[src[i]];
+    }
+}
+
+//? Encoding only happens when writing files, so it stays scalar on every ISA
+static void f32_to_ulaw_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t v = quantize(src[i], 32768.0f, -32768.0f, 32767.0f);
+        uint8_t mask = 0xFF;
+        if (v < 0) {
+            v = -v;
+            mask = 0x7F;
+        }
+        if (v > 32635) v = 32635;   //! past this the bias would carry out of the top segment
+        v += 0x84;
+        int segment = 7;
+        for (int32_t bit = 0x4000; (v & bit) == 0 && segment > 0; bit >>= 1) --segment;
+        dst[i] = (uint8_t)(((segment << 4) | ((v >> (segment + 3)) & 0x0F)) ^ mask);
+    }
+}
+
+static void f32_to_alaw_scalar(uint8_t* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t v = quantize(src[i], 32768.0f, -32768.0f, 32767.0f) >> 3;
+        uint8_t mask = 0xD5;
+        if (v < 0) {
+            v = -v - 1;
+            mask = 0x55;
+        }
+        int segment = 0;
+        while (segment < 8 && v >= (0x20 << segment)) ++segment;
+        uint8_t code = (segment == 8) ? 0x7F : (uint8_t)((segment << 4) | ((v >> (segment < 2 ? 1 : segment)) & 0x0F));
+        dst[i] = code ^ mask;
+    }
+}
+
+#ifdef WAV_ISA_X86
+//=================================================SSE2 KERNELS==========================================================
+//* Each kernel does the bulk in vectors and hands the last few samples to the scalar version
+
+TARGET_SSE2 static void u8_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 bias = _mm_set1_ps(128.0f);
+    const __m128 scale = _mm_set1_ps(U8_SCALE);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i,      _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), bias), scale));
+        _mm_storeu_ps(dst + i + 4,  _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), bias), scale));
+        _mm_storeu_ps(dst + i + 8,  _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), bias), scale));
+        _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), bias), scale));
+    }
+    u8_to_f32_scalar(dst + i, src + i, n - i);
+}
+
+TARGET_SSE2 static void s16_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+        //? Duplicating each 16-bit lane then shifting right by 16 sign-extends it
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    s16_to_f32_scalar(dst + i, src + 2 * i, n - i);
+}
+
+TARGET_SSE2 static void s24_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(S24_SCALE);
+    size_t i = 0;
+    //! Each 4-byte load grabs one byte past its sample, keep one sample of slack at the end
+    for (; i + 5 <= n; i += 4) {
+        const uint8_t* p = src + 3 * i;
+        int32_t a, b, c, d;
+        memcpy(&a, p, 4);
+        memcpy(&b, p + 3, 4);
+        memcpy(&c, p + 6, 4);
+        memcpy(&d, p + 9, 4);
+        __m128i v = _mm_set_epi32(d, c, b, a);
+        v = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    s24_to_f32_scalar(dst + i, src + 3 * i, n - i);
+}
+
+TARGET_SSE2 static void s24_unpack_sse2(int32_t* dst, const uint8_t* src, size_t n) {
+    size_t i = 0;
+    //! Same one-sample slack as s24_to_f32_sse2
+    for (; i + 5 <= n; i += 4) {
+        const uint8_t* p = src + 3 * i;
+        int32_t a, b, c, d;
+        memcpy(&a, p, 4);
+        memcpy(&b, p + 3, 4);
+        memcpy(&c, p + 6, 4);
+        memcpy(&d, p + 9, 4);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_slli_epi32(_mm_set_epi32(d, c, b, a), 8));
+    }
+    s24_unpack_scalar(dst + i, src + 3 * i, n - i);
+}
+
+TARGET_SSE2 static void s32_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(S32_SCALE);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + 4 * i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    s32_to_f32_scalar(dst + i, src + 4 * i, n - i);
+}
+
+TARGET_SSE2 static void f32_to_u8_sse2(uint8_t* dst, const float* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(128.0f);
+    const __m128 lo = _mm_set1_ps(-128.0f);
+    const __m128 hi = _mm_set1_ps(127.0f);
+    const __m128i bias = _mm_set1_epi32(128);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_add_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i),      scale), lo), hi)), bias);
+        __m128i b = _mm_add_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4),  scale), lo), hi)), bias);
+        __m128i c = _mm_add_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 8),  scale), lo), hi)), bias);
+        __m128i d = _mm_add_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 12), scale), lo), hi)), bias);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+    f32_to_u8_scalar(dst + i, src + i, n - i);
+}
+
+TARGET_SSE2 static void f32_to_s16_sse2(uint8_t* dst, const float* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i),     scale), lo), hi));
+        __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lo), hi));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_packs_epi32(a, b));
+    }
+    f32_to_s16_scalar(dst + 2 * i, src + i, n - i);
+}
+
+TARGET_SSE2 static void f32_to_s24_sse2(uint8_t* dst, const float* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(8388608.0f);
+    const __m128 lo = _mm_set1_ps(-8388608.0f);
+    const __m128 hi = _mm_set1_ps(8388607.0f);
+    size_t i = 0;
+    //? SSE2 has no byte shuffle: quantize in vectors, then pack the 3-byte triplets by hand
+    for (; i + 4 <= n; i += 4) {
+        int32_t v[4];
+        _mm_storeu_si128((__m128i*)v, _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi)));
+        uint8_t* p = dst + 3 * i;
+        for (int k = 0; k < 4; ++k) {
+            p[3 * k]     = (uint8_t)(v[k] & 0xFF);
+            p[3 * k + 1] = (uint8_t)((v[k] >> 8) & 0xFF);
+            p[3 * k + 2] = (uint8_t)((v[k] >> 16) & 0xFF);
+        }
+    }
+    f32_to_s24_scalar(dst + 3 * i, src + i, n - i);
+}
+
+TARGET_SSE2 static void f32_to_s32_sse2(uint8_t* dst, const float* src, size_t n) {
+    const __m128 scale = _mm_set1_ps(2147483648.0f);
+    const __m128 lo = _mm_set1_ps(-2147483648.0f);
+    const __m128 hi = _mm_set1_ps(S32_MAX_F);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi));
+        _mm_storeu_si128((__m128i*)(dst + 4 * i), v);
+    }
+    f32_to_s32_scalar(dst + 4 * i, src + i, n - i);
+}
+
+//? G.711 in vectors, no gathers: the 3-bit segment and 4-bit step are already a float's exponent and
+//? top mantissa bits. (step + 16.5) << (segment + 3), the level before the bias comes off, is built
+//? straight from the code's bits, pre-scaled by 2^-15 through the exponent, so every lane is exact
+//? and matches the tables bit for bit
+#define G711_FLOAT_BASE     (((127 + 7 - 15) << 23) + (1 << 18))
+#define ULAW_BIAS_F         (132.0f * S16_SCALE)
+#define ALAW_SEGMENT0_F     (256.0f * S16_SCALE)     //? segment 0 has no implicit leading step
+
+TARGET_SSE2 static inline __m128 ulaw_expand_sse2(__m128i x) {
+    __m128 level = _mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x7F)), 19), _mm_set1_epi32(G711_FLOAT_BASE)));
+    __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x80)), 24));
+    //* Signing both terms before subtracting keeps the zero level +0 for either sign, like the table
+    return _mm_sub_ps(_mm_xor_ps(level, sign), _mm_xor_ps(_mm_set1_ps(ULAW_BIAS_F), sign));
+}
+
+TARGET_SSE2 static inline __m128 alaw_expand_sse2(__m128i x) {
+    __m128i segment0 = _mm_cmpeq_epi32(_mm_and_si128(x, _mm_set1_epi32(0x70)), _mm_setzero_si128());
+    //? Segment 0 is built as segment 1, then loses the leading step it doesn't have
+    __m128i bits = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x7F)), 19), _mm_set1_epi32(G711_FLOAT_BASE));
+    bits = _mm_add_epi32(bits, _mm_and_si128(segment0, _mm_set1_epi32(1 << 23)));
+    __m128 level = _mm_sub_ps(_mm_castsi128_ps(bits), _mm_and_ps(_mm_castsi128_ps(segment0), _mm_set1_ps(ALAW_SEGMENT0_F)));
+    __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(x, _mm_set1_epi32(0x80)), 24));
+    return _mm_xor_ps(level, sign);
+}
+
+TARGET_SSE2 static void ulaw_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i invert = _mm_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), invert);
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i,      ulaw_expand_sse2(_mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 4,  ulaw_expand_sse2(_mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 8,  ulaw_expand_sse2(_mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_ps(dst + i + 12, ulaw_expand_sse2(_mm_unpackhi_epi16(hi, zero)));
+    }
+    ulaw_to_f32_scalar(dst + i, src + i, n - i);
+}
+
+TARGET_SSE2 static void alaw_to_f32_sse2(float* dst, const uint8_t* src, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i flip = _mm_set1_epi8(0x55);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), flip);
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i,      alaw_expand_sse2(_mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 4,  alaw_expand_sse2(_mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 8,  alaw_expand_sse2(_mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_ps(dst + i + 12, alaw_expand_sse2(_mm_unpackhi_epi16(hi, zero)));
+    }
+    alaw_to_f32_scalar(dst + i, src + i, n - i);
+}
+
+//=================================================AVX2 KERNELS==========================================================
+
+TARGET_AVX2 static void u8_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    const __m256 bias = _mm256_set1_ps(128.0f);
+    const __m256 scale = _mm256_set1_ps(U8_SCALE);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        for (int k = 0; k < 32; k += 8) {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i + k)));
+            _mm256_storeu_ps(dst + i + k, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(v), bias), scale));
+        }
+    }
+    _mm256_zeroupper();
+    u8_to_f32_sse2(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static void s16_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + 2 * i)));
+        __m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + 2 * i + 16)));
+        _mm256_storeu_ps(dst + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(a), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(b), scale));
+    }
+    _mm256_zeroupper();
+    s16_to_f32_sse2(dst + i, src + 2 * i, n - i);
+}
+
+TARGET_AVX2 static void s24_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    //? Each 128-bit lane holds 4 packed samples (12 bytes): move every triplet into the top
+    //? 3 bytes of a 32-bit slot, then an arithmetic shift right sign-extends it
+    const __m256i shuffle = _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    const __m256 scale = _mm256_set1_ps(S24_SCALE);
+    size_t i = 0;
+    //! The second 16-byte load ends 4 bytes past the 8th sample, hence the slack
+    for (; i + 10 <= n; i += 8) {
+        const uint8_t* p = src + 3 * i;
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                            _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+        v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, shuffle), 8);
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    _mm256_zeroupper();
+    s24_to_f32_sse2(dst + i, src + 3 * i, n - i);
+}
+
+TARGET_AVX2 static void s24_unpack_avx2(int32_t* dst, const uint8_t* src, size_t n) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    size_t i = 0;
+    //! Same 4-byte overread as s24_to_f32_avx2
+    for (; i + 10 <= n; i += 8) {
+        const uint8_t* p = src + 3 * i;
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                            _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(v, shuffle));
+    }
+    _mm256_zeroupper();
+    s24_unpack_sse2(dst + i, src + 3 * i, n - i);
+}
+
+TARGET_AVX2 static void s32_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(S32_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + 4 * i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    _mm256_zeroupper();
+    s32_to_f32_sse2(dst + i, src + 4 * i, n - i);
+}
+
+//? Same bit assembly as the SSE2 versions, 8 lanes at a time
+TARGET_AVX2 static inline __m256 ulaw_expand_avx2(__m256i x) {
+    __m256 level = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0x7F)), 19), _mm256_set1_epi32(G711_FLOAT_BASE)));
+    __m256 sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0x80)), 24));
+    return _mm256_sub_ps(_mm256_xor_ps(level, sign), _mm256_xor_ps(_mm256_set1_ps(ULAW_BIAS_F), sign));
+}
+
+TARGET_AVX2 static inline __m256 alaw_expand_avx2(__m256i x) {
+    __m256i segment0 = _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0x70)), _mm256_setzero_si256());
+    __m256i bits = _mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0x7F)), 19), _mm256_set1_epi32(G711_FLOAT_BASE));
+    bits = _mm256_add_epi32(bits, _mm256_and_si256(segment0, _mm256_set1_epi32(1 << 23)));
+    __m256 level = _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_and_ps(_mm256_castsi256_ps(segment0), _mm256_set1_ps(ALAW_SEGMENT0_F)));
+    __m256 sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(x, _mm256_set1_epi32(0x80)), 24));
+    return _mm256_xor_ps(level, sign);
+}
+
+TARGET_AVX2 static void ulaw_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    const __m256i invert = _mm256_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        for (int k = 0; k < 32; k += 8) {
+            __m256i v = _mm256_xor_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i + k))), invert);
+            _mm256_storeu_ps(dst + i + k, ulaw_expand_avx2(v));
+        }
+    }
+    _mm256_zeroupper();
+    ulaw_to_f32_sse2(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static void alaw_to_f32_avx2(float* dst, const uint8_t* src, size_t n) {
+    const __m256i flip = _mm256_set1_epi32(0x55);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        for (int k = 0; k < 32; k += 8) {
+            __m256i v = _mm256_xor_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i + k))), flip);
+            _mm256_storeu_ps(dst + i + k, alaw_expand_avx2(v));
+        }
+    }
+    _mm256_zeroupper();
+    alaw_to_f32_sse2(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static void f32_to_u8_avx2(uint8_t* dst, const float* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(128.0f);
+    const __m256 lo = _mm256_set1_ps(-128.0f);
+    const __m256 hi = _mm256_set1_ps(127.0f);
+    const __m256i bias = _mm256_set1_epi32(128);
+    //? The packs work per 128-bit lane, this puts the 32-bit groups back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i),      scale), lo), hi)), bias);
+        __m256i b = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8),  scale), lo), hi)), bias);
+        __m256i c = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 16), scale), lo), hi)), bias);
+        __m256i d = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 24), scale), lo), hi)), bias);
+        __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permutevar8x32_epi32(packed, order));
+    }
+    _mm256_zeroupper();
+    f32_to_u8_sse2(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static void f32_to_s16_avx2(uint8_t* dst, const float* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 lo = _mm256_set1_ps(-32768.0f);
+    const __m256 hi = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i),     scale), lo), hi));
+        __m256i b = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), lo), hi));
+        //? packs interleaves the lanes (a0 b0 a1 b1), swap the middle quadwords back
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i), packed);
+    }
+    _mm256_zeroupper();
+    f32_to_s16_sse2(dst + 2 * i, src + i, n - i);
+}
+
+TARGET_AVX2 static void f32_to_s24_avx2(uint8_t* dst, const float* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(8388608.0f);
+    const __m256 lo = _mm256_set1_ps(-8388608.0f);
+    const __m256 hi = _mm256_set1_ps(8388607.0f);
+    //? Drop the top byte of every 32-bit slot: 12 packed bytes per lane, 4 junk bytes at the end
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    size_t i = 0;
+    //! The second 16-byte store runs 4 bytes past the 8th sample, hence the slack
+    for (; i + 10 <= n; i += 8) {
+        __m256i v = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi));
+        v = _mm256_shuffle_epi8(v, shuffle);
+        uint8_t* p = dst + 3 * i;
+        _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i*)(p + 12), _mm256_extracti128_si256(v, 1));
+    }
+    _mm256_zeroupper();
+    f32_to_s24_sse2(dst + 3 * i, src + i, n - i);
+}
+
+TARGET_AVX2 static void f32_to_s32_avx2(uint8_t* dst, const float* src, size_t n) {
+    const __m256 scale = _mm256_set1_ps(2147483648.0f);
+    const __m256 lo = _mm256_set1_ps(-2147483648.0f);
+    const __m256 hi = _mm256_set1_ps(S32_MAX_F);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi));
+        _mm256_storeu_si256((__m256i*)(dst + 4 * i), v);
+    }
+    _mm256_zeroupper();
+    f32_to_s32_sse2(dst + 4 * i, src + i, n - i);
+}
+#endif
+
+//=================================================DISPATCH==========================================================
+
+//* Indexed by [wav_isa_t][wav_sample_format_t]
+static const to_float_fn to_float_kernels[WAV_ISA_COUNT][7] = {
+    { u8_to_f32_scalar, s16_to_f32_scalar, s24_to_f32_scalar, s32_to_f32_scalar, f32_to_f32, ulaw_to_f32_scalar, alaw_to_f32_scalar },
+#ifdef WAV_ISA_X86
+    { u8_to_f32_sse2,   s16_to_f32_sse2,   s24_to_f32_sse2,   s32_to_f32_sse2,   f32_to_f32, ulaw_to_f32_sse2,   alaw_to_f32_sse2 },
+    { u8_to_f32_avx2,   s16_to_f32_avx2,   s24_to_f32_avx2,   s32_to_f32_avx2,   f32_to_f32, ulaw_to_f32_avx2,   alaw_to_f32_avx2 },
+#endif
+};
+
+static const from_float_fn from_float_kernels[WAV_ISA_COUNT][7] = {
+    { f32_to_u8_scalar, f32_to_s16_scalar, f32_to_s24_scalar, f32_to_s32_scalar, f32_from_f32, f32_to_ulaw_scalar, f32_to_alaw_scalar },
+#ifdef WAV_ISA_X86
+    { f32_to_u8_sse2,   f32_to_s16_sse2,   f32_to_s24_sse2,   f32_to_s32_sse2,   f32_from_f32, f32_to_ulaw_scalar, f32_to_alaw_scalar },
+    { f32_to_u8_avx2,   f32_to_s16_avx2,   f32_to_s24_avx2,   f32_to_s32_avx2,   f32_from_f32, f32_to_ulaw_scalar, f32_to_alaw_scalar },
+#endif
+};
+
+typedef void (*unpack_fn)(int32_t* dst, const uint8_t* src, size_t samples);
+
+static const unpack_fn s24_unpack_kernels[WAV_ISA_COUNT] = {
+    s24_unpack_scalar,
+#ifdef WAV_ISA_X86
+    s24_unpack_sse2,
+    s24_unpack_avx2,
+#endif
+};
+
+static int pinned_isa = -1;     //? -1 = use the best the CPU has
+
+static wav_isa_t wav_detect_isa(void) {
+#ifdef WAV_ISA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return WAV_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return WAV_ISA_SSE2;
+#endif
+    return WAV_ISA_SCALAR;
+}
+
+wav_isa_t wav_convert_get_isa(void) {
+    return (pinned_isa >= 0) ? (wav_isa_t)pinned_isa : wav_detect_isa();
+}
+
+bool wav_convert_set_isa(wav_isa_t isa) {
+    if (isa > wav_detect_isa()) return false;
+    pinned_isa = (int)isa;
+    return true;
+}
+
+const char* wav_isa_name(wav_isa_t isa) {
+    switch (isa) {
+        case WAV_ISA_SCALAR:    return "scalar";
+        case WAV_ISA_SSE2:      return "sse2";
+        case WAV_ISA_AVX2:      return "avx2";
+    }
+    return "unknown";
+}
+
+size_t wav_sample_format_size(wav_sample_format_t format) {
+    switch (format) {
+        case WAV_SAMPLE_U8:     return 1;
+        case WAV_SAMPLE_S16:    return 2;
+        case WAV_SAMPLE_S24:    return 3;
+        case WAV_SAMPLE_S32:    return 4;
+        case WAV_SAMPLE_F32:    return 4;
+        case WAV_SAMPLE_ULAW:   return 1;
+        case WAV_SAMPLE_ALAW:   return 1;
+    }
+    return 0;
+}
+
+bool wav_sample_format_from_header(const wav_header_t* header, wav_sample_format_t* format) {
+    //? `encoding` already resolves extensible files to their sub-format
+    if (header->encoding == WAV_FORMAT_PCM) {
+        switch (header->bits_per_sample) {
+            case 8:     *format = WAV_SAMPLE_U8;  return true;
+            case 16:    *format = WAV_SAMPLE_S16; return true;
+            case 24:    *format = WAV_SAMPLE_S24; return true;
+            case 32:    *format = WAV_SAMPLE_S32; return true;
+        }
+    } else if (header->encoding == WAV_FORMAT_IEEE_FLOAT && header->bits_per_sample == 32) {
+        *format = WAV_SAMPLE_F32;
+        return true;
+    } else if (header->encoding == WAV_FORMAT_MULAW && header->bits_per_sample == 8) {
+        *format = WAV_SAMPLE_ULAW;
+        return true;
+    } else if (header->encoding == WAV_FORMAT_ALAW && header->bits_per_sample == 8) {
+        *format = WAV_SAMPLE_ALAW;
+        return true;
+    }
+    return false;
+}
+
+void wav_convert_to_float(float* dst, const void* src, size_t samples, wav_sample_format_t format) {
+    if (samples == 0) return;
+    to_float_kernels[wav_convert_get_isa()][format](dst, (const uint8_t*)src, samples);
+}
+
+void wav_convert_from_float(void* dst, const float* src, size_t samples, wav_sample_format_t format) {
+    if (samples == 0) return;
+    from_float_kernels[wav_convert_get_isa()][format]((uint8_t*)dst, src, samples);
+}
+
+void wav_unpack_s24(int32_t* dst, const void* src, size_t samples) {
+    if (samples == 0) return;
+    s24_unpack_kernels[wav_convert_get_isa()](dst, (const uint8_t*)src, samples);
+}
@@ -0,0 +1,99 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_parser.h"
+
+/**
+ * Sample encodings found in WAV data chunks. Integer formats are little-endian,
+ * S24 is packed (3 bytes per sample, no padding). The G.711 formats are one byte
+ * per sample that expands to 14 (μ-law) or 13 (A-law) bits of 16-bit PCM.
+ */
+typedef enum wav_sample_format_t {
+    WAV_SAMPLE_U8,              //? unsigned, 128 is silence
+    WAV_SAMPLE_S16,
+    WAV_SAMPLE_S24,
+    WAV_SAMPLE_S32,
+    WAV_SAMPLE_F32,             //? IEEE float, nominal range [-1, 1]
+    WAV_SAMPLE_ULAW,            //? G.711 μ-law
+    WAV_SAMPLE_ALAW,            //? G.711 A-law
+} wav_sample_format_t;
+
+/**
+ * Instruction sets the kernels are compiled for. The best one the CPU supports is
+ * picked at runtime; wav_convert_set_isa() can pin a lower one (benchmarks, debugging).
+ */
+typedef enum wav_isa_t {
+    WAV_ISA_SCALAR,
+    WAV_ISA_SSE2,
+    WAV_ISA_AVX2,
+} wav_isa_t;
+
+/**
+ * @returns the number of bytes one sample of `format` takes in a data chunk.
+ */
+size_t wav_sample_format_size(wav_sample_format_t format);
+
+/**
+ * @brief Works out the sample encoding of a parsed header.
+ *
+ * @returns `false` if the header's format/bit depth combination has no kernel.
+ */
+bool wav_sample_format_from_header(const wav_header_t* header, wav_sample_format_t* format);
+
+/**
+ * @brief Converts `samples` samples of `format` to normalized float32.
+ *
+ * Integers are divided by 2^(bits-1), so full scale maps to [-1, 1); μ-law and
+ * A-law land on exactly the levels of their 16-bit PCM expansion.
+ * `samples` counts individual samples, not frames (frames * num_channels).
+ */
+void wav_convert_to_float(float* dst, const void* src, size_t samples, wav_sample_format_t format);
+
+/**
+ * @brief Converts normalized float32 back to `format`.
+ *
+ * Values are scaled by 2^(bits-1), rounded to nearest and saturated to the
+ * format's range, so out-of-range input clips instead of wrapping around. μ-law
+ * and A-law are quantized to 16 bits first, then companded.
+ */
+void wav_convert_from_float(void* dst, const float* src, size_t samples, wav_sample_format_t format);
+
+/**
+ * @brief Unpacks packed 24-bit PCM into 32-bit containers.
+ *
+ * Each sample ends up in the top 24 bits (low byte zero), so the output is valid
+ * WAV_SAMPLE_S32 data at the same level and integer pipelines can treat 24-bit
+ * files as 32-bit ones without going through float.
+ */
+void wav_unpack_s24(int32_t* dst, const void* src, size_t samples);
+
+/**
+ * @returns the instruction set the kernels currently run with.
+ */
+wav_isa_t wav_convert_get_isa(void);
+
+/**
+ * @brief Pins the kernels to `isa`.
+ *
+ * @returns `false` (and changes nothing) if the CPU doesn't support `isa`.
+ */
+bool wav_convert_set_isa(wav_isa_t isa);
+
+/**
+ * @returns a printable name for `isa` ("scalar", "sse2", "avx2").
+ */
+const char* wav_isa_name(wav_isa_t isa);
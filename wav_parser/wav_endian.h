@@ -0,0 +1,47 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+//* Internal: little-endian field access for headers that are in memory, independent of the host's byte order
+
+#pragma once
+#include <stdint.h>
+
+static inline uint16_t decode_u16(const uint8_t* bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint32_t decode_u32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static inline uint64_t decode_u64(const uint8_t* bytes) {
+    return (uint64_t)decode_u32(bytes) | ((uint64_t)decode_u32(bytes + 4) << 32);
+}
+
+static inline void encode_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void encode_u32(uint8_t* p, uint32_t v) {
+    encode_u16(p, (uint16_t)(v & 0xFFFF));
+    encode_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline void encode_u64(uint8_t* p, uint64_t v) {
+    encode_u32(p, (uint32_t)(v & 0xFFFFFFFFu));
+    encode_u32(p + 4, (uint32_t)(v >> 32));
+}
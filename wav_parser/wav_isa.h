@@ -0,0 +1,31 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+//* Internal: what every SIMD kernel file needs to dispatch on wav_convert_get_isa()
+
+#pragma once
+#include "wav_convert.h"
+
+//? The SIMD paths rely on GCC/Clang function target attributes so the rest of a file
+//? still builds for the baseline ISA; anything else just gets the scalar kernels
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define WAV_ISA_X86 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define WAV_ISA_COUNT 3     //? entries of a kernel table indexed by wav_isa_t
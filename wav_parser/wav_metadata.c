@@ -0,0 +1,143 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_metadata.h"
+#include "wav_endian.h"
+#include "log.h"
+#include <errno.h>
+
+//=================================================DIRECTORY==========================================================
+
+const wav_chunk_t* wav_find_chunk(const wav_chunk_dir_t* chunks, const char* id) {
+    for (uint32_t i = 0; i < chunks->count; ++i) {
+        if (memcmp(chunks->chunks[i].id, id, 4) == 0) return &chunks->chunks[i];
+    }
+    return NULL;
+}
+
+const wav_chunk_t* wav_find_list(const wav_chunk_dir_t* chunks, const char* form) {
+    for (uint32_t i = 0; i < chunks->count; ++i) {
+        if (memcmp(chunks->chunks[i].id, "LIST", 4) == 0 && memcmp(chunks->chunks[i].form, form, 4) == 0) return &chunks->chunks[i];
+    }
+    return NULL;
+}
+
+const uint8_t* wav_chunk_bytes(const wav_file_t* wav_file, const wav_chunk_t* chunk) {
+    if (!wav_file->data || (wav_file->owner != WAV_DATA_MAPPED && wav_file->owner != WAV_DATA_BORROWED)) return NULL;
+    const wav_chunk_t* data = wav_find_chunk(&wav_file->chunks, "data");
+    if (!data) return NULL;
+    //* The samples sit at the data chunk's offset in the image, which gives the image's start
+    //* (chunk sizes were clamped to the image when it was parsed)
+    const uint8_t* image = wav_file->data - data->offset;
+    return image + chunk->offset;
+}
+
+bool wav_stream_read_chunk(const wav_stream_t* stream, const wav_chunk_t* chunk, void* out) {
+    if (!stream || !stream->file.is_open || !chunk || !out) return false;
+    if (chunk->size > (size_t)-1) {
+        Log(LOG_ERROR, "The %s chunk (%llu bytes) doesn't fit in memory.\n", chunk->id, (unsigned long long)chunk->size);
+        return false;
+    }
+    int64_t got = io_pread(&stream->file, out, (size_t)chunk->size, chunk->offset);
+    if (got != (int64_t)chunk->size) {
+        Log(LOG_ERROR, "Failed to read the %s chunk: %s\n", chunk->id, got < 0 ? strerror(errno) : "unexpected end of file");
+        return false;
+    }
+    return true;
+}
+
+uint8_t* wav_load_chunk(const char* path, const wav_chunk_t* chunk) {
+    if (!chunk || chunk->size > (size_t)-1) return NULL;
+    io_file_t file;
+    if (!io_open_file(path, &file)) {
+        Log(LOG_ERROR, "Failed to open file : %s\n", path);
+        Log(LOG_ERROR, "Reason : %s.\n", strerror(errno));
+        return NULL;
+    }
+    //? One extra byte so an empty chunk still gets a buffer to return
+    uint8_t* bytes = (uint8_t*)malloc((size_t)chunk->size + 1);
+    if (!bytes) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for %s's %s chunk.\n", (unsigned long long)chunk->size, path, chunk->id);
+    } else if (io_pread(&file, bytes, (size_t)chunk->size, chunk->offset) != (int64_t)chunk->size) {
+        Log(LOG_ERROR, "Failed to read %s's %s chunk.\n", path, chunk->id);
+        free(bytes);
+        bytes = NULL;
+    }
+    io_close_file(&file);
+    return bytes;
+}
+
+//=================================================DECODERS==========================================================
+
+size_t wav_decode_cue(const uint8_t* bytes, uint64_t size, wav_cue_point_t* points, size_t max) {
+    if (size < 4) return 0;
+    uint32_t count = decode_u32(bytes);
+    //? id, position, fccChunk, chunkStart, blockStart, sampleOffset
+    if ((uint64_t)count * 24 > size - 4) count = (uint32_t)((size - 4) / 24);
+    for (uint32_t i = 0; i < count && i < max; ++i) {
+        const uint8_t* entry = bytes + 4 + 24 * (size_t)i;
+        points[i].id = decode_u32(entry);
+        //* sampleOffset is the frame in the data chunk; `position` only means something with a playlist
+        points[i].frame = decode_u32(entry + 20);
+    }
+    return count;
+}
+
+bool wav_decode_smpl(const uint8_t* bytes, uint64_t size, wav_smpl_t* smpl) {
+    memset(smpl, 0, sizeof(*smpl));
+    if (size < 36) return false;
+    smpl->manufacturer = decode_u32(bytes);
+    smpl->product = decode_u32(bytes + 4);
+    smpl->sample_period = decode_u32(bytes + 8);
+    smpl->midi_unity_note = decode_u32(bytes + 12);
+    smpl->midi_pitch_fraction = decode_u32(bytes + 16);
+    //? SMPTE format/offset (20, 24) don't matter for playback
+    smpl->loop_count = decode_u32(bytes + 28);
+    if ((uint64_t)smpl->loop_count * 24 > size - 36) return false;
+    for (uint32_t i = 0; i < smpl->loop_count && i < WAV_MAX_LOOPS; ++i) {
+        const uint8_t* entry = bytes + 36 + 24 * (size_t)i;
+        wav_smpl_loop_t* loop = &smpl->loops[i];
+        loop->cue_id = decode_u32(entry);
+        loop->type = decode_u32(entry + 4);
+        loop->start = decode_u32(entry + 8);
+        loop->end = decode_u32(entry + 12);
+        loop->fraction = decode_u32(entry + 16);
+        loop->play_count = decode_u32(entry + 20);
+    }
+    return true;
+}
+
+size_t wav_decode_info(const uint8_t* bytes, uint64_t size, wav_info_tag_t* tags, size_t max) {
+    if (size < 4 || memcmp(bytes, "INFO", 4) != 0) return 0;
+    size_t count = 0;
+    uint64_t pos = 4;
+    while (pos + 8 <= size) {
+        uint32_t length = decode_u32(bytes + pos + 4);
+        if (length > size - pos - 8) length = (uint32_t)(size - pos - 8);
+        if (count < max) {
+            wav_info_tag_t* tag = &tags[count];
+            memcpy(tag->id, bytes + pos, 4);
+            tag->id[4] = '\0';
+            tag->value = (const char*)bytes + pos + 8;
+            //? Values are zero-terminated, often padded with more zeros
+            tag->length = length;
+            while (tag->length > 0 && tag->value[tag->length - 1] == '\0') --tag->length;
+        }
+        ++count;
+        pos += 8 + (uint64_t)length + (length & 1);
+    }
+    return count;
+}
@@ -0,0 +1,123 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+#pragma once
+#include "wav_parser.h"
+
+#define WAV_MAX_LOOPS 8     //? loops a decoded smpl chunk keeps, see wav_smpl_t
+
+/**
+ * One entry of a `cue ` chunk: a marker at a frame of the data chunk.
+ */
+typedef struct wav_cue_point_t {
+    uint32_t id;                //? what `labl`/`ltxt` entries of a LIST/adtl chunk and smpl loops refer to
+    uint64_t frame;
+} wav_cue_point_t;
+
+typedef enum wav_loop_type_t {
+    WAV_LOOP_FORWARD = 0,
+    WAV_LOOP_ALTERNATING = 1,   //? ping-pong
+    WAV_LOOP_BACKWARD = 2,
+} wav_loop_type_t;
+
+typedef struct wav_smpl_loop_t {
+    uint32_t cue_id;
+    uint32_t type;              //? wav_loop_type_t, or a manufacturer specific value (32 and up)
+    uint64_t start;             //? first frame of the loop
+    uint64_t end;               //! last frame played before jumping back, inclusive
+    uint32_t fraction;          //? fine tuning of `end`, in 1/2^32 of a frame
+    uint32_t play_count;        //? 0 loops forever
+} wav_smpl_loop_t;
+
+/**
+ * Decoded `smpl` chunk: how a sampler should play the file.
+ */
+typedef struct wav_smpl_t {
+    uint32_t manufacturer;
+    uint32_t product;
+    uint32_t sample_period;     //? nanoseconds per frame
+    uint32_t midi_unity_note;   //? the note the file plays at its own pitch (60 = middle C)
+    uint32_t midi_pitch_fraction;
+    uint32_t loop_count;        //? loops the chunk declares; only the first WAV_MAX_LOOPS are in `loops`
+    wav_smpl_loop_t loops[WAV_MAX_LOOPS];
+} wav_smpl_t;
+
+/**
+ * One LIST/INFO tag (INAM title, IART artist, ICMT comment, ISFT software...).
+ * `value` points into the chunk bytes it was decoded from and is not copied; it
+ * isn't necessarily NUL terminated, use `length`.
+ */
+typedef struct wav_info_tag_t {
+    char id[5];
+    const char* value;
+    uint32_t length;            //? trailing NULs not included
+} wav_info_tag_t;
+
+/**
+ * @returns the first chunk called `id` ("cue ", "smpl"...), or NULL if the file has none.
+ */
+const wav_chunk_t* wav_find_chunk(const wav_chunk_dir_t* chunks, const char* id);
+
+/**
+ * @returns the first LIST chunk of type `form` ("INFO", "adtl"), or NULL.
+ */
+const wav_chunk_t* wav_find_list(const wav_chunk_dir_t* chunks, const char* form);
+
+/**
+ * @brief Points at a chunk's body without copying it.
+ *
+ * Only files whose whole image is in memory can do that: wav_parse_file_mapped()
+ * (the chunk's pages are read on first touch) and wav_parse_memory() without copy.
+ *
+ * @returns the chunk's `chunk->size` bytes, or NULL for a heap-loaded file.
+ */
+const uint8_t* wav_chunk_bytes(const wav_file_t* wav_file, const wav_chunk_t* chunk);
+
+/**
+ * @brief Reads a chunk's body with one positional read, the stream's position is left alone.
+ *
+ * @param out Caller-owned, at least `chunk->size` bytes.
+ * @returns `false` (with the reason logged) if the chunk can't be read whole.
+ */
+bool wav_stream_read_chunk(const wav_stream_t* stream, const wav_chunk_t* chunk, void* out);
+
+/**
+ * @brief Reads one chunk of the file at `path` (e.g. from a wav_probe() directory) into a new buffer.
+ *
+ * @returns the `chunk->size` bytes, to free(), or NULL (with the reason logged).
+ */
+uint8_t* wav_load_chunk(const char* path, const wav_chunk_t* chunk);
+
+/**
+ * @brief Decodes the body of a `cue ` chunk.
+ *
+ * @returns how many cue points the chunk holds; at most `max` of them are stored in `points`.
+ */
+size_t wav_decode_cue(const uint8_t* bytes, uint64_t size, wav_cue_point_t* points, size_t max);
+
+/**
+ * @brief Decodes the body of a `smpl` chunk.
+ * @returns `false` if the chunk is too short for what it declares.
+ */
+bool wav_decode_smpl(const uint8_t* bytes, uint64_t size, wav_smpl_t* smpl);
+
+/**
+ * @brief Decodes the body of a LIST/INFO chunk (starting with "INFO").
+ *
+ * @returns how many tags the list holds; at most `max` of them are stored in `tags`.
+ */
+size_t wav_decode_info(const uint8_t* bytes, uint64_t size, wav_info_tag_t* tags, size_t max);
@@ -15,6 +15,7 @@
  */
 
 #include "wav_parser.h"
+#include "wav_endian.h"
 #include "log.h"
 #include "path_utils.h"
 #include <errno.h>
@@ -23,7 +24,7 @@ void wav_print_header(const wav_header_t* header) {
     printf(COLOR_CYAN "----- WAV Header Info -----\n" COLOR_RESET);
     
     printf(COLOR_GREEN "ChunkID: " COLOR_RESET "%.4s\n", header->RIFF);
-    printf(COLOR_GREEN "File Size (minus 8 bytes): " COLOR_RESET "%d bytes\n", header->file_size);
+    printf(COLOR_GREEN "File Size (minus 8 bytes): " COLOR_RESET "%llu bytes\n", (unsigned long long)header->file_size);
     printf(COLOR_GREEN "Format: " COLOR_RESET "%.4s\n", header->WAVE);
     
     printf("\n" COLOR_YELLOW "Format Subchunk:" COLOR_RESET "\n");
@@ -31,8 +32,18 @@ void wav_print_header(const wav_header_t* header) {
     printf("  " COLOR_BLUE "Subchunk1 Size: " COLOR_RESET "%d bytes\n", header->chunk_size);
     
     printf("  " COLOR_BLUE "Audio Format: " COLOR_RESET "%d ", header->format_type);
-    if (header->format_type == 1)
+    if (header->format_type == WAV_FORMAT_EXTENSIBLE)
+        printf(COLOR_GREEN "(Extensible, %s)\n" COLOR_RESET, header->encoding == WAV_FORMAT_IEEE_FLOAT ? "IEEE float" : "PCM");
+    else if (header->format_type == WAV_FORMAT_IEEE_FLOAT)
+        printf(COLOR_GREEN "(IEEE float)\n" COLOR_RESET);
+    else if (header->format_type == WAV_FORMAT_PCM)
         printf(COLOR_GREEN "(PCM)\n" COLOR_RESET);
+    else if (header->format_type == WAV_FORMAT_ALAW)
+        printf(COLOR_GREEN "(A-law)\n" COLOR_RESET);
+    else if (header->format_type == WAV_FORMAT_MULAW)
+        printf(COLOR_GREEN "(mu-law)\n" COLOR_RESET);
+    else if (header->format_type == WAV_FORMAT_IMA_ADPCM)
+        printf(COLOR_GREEN "(IMA ADPCM, %d frames per block)\n" COLOR_RESET, header->samples_per_block);
     else
         printf(COLOR_RED "(Compressed/Other)\n" COLOR_RESET);
     
@@ -48,10 +59,14 @@ void wav_print_header(const wav_header_t* header) {
     printf("  " COLOR_BLUE "Byte Rate: " COLOR_RESET "%d bytes/sec\n", header->byte_rate);
     printf("  " COLOR_BLUE "Block Align: " COLOR_RESET "%d bytes/frame\n", header->block_align);
     printf("  " COLOR_BLUE "Bits per Sample: " COLOR_RESET "%d bits\n", header->bits_per_sample);
+    if (header->format_type == WAV_FORMAT_EXTENSIBLE) {
+        printf("  " COLOR_BLUE "Valid Bits per Sample: " COLOR_RESET "%d bits\n", header->valid_bits_per_sample);
+        printf("  " COLOR_BLUE "Channel Mask: " COLOR_RESET "0x%08X\n", header->channel_mask);
+    }
 
     printf("\n" COLOR_YELLOW "Data Subchunk:" COLOR_RESET "\n");
     printf("  " COLOR_BLUE "Data Header: " COLOR_RESET "%.4s\n", header->data);
-    printf("  " COLOR_BLUE "Data Size: " COLOR_RESET "%d bytes\n", header->data_size);
+    printf("  " COLOR_BLUE "Data Size: " COLOR_RESET "%llu bytes\n", (unsigned long long)header->data_size);
 
     if (header->byte_rate > 0) {
         double duration_sec = (double)header->data_size / header->byte_rate;
@@ -61,31 +76,371 @@ void wav_print_header(const wav_header_t* header) {
     printf(COLOR_CYAN "---------------------------\n" COLOR_RESET);
 }
 
+//? Enough for RIFF + fmt + a few small metadata chunks, which covers almost every file in one read
+#define WAV_PROBE_BLOCK 4096
+
 static bool wav_validate_filename(const char* path) {
     const char* EXTENSION = ".wav";
-    
-    char* filename = get_filename(path);
-    
-    const char* dot = (filename) ? strrchr(filename, '.') : NULL;
-    if(!dot || dot == path) {
-        return false;
+
+    //* Works on the path in place: probing millions of files shouldn't cost an allocation each
+    const char* filename = path;
+    for (const char* c = path; *c != '\0'; ++c) {
+        if (*c == '/' || *c == '\\') filename = c + 1;
     }
-    
-    const char *left = dot - 1;
-    if (left >= path && (*left == '\\' || *left == '/')) {
+
+    const char* dot = strrchr(filename, '.');
+    if(!dot || dot == filename) {
         return false;
     }
-    int res = strcasecmp(dot, EXTENSION) == 0;
-    free(filename);
-    return res;
+    return strcasecmp(dot, EXTENSION) == 0;
 }
 
-static void read_text(char* buff, FILE* file) {
-    fread(buff, 4, 1, file);
+static void decode_text(char* buff, const uint8_t* bytes) {
+    memcpy(buff, bytes, 4);
     buff[4] = '\0';
 }
 
-bool wav_parse_file(const char *path, wav_file_t* wav_file)
+/**
+ * The part of a WAV file image the chunk walk can currently see. For in-memory images
+ * the window is the whole image; for files it is one block that gets reloaded (one
+ * positional read) whenever the walk steps past it.
+ */
+typedef struct wav_window_t {
+    const uint8_t* bytes;
+    size_t size;                // valid bytes in `bytes`
+    uint64_t offset;            // file offset of bytes[0]
+    const io_file_t* file;      //? NULL when the whole image is in memory
+    uint8_t* block;             //? WAV_PROBE_BLOCK bytes to reload into, only used with `file`
+} wav_window_t;
+
+/**
+ * @returns a pointer to `length` bytes at file offset `offset`, or NULL past the end of the image.
+ */
+static const uint8_t* wav_window_at(wav_window_t* window, uint64_t offset, size_t length) {
+    //! Offsets come from 64-bit sizes in the file, so nothing here may add them up
+    if (offset >= window->offset && offset - window->offset <= window->size && length <= window->size - (offset - window->offset)) {
+        return window->bytes + (offset - window->offset);
+    }
+    if (window->file == NULL) {
+        return NULL;
+    }
+    int64_t got = io_pread(window->file, window->block, WAV_PROBE_BLOCK, offset);
+    if (got < (int64_t)length) {
+        return NULL;
+    }
+    window->bytes = window->block;
+    window->size = (size_t)got;
+    window->offset = offset;
+    return window->bytes;
+}
+
+//? Every extensible sub-format GUID ends with these 14 bytes, the first 2 are the actual format tag
+static const uint8_t WAV_GUID_SUFFIX[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+/**
+ * Decodes the body of a fmt chunk (`size` bytes at `fmt`) and checks that the sample
+ * layout is one the rest of the library can handle.
+ */
+static bool wav_decode_fmt(const uint8_t* fmt, uint32_t size, const char* path, wav_header_t* header) {
+    header->format_type = decode_u16(fmt);
+    header->num_channels = decode_u16(fmt + 2);
+    header->sample_rate = decode_u32(fmt + 4);
+    header->byte_rate = decode_u32(fmt + 8);
+    header->block_align = decode_u16(fmt + 12);
+    header->bits_per_sample = decode_u16(fmt + 14);
+    header->cb_size = (size >= 18) ? decode_u16(fmt + 16) : 0;
+    header->valid_bits_per_sample = header->bits_per_sample;
+    header->channel_mask = 0;
+    header->encoding = header->format_type;
+    header->samples_per_block = 1;
+    //* Plain files get the GUID they would have as extensible ones, so consumers only deal with one form
+    header->sub_format[0] = (uint8_t)(header->format_type & 0xFF);
+    header->sub_format[1] = (uint8_t)(header->format_type >> 8);
+    memcpy(header->sub_format + 2, WAV_GUID_SUFFIX, sizeof(WAV_GUID_SUFFIX));
+
+    if(header->format_type == WAV_FORMAT_EXTENSIBLE) {
+        if(size < 40 || header->cb_size < 22) {
+            Log(LOG_ERROR, "%s's extensible fmt chunk is truncated (%u bytes, cbSize %u).\n", path, size, header->cb_size);
+            return false;
+        }
+        header->valid_bits_per_sample = decode_u16(fmt + 18);
+        header->channel_mask = decode_u32(fmt + 20);
+        memcpy(header->sub_format, fmt + 24, 16);
+        if(memcmp(header->sub_format + 2, WAV_GUID_SUFFIX, sizeof(WAV_GUID_SUFFIX)) != 0) {
+            Log(LOG_ERROR, "%s's extensible sub-format GUID is not a standard WAVE format.\n", path);
+            return false;
+        }
+        header->encoding = decode_u16(header->sub_format);
+    }
+
+    bool supported = false;
+    if(header->encoding == WAV_FORMAT_PCM) {
+        supported = header->bits_per_sample == 8 || header->bits_per_sample == 16 ||
+                    header->bits_per_sample == 24 || header->bits_per_sample == 32;
+    } else if(header->encoding == WAV_FORMAT_IEEE_FLOAT) {
+        supported = header->bits_per_sample == 32;
+    } else if(header->encoding == WAV_FORMAT_ALAW || header->encoding == WAV_FORMAT_MULAW) {
+        supported = header->bits_per_sample == 8;
+    } else if(header->encoding == WAV_FORMAT_IMA_ADPCM && header->format_type != WAV_FORMAT_EXTENSIBLE) {
+        supported = header->bits_per_sample == 4;
+    } else {
+        Log(LOG_ERROR, "%s's format type should be 1(PCM), 3(IEEE float), 6(A-law), 7(mu-law), 0x11(IMA ADPCM) or 0xFFFE(extensible), but is : %d\n", path, header->encoding);
+        return false;
+    }
+    if(!supported) {
+        Log(LOG_ERROR, "%s's bits per sample (%d) is not supported for format %d.\n", path, header->bits_per_sample, header->encoding);
+        return false;
+    }
+    if(header->encoding == WAV_FORMAT_IMA_ADPCM) {
+        //* Each block is a 4-byte header per channel (the first frame), then 4-byte groups of 8 nibbles per channel in turn
+        const uint32_t header_bytes = 4u * header->num_channels;
+        if(size < 20 || header->cb_size < 2) {
+            Log(LOG_ERROR, "%s's IMA ADPCM fmt chunk has no samples-per-block field.\n", path);
+            return false;
+        }
+        header->samples_per_block = decode_u16(fmt + 18);
+        if(header->num_channels == 0 || header->block_align <= header_bytes || (header->block_align - header_bytes) % header_bytes != 0 ||
+           header->samples_per_block != (header->block_align - header_bytes) * 2 / header->num_channels + 1) {
+            Log(LOG_ERROR, "%s's IMA ADPCM blocks of %d bytes can't hold %d frames of %d channels.\n", path, header->block_align, header->samples_per_block, header->num_channels);
+            return false;
+        }
+        return true;
+    }
+    if(header->num_channels == 0 || header->block_align != header->num_channels * (header->bits_per_sample / 8)) {
+        Log(LOG_ERROR, "%s's block align (%d) doesn't match %d channels of %d bits.\n", path, header->block_align, header->num_channels, header->bits_per_sample);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @returns the number of frames in `bytes` bytes of `header`'s data. A trailing partial
+ *          ADPCM block still holds its header frame and every whole group after it.
+ */
+static uint64_t wav_data_frames(const wav_header_t* header, uint64_t bytes) {
+    if(header->encoding != WAV_FORMAT_IMA_ADPCM) {
+        return bytes / header->block_align;
+    }
+    const uint32_t header_bytes = 4u * header->num_channels;
+    const uint64_t tail = bytes % header->block_align;
+    uint64_t frames = bytes / header->block_align * header->samples_per_block;
+    if(tail >= header_bytes) {
+        frames += (tail - header_bytes) / header_bytes * 8 + 1;
+    }
+    return frames;
+}
+
+/**
+ * Sizes an RF64/BW64 file keeps in its ds64 chunk because they don't fit the 32-bit
+ * chunk headers (those are then set to 0xFFFFFFFF).
+ */
+typedef struct wav_ds64_t {
+    bool present;
+    uint64_t riff_size;
+    uint64_t data_size;
+    uint64_t table_offset;      //? file offset of the per-chunk size table
+    uint32_t table_length;
+} wav_ds64_t;
+
+#define WAV_SIZE_IN_DS64 0xFFFFFFFFu
+
+/**
+ * @returns the real size of the chunk `id` whose header says `size`, looking it up in
+ *          the ds64 chunk when the header only holds the 0xFFFFFFFF placeholder.
+ */
+static uint64_t wav_chunk_size(wav_window_t* window, const wav_ds64_t* ds64, const char id[4], uint32_t size) {
+    if (size != WAV_SIZE_IN_DS64 || !ds64->present) {
+        return size;
+    }
+    if (memcmp(id, "data", 4) == 0) {
+        return ds64->data_size;
+    }
+    for (uint32_t i = 0; i < ds64->table_length; ++i) {
+        const uint8_t* entry = wav_window_at(window, ds64->table_offset + 12 * (uint64_t)i, 12);
+        if (entry == NULL) break;
+        if (memcmp(entry, id, 4) == 0) {
+            return decode_u64(entry + 4);
+        }
+    }
+    return size;
+}
+
+/**
+ * Moves `*pos` from the chunk header there to the next one: 8 header bytes, `size` bytes
+ * of body and a pad byte after an odd size (chunks are word aligned).
+ *
+ * @returns `false`, leaving `*pos` alone, if the chunk runs past `end` (the end of the RIFF
+ *          body, or of the image when it's in memory). ds64 sizes are 64-bit values taken
+ *          from the file, and a wrapped offset would send the walk back over earlier chunks forever.
+ */
+static bool wav_next_chunk(uint64_t* pos, uint64_t size, uint64_t end, const char id[4], const char* path) {
+    if (size > UINT64_MAX - 9 - *pos || *pos + 8 + size > end) {
+        Log(LOG_ERROR, "%s's %.4s chunk claims %llu bytes, more than the file holds.\n", path, id, (unsigned long long)size);
+        return false;
+    }
+    *pos += 8 + size + (size & 1);
+    return true;
+}
+
+/**
+ * Adds the chunk whose 8-byte header is at `pos` to the directory. In-memory images
+ * are clamped to the bytes actually there, so a chunk's body can always be pointed at.
+ */
+static void wav_record_chunk(wav_window_t* window, wav_chunk_dir_t* chunks, const char id[4], uint64_t pos, uint64_t size) {
+    if (chunks->count == WAV_MAX_CHUNKS) {
+        chunks->truncated = true;
+        return;
+    }
+    wav_chunk_t* chunk = &chunks->chunks[chunks->count++];
+    memset(chunk, 0, sizeof(*chunk));
+    decode_text(chunk->id, (const uint8_t*)id);
+    chunk->offset = pos + 8;
+    chunk->size = size;
+    if (window->file == NULL) {
+        const uint64_t left = (chunk->offset < window->size) ? window->size - chunk->offset : 0;
+        if (chunk->size > left) chunk->size = left;
+    }
+    if (memcmp(id, "LIST", 4) == 0 && chunk->size >= 4) {
+        //? The list type sits right after the header, almost always in the block already read
+        const uint8_t* form = wav_window_at(window, chunk->offset, 4);
+        if (form) decode_text(chunk->form, form);
+    }
+}
+
+/**
+ * Records the chunks that follow `data` (LIST, cue, smpl... usually live there). The
+ * RIFF size bounds the walk (`end`) so a file ending with its data chunk costs no extra read.
+ *
+ * @returns `false` if a chunk's size can't be stepped over (see wav_next_chunk()).
+ */
+static bool wav_record_trailing_chunks(wav_window_t* window, const char* path, const wav_ds64_t* ds64, uint64_t end, uint64_t pos, wav_chunk_dir_t* chunks) {
+    const uint8_t* chunk;
+    while (pos < end && end - pos >= 8 && (chunk = wav_window_at(window, pos, 8)) != NULL) {
+        char id[4];
+        memcpy(id, chunk, 4);
+        uint64_t size = wav_chunk_size(window, ds64, id, decode_u32(chunk + 4));
+        wav_record_chunk(window, chunks, id, pos, size);
+        if (chunks->truncated) return true;
+        if (!wav_next_chunk(&pos, size, end, id, path)) return false;
+    }
+    return true;
+}
+
+/**
+ * Validates the RIFF/RF64 header and walks the chunks up to `data`, decoding `ds64` and
+ * `fmt ` on the way. On success `*data_offset` is the file offset of the first sample and
+ * `chunks` lists every chunk of the file: the walk goes on past `data` to record the rest.
+ */
+static bool wav_decode_header(wav_window_t* window, const char* path, wav_header_t* header, uint64_t* data_offset, wav_chunk_dir_t* chunks) {
+    const uint8_t* bytes = wav_window_at(window, 0, 12);
+    if(bytes == NULL) {
+        Log(LOG_ERROR, "%s is too small to be a WAV file.\n", path);
+        return false;
+    }
+
+    decode_text(header->RIFF, bytes);
+    //? RF64 (EBU Tech 3306) and BW64 (ITU-R BS.2088) are the 64-bit variants, same layout plus a ds64 chunk
+    bool is_rf64 = strcmp(header->RIFF, "RF64") == 0 || strcmp(header->RIFF, "BW64") == 0;
+    if(strcmp(header->RIFF, "RIFF") != 0 && !is_rf64) {
+        Log(LOG_ERROR, "%s's first 4 bytes should be \"RIFF\" (or \"RF64\"/\"BW64\") but are : %s\n", path, header->RIFF);
+        return false;
+    }
+    header->file_size = decode_u32(bytes + 4);
+
+    decode_text(header->WAVE, bytes + 8);
+    if(strcmp(header->WAVE, "WAVE") != 0) {
+        Log(LOG_ERROR, "%s's 4 bytes should be \"WAVE\" but are : %s\n", path, header->WAVE);
+        return false;
+    }
+
+    memset(chunks, 0, sizeof(*chunks));
+    wav_ds64_t ds64;
+    memset(&ds64, 0, sizeof(ds64));
+    if(is_rf64) {
+        //! ds64 has to be the first chunk, nothing else can be sized before it
+        const uint8_t* chunk = wav_window_at(window, 12, 8 + 28);
+        if(chunk == NULL || memcmp(chunk, "ds64", 4) != 0 || decode_u32(chunk + 4) < 28) {
+            Log(LOG_ERROR, "%s is an %s file but doesn't start with a valid ds64 chunk.\n", path, header->RIFF);
+            return false;
+        }
+        ds64.present = true;
+        ds64.riff_size = decode_u64(chunk + 8);
+        ds64.data_size = decode_u64(chunk + 16);
+        ds64.table_length = decode_u32(chunk + 32);
+        //? The table can't hold more entries than the chunk has room for
+        const uint32_t table_room = (decode_u32(chunk + 4) - 28) / 12;
+        if(ds64.table_length > table_room) ds64.table_length = table_room;
+        ds64.table_offset = 12 + 8 + 28;
+        header->file_size = ds64.riff_size;
+    }
+
+    //* No chunk may run past the RIFF body, nor past the bytes there are when the image is in memory
+    uint64_t end = (header->file_size > UINT64_MAX - 8) ? UINT64_MAX : header->file_size + 8;
+    if (window->file == NULL && end > window->size) end = window->size;
+
+    //? fmt usually comes first, but recorders like to put a JUNK/bext chunk before it
+    bool has_fmt = false;
+    uint64_t pos = 12;
+    const uint8_t* chunk;
+    while ((chunk = wav_window_at(window, pos, 8)) != NULL) {
+        char id[4];
+        memcpy(id, chunk, 4);   //* looking sizes up in ds64 may move the window under `chunk`
+        uint64_t chunkSize = wav_chunk_size(window, &ds64, id, decode_u32(chunk + 4));
+        wav_record_chunk(window, chunks, id, pos, chunkSize);
+        if (memcmp(id, "fmt ", 4) == 0) {
+            decode_text(header->fmt, (const uint8_t*)id);
+            header->chunk_size = (uint32_t)chunkSize;
+            if (chunkSize < 16) {
+                Log(LOG_ERROR, "%s's fmt chunk is too small (%u bytes).\n", path, header->chunk_size);
+                return false;
+            }
+            //* Only the first 40 bytes mean anything to us, anything past them is skipped below
+            uint32_t fmt_size = (chunkSize < 40) ? (uint32_t)chunkSize : 40;
+            const uint8_t* fmt = wav_window_at(window, pos + 8, fmt_size);
+            if (fmt == NULL) {
+                Log(LOG_ERROR, "Unexpected end of file while reading %s's fmt chunk.\n", path);
+                return false;
+            }
+            if (!wav_decode_fmt(fmt, fmt_size, path, header)) {
+                return false;
+            }
+            has_fmt = true;
+        } else if (memcmp(id, "data", 4) == 0) {
+            if (!has_fmt) {
+                Log(LOG_ERROR, "%s has no fmt chunk before its data chunk.\n", path);
+                return false;
+            }
+            decode_text(header->data, (const uint8_t*)id);
+            header->data_size = chunkSize;
+            //* Files are checked when the samples are read, images in memory can be checked right away
+            if (window->file == NULL && chunkSize > window->size - (pos + 8)) {
+                Log(LOG_ERROR, "%s's data chunk claims %llu bytes but only %zu are left in the file.\n", path, (unsigned long long)chunkSize, (size_t)(window->size - (pos + 8)));
+                return false;
+            }
+            *data_offset = pos + 8;
+            if (!wav_next_chunk(&pos, chunkSize, end, id, path)) {
+                return false;
+            }
+            return wav_record_trailing_chunks(window, path, &ds64, end, pos, chunks);
+        }
+        if (!wav_next_chunk(&pos, chunkSize, end, id, path)) {
+            return false;
+        }
+    }
+
+    Log(LOG_ERROR, "%s has no data chunk.\n", path);
+    return false;
+}
+
+/**
+ * Validates `path`, opens it and decodes everything up to the first sample with a single
+ * read of WAV_PROBE_BLOCK bytes; further reads only happen when metadata chunks (LIST,
+ * smpl...) push `data` past that block, plus one per chunk stored after `data` to record
+ * it in the chunk directory. On success the file is left open for the caller.
+ */
+static bool wav_probe_open(const char *path, io_file_t* file, wav_probe_t* info)
 {
     if(!wav_validate_filename(path)) {
         char* filename = get_filename(path);
@@ -94,98 +449,238 @@ bool wav_parse_file(const char *path, wav_file_t* wav_file)
         return false;
     }
 
-    FILE* fp;
-    bool retval = true;
-    fp = fopen(path, "rb");
-    if(fp == NULL) {
+    if(!io_open_file(path, file)) {
         Log(LOG_ERROR, "Failed to open file : %s\n" , path);
         Log(LOG_ERROR, "Reason : %s.\n" , strerror(errno));
-        retval = false;
-        goto CLOSE_FILE;
+        return false;
     }
 
-    read_text(wav_file->header.RIFF, fp);
-    if(strcmp((wav_file->header.RIFF), "RIFF") != 0) {
-        Log(LOG_ERROR, "%s's first 4 bytes should be \"RIFF\" but are : %s\n", path, wav_file->header.RIFF);
-        retval = false;
-        goto CLOSE_FILE;
+    uint8_t block[WAV_PROBE_BLOCK];
+    wav_window_t window = { block, 0, 0, file, block };
+    int64_t got = io_pread(file, block, sizeof(block), 0);
+    if(got < 0) {
+        Log(LOG_ERROR, "Failed to read file : %s\n" , path);
+        Log(LOG_ERROR, "Reason : %s.\n" , strerror(errno));
+        io_close_file(file);
+        return false;
     }
+    window.size = (size_t)got;
 
-    fread(&wav_file->header.file_size, 4/* bytes */, 1, fp);
-
-    read_text(wav_file->header.WAVE, fp);
-    if(strcmp((wav_file->header.WAVE), "WAVE") != 0 ) {
-        Log(LOG_ERROR, "%s's 4 bytes should be \"WAVE\" but are : %s\n", path, wav_file->header.WAVE);
-        retval = false;
-        goto CLOSE_FILE;
+    if(!wav_decode_header(&window, path, &info->header, &info->data_offset, &info->chunks)) {
+        io_close_file(file);
+        return false;
     }
+    info->data_length = info->header.data_size;
+    info->samples = wav_data_frames(&info->header, info->data_length);
+    return true;
+}
 
-    read_text(wav_file->header.fmt, fp);
-    if(strcmp((wav_file->header.fmt), "fmt ") != 0 ) {
-        Log(LOG_ERROR, "%s's 4 bytes should be \"fmt/0\" but are : %s\n", path, wav_file->header.fmt);
-        retval = false;
-        goto CLOSE_FILE;
+bool wav_probe(const char *path, wav_probe_t* info)
+{
+    io_file_t file;
+    if(!wav_probe_open(path, &file, info)) {
+        return false;
     }
-    fread(&wav_file->header.chunk_size, 4/* bytes */, 1, fp);
-    fread(&wav_file->header.format_type, 2/* bytes */, 1, fp);
-    if(wav_file->header.format_type != 1) {
-        Log(LOG_ERROR, "%s's format type should be 1(PCM), but is : %d\n" COLOR_RESET, path, wav_file->header.format_type);
-        retval = false;
-        goto CLOSE_FILE;
+    io_close_file(&file);
+    return true;
+}
+
+bool wav_parse_file(const char *path, wav_file_t* wav_file)
+{
+    io_file_t file;
+    wav_probe_t info;
+    if(!wav_probe_open(path, &file, &info)) {
+        return false;
     }
 
-    fread(&wav_file->header.num_channels, 2/* bytes */, 1, fp);
-    fread(&wav_file->header.sample_rate, 4/* bytes */, 1, fp);
-    fread(&wav_file->header.byte_rate, 4/* bytes */, 1, fp);
-    fread(&wav_file->header.block_align, 2/* bytes */, 1, fp);
-    fread(&wav_file->header.bits_per_sample, 2/* bytes */, 1, fp);
-    if(wav_file->header.bits_per_sample != 16) {
-        Log(LOG_ERROR, "%s's bits per sample should be 16, but is : %d\n", path, wav_file->header.sample_rate);
+    bool retval = true;
+    wav_file->header = info.header;
+    wav_file->chunks = info.chunks;
+    if(info.data_length > (size_t)-1) {
+        //? Only reachable on 32-bit builds, the caller should stream or map the file instead
+        Log(LOG_ERROR, "%s's data chunk (%llu bytes) doesn't fit in this process' address space, use wav_stream_open() instead.\n", path, (unsigned long long)info.data_length);
         retval = false;
         goto CLOSE_FILE;
     }
+    wav_file->data_length = info.data_length;
 
-    while (fread(wav_file->header.data, 1, 4, fp) == 4) {
-        uint32_t chunkSize = 0;
-        
-        if (fread(&chunkSize, 1, 4, fp) != 4) {
-            Log(LOG_WARNING, "[WARNING] - Unexpected end of file while reading chunk size.\n");
-            break;
-        }
-
-        if (strncmp(wav_file->header.data, "data", 4) == 0) {
-            wav_file->header.data_size = chunkSize;
-            break; 
-        } else {
-            // Skip over this chunk's data
-            fseek(fp, chunkSize, SEEK_CUR);
-        }
-    }
-    wav_file->data_length = wav_file->header.data_size;
-
-    wav_file->data = (uint8_t*)malloc(wav_file->data_length);
+    wav_file->data = (uint8_t*)malloc((size_t)wav_file->data_length);
+    wav_file->owner = WAV_DATA_HEAP;
     if(wav_file->data == NULL) {
-        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %d bytes for data.\n", wav_file->data_length);
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for data.\n", (unsigned long long)wav_file->data_length);
         Log(LOG_ERROR, "Reason: %s\n", strerror(errno));
         retval = false;
         goto CLOSE_FILE;
     }
 
-    if(fread(wav_file->data, 1, wav_file->data_length, fp) != wav_file->data_length) {
+    if(io_pread(&file, wav_file->data, (size_t)wav_file->data_length, info.data_offset) != (int64_t)wav_file->data_length) {
         Log(LOG_ERROR, "Failed to read data's bytes.\n");
         retval = false;
         goto CLOSE_FILE;
     }
     
-    wav_file->samples = wav_file->data_length / wav_file->header.block_align;
+    wav_file->samples = info.samples;
     char* filename = get_filename(path); 
-    Log(LOG_INFO, "%s parsed successfully!!!!\n\n", filename);
+    Log(LOG_DEBUG, "%s parsed successfully!!!!\n\n", filename);
     free(filename);
 CLOSE_FILE:
-    fclose(fp);
+    io_close_file(&file);
     return retval;
 }
 
+/**
+ * Attaches the data chunk of an in-memory file image to `wav_file`, either by copying
+ * it to the heap or by pointing into `bytes` (the caller then decides the owner).
+ */
+static bool wav_parse_bytes(const uint8_t* bytes, size_t size, const char* name, wav_file_t* wav_file, bool copy)
+{
+    wav_window_t window = { bytes, size, 0, NULL, NULL };
+    uint64_t data_offset = 0;
+    if(!wav_decode_header(&window, name, &wav_file->header, &data_offset, &wav_file->chunks)) {
+        return false;
+    }
+
+    wav_file->data_length = wav_file->header.data_size;
+    if(copy) {
+        //* The decoder already checked the data chunk lies inside `bytes`, so it fits in a size_t
+        wav_file->data = (uint8_t*)malloc((size_t)wav_file->data_length);
+        if(wav_file->data == NULL) {
+            Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for data.\n", (unsigned long long)wav_file->data_length);
+            Log(LOG_ERROR, "Reason: %s\n", strerror(errno));
+            wav_file->data_length = 0;
+            return false;
+        }
+        memcpy(wav_file->data, bytes + data_offset, (size_t)wav_file->data_length);
+        wav_file->owner = WAV_DATA_HEAP;
+    } else {
+        wav_file->data = (uint8_t*)bytes + data_offset;
+        wav_file->owner = WAV_DATA_BORROWED;
+    }
+    wav_file->samples = wav_data_frames(&wav_file->header, wav_file->data_length);
+    return true;
+}
+
+bool wav_parse_file_mapped(const char *path, wav_file_t* wav_file)
+{
+    if(!wav_validate_filename(path)) {
+        char* filename = get_filename(path);
+        Log(LOG_ERROR, "Invalid file type." COLOR_BLUE "'%s'" COLOR_RED " is not a valid WAV file. Please provide a .wav file.\n", filename);
+        free(filename);
+        return false;
+    }
+
+    io_map_t map;
+    if(!io_map_file(path, &map)) {
+        Log(LOG_ERROR, "Failed to map file : %s\n" , path);
+        Log(LOG_ERROR, "Reason : %s.\n" , strerror(errno));
+        return false;
+    }
+
+    if(!wav_parse_bytes(map.base, map.size, path, wav_file, false)) {
+        io_unmap_file(&map);
+        return false;
+    }
+    wav_file->mapping = map;
+    wav_file->owner = WAV_DATA_MAPPED;
+
+    char* filename = get_filename(path);
+    Log(LOG_DEBUG, "%s mapped successfully!!!!\n\n", filename);
+    free(filename);
+    return true;
+}
+
+bool wav_parse_memory(const void* bytes, size_t size, wav_file_t* wav_file, bool copy)
+{
+    if(bytes == NULL) {
+        Log(LOG_ERROR, "Cannot parse a NULL WAV buffer.\n");
+        return false;
+    }
+    if(!wav_parse_bytes((const uint8_t*)bytes, size, "WAV buffer", wav_file, copy)) {
+        return false;
+    }
+    Log(LOG_DEBUG, "WAV buffer (%zu bytes) parsed successfully!!!!\n\n", size);
+    return true;
+}
+
+bool wav_stream_open(const char *path, wav_stream_t* stream)
+{
+    memset(stream, 0, sizeof(*stream));
+    wav_probe_t info;
+    if(!wav_probe_open(path, &stream->file, &info)) {
+        return false;
+    }
+    if(info.header.encoding == WAV_FORMAT_IMA_ADPCM) {
+        //? A frame isn't a fixed run of bytes in the file, reads would land mid-block
+        Log(LOG_ERROR, "%s is IMA ADPCM, which can't be streamed: load it and decode it with wav_codec.h.\n", path);
+        io_close_file(&stream->file);
+        memset(stream, 0, sizeof(*stream));
+        return false;
+    }
+    stream->header = info.header;
+    stream->chunks = info.chunks;
+    stream->data_offset = info.data_offset;
+    stream->frames_total = info.samples;
+    stream->frames_left = stream->frames_total;
+    return true;
+}
+
+size_t wav_read_frames_at(const wav_stream_t* stream, uint64_t frame_index, size_t count, void* out)
+{
+    if(!stream || !stream->file.is_open || !out || frame_index >= stream->frames_total) return 0;
+    if(count > stream->frames_total - frame_index) {
+        count = (size_t)(stream->frames_total - frame_index);
+    }
+    if(count == 0) return 0;
+
+    const size_t block_align = stream->header.block_align;
+    int64_t got = io_pread(&stream->file, out, count * block_align, stream->data_offset + frame_index * block_align);
+    if(got < 0) {
+        Log(LOG_ERROR, "Failed to read data's bytes: %s\n", strerror(errno));
+        return 0;
+    }
+    return (size_t)got / block_align;
+}
+
+size_t wav_stream_read_frames(wav_stream_t* stream, void* buffer, size_t max_frames)
+{
+    if(!stream || !stream->file.is_open || !buffer) return 0;
+    if(max_frames > stream->frames_left) {
+        max_frames = (size_t)stream->frames_left;
+    }
+    if(max_frames == 0) return 0;
+
+    size_t frames = wav_read_frames_at(stream, stream->frames_total - stream->frames_left, max_frames, buffer);
+    if(frames < max_frames) {
+        Log(LOG_WARNING, "Unexpected end of file: %llu frames of the data chunk are missing.\n", (unsigned long long)(stream->frames_left - frames));
+        stream->frames_left = 0;
+        return frames;
+    }
+    stream->frames_left -= frames;
+    return frames;
+}
+
+bool wav_stream_rewind(wav_stream_t* stream)
+{
+    if(!stream || !stream->file.is_open) return false;
+    //* Reads are positional, nothing to seek
+    stream->frames_left = stream->frames_total;
+    return true;
+}
+
+bool wav_stream_seek(wav_stream_t* stream, uint64_t frame_index)
+{
+    if(!stream || !stream->file.is_open) return false;
+    stream->frames_left = (frame_index < stream->frames_total) ? stream->frames_total - frame_index : 0;
+    return true;
+}
+
+void wav_stream_close(wav_stream_t* stream)
+{
+    if(!stream) return;
+    io_close_file(&stream->file);
+    memset(stream, 0, sizeof(*stream));
+}
+
 void wav_init_file(wav_file_t* wav_file) {
     if(wav_file) {
         memset(wav_file, 0, sizeof(*wav_file));
@@ -198,9 +693,18 @@ void wav_free_file(wav_file_t *wav_file)
     if (!wav_file) return;
 
     if (wav_file->data != NULL) {
-        free(wav_file->data);
+        if (wav_file->owner == WAV_DATA_MAPPED) {
+            io_unmap_file(&wav_file->mapping);
+            Log(LOG_DEBUG, "Data section successfully unmapped!\n\n");
+        } else if (wav_file->owner == WAV_DATA_BORROWED) {
+            //? The bytes belong to whoever called wav_parse_memory(), just forget them
+            Log(LOG_DEBUG, "Borrowed data section released!\n\n");
+        } else {
+            free(wav_file->data);
+            Log(LOG_DEBUG, "Data section successfully freed!\n\n");
+        }
         wav_file->data = NULL; 
-        Log(LOG_INFO, "Data section successfully freed!\n\n");
+        wav_file->owner = WAV_DATA_NONE;
     } else {
         Log(LOG_WARNING, "No free needed - Data block was not allocated.\n\n");
         return;
@@ -208,5 +712,6 @@ void wav_free_file(wav_file_t *wav_file)
     wav_file->data_length = 0;
     wav_file->samples = 0;
     memset(&wav_file->header, 0, sizeof(wav_header_t));
+    memset(&wav_file->chunks, 0, sizeof(wav_chunk_dir_t));
 }
 
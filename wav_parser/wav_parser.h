@@ -20,34 +20,207 @@
 #include <stdint.h> 
 #include <stdbool.h> 
 #include <string.h> 
+#include "file_io.h"
+
+#define WAV_FORMAT_PCM          0x0001
+#define WAV_FORMAT_IEEE_FLOAT   0x0003
+#define WAV_FORMAT_ALAW         0x0006  //? G.711 A-law, 8 bits per sample
+#define WAV_FORMAT_MULAW        0x0007  //? G.711 μ-law, 8 bits per sample
+#define WAV_FORMAT_IMA_ADPCM    0x0011  //? 4 bits per sample in independent blocks, see wav_codec.h
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE  //? real format is in the sub-format GUID
+#define WAV_MAX_CHUNKS          16      //? chunks a directory records, see wav_chunk_dir_t
 
 typedef struct wav_header_t {
-    char RIFF[5];
-    uint32_t file_size;
+    char RIFF[5];               //? "RIFF", or "RF64"/"BW64" for files over 4 GB
+    uint64_t file_size;         //? from the ds64 chunk for RF64/BW64 files
     char WAVE[5];
     char fmt[5];                //! includes trailing null (usually "fmt ")
     uint32_t chunk_size;         // size of format chunk (usually 16 for PCM)
-    uint16_t format_type;        // 1 = PCM
+    uint16_t format_type;        // 1 = PCM, 3 = IEEE float, 6/7 = A-law/μ-law, 0x11 = IMA ADPCM, 0xFFFE = extensible
     uint16_t num_channels;
     uint32_t sample_rate;
     uint32_t byte_rate;          //? sample_rate * num_channels * bits_per_sample / 8
-    uint16_t block_align;        //? num_channels * bits_per_sample / 8
+    uint16_t block_align;        //? num_channels * bits_per_sample / 8, or the size of one compressed block for IMA ADPCM
     uint16_t bits_per_sample;
+    uint16_t cb_size;            //? size of the fmt extension, 0 when the chunk is plain 16 bytes
+    uint16_t valid_bits_per_sample; //? extensible only (e.g. 24 in a 32-bit container), else == bits_per_sample
+    uint32_t channel_mask;       //? extensible only, speaker position bits (SPEAKER_FRONT_LEFT...)
+    uint8_t sub_format[16];      //? GUID whose first 2 bytes are the real format tag (derived from format_type for non-extensible files)
+    uint16_t encoding;           //! format tag of the samples: format_type, or the sub-format's tag for extensible files
+    uint16_t samples_per_block;  //? frames in one block_align-byte block: 1, or the fmt extension's count for IMA ADPCM
     char data[5];               // "data"
-    uint32_t data_size;        //? size of the data section in bytes
+    uint64_t data_size;        //? size of the data section in bytes (64-bit for RF64/BW64)
 } wav_header_t;
 
+/**
+ * Where one top-level chunk of the file is. Nothing of the chunk is loaded.
+ */
+typedef struct wav_chunk_t {
+    char id[5];                 //? "fmt ", "data", "LIST", "cue ", "smpl"...
+    char form[5];               //? list type for LIST chunks ("INFO", "adtl"...), empty otherwise
+    uint64_t offset;            // file offset of the chunk's body, past its 8-byte header
+    uint64_t size;              //? body size, from ds64 when the header can't hold it
+} wav_chunk_t;
+
+/**
+ * Every top-level chunk of a file, in file order, recorded by the same walk that
+ * finds `fmt ` and `data` (chunks after `data` included). See wav_metadata.h for
+ * lookups and decoders.
+ */
+typedef struct wav_chunk_dir_t {
+    wav_chunk_t chunks[WAV_MAX_CHUNKS];
+    uint32_t count;
+    bool truncated;             //? the file has more than WAV_MAX_CHUNKS chunks, the rest weren't recorded
+} wav_chunk_dir_t;
+
+typedef enum wav_data_owner_t {
+    WAV_DATA_NONE,              // no data attached (freshly initialized file)
+    WAV_DATA_HEAP,              //? `data` was malloc'd by the parser, wav_free_file() frees it
+    WAV_DATA_MAPPED,            //? `data` points into `mapping`, wav_free_file() unmaps it
+    WAV_DATA_BORROWED,          //? `data` points into a caller's buffer, wav_free_file() leaves it alone
+} wav_data_owner_t;
+
 typedef struct wav_file_t
 {
     wav_header_t header;
     uint8_t* data;
-    uint32_t data_length;
-    uint32_t samples;
+    uint64_t data_length;
+    uint64_t samples;
+    wav_data_owner_t owner;     //! decides how wav_free_file() releases `data`
+    io_map_t mapping;           // only valid when owner == WAV_DATA_MAPPED
+    wav_chunk_dir_t chunks;
 }wav_file_t;
 
+/**
+ * What wav_probe() finds out about a file without loading any samples.
+ */
+typedef struct wav_probe_t
+{
+    wav_header_t header;
+    uint64_t data_offset;       // file offset of the first sample
+    uint64_t data_length;       //? same as header.data_size
+    uint64_t samples;           //? frames, data_length / block_align for uncompressed data
+    wav_chunk_dir_t chunks;
+}wav_probe_t;
+
+/**
+ * Incremental reader over a WAV file's data chunk.
+ *
+ * Only the header is decoded up front; samples are then pulled in whole frames
+ * into a buffer owned by the caller, so memory use does not depend on the file
+ * size and processing can start as soon as the header has been read. This is the
+ * way to process RF64/BW64 recordings larger than the address space.
+ *
+ * Frames are read as raw bytes, so block-coded data (IMA ADPCM) can't be streamed:
+ * load it and decode it with wav_codec.h instead.
+ */
+typedef struct wav_stream_t
+{
+    wav_header_t header;
+    io_file_t file;
+    uint64_t data_offset;       // file offset of the first sample
+    uint64_t frames_total;      //? data_size / block_align
+    uint64_t frames_left;
+    wav_chunk_dir_t chunks;
+}wav_stream_t;
+
 void wav_init_file(wav_file_t* wav_file);
 void wav_free_file(wav_file_t* wav_file);
 bool wav_parse_file(const char* filename, wav_file_t* wav_file);
+
+/**
+ * @brief Decodes a WAV file's header and locates its data chunk without loading it.
+ *
+ * The first few KB of the file are fetched with a single positional read and every
+ * field is decoded from that block; more reads only happen when large metadata
+ * chunks (LIST, smpl...) push `data` past it, and for `info->chunks`: every chunk
+ * stored after `data` (where LIST, cue and smpl usually are) costs one more small
+ * read of its header. A file that ends with its data chunk still takes one read.
+ * Nothing is allocated, which makes this the cheap way to catalogue many files.
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_probe(const char* filename, wav_probe_t* info);
+
+/**
+ * @brief Parses a WAV file without copying its samples.
+ *
+ * The whole file is memory-mapped and `wav_file->data` points straight at the
+ * data chunk inside the mapping, so loading costs the same whatever the file
+ * size and every process mapping the same file shares one physical copy of it.
+ * Pages are only read from disk when the samples are first touched.
+ *
+ * The mapping is copy-on-write: writing to `data` never modifies the file.
+ * Release it with wav_free_file() as usual.
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_parse_file_mapped(const char* filename, wav_file_t* wav_file);
+
+/**
+ * @brief Parses a WAV file image that is already in memory (IPC blob, archive entry...).
+ *
+ * Runs the same validation and chunk walk as wav_parse_file() over `bytes`.
+ *
+ * @param copy `true` to copy the samples to the heap, `false` to borrow them:
+ *             `wav_file->data` then points inside `bytes`, which must outlive
+ *             `wav_file` (wav_free_file() will not free it).
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_parse_memory(const void* bytes, size_t size, wav_file_t* wav_file, bool copy);
+
+/**
+ * @brief Opens a WAV file for streaming and decodes its header.
+ *
+ * Runs the same validation and chunk walk as wav_parse_file() but stops at the
+ * first sample instead of loading the data chunk. IMA ADPCM files are refused.
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_stream_open(const char* filename, wav_stream_t* stream);
+
+/**
+ * @brief Reads up to `max_frames` whole frames into `buffer`.
+ *
+ * @param buffer Caller-owned, at least `max_frames * header.block_align` bytes.
+ *
+ * @returns the number of frames read, 0 once the data chunk is exhausted.
+ */
+size_t wav_stream_read_frames(wav_stream_t* stream, void* buffer, size_t max_frames);
+
+/**
+ * @brief Moves the stream back to the first frame of the data chunk.
+ */
+bool wav_stream_rewind(wav_stream_t* stream);
+
+/**
+ * @brief Moves the stream to `frame_index`, so the next wav_stream_read_frames() starts there.
+ *
+ * Nothing is read: the position is only used to compute the offset of the next read.
+ * Seeking past the end leaves the stream exhausted.
+ */
+bool wav_stream_seek(wav_stream_t* stream, uint64_t frame_index);
+
+/**
+ * @brief Reads `count` frames starting at `frame_index` straight from the data chunk.
+ *
+ * One positional read at the frame's file offset, whatever the file size: nothing
+ * before or after the range is touched and the stream's own position is left alone,
+ * so several threads may read different ranges of the same stream at once.
+ *
+ * @param out Caller-owned, at least `count * header.block_align` bytes.
+ *
+ * @returns the number of frames read, fewer than `count` if the range runs past
+ *          the end of the data (or of a truncated file), 0 on error.
+ */
+size_t wav_read_frames_at(const wav_stream_t* stream, uint64_t frame_index, size_t count, void* out);
+
+/**
+ * @brief Closes the underlying file. Safe to call on a stream that failed to open.
+ */
+void wav_stream_close(wav_stream_t* stream);
+
 void wav_print_header(const wav_header_t* header);
 
 
@@ -0,0 +1,543 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_planar.h"
+#include "wav_isa.h"
+#include "log.h"
+
+#define WAV_PLANAR_BLOCK    1024    //? frames converted per pass when building/flattening a view
+#define WAV_PLANAR_ALIGN    16      //? planes start on a multiple of this many samples
+
+typedef void (*deinterleave_f32_fn)(float* const* planes, const float* src, size_t frames, unsigned channels);
+typedef void (*interleave_f32_fn)(float* dst, const float* const* planes, size_t frames, unsigned channels);
+typedef void (*deinterleave_s16_fn)(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels);
+typedef void (*interleave_s16_fn)(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels);
+
+//=================================================SCALAR KERNELS==========================================================
+//* The SIMD kernels call these with an offset `first` for the frames their vectors don't cover
+
+static void deinterleave_f32_scalar_from(float* const* planes, const float* src, size_t first, size_t frames, unsigned channels) {
+    for (unsigned c = 0; c < channels; ++c) {
+        float* plane = planes[c];
+        for (size_t i = first; i < frames; ++i) {
+            plane[i] = src[i * channels + c];
+        }
+    }
+}
+
+static void interleave_f32_scalar_from(float* dst, const float* const* planes, size_t first, size_t frames, unsigned channels) {
+    for (unsigned c = 0; c < channels; ++c) {
+        const float* plane = planes[c];
+        for (size_t i = first; i < frames; ++i) {
+            dst[i * channels + c] = plane[i];
+        }
+    }
+}
+
+static void deinterleave_s16_scalar_from(int16_t* const* planes, const int16_t* src, size_t first, size_t frames, unsigned channels) {
+    for (unsigned c = 0; c < channels; ++c) {
+        int16_t* plane = planes[c];
+        for (size_t i = first; i < frames; ++i) {
+            plane[i] = src[i * channels + c];
+        }
+    }
+}
+
+static void interleave_s16_scalar_from(int16_t* dst, const int16_t* const* planes, size_t first, size_t frames, unsigned channels) {
+    for (unsigned c = 0; c < channels; ++c) {
+        const int16_t* plane = planes[c];
+        for (size_t i = first; i < frames; ++i) {
+            dst[i * channels + c] = plane[i];
+        }
+    }
+}
+
+static void deinterleave_f32_scalar(float* const* planes, const float* src, size_t frames, unsigned channels) {
+    if (channels == 1) {
+        memcpy(planes[0], src, frames * sizeof(float));
+        return;
+    }
+    deinterleave_f32_scalar_from(planes, src, 0, frames, channels);
+}
+
+static void interleave_f32_scalar(float* dst, const float* const* planes, size_t frames, unsigned channels) {
+    if (channels == 1) {
+        memcpy(dst, planes[0], frames * sizeof(float));
+        return;
+    }
+    interleave_f32_scalar_from(dst, planes, 0, frames, channels);
+}
+
+static void deinterleave_s16_scalar(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels) {
+    if (channels == 1) {
+        memcpy(planes[0], src, frames * sizeof(int16_t));
+        return;
+    }
+    deinterleave_s16_scalar_from(planes, src, 0, frames, channels);
+}
+
+static void interleave_s16_scalar(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels) {
+    if (channels == 1) {
+        memcpy(dst, planes[0], frames * sizeof(int16_t));
+        return;
+    }
+    interleave_s16_scalar_from(dst, planes, 0, frames, channels);
+}
+
+#ifdef WAV_ISA_X86
+//=================================================SSE2 KERNELS==========================================================
+//* Wide layouts are handled as 4x4 transposes over groups of 4 channels. When the channel count
+//* isn't a multiple of 4 the last group is moved back to end on the last channel: it overlaps the
+//* previous one, which just writes the same samples twice, and nothing reads or writes past a frame.
+
+TARGET_SSE2 static void deinterleave_f32_sse2(float* const* planes, const float* src, size_t frames, unsigned channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        float* left = planes[0];
+        float* right = planes[1];
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(src + 2 * i);       //? L0 R0 L1 R1
+            __m128 b = _mm_loadu_ps(src + 2 * i + 4);   //? L2 R2 L3 R3
+            _mm_storeu_ps(left + i,  _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    } else if (channels >= 4) {
+        for (; i + 4 <= frames; i += 4) {
+            const float* frame = src + i * channels;
+            for (unsigned c = 0; c < channels; c += 4) {
+                unsigned g = (c + 4 <= channels) ? c : channels - 4;
+                __m128 r0 = _mm_loadu_ps(frame + g);
+                __m128 r1 = _mm_loadu_ps(frame + channels + g);
+                __m128 r2 = _mm_loadu_ps(frame + 2 * channels + g);
+                __m128 r3 = _mm_loadu_ps(frame + 3 * channels + g);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(planes[g] + i, r0);
+                _mm_storeu_ps(planes[g + 1] + i, r1);
+                _mm_storeu_ps(planes[g + 2] + i, r2);
+                _mm_storeu_ps(planes[g + 3] + i, r3);
+            }
+        }
+    } else {
+        deinterleave_f32_scalar(planes, src, frames, channels);
+        return;
+    }
+    deinterleave_f32_scalar_from(planes, src, i, frames, channels);
+}
+
+TARGET_SSE2 static void interleave_f32_sse2(float* dst, const float* const* planes, size_t frames, unsigned channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        const float* left = planes[0];
+        const float* right = planes[1];
+        for (; i + 4 <= frames; i += 4) {
+            __m128 l = _mm_loadu_ps(left + i);
+            __m128 r = _mm_loadu_ps(right + i);
+            _mm_storeu_ps(dst + 2 * i,     _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+        }
+    } else if (channels >= 4) {
+        for (; i + 4 <= frames; i += 4) {
+            float* frame = dst + i * channels;
+            for (unsigned c = 0; c < channels; c += 4) {
+                unsigned g = (c + 4 <= channels) ? c : channels - 4;
+                __m128 r0 = _mm_loadu_ps(planes[g] + i);
+                __m128 r1 = _mm_loadu_ps(planes[g + 1] + i);
+                __m128 r2 = _mm_loadu_ps(planes[g + 2] + i);
+                __m128 r3 = _mm_loadu_ps(planes[g + 3] + i);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(frame + g, r0);
+                _mm_storeu_ps(frame + channels + g, r1);
+                _mm_storeu_ps(frame + 2 * channels + g, r2);
+                _mm_storeu_ps(frame + 3 * channels + g, r3);
+            }
+        }
+    } else {
+        interleave_f32_scalar(dst, planes, frames, channels);
+        return;
+    }
+    interleave_f32_scalar_from(dst, planes, i, frames, channels);
+}
+
+TARGET_SSE2 static void deinterleave_s16_sse2(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        int16_t* left = planes[0];
+        int16_t* right = planes[1];
+        for (; i + 8 <= frames; i += 8) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + 2 * i + 8));
+            //? Left is the low half of every 32-bit pair, right the high half; sign-extend both and repack
+            __m128i l = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+            __m128i r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+            _mm_storeu_si128((__m128i*)(left + i), l);
+            _mm_storeu_si128((__m128i*)(right + i), r);
+        }
+    } else if (channels >= 4) {
+        for (; i + 4 <= frames; i += 4) {
+            const int16_t* frame = src + i * channels;
+            for (unsigned c = 0; c < channels; c += 4) {
+                unsigned g = (c + 4 <= channels) ? c : channels - 4;
+                __m128i r0 = _mm_loadl_epi64((const __m128i*)(frame + g));
+                __m128i r1 = _mm_loadl_epi64((const __m128i*)(frame + channels + g));
+                __m128i r2 = _mm_loadl_epi64((const __m128i*)(frame + 2 * channels + g));
+                __m128i r3 = _mm_loadl_epi64((const __m128i*)(frame + 3 * channels + g));
+                __m128i t0 = _mm_unpacklo_epi16(r0, r1);
+                __m128i t1 = _mm_unpacklo_epi16(r2, r3);
+                __m128i c01 = _mm_unpacklo_epi32(t0, t1);   //? channel g in the low 64 bits, g+1 in the high
+                __m128i c23 = _mm_unpackhi_epi32(t0, t1);
+                _mm_storel_epi64((__m128i*)(planes[g] + i), c01);
+                _mm_storel_epi64((__m128i*)(planes[g + 1] + i), _mm_unpackhi_epi64(c01, c01));
+                _mm_storel_epi64((__m128i*)(planes[g + 2] + i), c23);
+                _mm_storel_epi64((__m128i*)(planes[g + 3] + i), _mm_unpackhi_epi64(c23, c23));
+            }
+        }
+    } else {
+        deinterleave_s16_scalar(planes, src, frames, channels);
+        return;
+    }
+    deinterleave_s16_scalar_from(planes, src, i, frames, channels);
+}
+
+TARGET_SSE2 static void interleave_s16_sse2(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        const int16_t* left = planes[0];
+        const int16_t* right = planes[1];
+        for (; i + 8 <= frames; i += 8) {
+            __m128i l = _mm_loadu_si128((const __m128i*)(left + i));
+            __m128i r = _mm_loadu_si128((const __m128i*)(right + i));
+            _mm_storeu_si128((__m128i*)(dst + 2 * i),     _mm_unpacklo_epi16(l, r));
+            _mm_storeu_si128((__m128i*)(dst + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+        }
+    } else if (channels >= 4) {
+        for (; i + 4 <= frames; i += 4) {
+            int16_t* frame = dst + i * channels;
+            for (unsigned c = 0; c < channels; c += 4) {
+                unsigned g = (c + 4 <= channels) ? c : channels - 4;
+                __m128i t0 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(planes[g] + i)),
+                                                _mm_loadl_epi64((const __m128i*)(planes[g + 1] + i)));
+                __m128i t1 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(planes[g + 2] + i)),
+                                                _mm_loadl_epi64((const __m128i*)(planes[g + 3] + i)));
+                __m128i f01 = _mm_unpacklo_epi32(t0, t1);   //? frame i in the low 64 bits, i+1 in the high
+                __m128i f23 = _mm_unpackhi_epi32(t0, t1);
+                _mm_storel_epi64((__m128i*)(frame + g), f01);
+                _mm_storel_epi64((__m128i*)(frame + channels + g), _mm_unpackhi_epi64(f01, f01));
+                _mm_storel_epi64((__m128i*)(frame + 2 * channels + g), f23);
+                _mm_storel_epi64((__m128i*)(frame + 3 * channels + g), _mm_unpackhi_epi64(f23, f23));
+            }
+        }
+    } else {
+        interleave_s16_scalar(dst, planes, frames, channels);
+        return;
+    }
+    interleave_s16_scalar_from(dst, planes, i, frames, channels);
+}
+
+//=================================================AVX2 KERNELS==========================================================
+//* Float interleave runs 8 frames per step (two 4x4 transposes side by side). Float deinterleave has no
+//* AVX2 version: it writes one stream per channel and is store-bound, the 256-bit variants measured
+//* slower than SSE2 for stereo and wide layouts alike, so the AVX2 table entry reuses the SSE2 kernel.
+
+//? 4x4 transpose inside each 128-bit lane, no lane crossing
+TARGET_AVX2 static void transpose4x2_ps(__m256* r0, __m256* r1, __m256* r2, __m256* r3) {
+    __m256 t0 = _mm256_unpacklo_ps(*r0, *r1);
+    __m256 t1 = _mm256_unpackhi_ps(*r0, *r1);
+    __m256 t2 = _mm256_unpacklo_ps(*r2, *r3);
+    __m256 t3 = _mm256_unpackhi_ps(*r2, *r3);
+    *r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    *r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    *r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    *r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+TARGET_AVX2 static void interleave_f32_avx2(float* dst, const float* const* planes, size_t frames, unsigned channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        const float* left = planes[0];
+        const float* right = planes[1];
+        for (; i + 8 <= frames; i += 8) {
+            //? Pre-swap the middle pairs so the per-lane unpacks come out in frame order
+            __m256 l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(left + i)), 0xD8));
+            __m256 r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(right + i)), 0xD8));
+            _mm256_storeu_ps(dst + 2 * i,     _mm256_unpacklo_ps(l, r));
+            _mm256_storeu_ps(dst + 2 * i + 8, _mm256_unpackhi_ps(l, r));
+        }
+    } else if (channels >= 4) {
+        for (; i + 8 <= frames; i += 8) {
+            float* frame = dst + i * channels;
+            float* later = frame + 4 * channels;
+            for (unsigned c = 0; c < channels; c += 4) {
+                unsigned g = (c + 4 <= channels) ? c : channels - 4;
+                __m256 r0 = _mm256_loadu_ps(planes[g] + i);
+                __m256 r1 = _mm256_loadu_ps(planes[g + 1] + i);
+                __m256 r2 = _mm256_loadu_ps(planes[g + 2] + i);
+                __m256 r3 = _mm256_loadu_ps(planes[g + 3] + i);
+                transpose4x2_ps(&r0, &r1, &r2, &r3);
+                //? Low lanes hold frames 0-3, high lanes frames 4-7
+                _mm_storeu_ps(frame + g, _mm256_castps256_ps128(r0));
+                _mm_storeu_ps(frame + channels + g, _mm256_castps256_ps128(r1));
+                _mm_storeu_ps(frame + 2 * channels + g, _mm256_castps256_ps128(r2));
+                _mm_storeu_ps(frame + 3 * channels + g, _mm256_castps256_ps128(r3));
+                _mm_storeu_ps(later + g, _mm256_extractf128_ps(r0, 1));
+                _mm_storeu_ps(later + channels + g, _mm256_extractf128_ps(r1, 1));
+                _mm_storeu_ps(later + 2 * channels + g, _mm256_extractf128_ps(r2, 1));
+                _mm_storeu_ps(later + 3 * channels + g, _mm256_extractf128_ps(r3, 1));
+            }
+        }
+    } else {
+        interleave_f32_sse2(dst, planes, frames, channels);
+        return;
+    }
+    _mm256_zeroupper();
+    interleave_f32_scalar_from(dst, planes, i, frames, channels);
+}
+
+TARGET_AVX2 static void deinterleave_s16_avx2(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels) {
+    if (channels != 2) {
+        deinterleave_s16_sse2(planes, src, frames, channels);
+        return;
+    }
+    int16_t* left = planes[0];
+    int16_t* right = planes[1];
+    size_t i = 0;
+    for (; i + 16 <= frames; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + 2 * i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + 2 * i + 16));
+        __m256i l = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16), _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16));
+        __m256i r = _mm256_packs_epi32(_mm256_srai_epi32(a, 16), _mm256_srai_epi32(b, 16));
+        _mm256_storeu_si256((__m256i*)(left + i),  _mm256_permute4x64_epi64(l, 0xD8));
+        _mm256_storeu_si256((__m256i*)(right + i), _mm256_permute4x64_epi64(r, 0xD8));
+    }
+    _mm256_zeroupper();
+    deinterleave_s16_scalar_from(planes, src, i, frames, channels);
+}
+
+TARGET_AVX2 static void interleave_s16_avx2(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels) {
+    if (channels != 2) {
+        interleave_s16_sse2(dst, planes, frames, channels);
+        return;
+    }
+    const int16_t* left = planes[0];
+    const int16_t* right = planes[1];
+    size_t i = 0;
+    for (; i + 16 <= frames; i += 16) {
+        __m256i l = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)(left + i)), 0xD8);
+        __m256i r = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)(right + i)), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i),      _mm256_unpacklo_epi16(l, r));
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i + 16), _mm256_unpackhi_epi16(l, r));
+    }
+    _mm256_zeroupper();
+    interleave_s16_scalar_from(dst, planes, i, frames, channels);
+}
+#endif
+
+//=================================================DISPATCH==========================================================
+
+static const deinterleave_f32_fn deinterleave_f32_kernels[WAV_ISA_COUNT] = {
+    deinterleave_f32_scalar,
+#ifdef WAV_ISA_X86
+    deinterleave_f32_sse2,
+    deinterleave_f32_sse2,
+#endif
+};
+
+static const interleave_f32_fn interleave_f32_kernels[WAV_ISA_COUNT] = {
+    interleave_f32_scalar,
+#ifdef WAV_ISA_X86
+    interleave_f32_sse2,
+    interleave_f32_avx2,
+#endif
+};
+
+static const deinterleave_s16_fn deinterleave_s16_kernels[WAV_ISA_COUNT] = {
+    deinterleave_s16_scalar,
+#ifdef WAV_ISA_X86
+    deinterleave_s16_sse2,
+    deinterleave_s16_avx2,
+#endif
+};
+
+static const interleave_s16_fn interleave_s16_kernels[WAV_ISA_COUNT] = {
+    interleave_s16_scalar,
+#ifdef WAV_ISA_X86
+    interleave_s16_sse2,
+    interleave_s16_avx2,
+#endif
+};
+
+void wav_deinterleave_f32(float* const* planes, const float* src, size_t frames, unsigned channels) {
+    if (frames == 0 || channels == 0) return;
+    deinterleave_f32_kernels[wav_convert_get_isa()](planes, src, frames, channels);
+}
+
+void wav_interleave_f32(float* dst, const float* const* planes, size_t frames, unsigned channels) {
+    if (frames == 0 || channels == 0) return;
+    interleave_f32_kernels[wav_convert_get_isa()](dst, planes, frames, channels);
+}
+
+void wav_deinterleave_s16(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels) {
+    if (frames == 0 || channels == 0) return;
+    deinterleave_s16_kernels[wav_convert_get_isa()](planes, src, frames, channels);
+}
+
+void wav_interleave_s16(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels) {
+    if (frames == 0 || channels == 0) return;
+    interleave_s16_kernels[wav_convert_get_isa()](dst, planes, frames, channels);
+}
+
+//=================================================PLANAR VIEW==========================================================
+
+static size_t planar_sample_size(wav_planar_type_t type) {
+    return (type == WAV_PLANAR_F32) ? sizeof(float) : sizeof(int16_t);
+}
+
+void wav_planar_init(wav_planar_t* planar) {
+    if (planar) {
+        memset(planar, 0, sizeof(*planar));
+    }
+}
+
+void wav_planar_free(wav_planar_t* planar) {
+    if (!planar) return;
+    free(planar->data);
+    free(planar->planes);
+    wav_planar_init(planar);
+}
+
+static bool wav_planar_alloc(wav_planar_t* planar, wav_planar_type_t type, uint16_t channels, uint64_t frames) {
+    size_t sample_size = planar_sample_size(type);
+    //? Pad every plane so the next one starts on a fresh cache line
+    uint64_t stride = (frames + WAV_PLANAR_ALIGN - 1) / WAV_PLANAR_ALIGN * WAV_PLANAR_ALIGN;
+    if (stride == 0) stride = WAV_PLANAR_ALIGN;
+    if (channels == 0 || stride > SIZE_MAX / sample_size / channels) {
+        Log(LOG_ERROR, "A planar view of %llu frames x %u channels doesn't fit in memory.\n", (unsigned long long)frames, channels);
+        return false;
+    }
+    planar->data = malloc((size_t)stride * channels * sample_size);
+    planar->planes = (void**)malloc(channels * sizeof(void*));
+    if (planar->data == NULL || planar->planes == NULL) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate %llu bytes for the planar view.\n",
+            (unsigned long long)(stride * channels * sample_size));
+        wav_planar_free(planar);
+        return false;
+    }
+    for (uint16_t c = 0; c < channels; ++c) {
+        planar->planes[c] = (uint8_t*)planar->data + (size_t)stride * c * sample_size;
+    }
+    planar->type = type;
+    planar->num_channels = channels;
+    planar->frames = frames;
+    planar->stride = (size_t)stride;
+    return true;
+}
+
+bool wav_planar_from_file(const wav_file_t* wav_file, wav_planar_type_t type, wav_planar_t* planar) {
+    if (!wav_file || !planar || wav_file->data == NULL) return false;
+    wav_planar_init(planar);
+
+    wav_sample_format_t format;
+    if (!wav_sample_format_from_header(&wav_file->header, &format)) {
+        Log(LOG_ERROR, "Format %d with %d bits per sample has no conversion kernel.\n", wav_file->header.encoding, wav_file->header.bits_per_sample);
+        return false;
+    }
+    const unsigned channels = wav_file->header.num_channels;
+    const size_t sample_size = wav_sample_format_size(format);
+    if (!wav_planar_alloc(planar, type, wav_file->header.num_channels, wav_file->samples)) {
+        return false;
+    }
+
+    //* Interleaved scratch for one block; the data pointer can sit at any byte offset in a mapped file,
+    //* so the samples always go through here instead of being cast in place
+    float* scratch = (float*)malloc((size_t)WAV_PLANAR_BLOCK * channels * sizeof(float));
+    int16_t* scratch16 = (type == WAV_PLANAR_S16) ? (int16_t*)malloc((size_t)WAV_PLANAR_BLOCK * channels * sizeof(int16_t)) : NULL;
+    void** planes = (void**)malloc(channels * sizeof(void*));
+    bool retval = true;
+    if (scratch == NULL || planes == NULL || (type == WAV_PLANAR_S16 && scratch16 == NULL)) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the planar conversion buffers.\n");
+        wav_planar_free(planar);
+        retval = false;
+        goto FREE_SCRATCH;
+    }
+
+    for (uint64_t done = 0; done < planar->frames; done += WAV_PLANAR_BLOCK) {
+        size_t frames = (planar->frames - done < WAV_PLANAR_BLOCK) ? (size_t)(planar->frames - done) : WAV_PLANAR_BLOCK;
+        size_t samples = frames * channels;
+        const uint8_t* src = wav_file->data + (size_t)done * channels * sample_size;
+        for (unsigned c = 0; c < channels; ++c) {
+            planes[c] = (uint8_t*)planar->planes[c] + (size_t)done * planar_sample_size(type);
+        }
+        if (type == WAV_PLANAR_F32) {
+            wav_convert_to_float(scratch, src, samples, format);
+            wav_deinterleave_f32((float* const*)planes, scratch, frames, channels);
+        } else {
+            if (format == WAV_SAMPLE_S16) {
+                memcpy(scratch16, src, samples * sizeof(int16_t));
+            } else {
+                wav_convert_to_float(scratch, src, samples, format);
+                wav_convert_from_float(scratch16, scratch, samples, WAV_SAMPLE_S16);
+            }
+            wav_deinterleave_s16((int16_t* const*)planes, scratch16, frames, channels);
+        }
+    }
+
+FREE_SCRATCH:
+    free(scratch);
+    free(scratch16);
+    free(planes);
+    return retval;
+}
+
+bool wav_planar_to_interleaved(const wav_planar_t* planar, void* dst, wav_sample_format_t format) {
+    if (!planar || !dst || planar->data == NULL) return false;
+    const unsigned channels = planar->num_channels;
+    const size_t sample_size = wav_sample_format_size(format);
+
+    float* scratch = (float*)malloc((size_t)WAV_PLANAR_BLOCK * channels * sizeof(float));
+    int16_t* scratch16 = (planar->type == WAV_PLANAR_S16) ? (int16_t*)malloc((size_t)WAV_PLANAR_BLOCK * channels * sizeof(int16_t)) : NULL;
+    const void** planes = (const void**)malloc(channels * sizeof(void*));
+    bool retval = true;
+    if (scratch == NULL || planes == NULL || (planar->type == WAV_PLANAR_S16 && scratch16 == NULL)) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the planar conversion buffers.\n");
+        retval = false;
+        goto FREE_SCRATCH;
+    }
+
+    for (uint64_t done = 0; done < planar->frames; done += WAV_PLANAR_BLOCK) {
+        size_t frames = (planar->frames - done < WAV_PLANAR_BLOCK) ? (size_t)(planar->frames - done) : WAV_PLANAR_BLOCK;
+        size_t samples = frames * channels;
+        uint8_t* out = (uint8_t*)dst + (size_t)done * channels * sample_size;
+        for (unsigned c = 0; c < channels; ++c) {
+            planes[c] = (const uint8_t*)planar->planes[c] + (size_t)done * planar_sample_size(planar->type);
+        }
+        if (planar->type == WAV_PLANAR_F32) {
+            wav_interleave_f32(scratch, (const float* const*)planes, frames, channels);
+        } else {
+            wav_interleave_s16(scratch16, (const int16_t* const*)planes, frames, channels);
+            if (format == WAV_SAMPLE_S16) {
+                memcpy(out, scratch16, samples * sizeof(int16_t));
+                continue;
+            }
+            wav_convert_to_float(scratch, scratch16, samples, WAV_SAMPLE_S16);
+        }
+        wav_convert_from_float(out, scratch, samples, format);
+    }
+
+FREE_SCRATCH:
+    free(scratch);
+    free(scratch16);
+    free(planes);
+    return retval;
+}
@@ -0,0 +1,94 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#pragma once
+#include "wav_convert.h"
+
+/**
+ * Sample type of a planar view.
+ */
+typedef enum wav_planar_type_t {
+    WAV_PLANAR_F32,             //? normalized float, same scale as wav_convert_to_float()
+    WAV_PLANAR_S16,
+} wav_planar_type_t;
+
+/**
+ * Per-channel (deinterleaved) copy of a file's samples.
+ *
+ * Every channel is one contiguous array of `frames` samples, so per-channel work
+ * walks memory linearly instead of striding by block_align. All planes live in a
+ * single allocation, `stride` samples apart.
+ */
+typedef struct wav_planar_t {
+    wav_planar_type_t type;
+    uint16_t num_channels;
+    uint64_t frames;
+    size_t stride;              //? samples between the starts of two planes (>= frames, padded)
+    void* data;                 //? the one allocation holding every plane
+    void** planes;              //? planes[c] is a float* or int16_t* depending on `type`
+} wav_planar_t;
+
+/**
+ * @brief Splits interleaved float frames into one array per channel.
+ *
+ * `planes[c]` receives `frames` samples of channel `c`. Mono, stereo and wider
+ * layouts each have their own kernel; the best instruction set is picked the same
+ * way as for the conversion kernels (see wav_convert_set_isa()).
+ */
+void wav_deinterleave_f32(float* const* planes, const float* src, size_t frames, unsigned channels);
+
+/**
+ * @brief Inverse of wav_deinterleave_f32(): weaves per-channel arrays back into frames.
+ */
+void wav_interleave_f32(float* dst, const float* const* planes, size_t frames, unsigned channels);
+
+/**
+ * @brief 16-bit version of wav_deinterleave_f32().
+ */
+void wav_deinterleave_s16(int16_t* const* planes, const int16_t* src, size_t frames, unsigned channels);
+
+/**
+ * @brief 16-bit version of wav_interleave_f32().
+ */
+void wav_interleave_s16(int16_t* dst, const int16_t* const* planes, size_t frames, unsigned channels);
+
+/**
+ * @brief Initializes a planar view to an empty state, safe to pass to wav_planar_free().
+ */
+void wav_planar_init(wav_planar_t* planar);
+
+/**
+ * @brief Builds a planar view of a loaded file's samples.
+ *
+ * Any format wav_sample_format_from_header() knows is accepted; samples are
+ * converted to `type` on the way (integers to WAV_PLANAR_S16 go through float and
+ * are rounded and saturated like wav_convert_from_float()).
+ *
+ * @returns `false` if the format has no kernel or the allocation fails.
+ */
+bool wav_planar_from_file(const wav_file_t* wav_file, wav_planar_type_t type, wav_planar_t* planar);
+
+/**
+ * @brief Writes a planar view back out as interleaved samples of `format`.
+ *
+ * `dst` must hold `frames * num_channels` samples of `format`.
+ */
+bool wav_planar_to_interleaved(const wav_planar_t* planar, void* dst, wav_sample_format_t format);
+
+/**
+ * @brief Frees the planes and resets `planar`.
+ */
+void wav_planar_free(wav_planar_t* planar);
@@ -0,0 +1,295 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "wav_writer.h"
+#include "wav_endian.h"
+#include "log.h"
+#include <errno.h>
+
+#define WAV_DS64_SLOT       36              //? ds64 chunk with an empty table, or the JUNK chunk holding its place
+#define WAV_MAX_HEADER      (12 + WAV_DS64_SLOT + 8 + 40 + 8)
+#define WAV_RIFF_LIMIT      0xFFFFFFFFull   //? largest size a 32-bit RIFF/data chunk header can hold
+
+//? Same GUID tail the parser checks for, the first 2 bytes are the format tag
+static const uint8_t wav_guid_suffix[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+//? Default speaker masks (KSAUDIO_SPEAKER_*) for 1 to 8 channels
+static const uint32_t wav_channel_masks[9] = { 0, 0x4, 0x3, 0x7, 0x33, 0x37, 0x3F, 0x70F, 0x63F };
+
+void wav_init_header(wav_header_t* header, uint16_t encoding, uint16_t num_channels, uint32_t sample_rate, uint16_t bits_per_sample) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->RIFF, "RIFF", 5);
+    memcpy(header->WAVE, "WAVE", 5);
+    memcpy(header->fmt, "fmt ", 5);
+    memcpy(header->data, "data", 5);
+    const bool extensible = num_channels > 2 || (encoding == WAV_FORMAT_PCM && bits_per_sample > 16);
+    header->format_type = extensible ? WAV_FORMAT_EXTENSIBLE : encoding;
+    header->encoding = encoding;
+    header->samples_per_block = 1;
+    header->num_channels = num_channels;
+    header->sample_rate = sample_rate;
+    header->bits_per_sample = bits_per_sample;
+    header->block_align = (uint16_t)(num_channels * (bits_per_sample / 8));
+    header->byte_rate = sample_rate * header->block_align;
+    header->valid_bits_per_sample = bits_per_sample;
+    header->channel_mask = extensible && num_channels <= 8 ? wav_channel_masks[num_channels] : 0;
+    header->sub_format[0] = (uint8_t)(encoding & 0xFF);
+    header->sub_format[1] = (uint8_t)(encoding >> 8);
+    memcpy(header->sub_format + 2, wav_guid_suffix, sizeof(wav_guid_suffix));
+    header->cb_size = extensible ? 22 : 0;
+    header->chunk_size = extensible ? 40 : (encoding == WAV_FORMAT_PCM ? 16 : 18);
+}
+
+/**
+ * Copies the format fields of `format` into `header` and fills in what follows from
+ * them, checking that it's a layout the parser reads back.
+ */
+static bool wav_writer_format(wav_header_t* header, const wav_header_t* format) {
+    const uint16_t encoding = (format->format_type == WAV_FORMAT_EXTENSIBLE) ? (uint16_t)(format->sub_format[0] | (format->sub_format[1] << 8))
+                                                                              : format->format_type;
+    const uint16_t bits = format->bits_per_sample;
+    bool supported = (encoding == WAV_FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+                     (encoding == WAV_FORMAT_IEEE_FLOAT && bits == 32) ||
+                     ((encoding == WAV_FORMAT_MULAW || encoding == WAV_FORMAT_ALAW) && bits == 8);
+    if (!supported || format->num_channels == 0 || format->sample_rate == 0) {
+        Log(LOG_ERROR, "WAV writer: can't write format %d with %d channels of %d bits at %u Hz.\n", encoding, format->num_channels, bits, format->sample_rate);
+        return false;
+    }
+    wav_init_header(header, encoding, format->num_channels, format->sample_rate, bits);
+    //* Keep the caller's choice of fmt chunk, the defaults only decide when it's ambiguous
+    if (format->format_type == WAV_FORMAT_EXTENSIBLE) {
+        header->format_type = WAV_FORMAT_EXTENSIBLE;
+        header->cb_size = 22;
+        header->chunk_size = 40;
+        header->valid_bits_per_sample = (format->valid_bits_per_sample && format->valid_bits_per_sample <= bits) ? format->valid_bits_per_sample : bits;
+        header->channel_mask = format->channel_mask;
+    } else {
+        header->format_type = encoding;
+        header->cb_size = 0;
+        header->chunk_size = (encoding == WAV_FORMAT_PCM) ? 16 : 18;
+        header->valid_bits_per_sample = bits;
+        header->channel_mask = 0;
+    }
+    return true;
+}
+
+static size_t wav_header_bytes(const wav_header_t* header, bool ds64_slot) {
+    return 12 + (ds64_slot ? WAV_DS64_SLOT : 0) + 8 + header->chunk_size + 8;
+}
+
+/**
+ * Lays out RIFF/RF64, the ds64 slot, fmt and the data chunk header for `data_bytes`
+ * of samples. As RF64 the 32-bit sizes are 0xFFFFFFFF and the real ones go in ds64;
+ * otherwise the slot, if any, is a JUNK chunk that can become ds64 later.
+ *
+ * @returns the header's size, samples start right after it.
+ */
+static size_t wav_encode_header(uint8_t* out, const wav_header_t* header, bool ds64_slot, bool rf64, uint64_t data_bytes) {
+    const size_t size = wav_header_bytes(header, ds64_slot || rf64);
+    const uint64_t riff_size = size - 8 + data_bytes + (data_bytes & 1);
+    uint8_t* p = out;
+    memcpy(p, rf64 ? "RF64" : "RIFF", 4);
+    encode_u32(p + 4, rf64 ? 0xFFFFFFFFu : (uint32_t)riff_size);
+    memcpy(p + 8, "WAVE", 4);
+    p += 12;
+    if (ds64_slot || rf64) {
+        memset(p, 0, WAV_DS64_SLOT);
+        memcpy(p, rf64 ? "ds64" : "JUNK", 4);
+        encode_u32(p + 4, WAV_DS64_SLOT - 8);
+        if (rf64) {
+            encode_u64(p + 8, riff_size);
+            encode_u64(p + 16, data_bytes);
+            encode_u64(p + 24, data_bytes / header->block_align);
+            encode_u32(p + 32, 0);              //? no other chunk needs a 64-bit size
+        }
+        p += WAV_DS64_SLOT;
+    }
+    memcpy(p, "fmt ", 4);
+    encode_u32(p + 4, header->chunk_size);
+    encode_u16(p + 8, header->format_type);
+    encode_u16(p + 10, header->num_channels);
+    encode_u32(p + 12, header->sample_rate);
+    encode_u32(p + 16, header->byte_rate);
+    encode_u16(p + 20, header->block_align);
+    encode_u16(p + 22, header->bits_per_sample);
+    if (header->chunk_size >= 18) encode_u16(p + 24, header->cb_size);
+    if (header->chunk_size >= 40) {
+        encode_u16(p + 26, header->valid_bits_per_sample);
+        encode_u32(p + 28, header->channel_mask);
+        memcpy(p + 32, header->sub_format, 16);
+    }
+    p += 8 + header->chunk_size;
+    memcpy(p, "data", 4);
+    encode_u32(p + 4, rf64 ? 0xFFFFFFFFu : (uint32_t)data_bytes);
+    return size;
+}
+
+//? The sizes the parser would report for the file just written
+static void wav_finish_header(wav_header_t* header, bool rf64, size_t header_bytes, uint64_t data_bytes) {
+    memcpy(header->RIFF, rf64 ? "RF64" : "RIFF", 5);
+    header->file_size = header_bytes - 8 + data_bytes + (data_bytes & 1);
+    header->data_size = data_bytes;
+}
+
+static bool wav_fits_riff(size_t header_bytes, uint64_t data_bytes) {
+    return data_bytes <= WAV_RIFF_LIMIT && header_bytes - 8 + data_bytes + (data_bytes & 1) <= WAV_RIFF_LIMIT;
+}
+
+//=================================================STREAMING==========================================================
+
+static bool wav_writer_write(wav_writer_t* writer, const io_vec_t* vecs, int count, uint64_t bytes) {
+    int64_t put = io_pwritev(&writer->file, vecs, count, writer->file_offset);
+    if (put < 0 || (uint64_t)put != bytes) {
+        Log(LOG_ERROR, "WAV writer: write of %llu bytes at offset %llu failed. Reason: %s\n", (unsigned long long)bytes,
+            (unsigned long long)writer->file_offset, strerror(errno));
+        writer->failed = true;
+        return false;
+    }
+    writer->file_offset += bytes;
+    return true;
+}
+
+bool wav_writer_open(wav_writer_t* writer, const char* path, const wav_header_t* format, const wav_writer_options_t* options) {
+    memset(writer, 0, sizeof(*writer));
+    const wav_writer_options_t defaults = { 0, WAV_RF64_AUTO, 0 };
+    if (!options) options = &defaults;
+    if (!wav_writer_format(&writer->header, format)) return false;
+    writer->rf64 = options->rf64;
+
+    size_t buffer_size = options->buffer_bytes ? options->buffer_bytes : WAV_WRITER_DEFAULT_BUFFER;
+    buffer_size = (buffer_size + WAV_WRITER_ALIGN - 1) & ~(size_t)(WAV_WRITER_ALIGN - 1);
+    writer->allocation = malloc(buffer_size + WAV_WRITER_ALIGN);
+    if (!writer->allocation) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate a %zu byte write buffer.\n", buffer_size);
+        return false;
+    }
+    writer->buffer = (uint8_t*)(((uintptr_t)writer->allocation + WAV_WRITER_ALIGN - 1) & ~(uintptr_t)(WAV_WRITER_ALIGN - 1));
+    writer->buffer_size = buffer_size;
+
+    if (!io_create_file(path, &writer->file)) {
+        Log(LOG_ERROR, "Unable to create %s. Reason: %s\n", path, strerror(errno));
+        free(writer->allocation);
+        writer->allocation = NULL;
+        return false;
+    }
+    //? Sizes are placeholders until close; the slot lets AUTO turn into RF64 without moving the samples
+    writer->buffered = wav_encode_header(writer->buffer, &writer->header, writer->rf64 != WAV_RF64_NEVER, writer->rf64 == WAV_RF64_ALWAYS, 0);
+    writer->data_offset = writer->buffered;
+    if (options->expected_frames) {
+        const uint64_t data_bytes = options->expected_frames * writer->header.block_align;
+        if (!io_preallocate(&writer->file, writer->data_offset + data_bytes + (data_bytes & 1))) {
+            Log(LOG_DEBUG, "Couldn't reserve space for %s, writing it anyway. Reason: %s\n", path, strerror(errno));
+        }
+    }
+    return true;
+}
+
+bool wav_writer_append_frames(wav_writer_t* writer, const void* frames, size_t count) {
+    if (writer->failed || !writer->file.is_open) return false;
+    const uint64_t bytes = (uint64_t)count * writer->header.block_align;
+    const uint64_t data_bytes = writer->frames_written * writer->header.block_align + bytes;
+    if (writer->rf64 == WAV_RF64_NEVER && !wav_fits_riff(writer->data_offset, data_bytes)) {
+        Log(LOG_ERROR, "WAV writer: %llu bytes of samples don't fit a RIFF file, use RF64.\n", (unsigned long long)data_bytes);
+        writer->failed = true;
+        return false;
+    }
+    const uint8_t* src = (const uint8_t*)frames;
+    if (writer->buffered + bytes < writer->buffer_size) {
+        memcpy(writer->buffer + writer->buffered, src, (size_t)bytes);
+        writer->buffered += (size_t)bytes;
+    } else {
+        //* Everything up to the last whole buffer goes out in one write: what was buffered, then straight from `frames`
+        const uint64_t total = writer->buffered + bytes;
+        const uint64_t direct = total - total % writer->buffer_size;
+        const size_t taken = (size_t)(direct - writer->buffered);
+        io_vec_t vecs[2] = { { writer->buffer, writer->buffered }, { src, taken } };
+        if (!wav_writer_write(writer, vecs, 2, direct)) return false;
+        writer->buffered = (size_t)(bytes - taken);
+        memcpy(writer->buffer, src + taken, writer->buffered);
+    }
+    writer->frames_written += count;
+    return true;
+}
+
+bool wav_writer_flush(wav_writer_t* writer) {
+    if (writer->failed || !writer->file.is_open) return false;
+    const uint64_t data_bytes = writer->frames_written * writer->header.block_align;
+    const bool ds64_slot = writer->rf64 != WAV_RF64_NEVER;
+    const bool rf64 = writer->rf64 == WAV_RF64_ALWAYS || !wav_fits_riff(writer->data_offset, data_bytes);
+    const bool header_written = writer->file_offset > 0;
+    //* Nothing written yet: the final header goes out with the samples
+    if (!header_written) wav_encode_header(writer->buffer, &writer->header, ds64_slot, rf64, data_bytes);
+    //? Chunks are word aligned, an odd sized data chunk is followed by a pad byte. The buffer always has room
+    //? for it, and it isn't counted so the next append writes over it
+    const size_t pad = (size_t)(data_bytes & 1);
+    writer->buffer[writer->buffered] = 0;
+    io_vec_t vec = { writer->buffer, writer->buffered + pad };
+    if (!wav_writer_write(writer, &vec, 1, writer->buffered + pad)) return false;
+    writer->file_offset -= pad;
+    writer->buffered = 0;
+    if (header_written) {
+        uint8_t header[WAV_MAX_HEADER];
+        size_t size = wav_encode_header(header, &writer->header, ds64_slot, rf64, data_bytes);
+        if (io_pwrite(&writer->file, header, size, 0) != (int64_t)size) {
+            Log(LOG_ERROR, "WAV writer: unable to update the header. Reason: %s\n", strerror(errno));
+            writer->failed = true;
+            return false;
+        }
+    }
+    wav_finish_header(&writer->header, rf64, (size_t)writer->data_offset, data_bytes);
+    return true;
+}
+
+bool wav_writer_close(wav_writer_t* writer) {
+    bool ok = wav_writer_flush(writer);
+    io_close_file(&writer->file);
+    free(writer->allocation);
+    writer->allocation = NULL;
+    writer->buffer = NULL;
+    return ok;
+}
+
+//=================================================ONE-SHOT==========================================================
+
+bool wav_write_file(const char* path, const wav_file_t* wav_file) {
+    wav_header_t header;
+    if (!wav_writer_format(&header, &wav_file->header)) return false;
+    const uint64_t data_bytes = wav_file->data_length;
+    if (data_bytes % header.block_align != 0 || (data_bytes > 0 && !wav_file->data)) {
+        Log(LOG_ERROR, "Can't write %s: %llu bytes of samples aren't whole %d byte frames.\n", path, (unsigned long long)data_bytes, header.block_align);
+        return false;
+    }
+    const bool rf64 = !wav_fits_riff(wav_header_bytes(&header, false), data_bytes);
+    uint8_t bytes[WAV_MAX_HEADER];
+    const size_t header_bytes = wav_encode_header(bytes, &header, false, rf64, data_bytes);
+    const uint8_t pad = 0;
+
+    io_file_t file;
+    if (!io_create_file(path, &file)) {
+        Log(LOG_ERROR, "Unable to create %s. Reason: %s\n", path, strerror(errno));
+        return false;
+    }
+    const uint64_t total = header_bytes + data_bytes + (data_bytes & 1);
+    io_preallocate(&file, total);   //? only a layout hint, the write below extends the file anyway
+    io_vec_t vecs[3] = { { bytes, header_bytes }, { wav_file->data, (size_t)data_bytes }, { &pad, (size_t)(data_bytes & 1) } };
+    int64_t put = io_pwritev(&file, vecs, 3, 0);
+    bool ok = put >= 0 && (uint64_t)put == total;
+    if (!ok) Log(LOG_ERROR, "Unable to write %s. Reason: %s\n", path, strerror(errno));
+    io_close_file(&file);
+    return ok;
+}
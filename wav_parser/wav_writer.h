@@ -0,0 +1,122 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+
+#pragma once
+#include "wav_parser.h"
+
+#define WAV_WRITER_DEFAULT_BUFFER   (1u << 20)      //? bytes handed to the OS per write
+#define WAV_WRITER_ALIGN            4096            //? buffer address and flush size granularity
+
+/**
+ * When a file is written as RF64 (EBU Tech 3306), the 64-bit variant plain RIFF
+ * headers switch to past 4 GB.
+ */
+typedef enum wav_rf64_mode_t {
+    WAV_RF64_AUTO,      //? RIFF, turned into RF64 at close if it outgrew 4 GB (a placeholder JUNK chunk makes room for ds64)
+    WAV_RF64_NEVER,     //? RIFF only, appending past 4 GB fails
+    WAV_RF64_ALWAYS,
+} wav_rf64_mode_t;
+
+typedef struct wav_writer_options_t {
+    uint64_t expected_frames;   //? 0 when unknown; otherwise the file's space is reserved up front
+    wav_rf64_mode_t rf64;
+    size_t buffer_bytes;        //? 0 for WAV_WRITER_DEFAULT_BUFFER, rounded up to WAV_WRITER_ALIGN
+} wav_writer_options_t;
+
+/**
+ * Streaming WAV writer: the header goes out first with placeholder sizes, frames
+ * are appended in any number of calls and the sizes are patched on close.
+ *
+ * Appends are gathered into a buffer that is only written out in whole multiples
+ * of its size, from offset 0, so the OS only ever sees large aligned writes. A
+ * large append goes out in the same call as what was buffered before it
+ * (io_pwritev()) instead of being copied through the buffer.
+ */
+typedef struct wav_writer_t
+{
+    wav_header_t header;        //? the format being written; sizes are final after wav_writer_close()
+    io_file_t file;
+    uint8_t* buffer;            //? WAV_WRITER_ALIGN aligned, bytes not written yet
+    void* allocation;           //? what `buffer` was carved from
+    size_t buffer_size;
+    size_t buffered;
+    uint64_t file_offset;       //? where buffer[0] goes
+    uint64_t data_offset;       //? file offset of the first sample
+    uint64_t frames_written;
+    wav_rf64_mode_t rf64;
+    bool failed;                //? a write failed, the file is incomplete
+}wav_writer_t;
+
+/**
+ * @brief Fills `header` with a consistent format, ready for wav_writer_open() or wav_write_file().
+ *
+ * Layouts that the plain fmt chunk can't describe unambiguously (more than 2
+ * channels, or more than 16 bits of PCM) get the extensible fmt chunk with the
+ * usual speaker mask for their channel count.
+ *
+ * @param encoding WAV_FORMAT_PCM (8, 16, 24 or 32 bits), WAV_FORMAT_IEEE_FLOAT (32 bits)
+ *                 or WAV_FORMAT_MULAW/WAV_FORMAT_ALAW (8 bits).
+ */
+void wav_init_header(wav_header_t* header, uint16_t encoding, uint16_t num_channels, uint32_t sample_rate, uint16_t bits_per_sample);
+
+/**
+ * @brief Creates `path` and writes the header for `format`'s sample layout.
+ *
+ * Only the format fields of `format` are used (see wav_init_header()), its sizes
+ * are ignored. `options` may be NULL for the defaults.
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_writer_open(wav_writer_t* writer, const char* path, const wav_header_t* format, const wav_writer_options_t* options);
+
+/**
+ * @brief Appends `count` interleaved frames (`count * header.block_align` bytes) in the file's format.
+ *
+ * @returns `false` (with the reason logged) if a write failed or the frames don't
+ *          fit a plain RIFF file under WAV_RF64_NEVER; later appends fail too.
+ */
+bool wav_writer_append_frames(wav_writer_t* writer, const void* frames, size_t count);
+
+/**
+ * @brief Writes everything appended so far and patches the sizes, so the file on
+ *        disk is complete as it stands. Appending can go on afterwards.
+ *
+ * The buffer is written out partially, so later writes are no longer aligned to
+ * the buffer size; flush at checkpoints, not after every append.
+ *
+ * @returns `false` (with the reason logged) if a write failed.
+ */
+bool wav_writer_flush(wav_writer_t* writer);
+
+/**
+ * @brief Writes what's left, patches the RIFF, ds64 and data sizes and closes the file.
+ *
+ * Always closes the file, even after a failed append.
+ *
+ * @returns `true` if the whole file was written.
+ */
+bool wav_writer_close(wav_writer_t* writer);
+
+/**
+ * @brief Writes `wav_file` (header and `data_length` bytes of samples) to `path` in one go.
+ *
+ * The file's space is reserved first and header and samples go out in one gathered
+ * write, straight from `data`. Files past 4 GB are written as RF64.
+ *
+ * @returns `true` on success, `false` (with the reason logged) otherwise.
+ */
+bool wav_write_file(const char* path, const wav_file_t* wav_file);
@@ -23,306 +23,715 @@
 
 
 #include "soundplayer.h"
-#include "wav_parser.h"
+#include "mixer.h"
+#include "wav_cache.h"
+#include "wav_metadata.h"
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
-#include <mmsystem.h>
 #include "log.h"
 
-//!There's a bug when the playback starts (it's either cuz of the refs or critical sections misuse kinda). sometimes it does happends sometimes it doesn't
-//!it's like a delayed playback start problem (like when the playback starts a tiny small part of the data buffer has alrdy been consumed)
-//!: check play_sound
-//TODO: add guards against invalid pointers usage 
-//!Maybe add an InitSoundSystem that init a global lock and also keep tracks of every sound created to have better and safer access to ptr check
-//* date: 25/10/2025, not so sure about the idea prior to this comment no more, but ion wanna remove it completely just yet 
-
-static void CALLBACK waveOutProc(HWAVEOUT hwo, UINT uMsg, DWORD_PTR dwInstance, DWORD_PTR param1, DWORD_PTR param2);
-static void sound_cleanup_on_fail(sound* snd);
-static void sound_ctx_aqcuire(state internal);
-static void sound_ctx_release(state internal);
-static void sound_load(sound *snd);
-static bool WaveOutOpFailed(MMRESULT mmResult, const char* fn_name);
-static void WAVEFORMATEX_HDRinit(const sound* snd);
-static void prepareSoundData(sound* snd);
-static void unprepareSoundData(sound* snd);
-static void unprepareSoundDataInCleanup(sound* snd);
+//* Every sound plays through one shared engine: a single waveOut device fed from a small
+//* ring of buffers, rendered by the mixer. Short sounds are decoded once into the shared
+//* asset cache and every instance mixes from that one copy; long ones are streamed from
+//* disk by a feeder thread each, so playback starts after one chunk is decoded.
+#define ENGINE_SAMPLE_RATE      48000
+#define ENGINE_CHANNELS         2
+#define ENGINE_BLOCK_FRAMES     480     //? 10 ms per device buffer
+#define ENGINE_BUFFERS          4       //? ~40 ms of device latency
+#define ENGINE_MAX_VOICES       64      //? unless sound_system_init() says otherwise
+#define ENGINE_CACHE_BUDGET     (64ull << 20)   //? decoded sample data kept around once no sound uses it
+#define SOUND_CACHE_MAX_BYTES   (4ull << 20)    //? bigger files are streamed instead of cached
+#define SOUND_LOADER_THREADS    2       //? sound_init_async() loads running at once, more would just fight over the disk
+
+static bool engine_acquire(void);
+static bool engine_acquire_locked(void);
+static struct sound_path_t* engine_path_for(const char* path);
+static BOOL CALLBACK engine_lock_init(PINIT_ONCE once, PVOID param, PVOID* context);
+static void engine_release(void);
+static void sound_stop_voice(sound* snd);
+static bool sound_ready(sound* snd);
+static sound* sound_alloc(const char* file_path);
+static void sound_free(sound* snd);
+static bool sound_open(sound* snd);
+static void sound_close(state s);
+static BOOL CALLBACK loader_pool_init(PINIT_ONCE once, PVOID param, PVOID* context);
+static void CALLBACK sound_load_job(PTP_CALLBACK_INSTANCE instance, PVOID context);
+static bool sound_start_voice(sound* snd, uint64_t frame, uint64_t trigger);
+static void sound_read_loop_points(state s, const char* file_path, const wav_chunk_dir_t* chunks, struct sound_path_t* info);
 
 struct state__ {
-    wav_file_t wav_file;
-    WAVEFORMATEX format;
-    HWAVEOUT hWaveOut;
-    WAVEHDR waveHeader;
-    DWORD sndFlags;
+    wav_asset_t* asset;             //? shared decoded samples, NULL when streaming from disk
+    audio_stream_t* stream;         //? NULL when the asset is mixed directly
+    mixer_voice_t voice;
+    bool looping;                   //? sound_set_looping(), applies to `voice`
+    uint64_t loop_start;            //? file frames; the smpl chunk's first loop if any, the whole file otherwise
+    uint64_t loop_end;              //? exclusive, 0 for the end of the file
+    atomic_uint instances;          //? fire-and-forget voices the mixer still reads the asset for, waited on at unload
+    audio_latency_t* latency;       //? owned by the engine, NULL if it couldn't be allocated
     CRITICAL_SECTION lock;
-    volatile LONG refcount;
-    HANDLE hBufferDoneEvent; /*rename to hAllBufferDoneEvent for dbl buffering clarity*/
+    //* Loading; `loaded` is only created by sound_init_async() and is set once the loader is done with the sound
+    volatile LONG load_state;       //? sound_load_state_t
+    volatile LONG cancel;
+    HANDLE loaded;
+    sound_loaded_fn on_loaded;
+    void* user;
+    char error[128];                //? why the load failed, empty otherwise
 };
 
-typedef enum Flags {
-    SOUND_IS_INITIALIZED    = 0x00000001,
-    SOUND_PLAYBACK_DONE     = 0x00000002,
-    SOUND_IS_PLAYING        = 0x00000004,
-    SOUND_WAV_PARSED        = 0x00000008,
-    SOUND_LOOPING           = 0x0000000E, //?Even though 0xE is technically a combination of multiple bits, it represents one valid state (since a sound's is_done and playing flags are mutually exclusive )
-}Flags;
+static INIT_ONCE engine_once = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION engine_lock;
+static audio_backend_t* engine_backend;
+static mixer_t* engine_mixer;
+static wav_cache_t* engine_cache;
+static unsigned engine_sounds;          //? loaded sounds (plus sound_system_init()), the device closes with the last one
+static bool engine_system_held;         //? sound_system_init() holds one of engine_sounds until sound_system_shutdown()
+static uint32_t engine_max_voices = ENGINE_MAX_VOICES;
+static mixer_steal_policy_t engine_steal_policy = MIXER_STEAL_NONE;
+
+//* Latency histograms outlive their sounds: the device reports a block as played well after
+//* the voice in it may have ended. They're kept per path until the engine closes, which also
+//* means reloading a sound keeps adding to the same numbers. The entry also keeps the smpl
+//* loop read when the path was last loaded from disk, so a cache hit needs no disk access.
+typedef struct sound_path_t {
+    struct sound_path_t* next;
+    audio_latency_t latency;
+    bool loop_known;                //? the fields below match the cached asset; under engine_lock
+    uint64_t loop_start;
+    uint64_t loop_end;
+    char path[];
+} sound_path_t;
+static sound_path_t* engine_paths;
+
+//* Loader pool for sound_init_async(), created on first use and kept for the process' lifetime
+static INIT_ONCE loader_once = INIT_ONCE_STATIC_INIT;
+static PTP_POOL loader_pool;
+static TP_CALLBACK_ENVIRON loader_env;
 
 //=================================================PUBLIC API IMPLEMENTATION==========================================================
 
-sound *sound_init(const char* file_path) {
-    state s = (state)malloc(sizeof(struct state__));
-    if(!s) {
-        Log(LOG_ERROR, "malloc failed to allocate memory for sound state\n");
-        exit(EXIT_FAILURE);
+bool sound_system_init(uint32_t max_voices, mixer_steal_policy_t policy) {
+    InitOnceExecuteOnce(&engine_once, engine_lock_init, NULL, NULL);
+    EnterCriticalSection(&engine_lock);
+    if(engine_backend) {
+        //? The voice pool is allocated once with the mixer, it can't be resized under playing sounds
+        Log(LOG_WARNING, "The sound system is already running with %u voices, settings ignored.\n", engine_max_voices);
+    } else if(max_voices > 0) {
+        engine_max_voices = max_voices;
+        engine_steal_policy = policy;
     }
-    memset(s, 0, sizeof(struct state__));
-    sound *snd = (sound*)malloc(sizeof(sound));
-    if(!snd) {
-        Log(LOG_ERROR, "malloc failed to allocate memory for sound struct\n");
-        free(s);
-        exit(EXIT_FAILURE);
+    //? Init again holds nothing more: one shutdown still closes the device
+    bool ok = engine_system_held || engine_acquire_locked();
+    if(ok) engine_system_held = true;
+    LeaveCriticalSection(&engine_lock);
+    return ok;
+}
+
+void sound_system_shutdown(void) {
+    //* The lock may never have been initialized: no init, no sound ever loaded
+    InitOnceExecuteOnce(&engine_once, engine_lock_init, NULL, NULL);
+    EnterCriticalSection(&engine_lock);
+    bool held = engine_system_held;
+    engine_system_held = false;
+    LeaveCriticalSection(&engine_lock);
+    //! Without an init to match, releasing would close the device under sounds still loaded
+    if(!held) return;
+    engine_release();
+}
+
+sound *sound_init(const char* file_path) {
+    sound *snd = sound_alloc(file_path);
+    if(!snd) return NULL;
+    if(!sound_open(snd)) {
+        sound_free(snd);
+        return NULL;
     }
-    snd->file_path = NULL;
-    size_t len = strlen(file_path);
-    snd->file_path = (char*)malloc(len + 1);
-    if(!snd->file_path) {
-        Log(LOG_ERROR, "malloc failed to allocate memory for file_path\n");
-        free(s);
-        free(snd);
-        exit(EXIT_FAILURE);
+    snd->state->load_state = SOUND_READY;
+    return snd;
+}
+
+/**
+ * @brief Loads a sound on the loader pool; returns at once with the sound in SOUND_LOADING.
+ *
+ * Probing, parsing and opening the device all happen on one of the loader threads,
+ * so the caller never waits on the disk. `on_loaded` (optional) runs on that thread
+ * once the outcome is known (right away if the load can't even be queued); it
+ * must not unload the sound. Failures never end the
+ * process: they show up as SOUND_FAILED with sound_load_error() saying why.
+ *
+ * Until the sound is SOUND_READY every play call is a no-op. Whatever the outcome,
+ * the handle is released with sound_unload().
+ *
+ * @returns `NULL` only if the handle itself couldn't be allocated.
+ */
+sound *sound_init_async(const char* file_path, sound_loaded_fn on_loaded, void* user)
+{
+    sound *snd = sound_alloc(file_path);
+    if(!snd) return NULL;
+    state s = snd->state;
+    s->on_loaded = on_loaded;
+    s->user = user;
+    s->loaded = CreateEvent(NULL, TRUE, FALSE, NULL);
+    InitOnceExecuteOnce(&loader_once, loader_pool_init, NULL, NULL);
+    if(!s->loaded || !loader_pool || !TrySubmitThreadpoolCallback(sound_load_job, snd, &loader_env)) {
+        //? Report it through the handle like any other failure, the caller checks one place
+        snprintf(s->error, sizeof(s->error), "unable to queue the load");
+        s->load_state = SOUND_FAILED;
+        if(s->loaded) SetEvent(s->loaded);
+        if(on_loaded) on_loaded(snd, SOUND_FAILED, user);
     }
-    strcpy(snd->file_path, file_path);
-    snd->state = s;
-    sound_load(snd);
     return snd;
 }
 
+sound_load_state_t sound_load_state(sound* snd)
+{
+    if(!snd || !snd->state) return SOUND_FAILED;
+    return (sound_load_state_t)InterlockedCompareExchange(&snd->state->load_state, 0, 0);
+}
+
+/**
+ * @brief Waits up to `timeout_ms` for an asynchronous load to finish.
+ *
+ * @returns the load state afterwards, still SOUND_LOADING if the time ran out.
+ */
+sound_load_state_t sound_wait_loaded(sound* snd, uint32_t timeout_ms)
+{
+    if(!snd || !snd->state) return SOUND_FAILED;
+    if(snd->state->loaded) WaitForSingleObject(snd->state->loaded, timeout_ms);
+    return sound_load_state(snd);
+}
+
+/**
+ * @brief Asks a pending load to give up.
+ *
+ * A load that hasn't started is dropped; one in progress stops at its next step
+ * and releases what it already opened. Either way the sound ends up
+ * SOUND_CANCELLED, and still has to be released with sound_unload().
+ *
+ * @returns `false` if the load had already finished.
+ */
+bool sound_cancel_load(sound* snd)
+{
+    if(!snd || !snd->state || !snd->state->loaded) return false;
+    InterlockedExchange(&snd->state->cancel, 1);
+    return sound_load_state(snd) == SOUND_LOADING;
+}
+
+const char* sound_load_error(sound* snd)
+{
+    if(!snd || !snd->state) return "no sound";
+    return (sound_load_state(snd) == SOUND_LOADING) ? "" : snd->state->error;
+}
+
 void sound_unload(sound *snd)
 {
-    if (!snd) return; //!unsafe
-    if(!snd->state && !snd->file_path) {
-        Log(LOG_WARNING, "Only Sound's struct was freed - Sound's state wasn't initialized.\n\n");
-        free(snd);
-        return;
-    }
-    EnterCriticalSection(&snd->state->lock);
+    if (!snd) return;
     if (snd->state) {
-        unprepareSoundDataInCleanup(snd);
-        wav_free_file(&snd->state->wav_file);
-        LeaveCriticalSection(&snd->state->lock);
-        DeleteCriticalSection(&snd->state->lock);
-        LONG refCount = InterlockedCompareExchange((volatile LONG*)&snd->state->refcount, 0, 0);
-        if(refCount == 0) { 
-            free(snd->state);
-            snd->state = NULL;
-            if (snd->file_path) {
-                free(snd->file_path);
-                snd->file_path = NULL; 
-                Log(LOG_INFO, "Sound's file_path successfully freed!\n\n");
-            }
-            free(snd);
+        //? The loader may still be working on the sound: stop it early and wait until it's done with it
+        if (snd->state->loaded) {
+            InterlockedExchange(&snd->state->cancel, 1);
+            WaitForSingleObject(snd->state->loaded, INFINITE);
+        }
+        if (sound_load_state(snd) == SOUND_READY) {
+            EnterCriticalSection(&snd->state->lock);
+            //? The audio thread may be mid-block on the stream: wait for the mixer to let go of it
+            sound_stop_voice(snd);
+            sound_close(snd->state);
+            LeaveCriticalSection(&snd->state->lock);
+            Log(LOG_DEBUG, "Sound's state successfully unloaded!\n\n");
         }
-        Log(LOG_INFO, "Sound's state successfully unloaded!\n\n");
     }
+    sound_free(snd);
 }
 
 /**
- * @brief Plays a parsed WAV sound.
- * 
+ * @brief Plays a sound from the start, or does nothing if it is already playing.
+ *
+ * Queues a mixer voice for it (restarting the sound's feeder first if it streams);
+ * this never waits on the audio thread or the disk.
+ *
  * @param snd Initialized sound struct.
- *! @warning Not thread-safe: `play_sound()` and `WaveOutProc` access state flags concurrently without synchronization, which may cause data races and undefined behavior.
  */
 void play_sound(sound *snd)
 {
-    //TODO: yeah no vro pack it up and give every sound a critical section lock ✌🏻😭
-    //TODO: maybe use double Buffering for replays
-    if(!snd || !snd->state) return; //!unsafe access
+    const uint64_t trigger = audio_clock_ns();
+    if(!sound_ready(snd)) return;
+    EnterCriticalSection(&snd->state->lock);
+    if(!mixer_voice_playing(engine_mixer, snd->state->voice)) {
+        sound_start_voice(snd, 0, trigger);
+    }
+    LeaveCriticalSection(&snd->state->lock);
+}
 
-    //!Enter Critical section , incr refcount, do things..,ResetEvent, decr ref, leave critical Section
+/**
+ * @brief Jumps to `frame` of the sound, or starts playing it from there if it isn't playing.
+ *
+ * The jump lands sample-accurately at the next mixer block while the device keeps
+ * running: nothing is stopped or re-prepared. A streamed sound only reads the chunk
+ * at the new position, so scrubbing through an hour-long file costs one disk read
+ * per jump. `frame` counts frames of the file, whatever the device rate.
+ *
+ * @returns `false` if the jump couldn't be queued or no voice was free.
+ */
+bool sound_seek(sound* snd, uint64_t frame)
+{
+    const uint64_t trigger = audio_clock_ns();
+    if(!sound_ready(snd)) return false;
+    bool ok;
     EnterCriticalSection(&snd->state->lock);
-    sound_ctx_aqcuire(snd->state);
-    if(!(snd->state->sndFlags & SOUND_IS_PLAYING)) {
-        if((snd->state->sndFlags & SOUND_PLAYBACK_DONE) && (snd->state->waveHeader.dwFlags & WHDR_DONE)) {
-            snd->state->sndFlags &= ~SOUND_PLAYBACK_DONE;
-        }
-        MMRESULT mmres = waveOutWrite(snd->state->hWaveOut, &snd->state->waveHeader, sizeof(WAVEHDR));
-        if(WaveOutOpFailed(mmres, "waveOutWrite")) {
-            unprepareSoundData(snd);
-            prepareSoundData(snd);
-            mmres = waveOutWrite(snd->state->hWaveOut, &snd->state->waveHeader, sizeof(WAVEHDR));
-            if(WaveOutOpFailed(mmres, "waveOutWrite")) {
-                unprepareSoundData(snd);
-                Log(LOG_ERROR, "waveOutWrite failed after recovery attempt. Audio output unavailable. Aborting playback.\n");
-                return;
-            }
-        }
-        snd->state->sndFlags |= SOUND_IS_PLAYING;
-        ResetEvent(snd->state->hBufferDoneEvent);
+    if(mixer_voice_playing(engine_mixer, snd->state->voice)) {
+        ok = mixer_seek(engine_mixer, snd->state->voice, frame);
+    } else {
+        ok = sound_start_voice(snd, frame, trigger);
     }
-    sound_ctx_release(snd->state);
     LeaveCriticalSection(&snd->state->lock);
+    return ok;
 }
 
 /**
- * @brief Checks whether the audio buffer is still playing.
+ * @brief Starts the sound over from its first frame, or plays it if it isn't playing.
  *
- * This function reads the `dwFlags` member atomically using `InterlockedCompareExchange`
- * to ensure a thread-safe read without modifying the value.
- * 
- * @param snd Initialized sound struct.
+ * The restart lands sample-accurately at the next mixer block: the device stays open
+ * and nothing is re-prepared or re-queued, only the voice's position moves.
+ */
+bool sound_restart(sound* snd)
+{
+    return sound_seek(snd, 0);
+}
+
+//? Caller holds the sound's lock; a stale voice just ignores the command
+static bool sound_apply_loop(sound* snd) {
+    state s = snd->state;
+    if(s->stream) return audio_stream_set_loop(s->stream, s->looping, s->loop_start, s->loop_end);
+    if(!mixer_voice_playing(engine_mixer, s->voice)) return true;
+    return mixer_set_loop(engine_mixer, s->voice, s->looping, s->loop_start, s->loop_end);
+}
+
+/**
+ * @brief Loops the sound, now if it's playing and on every later play, or lets it play out.
+ *
+ * The loop is the file's `smpl` loop when it has one, the whole file otherwise (see
+ * sound_set_loop_points()). The jump back is sample accurate: the loop's first frame
+ * follows its last with no gap, whether the sound is mixed from memory or streamed.
+ * Turning looping off while playing lets the sound run on to its end.
  *
- * @returns `true` if playback is ongoing (`WHDR_DONE` not set); `false` if playback is complete.
+ * @returns `false` if the change couldn't be queued.
+ */
+bool sound_set_looping(sound* snd, bool loop)
+{
+    if(!sound_ready(snd)) return false;
+    EnterCriticalSection(&snd->state->lock);
+    snd->state->looping = loop;
+    bool ok = sound_apply_loop(snd);
+    LeaveCriticalSection(&snd->state->lock);
+    return ok;
+}
+
+/**
+ * @brief Sets the looped range to file frames `start` to `end - 1`, replacing the smpl loop.
+ *
+ * @param end 0 for the end of the file; an empty range loops the whole file.
+ */
+bool sound_set_loop_points(sound* snd, uint64_t start, uint64_t end)
+{
+    if(!sound_ready(snd)) return false;
+    EnterCriticalSection(&snd->state->lock);
+    snd->state->loop_start = start;
+    snd->state->loop_end = end;
+    bool ok = sound_apply_loop(snd);
+    LeaveCriticalSection(&snd->state->lock);
+    return ok;
+}
+
+/**
+ * @brief Changes the playing sound's gain and pan, glided over a few milliseconds.
  *
- * @note This function performs an atomic read of `dwFlags` but does not provide
- *       full synchronization for concurrent updates beyond the atomicity of the read.
+ * @returns `false` if the sound isn't playing or the mixer's queue is full.
+ */
+bool sound_set_gain(sound* snd, float gain, float pan)
+{
+    if(!sound_ready(snd)) return false;
+    return mixer_set_gain(engine_mixer, snd->state->voice, gain, pan);
+}
+
+/**
+ * @brief Fades the playing sound to `gain` over `duration_ms`, and stops it at the end if asked.
+ *
+ * Only this playback is faded: the mixer applies the fade while it mixes, so other
+ * sounds sharing the cached samples are unaffected.
+ *
+ * @returns `false` if the sound isn't playing or the mixer's queue is full.
+ */
+bool sound_fade(sound* snd, float gain, uint32_t duration_ms, mixer_fade_curve_t curve, bool stop_at_end)
+{
+    if(!sound_ready(snd)) return false;
+    const uint32_t frames = (uint32_t)((uint64_t)duration_ms * ENGINE_SAMPLE_RATE / 1000);
+    return mixer_fade(engine_mixer, snd->state->voice, gain, frames, curve, stop_at_end);
+}
+
+/**
+ * @brief Runs the playing sound through a lowpass at `cutoff_hz`, 0 to turn it off.
+ *
+ * @returns `false` if the sound isn't playing or the mixer's queue is full.
+ */
+bool sound_set_filter(sound* snd, float cutoff_hz)
+{
+    if(!sound_ready(snd)) return false;
+    return mixer_set_filter(engine_mixer, snd->state->voice, cutoff_hz);
+}
+
+/**
+ * @brief Plays one more overlapping copy of the sound, without touching the ones already playing.
+ *
+ * For a cached sound at the device rate this claims a voice from the mixer's pool and
+ * nothing else: no lock, no allocation, no system call, no waiting on the audio thread.
+ * Copies of one sound are only limited by the pool; when it's full the steal policy
+ * given to sound_system_init() decides which voice gives way. Anything else (streamed
+ * or resampled sounds) falls back to play_sound().
+ *
+ * @param priority voices of higher priority are never stolen for this one.
+ * @returns `false` if no voice was free and none could be stolen.
+ */
+bool play_sound_instance(sound* snd, float gain, float pan, uint8_t priority)
+{
+    const uint64_t trigger = audio_clock_ns();
+    if(!sound_ready(snd)) return false;
+    if(snd->state->stream) {
+        play_sound(snd);
+        return is_playing(snd);
+    }
+    //? No handle is kept: the mixer counts the voice in `instances` until it lets go of the asset
+    mixer_voice_params_t params = { gain, pan, false, priority, snd->state->latency, trigger, 0, 0, 0, &snd->state->instances };
+    return mixer_play_ex(engine_mixer, wav_asset_file(snd->state->asset), &params) != MIXER_INVALID_VOICE;
+}
+
+/**
+ * @brief Reads one stage of the sound's trigger-to-speaker latency.
+ *
+ * Every play of the sound (and of any other sound loaded from the same path) since the
+ * device opened is counted. Safe to call while it plays.
+ *
+ * @returns `false` if nothing was measured for the sound.
+ */
+bool sound_get_latency(sound* snd, audio_latency_stage_t stage, audio_latency_summary_t* summary)
+{
+    if(!sound_ready(snd) || !snd->state->latency || !summary || (unsigned)stage >= AUDIO_LATENCY_STAGES) return false;
+    audio_histogram_summarize(&snd->state->latency->stages[stage], summary);
+    return summary->count > 0;
+}
+
+/**
+ * @brief Prints the latency of every sound played since the device opened.
+ *
+ * The same report is logged when the last sound is unloaded and the device closes.
+ */
+void sound_print_latency(FILE* out)
+{
+    InitOnceExecuteOnce(&engine_once, engine_lock_init, NULL, NULL);
+    EnterCriticalSection(&engine_lock);
+    for(sound_path_t* entry = engine_paths; entry; entry = entry->next) {
+        audio_latency_print(out, entry->path, &entry->latency);
+    }
+    LeaveCriticalSection(&engine_lock);
+}
+
+/**
+ * @brief Checks whether the sound is still playing.
+ *
+ * @param snd Initialized sound struct.
+ *
+ * @returns `true` from play_sound() until the mixer has played the last frame.
  */
 bool is_playing(sound *snd)
 {
-    sound_ctx_aqcuire(snd->state);
-    LONG result = InterlockedCompareExchange((volatile LONG*)&snd->state->sndFlags, 0, 0);
-    sound_ctx_release(snd->state);
-    return (result & SOUND_IS_PLAYING) != 0;
+    if(!sound_ready(snd)) return false;
+    return mixer_voice_playing(engine_mixer, snd->state->voice);
 }
 
 //=================================================PRIVATE UTILITY IMPLEMENTATION==========================================================
 
-static void sound_ctx_aqcuire(state internal) {
-    InterlockedIncrement(&internal->refcount);
+static BOOL CALLBACK engine_lock_init(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once; (void)param; (void)context;
+    InitializeCriticalSection(&engine_lock);
+    return TRUE;
 }
 
-static void sound_ctx_release(state internal) {
-    InterlockedDecrement(&internal->refcount);
+//? Opens the device and the mixer for the first sound, later sounds just share them. Takes engine_lock held
+static bool engine_acquire_locked(void) {
+    if(!engine_backend) {
+        mixer_config_t mixer_config = { ENGINE_SAMPLE_RATE, ENGINE_CHANNELS, ENGINE_BLOCK_FRAMES, engine_max_voices, 256, engine_steal_policy };
+        engine_mixer = mixer_init(&mixer_config);
+        engine_cache = wav_cache_init(ENGINE_CACHE_BUDGET);
+        if(engine_mixer && engine_cache) {
+            audio_config_t config = { ENGINE_SAMPLE_RATE, ENGINE_CHANNELS, ENGINE_BLOCK_FRAMES, mixer_render, engine_mixer, mixer_block_event };
+            engine_backend = audio_waveout_backend_init(&config, ENGINE_BUFFERS);
+        }
+        if(!engine_backend || !audio_backend_start(engine_backend)) {
+            Log(LOG_ERROR, "Audio output unavailable.\n");
+            audio_backend_free(engine_backend);
+            mixer_free(engine_mixer);
+            wav_cache_free(engine_cache);
+            engine_backend = NULL;
+            engine_mixer = NULL;
+            engine_cache = NULL;
+            return false;
+        }
+    }
+    ++engine_sounds;
+    return true;
 }
 
-static void sound_load(sound *snd)
-{  
-    //!could cause race cond if called after play_sound(...)
-    if(!snd) return;
-    if(snd->state->sndFlags & SOUND_WAV_PARSED) return; //!maybe log
-    wav_init_file(&snd->state->wav_file);
-    if(!wav_parse_file(snd->file_path, &snd->state->wav_file)) {
-        sound_cleanup_on_fail(snd);
-        exit(EXIT_FAILURE);
-    }
-    snd->state->sndFlags |= SOUND_WAV_PARSED;
-    snd->state->hBufferDoneEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-    InitializeCriticalSection(&snd->state->lock);
-    WAVEFORMATEX_HDRinit(snd);
-    prepareSoundData(snd);
-}
-
-static bool WaveOutOpFailed(MMRESULT mmResult, const char* fn_name) {
-    if (mmResult != MMSYSERR_NOERROR) {
-        char errorText[MAXERRORLENGTH];
-        waveOutGetErrorTextA(mmResult, errorText, MAXERRORLENGTH);
-        Log(LOG_ERROR, "%s failed.\n", fn_name); //!use better errText
-        Log(LOG_ERROR, "Reason: %s.\n", errorText); //!use better errText
-        return true;
+static bool engine_acquire(void) {
+    InitOnceExecuteOnce(&engine_once, engine_lock_init, NULL, NULL);
+    EnterCriticalSection(&engine_lock);
+    bool ok = engine_acquire_locked();
+    LeaveCriticalSection(&engine_lock);
+    return ok;
+}
+
+static void engine_release(void) {
+    EnterCriticalSection(&engine_lock);
+    if(engine_sounds == 0) {
+        LeaveCriticalSection(&engine_lock);
+        return;
     }
-    return false;
-}
-
-static void WAVEFORMATEX_HDRinit(const sound* snd) {
-    wav_file_t* wav_file = &snd->state->wav_file;
-    WAVEFORMATEX* format = &snd->state->format;
-    WAVEHDR *wvHeader = &snd->state->waveHeader;
-    //---------------Format Section-------------------
-    format->wFormatTag = WAVE_FORMAT_PCM;
-    format->nChannels = wav_file->header.num_channels;
-    format->nSamplesPerSec = wav_file->header.sample_rate;
-    format->nAvgBytesPerSec = (wav_file->header.sample_rate * wav_file->header.block_align);
-    format->nBlockAlign = wav_file->header.block_align;
-    format->wBitsPerSample = wav_file->header.bits_per_sample;
-    format->cbSize = 0; 
-    //---------------Header Section-------------------
-    wvHeader->lpData = snd->state->wav_file.data;
-    wvHeader->dwBufferLength = snd->state->wav_file.data_length; 
-}
-//!potentially unsafe usage lock before use 
-static void prepareSoundData(sound* snd) {
-    MMRESULT mmres = waveOutOpen(&snd->state->hWaveOut, WAVE_MAPPER, &snd->state->format, (DWORD_PTR)waveOutProc, (DWORD_PTR)snd, CALLBACK_FUNCTION);
-    if(WaveOutOpFailed(mmres, "waveOutOpen")) {
-        sound_cleanup_on_fail(snd);
-        exit(EXIT_FAILURE);//! maybe not, will quit even if i was loading several sound and only one of em failed
+    if(--engine_sounds == 0) {
+        //? Backend first: once its thread is joined no block event can touch the histograms
+        audio_backend_free(engine_backend);
+        mixer_free(engine_mixer);
+        wav_cache_free(engine_cache);
+        engine_backend = NULL;
+        engine_mixer = NULL;
+        engine_cache = NULL;
+        if(engine_paths) {
+            Log(LOG_INFO, "Playback latency, from the play call to the first frame mixed, submitted and played:\n");
+        }
+        while(engine_paths) {
+            sound_path_t* next = engine_paths->next;
+            audio_latency_print(stdout, engine_paths->path, &engine_paths->latency);
+            free(engine_paths);
+            engine_paths = next;
+        }
     }
-    mmres = waveOutPrepareHeader(snd->state->hWaveOut, &snd->state->waveHeader, sizeof(WAVEHDR));
-    if(WaveOutOpFailed(mmres, "waveOutPrepareHeader")) {
-        waveOutClose(snd->state->hWaveOut);
-        sound_cleanup_on_fail(snd);
-        exit(EXIT_FAILURE);//! maybe not, will quit even if i was loading several sound and only one of em failed
+    LeaveCriticalSection(&engine_lock);
+}
+
+static sound_path_t* engine_path_for(const char* path) {
+    EnterCriticalSection(&engine_lock);
+    sound_path_t* entry = engine_paths;
+    while(entry && strcmp(entry->path, path) != 0) entry = entry->next;
+    if(!entry) {
+        size_t len = strlen(path);
+        entry = (sound_path_t*)malloc(sizeof(sound_path_t) + len + 1);
+        if(entry) {
+            audio_latency_reset(&entry->latency);
+            entry->loop_known = false;
+            memcpy(entry->path, path, len + 1);
+            entry->next = engine_paths;
+            engine_paths = entry;
+        } else {
+            Log(LOG_WARNING, "Not enough memory to measure %s's latency.\n", path);
+        }
     }
+    LeaveCriticalSection(&engine_lock);
+    return entry;
 }
-//!potentially unsafe usage lock before use, also redudant code, just add a boolean flag wether to WaitForSingleObject or not
-static void unprepareSoundData(sound* snd) {
-    MMRESULT mmres = waveOutReset(snd->state->hWaveOut);
-    if(WaveOutOpFailed(mmres, "waveOutUnprepareHeader")) {
-        //? Continue anyway, maybe device already stopped/invalid
+
+//? Caller holds the sound's lock and has checked its voice is gone, so the audio thread no longer reads the stream
+static bool sound_start_voice(sound* snd, uint64_t frame, uint64_t trigger) {
+    state s = snd->state;
+    mixer_voice_params_t params = { 1.0f, 0.0f, s->looping, MIXER_PRIORITY_NORMAL, s->latency, trigger, frame, s->loop_start, s->loop_end, NULL };
+    if(!snd->state->stream) {
+        snd->state->voice = mixer_play_ex(engine_mixer, wav_asset_file(snd->state->asset), &params);
+    } else {
+        audio_stream_set_loop(s->stream, s->looping, s->loop_start, s->loop_end);
+        if(!audio_stream_start_at(snd->state->stream, frame, s->looping)) return false;
+        snd->state->voice = mixer_play_stream_ex(engine_mixer, snd->state->stream, &params);
+        if(snd->state->voice == MIXER_INVALID_VOICE) audio_stream_stop(snd->state->stream);
     }
-    mmres = waveOutUnprepareHeader(snd->state->hWaveOut, &snd->state->waveHeader, sizeof(WAVEHDR));
-    if(WaveOutOpFailed(mmres, "waveOutUnprepareHeader")) {
-        //? Can't free buffer safely; proceed to close device
+    if(snd->state->voice == MIXER_INVALID_VOICE) {
+        Log(LOG_ERROR, "No free voice to play %s.\n", snd->file_path);
+        return false;
     }
-    mmres = waveOutClose(snd->state->hWaveOut);
-    if(WaveOutOpFailed(mmres, "waveOutClose")) {
-        //? Nothing else to do — OS will reclaim resources on process exit
+    return true;
+}
+
+static BOOL CALLBACK loader_pool_init(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once; (void)param; (void)context;
+    InitializeThreadpoolEnvironment(&loader_env);
+    loader_pool = CreateThreadpool(NULL);
+    if(!loader_pool) {
+        Log(LOG_ERROR, "Unable to create the sound loader pool.\n");
+        return TRUE;
     }
+    SetThreadpoolThreadMaximum(loader_pool, SOUND_LOADER_THREADS);
+    SetThreadpoolCallbackPool(&loader_env, loader_pool);
+    return TRUE;
 }
-//!this might be unsafe twan, whatchu saying ?
-static void unprepareSoundDataInCleanup(sound* snd) {
-    MMRESULT mmres = waveOutReset(snd->state->hWaveOut);
-    if(WaveOutOpFailed(mmres, "waveOutUnprepareHeader")) {
-        //? Continue anyway, maybe device already stopped/invalid
+
+static bool sound_ready(sound* snd) {
+    return snd && snd->state && sound_load_state(snd) == SOUND_READY;
+}
+
+static sound* sound_alloc(const char* file_path) {
+    sound *snd = (sound*)calloc(1, sizeof(sound));
+    state s = (state)calloc(1, sizeof(struct state__));
+    char* path = file_path ? (char*)malloc(strlen(file_path) + 1) : NULL;
+    if(!snd || !s || !path) {
+        Log(LOG_ERROR, "malloc failed to allocate memory for the sound\n");
+        free(snd);
+        free(s);
+        free(path);
+        return NULL;
     }
-    //!wait for the callback_func to receive WOM_DONE
-    WaitForSingleObject(snd->state->hBufferDoneEvent, INFINITE);
+    strcpy(path, file_path);
+    snd->file_path = path;
+    snd->state = s;
+    s->voice = MIXER_INVALID_VOICE;
+    atomic_init(&s->instances, 0);
+    s->load_state = SOUND_LOADING;
+    InitializeCriticalSection(&s->lock);
+    return snd;
+}
 
-    mmres = waveOutUnprepareHeader(snd->state->hWaveOut, &snd->state->waveHeader, sizeof(WAVEHDR));
-    if(WaveOutOpFailed(mmres, "waveOutUnprepareHeader")) {
-        //? Can't free buffer safely; proceed to close device
+static void sound_free(sound* snd) {
+    if(snd->state) {
+        DeleteCriticalSection(&snd->state->lock);
+        if(snd->state->loaded) CloseHandle(snd->state->loaded);
+        free(snd->state);
     }
-    mmres = waveOutClose(snd->state->hWaveOut);
-    if(WaveOutOpFailed(mmres, "waveOutClose")) {
-        //? Nothing else to do — OS will reclaim resources on process exit
+    free(snd->file_path);
+    free(snd);
+}
+
+//? Checked between the steps of a load, the slow ones are the parse and the device open
+static bool sound_cancelled(state s) {
+    if(!InterlockedCompareExchange(&s->cancel, 0, 0)) return false;
+    snprintf(s->error, sizeof(s->error), "cancelled");
+    return true;
+}
+
+//? The smpl chunk's first loop, played forward whatever its type; a file without one loops whole.
+//? Remembered in `info` (if any) for the sounds that will find the same asset in the cache
+static void sound_read_loop_points(state s, const char* file_path, const wav_chunk_dir_t* chunks, sound_path_t* info) {
+    const wav_chunk_t* chunk = wav_find_chunk(chunks, "smpl");
+    uint8_t* bytes = chunk ? wav_load_chunk(file_path, chunk) : NULL;
+    wav_smpl_t smpl;
+    if(bytes && wav_decode_smpl(bytes, chunk->size, &smpl) && smpl.loop_count > 0) {
+        s->loop_start = smpl.loops[0].start;
+        s->loop_end = smpl.loops[0].end + 1;    //? smpl loop ends are inclusive
+        if(smpl.loops[0].type != WAV_LOOP_FORWARD) {
+            Log(LOG_DEBUG, "%s: loop type %u played as a forward loop.\n", file_path, smpl.loops[0].type);
+        }
     }
+    free(bytes);
+    if(!info) return;
+    EnterCriticalSection(&engine_lock);
+    info->loop_start = s->loop_start;
+    info->loop_end = s->loop_end;
+    info->loop_known = true;
+    LeaveCriticalSection(&engine_lock);
 }
 
+//? A cache hit takes the loop its asset was loaded with; `false` if nobody recorded one
+static bool sound_cached_loop_points(state s, sound_path_t* info) {
+    if(!info) return false;
+    EnterCriticalSection(&engine_lock);
+    bool known = info->loop_known;
+    if(known) {
+        s->loop_start = info->loop_start;
+        s->loop_end = info->loop_end;
+    }
+    LeaveCriticalSection(&engine_lock);
+    return known;
+}
 
-static void sound_cleanup_on_fail(sound* snd) {
-    if (!snd) return;
-    if(!snd->state && !snd->file_path) {
-        Log(LOG_WARNING, "Only Sound's struct was freed - Sound's state wasn't initialized.\n\n");
-        free(snd);
-        return;
+//* Everything a sound needs before it can play: the engine, then the cached samples or a stream
+static bool sound_open(sound* snd) {
+    state s = snd->state;
+    const char* file_path = snd->file_path;
+    if(sound_cancelled(s)) return false;
+    if(!engine_acquire()) {
+        snprintf(s->error, sizeof(s->error), "no audio output device");
+        return false;
     }
-    if (snd->state) {
-        free(snd->state);
-        snd->state = NULL;
-        Log(LOG_INFO, "Sound's state successfully unloaded!\n\n");
+    sound_path_t* info = engine_path_for(file_path);
+    s->latency = info ? &info->latency : NULL;
+    //? A sound that's already loaded costs a hash lookup, no disk access at all
+    s->asset = wav_cache_find(engine_cache, file_path);
+    const bool cache_hit = s->asset != NULL;
+    wav_probe_t probe;
+    if(!s->asset) {
+        if(!wav_probe(file_path, &probe)) {
+            snprintf(s->error, sizeof(s->error), "unable to open or parse %s", file_path);
+            engine_release();
+            return false;
+        }
+        if(sound_cancelled(s)) {
+            engine_release();
+            return false;
+        }
+        //? IMA ADPCM can't be streamed from disk, it's cached compressed (a quarter of the PCM size) whatever its length
+        if(probe.data_length <= SOUND_CACHE_MAX_BYTES || probe.header.encoding == WAV_FORMAT_IMA_ADPCM) {
+            s->asset = wav_cache_acquire(engine_cache, file_path);
+        }
     }
-    if (snd->file_path) {
-        free(snd->file_path);
-        snd->file_path = NULL; 
-        Log(LOG_INFO, "Sound's file_path successfully freed!\n\n");
+    if(!cache_hit || !sound_cached_loop_points(s, info)) {
+        sound_read_loop_points(s, file_path, s->asset ? &wav_asset_file(s->asset)->chunks : &probe.chunks, info);
     }
-    if (snd) {
-        free(snd);
-        snd = NULL; 
-        Log(LOG_INFO, "Sound's struct successfully freed!\n\n");
+    if(s->asset) {
+        //? At the device rate the mixer reads the shared samples as they are, otherwise they're resampled while playing
+        const wav_file_t* file = wav_asset_file(s->asset);
+        if(file->header.sample_rate != ENGINE_SAMPLE_RATE) {
+            s->stream = audio_stream_open_memory(file, ENGINE_SAMPLE_RATE, 0);
+        }
+    } else {
+        //? Only the header is read here, the samples are decoded while they play
+        s->stream = audio_stream_open_file(file_path, ENGINE_SAMPLE_RATE, 0);
+    }
+    if(!s->stream && (!s->asset || wav_asset_file(s->asset)->header.sample_rate != ENGINE_SAMPLE_RATE)) {
+        snprintf(s->error, sizeof(s->error), "unable to decode %s", file_path);
+        sound_close(s);
+        return false;
     }
+    if(sound_cancelled(s)) {
+        sound_close(s);
+        return false;
+    }
+    return true;
 }
 
-static void CALLBACK waveOutProc(HWAVEOUT hwo, UINT uMsg, DWORD_PTR dwInstance, DWORD_PTR param1, DWORD_PTR param2) {
-    switch(uMsg) {
-        case WOM_DONE:
-        {
-            sound* snd = (sound*)dwInstance;
+//? Undoes sound_open(); no voice may be playing the sound any more
+static void sound_close(state s) {
+    audio_stream_close(s->stream);
+    wav_asset_release(s->asset);
+    s->stream = NULL;
+    s->asset = NULL;
+    engine_release();
+}
 
-            if(snd) {
-                sound_ctx_aqcuire(snd->state);
-                InterlockedAnd((volatile LONG*)&snd->state->sndFlags, ~SOUND_IS_PLAYING);
-                InterlockedOr((volatile LONG*)&snd->state->sndFlags, SOUND_PLAYBACK_DONE);
-                SetEvent(snd->state->hBufferDoneEvent);//! may be unsafe to access, consider using locks
-                sound_ctx_release(snd->state);
-            }
-        }
+static void CALLBACK sound_load_job(PTP_CALLBACK_INSTANCE instance, PVOID context) {
+    (void)instance;
+    sound* snd = (sound*)context;
+    state s = snd->state;
+    sound_load_state_t result = SOUND_READY;
+    if(!sound_open(snd)) {
+        result = InterlockedCompareExchange(&s->cancel, 0, 0) ? SOUND_CANCELLED : SOUND_FAILED;
+        if(result == SOUND_FAILED) Log(LOG_ERROR, "Loading %s failed: %s.\n", snd->file_path, s->error);
     }
-}
\ No newline at end of file
+    InterlockedExchange(&s->load_state, result);
+    if(s->on_loaded) s->on_loaded(snd, result, s->user);
+    //! last touch of `snd`: sound_unload() may free it as soon as this is set
+    SetEvent(s->loaded);
+}
+
+static void sound_stop_voice(sound* snd) {
+    //! a stop only lands at the next block boundary (and a full command queue drops it), so keep asking until the voice is gone
+    while(mixer_voice_playing(engine_mixer, snd->state->voice)) {
+        mixer_stop(engine_mixer, snd->state->voice);
+        Sleep(1);
+    }
+    while(atomic_load_explicit(&snd->state->instances, memory_order_acquire) > 0) {
+        mixer_stop_counted(engine_mixer, &snd->state->instances);
+        Sleep(1);
+    }
+}
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <stdbool.h>
+#include "mixer.h"
 
 typedef struct state__ *state;
 
@@ -24,7 +25,46 @@ typedef struct sound {
     state state;
 } sound;
 
+typedef enum sound_load_state_t {
+    SOUND_LOADING,
+    SOUND_READY,
+    SOUND_FAILED,               //? sound_load_error() says why
+    SOUND_CANCELLED,
+} sound_load_state_t;
+
+//? Runs on a loader thread when a sound_init_async() load finishes; must not unload `snd`
+typedef void (*sound_loaded_fn)(sound* snd, sound_load_state_t result, void* user);
+
+//? Optional: sizes the voice pool and picks what happens when it's full, before the first sound is
+//? loaded. Keeps the device open until sound_system_shutdown(). Defaults: 64 voices, no stealing
+//? Shutdown without a successful init (or a second one) does nothing
+bool  sound_system_init(uint32_t max_voices, mixer_steal_policy_t policy);
+void  sound_system_shutdown(void);
+
+//? Returns NULL (with the reason logged) if the file can't be opened or there's no audio device
 sound *sound_init(const char* file_path);
+//? Returns at once and loads on a background pool; poll sound_load_state() or pass a callback
+sound *sound_init_async(const char* file_path, sound_loaded_fn on_loaded, void* user);
+sound_load_state_t sound_load_state(sound* snd);
+sound_load_state_t sound_wait_loaded(sound* snd, uint32_t timeout_ms);
+bool  sound_cancel_load(sound* snd);
+const char* sound_load_error(sound* snd);
 void  sound_unload(sound* _sound);
 void  play_sound(sound* _sound);
-bool  is_playing(sound* snd);
\ No newline at end of file
+bool  play_sound_instance(sound* _sound, float gain, float pan, uint8_t priority);
+bool  is_playing(sound* snd);
+//? Sample-accurate jump (or start) at `frame` of the file, without reopening the device
+bool  sound_seek(sound* snd, uint64_t frame);
+//? Back to the first frame at the next mixer block, without reopening or re-queuing anything
+bool  sound_restart(sound* snd);
+//? Sample-accurate looping over the file's smpl loop (or the whole file), or over frames set here
+bool  sound_set_looping(sound* snd, bool loop);
+bool  sound_set_loop_points(sound* snd, uint64_t start, uint64_t end);
+//? Per-playback gain, pan, fades and lowpass on the playing sound; the loaded samples are never touched
+bool  sound_set_gain(sound* snd, float gain, float pan);
+bool  sound_fade(sound* snd, float gain, uint32_t duration_ms, mixer_fade_curve_t curve, bool stop_at_end);
+bool  sound_set_filter(sound* snd, float cutoff_hz);
+
+//? Trigger-to-speaker latency per sound, see audio_latency.h for the stages
+bool  sound_get_latency(sound* snd, audio_latency_stage_t stage, audio_latency_summary_t* summary);
+void  sound_print_latency(FILE* out);
\ No newline at end of file
@@ -0,0 +1,205 @@
+/*
+ * -------------------------------------------------------------
+ *  c-wav-player: Simple WAV File Parser and Win32 Sound Player
+ *  Author: Myson Dio (gtRZync)
+ *  License: MIT License
+ *  Repository: https://github.com/gtRZync/c-wav-player
+ *
+ *  Description:
+ *    Lightweight parser for standard RIFF/WAV files and a sound
+ *    playback system using Windows waveOut API. Skips metadata
+ *    chunks (e.g. LIST, smpl), reads PCM audio data, and plays it.
+ *
+ *  See README.md for usage and LICENSE for distribution terms.
+ * -------------------------------------------------------------
+ */
+
+#include "audio_backend.h"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#include "log.h"
+
+//* waveOut backend: a ring of small WAVEHDRs instead of one header over the whole file.
+//* The driver signals `done_event` (CALLBACK_EVENT) every time it finishes a buffer and the
+//* backend's thread refills it; nothing runs inside the driver's callback context.
+
+typedef struct waveout_impl_t {
+    HWAVEOUT device;
+    HANDLE done_event;          //? auto-reset, set by the driver on every WOM_DONE
+    HANDLE thread;
+    volatile LONG running;
+    bool started;
+    unsigned num_buffers;
+    unsigned next;              //? next header to come back, the driver returns them in submission order
+    uint64_t next_block;        //? render calls so far; each header keeps its block number in dwUser
+    WAVEHDR* headers;
+    int16_t* samples;           //? num_buffers blocks, one per header
+} waveout_impl_t;
+
+static bool waveout_failed(MMRESULT mmResult, const char* fn_name) {
+    if (mmResult != MMSYSERR_NOERROR) {
+        char errorText[MAXERRORLENGTH];
+        waveOutGetErrorTextA(mmResult, errorText, MAXERRORLENGTH);
+        Log(LOG_ERROR, "%s failed. Reason: %s.\n", fn_name, errorText);
+        return true;
+    }
+    return false;
+}
+
+//? Renders into one header and hands it (back) to the driver
+static bool waveout_submit(audio_backend_t* backend, WAVEHDR* header) {
+    waveout_impl_t* impl = (waveout_impl_t*)backend->impl;
+    backend->config.render(backend->config.user, (int16_t*)header->lpData, backend->config.block_frames);
+    header->dwFlags &= ~WHDR_DONE;
+    header->dwUser = (DWORD_PTR)impl->next_block++;
+    if (waveout_failed(waveOutWrite(impl->device, header, sizeof(WAVEHDR)), "waveOutWrite")) {
+        return false;
+    }
+    atomic_fetch_add_explicit(&backend->frames_rendered, backend->config.block_frames, memory_order_relaxed);
+    if (backend->config.on_block) {
+        backend->config.on_block(backend->config.user, AUDIO_BLOCK_SUBMITTED, (uint64_t)header->dwUser, audio_clock_ns());
+    }
+    return true;
+}
+
+static DWORD WINAPI waveout_thread(LPVOID arg) {
+    audio_backend_t* backend = (audio_backend_t*)arg;
+    waveout_impl_t* impl = (waveout_impl_t*)backend->impl;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+    while (InterlockedCompareExchange(&impl->running, 0, 0)) {
+        WaitForSingleObject(impl->done_event, INFINITE);
+        //* Every buffer back at once means the device played everything it had: an underrun
+        unsigned done = 0;
+        for (unsigned i = 0; i < impl->num_buffers; ++i) {
+            if (impl->headers[i].dwFlags & WHDR_DONE) ++done;
+        }
+        if (done == impl->num_buffers) {
+            atomic_fetch_add_explicit(&backend->underruns, 1, memory_order_relaxed);
+        }
+        //? The event only says "something finished", stamp it when we wake: this is as close to WOM_DONE as it gets
+        const uint64_t now = audio_clock_ns();
+        while (InterlockedCompareExchange(&impl->running, 0, 0) && (impl->headers[impl->next].dwFlags & WHDR_DONE)) {
+            if (backend->config.on_block) {
+                backend->config.on_block(backend->config.user, AUDIO_BLOCK_DONE, (uint64_t)impl->headers[impl->next].dwUser, now);
+            }
+            if (!waveout_submit(backend, &impl->headers[impl->next])) {
+                return 1;
+            }
+            impl->next = (impl->next + 1) % impl->num_buffers;
+        }
+    }
+    return 0;
+}
+
+static bool waveout_start(audio_backend_t* backend) {
+    waveout_impl_t* impl = (waveout_impl_t*)backend->impl;
+    if (impl->started) return true;
+    //? Queue the whole ring up front so the device has num_buffers blocks of slack from the start
+    impl->next = 0;
+    for (unsigned i = 0; i < impl->num_buffers; ++i) {
+        if (!waveout_submit(backend, &impl->headers[i])) {
+            waveOutReset(impl->device);
+            return false;
+        }
+    }
+    InterlockedExchange(&impl->running, 1);
+    impl->thread = CreateThread(NULL, 0, waveout_thread, backend, 0, NULL);
+    if (!impl->thread) {
+        Log(LOG_ERROR, "waveOut backend: unable to start the render thread.\n");
+        InterlockedExchange(&impl->running, 0);
+        waveOutReset(impl->device);
+        return false;
+    }
+    impl->started = true;
+    return true;
+}
+
+static void waveout_stop(audio_backend_t* backend) {
+    waveout_impl_t* impl = (waveout_impl_t*)backend->impl;
+    if (!impl->started) return;
+    InterlockedExchange(&impl->running, 0);
+    SetEvent(impl->done_event);
+    WaitForSingleObject(impl->thread, INFINITE);
+    CloseHandle(impl->thread);
+    impl->thread = NULL;
+    //? Returns every queued header to us (WHDR_DONE), so they can be refilled or unprepared
+    waveout_failed(waveOutReset(impl->device), "waveOutReset");
+    impl->started = false;
+}
+
+static void waveout_destroy(audio_backend_t* backend) {
+    waveout_impl_t* impl = (waveout_impl_t*)backend->impl;
+    if (impl) {
+        if (impl->device) {
+            for (unsigned i = 0; impl->headers && i < impl->num_buffers; ++i) {
+                if (impl->headers[i].dwFlags & WHDR_PREPARED) {
+                    waveOutUnprepareHeader(impl->device, &impl->headers[i], sizeof(WAVEHDR));
+                }
+            }
+            waveout_failed(waveOutClose(impl->device), "waveOutClose");
+        }
+        if (impl->done_event) CloseHandle(impl->done_event);
+        free(impl->headers);
+        free(impl->samples);
+        free(impl);
+    }
+    free(backend);
+}
+
+static const audio_backend_ops_t waveout_ops = { "waveOut", waveout_start, waveout_stop, waveout_destroy };
+
+audio_backend_t* audio_waveout_backend_init(const audio_config_t* config, unsigned num_buffers) {
+    if (!config || !config->render || config->sample_rate == 0 || config->num_channels == 0 || config->block_frames == 0 || num_buffers < 2) {
+        Log(LOG_ERROR, "Invalid audio backend configuration.\n");
+        return NULL;
+    }
+    const size_t block_bytes = config->block_frames * config->num_channels * sizeof(int16_t);
+    WAVEFORMATEX format = { 0 };
+    audio_backend_t* backend = (audio_backend_t*)calloc(1, sizeof(audio_backend_t));
+    waveout_impl_t* impl = (waveout_impl_t*)calloc(1, sizeof(waveout_impl_t));
+    if (!backend || !impl) {
+        Log(LOG_ERROR, "Memory allocation failed: unable to allocate the waveOut backend.\n");
+        free(backend);
+        free(impl);
+        return NULL;
+    }
+    backend->ops = &waveout_ops;
+    backend->config = *config;
+    backend->impl = impl;
+    atomic_init(&backend->frames_rendered, 0);
+    atomic_init(&backend->underruns, 0);
+    impl->num_buffers = num_buffers;
+    impl->headers = (WAVEHDR*)calloc(num_buffers, sizeof(WAVEHDR));
+    impl->samples = (int16_t*)malloc(num_buffers * block_bytes);
+    impl->done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!impl->headers || !impl->samples || !impl->done_event) {
+        Log(LOG_ERROR, "waveOut backend: unable to allocate the device buffers.\n");
+        goto fail;
+    }
+
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = config->num_channels;
+    format.nSamplesPerSec = config->sample_rate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = (WORD)(config->num_channels * sizeof(int16_t));
+    format.nAvgBytesPerSec = config->sample_rate * format.nBlockAlign;
+    if (waveout_failed(waveOutOpen(&impl->device, WAVE_MAPPER, &format, (DWORD_PTR)impl->done_event, 0, CALLBACK_EVENT), "waveOutOpen")) {
+        impl->device = NULL;
+        goto fail;
+    }
+    for (unsigned i = 0; i < num_buffers; ++i) {
+        WAVEHDR* header = &impl->headers[i];
+        header->lpData = (LPSTR)((uint8_t*)impl->samples + i * block_bytes);
+        header->dwBufferLength = (DWORD)block_bytes;
+        if (waveout_failed(waveOutPrepareHeader(impl->device, header, sizeof(WAVEHDR)), "waveOutPrepareHeader")) {
+            goto fail;
+        }
+    }
+    return backend;
+
+fail:
+    waveout_destroy(backend);
+    return NULL;
+}